@@ -1,6 +1,8 @@
 // lib/cubits/search/search_cubit.dart
 import 'dart:async';
+import 'dart:convert'; // For base64Decode
 import 'dart:developer';
+import 'dart:typed_data'; // For Uint8List
 import 'package:bloc/bloc.dart';
 import 'package:fluentui_system_icons/fluentui_system_icons.dart';
 import 'package:flutter/foundation.dart'; // For kDebugMode, listEquals, compute
@@ -11,9 +13,8 @@ import 'package:vxkonsol/core/global_controller.dart';
 import 'package:vxkonsol/core/search_result_sorter.dart';
 import 'package:vxkonsol/core/window_setup.dart'; // Assuming window resize logic is here
 import 'package:vxkonsol/models/search_result.dart';
-import 'package:vxkonsol/native_apis/program_fetcher.dart';
+import 'package:vxkonsol/native_apis/native_catalog.dart';
 import 'package:vxkonsol/native_apis/program_info.dart';
-import 'package:vxkonsol/native_apis/window_search.dart';
 import 'package:path/path.dart' as p;
 import 'package:window_manager/window_manager.dart'; // Make sure this import is present
 
@@ -26,10 +27,62 @@ class SearchCubit extends Cubit<SearchState> {
 
   final GlobalController _globalController = Get.find<GlobalController>();
 
+  // Native search results are pushed as frames on this channel.
+  static const EventChannel _nativeEventChannel =
+      EventChannel('windows_native_events');
+  // Budget for the first result frame of a query; slower providers append later.
+  static const int _firstFrameDeadlineMs = 30;
+  // Speculative mode: every keystroke starts a native search right away and
+  // cancels the previous one, instead of waiting out the 250 ms debounce. The
+  // Windows Search Index only starts once typing pauses for
+  // [_speculativeDelayMs], so fast typing never reaches it.
+  static const bool _speculativeSearch = true;
+  static const int _speculativeDelayMs = 40;
+
   Timer? _debounce;
   // Keep track of the current search operation ID to ignore stale results
   int _currentSearchId = 0;
 
+  StreamSubscription<dynamic>? _nativeEvents;
+  int _frameSearchId = -1;
+
+  // The result list as the native side last sent it. The runner keeps a copy
+  // and sends every frame (and fetchRows page) as a patch to it, numbered
+  // [_modelVersion] -> next, so only new rows cross the channel and unchanged
+  // entries keep their ProgramInfo (and SearchResult, see [_searchResults]).
+  // Patches are applied in version order whatever the query; [_modelSeq] is
+  // the query the list currently belongs to.
+  List<ProgramInfo> _model = const [];
+  int _modelVersion = 0;
+  int _modelSeq = -1;
+  final Map<int, _ViewUpdate> _pendingUpdates = <int, _ViewUpdate>{};
+  // Out-of-order updates beyond this mean one was lost; the view is reset.
+  static const int _maxPendingUpdates = 16;
+  bool _resettingView = false;
+  // Catalog matches shown before frame 0 of the query arrives.
+  final List<ProgramInfo> _instantResults = <ProgramInfo>[];
+  // Converted results, reused for as long as their ProgramInfo is.
+  final Expando<SearchResult> _searchResults = Expando<SearchResult>();
+
+  // Frames are paged: the native side keeps the full result set of the query,
+  // ranked as [SearchResultSorter] orders it, and keeps [_model] the best
+  // [_pageRows] rows of it, or more once [loadMoreResults] has pulled more as
+  // the list scrolls. A late frame with better rows moves them up. [_frameLoaded]
+  // is how many rows of the set, of [_frameTotal], [_model] holds.
+  static const int _pageRows = 40;
+  int _frameTotal = 0;
+  int _frameLoaded = 0;
+  bool _fetchingRows = false;
+  // Icons of paged rows, fetched in one fetchIcons call per microtask.
+  final Map<int, Future<Uint8List?>> _iconLoads = <int, Future<Uint8List?>>{};
+  Map<int, Completer<Uint8List?>> _pendingIcons = <int, Completer<Uint8List?>>{};
+
+  // Synchronous view of the native catalog (dart:ffi); null until the runner
+  // has published it, or where the exports are unavailable.
+  NativeCatalog? _nativeCatalog;
+  // Catalog matches shown before frame 0 arrives; the frame replaces them.
+  static const int _instantResultLimit = 50;
+
   // --- Keywords to Filter Out (Case-insensitive) ---
   // This list defines keywords that, if found in the program's name or path,
   // will cause the item to be excluded from the search results.
@@ -42,57 +95,45 @@ class SearchCubit extends Cubit<SearchState> {
   ];
 
   SearchCubit() : super(const SearchState()) {
+    _nativeEvents = _nativeEventChannel.receiveBroadcastStream().listen(
+        _onNativeEvent,
+        onError: (Object e) => log("[SearchCubit] Native event error: $e"));
+    // The runner outlives a hot restart; start from an empty list on both
+    // sides, and from search 1 as far as its cancel and paging state go.
+    _resetResultView(newSession: true);
     // Start loading installed programs immediately when the cubit is created.
     _loadInstalledPrograms();
   }
 
   // --- Initialization ---
-  /// Fetches the list of all installed programs in the background using an isolate.
-  /// Updates the state with the loaded programs or an error.
+  /// Waits for the runner's first catalog scan. The catalog stays native:
+  /// searches read it through [_nativeCatalog] and `startSearch` frames, so
+  /// only its size crosses the channel here.
   Future<void> _loadInstalledPrograms() async {
-    log("[SearchCubit] Initializing: Fetching installed programs...");
+    log("[SearchCubit] Initializing: Waiting for the program catalog...");
     // Ensure state reflects loading, only if not already loading
     if (!state.isLoadingInstalledPrograms) {
       emit(state.copyWith(
           isLoadingInstalledPrograms: true, clearInstalledProgramsError: true));
     }
 
-    final RootIsolateToken? rootIsolateToken = RootIsolateToken.instance;
-    if (rootIsolateToken == null) {
-      const errorMsg =
-          "Fatal Error: RootIsolateToken is null. Cannot fetch programs.";
-      log(errorMsg, level: 1000); // Log severe errors
-      if (!isClosed) {
-        emit(state.copyWith(
-          isLoadingInstalledPrograms: false,
-          installedProgramsError: errorMsg,
-        ));
-      }
-      return;
-    }
-
     try {
-      // Use compute to run the fetching logic in a separate isolate.
-      final List<ProgramInfo> programs =
-          await compute(fetchAllProgramsIsolateEntry, rootIsolateToken);
-
-      log("[SearchCubit] Initial program fetch completed. Received ${programs.length} unique programs.");
+      final reply = await _platformChannel.invokeMethod<Map<dynamic, dynamic>>(
+          'getAllPrograms', {'summary': true});
+      log("[SearchCubit] Catalog ready: ${reply?['count'] ?? 0} programs (generation ${reply?['generation']}).");
       if (!isClosed) {
-        // Check if cubit is closed before emitting
         emit(state.copyWith(
-          allInstalledPrograms: programs,
           isLoadingInstalledPrograms: false,
-          clearInstalledProgramsError: true, // Clear any previous error
+          clearInstalledProgramsError: true,
         ));
       }
-    } catch (e, s) {
-      final errorMsg = "Error fetching installed programs: $e";
+    } on PlatformException catch (e, s) {
+      final errorMsg = "Error loading installed programs: ${e.message}";
       log(errorMsg, stackTrace: s, level: 1000); // Log errors with stack trace
       if (!isClosed) {
         emit(state.copyWith(
           isLoadingInstalledPrograms: false,
           installedProgramsError: errorMsg,
-          allInstalledPrograms: [], // Clear any potentially partial data
         ));
       }
     }
@@ -100,8 +141,10 @@ class SearchCubit extends Cubit<SearchState> {
 
   // --- Search Logic ---
   /// Performs a search based on the provided query.
-  /// Combines results from the pre-loaded installed programs list and
-  /// real-time Windows Search Index results.
+  /// Immediately in speculative mode (otherwise after the debounce), the native
+  /// scheduler queries the installed-program catalog, the settings pages and
+  /// the Windows Search Index in parallel and streams the results back as
+  /// frames (see [_onNativeEvent]).
   /// Filters out items based on banned keywords.
   /// Sorts the results based on type priority, relevance, and title.
   /// Updates the state with the results, loading status, and errors.
@@ -109,6 +152,9 @@ class SearchCubit extends Cubit<SearchState> {
     // Increment search ID to invalidate previous pending operations
     final searchId = ++_currentSearchId;
     log("[SearchCubit] Search requested (ID: $searchId): '$query'");
+    // Stop native work for every older query right away instead of letting it
+    // run to completion and discarding the result here.
+    _cancelNativeSearches(searchId - 1);
 
     // Cancel any existing debounce timer
     if (_debounce?.isActive ?? false) _debounce?.cancel();
@@ -129,154 +175,357 @@ class SearchCubit extends Cubit<SearchState> {
       return;
     }
 
+    if (_speculativeSearch) {
+      _startNativeSearch(query, searchId);
+      return;
+    }
+
     // Debounce the search operation to avoid excessive processing while typing.
-    _debounce = Timer(const Duration(milliseconds: 250), () async {
+    _debounce = Timer(const Duration(milliseconds: 250), () {
       // Before executing the search, check if this is still the latest request
       // or if the cubit has been closed.
       if (searchId != _currentSearchId || isClosed) {
         log("[SearchCubit] Skipping stale search (ID: $searchId, Current: $_currentSearchId)");
         return;
       }
-      log("[SearchCubit] Debounce finished (ID: $searchId). Performing search for '$query'.");
+      log("[SearchCubit] Debounce finished (ID: $searchId). Starting native search for '$query'.");
+      _startNativeSearch(query, searchId);
+    });
+  }
 
-      final lowerCaseQuery = query.toLowerCase();
-      // Use a Set to automatically handle duplicates from local and Windows search
-      final combinedProgramInfo = <ProgramInfo>{};
-      String? searchError; // To store any error encountered during the search
+  // --- Native Search Frames ---
+  /// Starts the native provider scheduler for [query]. Results arrive as
+  /// `searchFrame` events on [_nativeEventChannel]: frame 0 holds whatever the
+  /// providers produced within the deadline, later frames append stragglers.
+  void _startNativeSearch(String query, int searchId) {
+    _frameSearchId = searchId;
+    _instantResults.clear();
+    _frameTotal = 0;
+    _frameLoaded = 0;
+    _iconLoads.clear();
+    _showInstantResults(query, searchId);
+    _platformChannel.invokeMethod('startSearch', {
+      'query': query,
+      'seq': searchId,
+      'deadlineMs': _firstFrameDeadlineMs,
+      'speculativeDelayMs': _speculativeSearch ? _speculativeDelayMs : 0,
+      'pageRows': _pageRows,
+    }).catchError((Object e) {
+      final errorMsg = "Native search failed to start (ID: $searchId): $e";
+      log(errorMsg, level: 1000);
+      if (searchId == _currentSearchId && !isClosed) {
+        emit(state.copyWith(isLoading: false, searchError: errorMsg));
+      }
+    });
+  }
+
+  /// Publishes the catalog's matches for [query] right away, read synchronously
+  /// from native memory, so the list updates on the keystroke itself instead
+  /// of after the first frame's deadline.
+  void _showInstantResults(String query, int searchId) {
+    _nativeCatalog ??= NativeCatalog.open();
+    final catalog = _nativeCatalog;
+    if (catalog == null) return;
+    final List<ProgramInfo> matches =
+        catalog.search(query, limit: _instantResultLimit);
+    if (matches.isEmpty) return;
+    _instantResults.addAll(matches);
+    _publishResults(query, searchId);
+  }
 
-      // == Step 1: Filter local programs (Synchronous) ==
-      // Filter the already loaded `allInstalledPrograms` based on the query.
+  /// Handles events pushed by the native side on [_nativeEventChannel].
+  void _onNativeEvent(dynamic event) {
+    if (event is! Map || event['type'] != 'searchFrame') return;
+    final int? seq = event['seq'] as int?;
+    if (seq == null || isClosed) return;
+    final int frame = event['frame'] as int? ?? 0;
+    final bool isFinal = event['final'] == true;
+    // Applied even for superseded queries: the runner's copy of the list has
+    // already taken the patch.
+    _receiveViewUpdate(event, seq, replace: frame == 0);
+    // Frames of superseded queries can still be in flight; show nothing of them.
+    if (seq != _currentSearchId || seq != _frameSearchId) {
+      log("[SearchCubit] Skipping frame for stale search (ID: $seq, Current: $_currentSearchId)");
+      return;
+    }
+
+    if (frame == 0) {
+      _instantResults.clear();
+      _frameLoaded = 0;
+    }
+    _trackPage(event);
+    final items = event['items'];
+    log("[SearchCubit] Frame $frame (ID: $seq) from ${event['providers']}: ${items is List ? items.length : 0} new items, $_frameTotal in all. Final: $isFinal");
+
+    _publishResults(state.query, seq, keepSelection: frame > 0);
+  }
+
+  /// Advances [_frameLoaded] to the end of a page of rows that starts at
+  /// `first`, which is 0 since pages are the ranked set's best rows. A page
+  /// that ends short of what is loaded (it raced a fetch) only updates the
+  /// total.
+  void _trackPage(Map<dynamic, dynamic> page) {
+    final int? total = page['total'] as int?;
+    final int? first = page['first'] as int?;
+    final int? next = page['next'] as int?;
+    if (total == null || first == null || next == null) return;
+    _frameTotal = total;
+    if (first <= _frameLoaded && next > _frameLoaded) _frameLoaded = next;
+  }
+
+  /// Queues a patch to [_model] and applies whatever is now in sequence.
+  void _receiveViewUpdate(Map<dynamic, dynamic> page, int seq,
+      {required bool replace}) {
+    final base = page['base'];
+    final version = page['version'];
+    if (base is! int || version is! int) return;
+    _pendingUpdates[base] = _ViewUpdate(page, seq, version, replace);
+    _drainViewUpdates();
+    if (_pendingUpdates.length > _maxPendingUpdates) {
+      log("[SearchCubit] Result list out of step at version $_modelVersion; resetting.");
+      _resetResultView();
+    }
+  }
+
+  void _drainViewUpdates() {
+    _pendingUpdates.removeWhere((base, _) => base < _modelVersion);
+    for (var update = _pendingUpdates.remove(_modelVersion);
+        update != null;
+        update = _pendingUpdates.remove(_modelVersion)) {
       try {
-        if (state.allInstalledPrograms.isNotEmpty) {
-          final localResults = state.allInstalledPrograms.where((program) =>
-              program.name.toLowerCase().contains(lowerCaseQuery) ||
-              program.path.toLowerCase().contains(lowerCaseQuery));
-          combinedProgramInfo.addAll(localResults);
-          // Log message moved after filtering for clarity
-        } else {
-          log("[SearchCubit] Local filter (ID: $searchId): No installed programs loaded yet or list is empty.");
-        }
-      } catch (e, s) {
-        log("[SearchCubit] Error during local filtering (ID: $searchId): $e",
-            stackTrace: s);
-        // Optionally set an error or log more details
+        _model = _applyPatch(_model, update.page);
+      } catch (e) {
+        log("[SearchCubit] Malformed result patch (version ${update.version}): $e");
+        _resetResultView();
+        return;
+      }
+      _modelVersion = update.version;
+      if (update.replace) _modelSeq = update.seq;
+    }
+  }
+
+  /// [old] with the edits of [page] applied: `removes` and the first of each
+  /// `moves` pair index [old], the second of each pair and `inserts` index the
+  /// result. Entries no edit mentions keep their order and fill the remaining
+  /// slots. `items` are the inserted rows; `updated` are rows kept from [old]
+  /// whose content changed, to put at the positions `updates` in the result.
+  static List<ProgramInfo> _applyPatch(
+      List<ProgramInfo> old, Map<dynamic, dynamic> page) {
+    final List<dynamic> removes = page['removes'] as List<dynamic>? ?? const [];
+    final List<dynamic> moves = page['moves'] as List<dynamic>? ?? const [];
+    final List<dynamic> inserts = page['inserts'] as List<dynamic>? ?? const [];
+    final List<dynamic> items = page['items'] as List<dynamic>? ?? const [];
+    final List<dynamic> updates = page['updates'] as List<dynamic>? ?? const [];
+    final List<dynamic> updated = page['updated'] as List<dynamic>? ?? const [];
+    if (items.length != inserts.length ||
+        updated.length != updates.length ||
+        moves.length.isOdd) {
+      throw const FormatException('Inconsistent patch');
+    }
+    final length = old.length - removes.length + inserts.length;
+    final next = List<ProgramInfo?>.filled(length, null);
+    final taken = List<bool>.filled(old.length, false);
+    for (final index in removes) {
+      taken[index as int] = true;
+    }
+    for (var k = 0; k < moves.length; k += 2) {
+      next[moves[k + 1] as int] = old[moves[k] as int];
+      taken[moves[k] as int] = true;
+    }
+    for (var k = 0; k < inserts.length; k++) {
+      next[inserts[k] as int] = ProgramInfo.fromMap(items[k] as Map);
+    }
+    var from = 0;
+    for (var i = 0; i < length; i++) {
+      if (next[i] != null) continue;
+      while (taken[from]) {
+        from++;
       }
+      next[i] = old[from++];
+    }
+    for (var k = 0; k < updates.length; k++) {
+      next[updates[k] as int] = ProgramInfo.fromMap(updated[k] as Map);
+    }
+    return [for (final program in next) program!];
+  }
+
+  /// Empties [_model] and the runner's copy of it, e.g. after an update was
+  /// lost. Updates sent after the reset keep coming in order. [newSession]
+  /// tells the runner that [_currentSearchId] starts over.
+  Future<void> _resetResultView({bool newSession = false}) async {
+    if (_resettingView) return;
+    _resettingView = true;
+    try {
+      final int? version = await _platformChannel.invokeMethod<int>(
+          'resetResultView', {'newSession': newSession});
+      if (version == null || isClosed) return;
+      _model = const [];
+      _modelVersion = version;
+      _modelSeq = -1;
+      _drainViewUpdates();
+    } on PlatformException catch (e) {
+      log("[SearchCubit] resetResultView failed: ${e.message}");
+    } finally {
+      _resettingView = false;
+    }
+  }
 
-      // == Step 2: Windows Search Index (Asynchronous via Isolate) ==
-      // Query the Windows Search Index in a separate isolate for performance.
-      final RootIsolateToken? rootIsolateToken = RootIsolateToken.instance;
-      if (rootIsolateToken != null) {
+  /// Fetches the next page of the current query's results from the native
+  /// result pager, if there is one. Called by the results list as it nears
+  /// the end of what is loaded.
+  Future<void> loadMoreResults() async {
+    final int seq = _frameSearchId;
+    if (_fetchingRows || _frameLoaded >= _frameTotal || seq != _currentSearchId || isClosed) {
+      return;
+    }
+    _fetchingRows = true;
+    try {
+      final page = await _platformChannel.invokeMethod<Map<dynamic, dynamic>>(
+          'fetchRows', {'seq': seq, 'start': _frameLoaded, 'count': _pageRows});
+      if (page == null || isClosed) return;
+      _receiveViewUpdate(page, seq, replace: false);
+      if (seq != _frameSearchId || seq != _currentSearchId) return;
+      _trackPage(page);
+      log("[SearchCubit] Fetched rows (ID: $seq): $_frameLoaded of $_frameTotal loaded.");
+      _publishResults(state.query, seq, keepSelection: true);
+    } on PlatformException catch (e) {
+      log("[SearchCubit] fetchRows failed (ID: $seq): ${e.message}");
+    } finally {
+      _fetchingRows = false;
+    }
+  }
+
+  /// The icon behind a paged row's [iconId], decoded; shared by every row
+  /// with the same icon.
+  Future<Uint8List?> _loadIcon(int iconId) {
+    return _iconLoads.putIfAbsent(iconId, () {
+      if (_pendingIcons.isEmpty) scheduleMicrotask(_flushIconRequests);
+      return (_pendingIcons[iconId] = Completer<Uint8List?>()).future;
+    });
+  }
+
+  Future<void> _flushIconRequests() async {
+    final pending = _pendingIcons;
+    _pendingIcons = <int, Completer<Uint8List?>>{};
+    List<dynamic>? icons;
+    try {
+      icons = await _platformChannel.invokeMethod<List<dynamic>>(
+          'fetchIcons', pending.keys.toList());
+    } on PlatformException catch (e) {
+      log("[SearchCubit] fetchIcons failed: ${e.message}");
+    }
+    var i = 0;
+    for (final completer in pending.values) {
+      final icon = icons != null && i < icons.length ? icons[i] : null;
+      i++;
+      Uint8List? bytes;
+      if (icon is String && icon.isNotEmpty) {
         try {
-          final payload =
-              WindowsSearchPayload(token: rootIsolateToken, query: query);
-          log("[SearchCubit] Starting Windows Search isolate (ID: $searchId)...");
-          // Run the isolate function using compute.
-          final List<ProgramInfo> windowsSearchResults =
-              await compute(searchWindowsIndexIsolateEntry, payload);
-          log("[SearchCubit] Windows Search isolate (ID: $searchId) returned ${windowsSearchResults.length} results.");
-          combinedProgramInfo
-              .addAll(windowsSearchResults); // Add results to the Set
-        } catch (e, s) {
-          final errorMsg = "Windows Search failed (ID: $searchId): $e";
-          log(errorMsg, stackTrace: s, level: 1000);
-          searchError =
-              errorMsg; // Store the error to potentially display later
+          bytes = base64Decode(icon);
+        } on FormatException {
+          bytes = null;
         }
-      } else {
-        final errorMsg =
-            "Cannot perform Windows Search (ID: $searchId): RootIsolateToken is null.";
-        log(errorMsg, level: 1000);
-        searchError = errorMsg;
       }
+      completer.complete(bytes);
+    }
+  }
 
-      // == Step 3: Filter out banned keywords ==
-      // Remove items whose name or path contains any of the defined banned keywords.
-      final List<ProgramInfo> filteredProgramInfo =
-          combinedProgramInfo.where((program) {
-        final lowerName = program.name.toLowerCase();
-        final lowerPath = program.path.toLowerCase();
-
-        // Check if name or path contains ANY of the banned keywords
-        bool isBanned = _bannedKeywords.any((bannedWord) =>
-            lowerName.contains(bannedWord) || lowerPath.contains(bannedWord));
-
-        // Keep the item only if it's NOT banned
-        return !isBanned;
-      }).toList(); // Convert the filtered Iterable back to a List
-
-      // Log how many items were removed by the filter.
-      final int filteredCount =
-          combinedProgramInfo.length - filteredProgramInfo.length;
-      if (filteredCount > 0) {
-        log("[SearchCubit] Filtered out $filteredCount items based on banned keywords (ID: $searchId).");
-      }
+  /// Filters, converts, sorts and emits the results of [searchId] (the
+  /// native list once its frame 0 is in, and the instant results), resizing
+  /// the window when result visibility changes.
+  /// [keepSelection] keeps the user's selection when a late frame appends results.
+  void _publishResults(String query, int searchId,
+      {bool keepSelection = false}) {
+    // A Set handles duplicates between the instant results and the frames.
+    final Set<ProgramInfo> candidates = <ProgramInfo>{
+      if (_modelSeq == searchId) ..._model,
+      ..._instantResults,
+    };
+
+    // == Step 1: Filter out banned keywords ==
+    // Remove items whose name or path contains any of the defined banned keywords.
+    final List<ProgramInfo> filteredProgramInfo =
+        candidates.where((program) {
+      final lowerName = program.name.toLowerCase();
+      final lowerPath = program.path.toLowerCase();
+
+      // Check if name or path contains ANY of the banned keywords
+      bool isBanned = _bannedKeywords.any((bannedWord) =>
+          lowerName.contains(bannedWord) || lowerPath.contains(bannedWord));
+
+      // Keep the item only if it's NOT banned
+      return !isBanned;
+    }).toList(); // Convert the filtered Iterable back to a List
+
+    // Log how many items were removed by the filter.
+    final int filteredCount =
+        candidates.length - filteredProgramInfo.length;
+    if (filteredCount > 0) {
+      log("[SearchCubit] Filtered out $filteredCount items based on banned keywords (ID: $searchId).");
+    }
 
-      // == Step 4: Convert Filtered ProgramInfo to SearchResult ==
-      // Map the filtered ProgramInfo objects to SearchResult objects suitable for the UI.
-      final List<SearchResult> combinedSearchResults = filteredProgramInfo
-          .map((program) => _programInfoToSearchResult(program))
-          .toList();
-
-      // == Step 5: Apply Prioritized Sort ==
-      // Sort the results using the dedicated SearchResultSorter class.
-      final List<SearchResult> sortedResults = SearchResultSorter.sortResults(
-          combinedSearchResults, // Pass the filtered and converted list
-          query // Pass the original query for relevance scoring
-          );
-
-      // == Step 6: Emit Final State ==
-      // Before emitting, double-check if this is still the latest search request.
-      if (searchId != _currentSearchId || isClosed) {
-        log("[SearchCubit] Skipping state update for stale search (ID: $searchId, Current: $_currentSearchId)");
-        return;
-      }
+    // == Step 2: Convert Filtered ProgramInfo to SearchResult ==
+    // Map the filtered ProgramInfo objects to SearchResult objects suitable for the UI.
+    final List<SearchResult> combinedSearchResults = filteredProgramInfo
+        .map((program) =>
+            _searchResults[program] ??= _programInfoToSearchResult(program))
+        .toList();
+
+    // == Step 3: Apply Prioritized Sort ==
+    // Sort the results using the dedicated SearchResultSorter class.
+    final List<SearchResult> sortedResults = SearchResultSorter.sortResults(
+        combinedSearchResults, // Pass the filtered and converted list
+        query // Pass the original query for relevance scoring
+        );
 
-      final bool hadResultsBefore = state.results.isNotEmpty;
-      final bool hasResultsNow = sortedResults.isNotEmpty;
-      // Automatically select the first item if results exist, otherwise select none (-1).
-      final int newSelectedIndex = hasResultsNow ? 0 : -1;
+    // == Step 4: Emit State ==
+    final bool hadResultsBefore = state.results.isNotEmpty;
+    final bool hasResultsNow = sortedResults.isNotEmpty;
+    // Automatically select the first item if results exist, otherwise select none (-1).
+    // Appended frames keep the selected entry, wherever the sort moved it,
+    // unless it no longer exists.
+    int newSelectedIndex = hasResultsNow ? 0 : -1;
+    if (keepSelection &&
+        state.selectedIndex >= 0 &&
+        state.selectedIndex < state.results.length) {
+      final int selectedId = state.results[state.selectedIndex].id;
+      final int index =
+          sortedResults.indexWhere((result) => result.id == selectedId);
+      if (index >= 0) newSelectedIndex = index;
+    }
 
-      log("[SearchCubit] Search complete (ID: $searchId). Combined, filtered, and sorted ${sortedResults.length} results. Selecting index: $newSelectedIndex. Error: $searchError");
+    log("[SearchCubit] Publishing ${sortedResults.length} results (ID: $searchId). Selecting index: $newSelectedIndex.");
 
-      // Emit the final state with the sorted results, updated loading status, etc.
-      emit(state.copyWith(
-        results: sortedResults, // The final sorted list for the UI
-        isLoading: false, // Search is complete
-        showHelp:
-            false, // Don't show help when results (or no results) are displayed
-        selectedIndex: newSelectedIndex,
-        searchError:
-            searchError, // Include any error message from the search process
-      ));
-
-      // == Resize Window ==
-      // Adjust window size based on whether results are now shown or hidden.
-      if (hadResultsBefore != hasResultsNow) {
-        log("[SearchCubit] Resizing window (ID: $searchId) because result visibility changed (had: $hadResultsBefore, has: $hasResultsNow)");
-        resizeWindow(hasResultsNow);
-      }
-      // Also shrink if the search had results before but now has none (and isn't empty query)
-      else if (query.isNotEmpty && !hasResultsNow && hadResultsBefore) {
-        log("[SearchCubit] Resizing window (ID: $searchId) because query exists but no results found (was showing results before).");
-        resizeWindow(false);
-      }
-    });
+    // Results are usable as soon as the first frame lands, so loading ends here.
+    emit(state.copyWith(
+      results: sortedResults, // The sorted list for the UI
+      isLoading: false,
+      showHelp:
+          false, // Don't show help when results (or no results) are displayed
+      selectedIndex: newSelectedIndex,
+    ));
+
+    // == Resize Window ==
+    // Adjust window size based on whether results are now shown or hidden.
+    if (hadResultsBefore != hasResultsNow) {
+      log("[SearchCubit] Resizing window (ID: $searchId) because result visibility changed (had: $hadResultsBefore, has: $hasResultsNow)");
+      resizeWindow(hasResultsNow);
+    }
   }
 
   // --- Helper Methods ---
 
   /// Converts a [ProgramInfo] object into a [SearchResult] object.
   SearchResult _programInfoToSearchResult(ProgramInfo program) {
-    // Use path and args combined as a somewhat unique ID for equality checks.
-    final id = '${program.path}|${program.args}';
     return SearchResult(
-      id: id,
+      id: program.id,
       title: program.name,
       description: program.desc, // Use the path as the description string
       path: program.path,
       args: program.args,
       iconBytes:
           program.decodedIconBytes, // Include decoded icon bytes if available
+      loadIcon: program.iconId != 0 ? () => _loadIcon(program.iconId) : null,
       // Set the callback to execute when the item is selected (e.g., Enter key)
       onSelected: () => _openItem(program.path, program.args),
       // Get a suitable fallback icon based on path/name/extension
@@ -441,6 +690,14 @@ class SearchCubit extends Cubit<SearchState> {
   }
 
   // --- Platform Channel Interaction ---
+  /// Asks the native side to abort every search with an ID up to [throughId].
+  /// Fire-and-forget: a failed cancel only costs wasted native CPU.
+  void _cancelNativeSearches(int throughId) {
+    _platformChannel.invokeMethod('cancel', throughId).catchError((Object e) {
+      log("[SearchCubit] Native cancel failed (through ID: $throughId): $e");
+    });
+  }
+
   /// Opens the specified item using the platform channel.
   /// Sends the path and arguments to the native side.
   Future<void> _openItem(String path, String args) async {
@@ -480,6 +737,7 @@ class SearchCubit extends Cubit<SearchState> {
   void resetSearch() {
     if (_debounce?.isActive ?? false) _debounce?.cancel();
     _currentSearchId++; // Invalidate any pending search operations
+    _cancelNativeSearches(_currentSearchId);
     final bool hadResults = state.results.isNotEmpty;
     log("[SearchCubit] Resetting search state.");
     // Emit the initial state, but keep already loaded programs
@@ -594,6 +852,20 @@ class SearchCubit extends Cubit<SearchState> {
     log("[SearchCubit] Closing.");
     _debounce?.cancel(); // Cancel any active timer
     _currentSearchId++; // Ensure any final pending operations are invalidated
+    _cancelNativeSearches(_currentSearchId);
+    _nativeEvents?.cancel();
+    _nativeCatalog?.close();
+    _nativeCatalog = null;
     return super.close();
   }
-} // End of SearchCubit class
\ No newline at end of file
+} // End of SearchCubit class
+
+/// A patch to [SearchCubit]'s result list, waiting for its turn.
+class _ViewUpdate {
+  final Map<dynamic, dynamic> page;
+  final int seq;
+  final int version;
+  final bool replace;
+
+  _ViewUpdate(this.page, this.seq, this.version, this.replace);
+}
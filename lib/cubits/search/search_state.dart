@@ -11,7 +11,6 @@ class SearchState {
   final String? searchError; // Error during dynamic search
 
   // --- New fields for initial program loading ---
-  final List<ProgramInfo> allInstalledPrograms; // Holds all fetched programs
   final bool isLoadingInstalledPrograms; // Loading state for initial fetch
   final String? installedProgramsError; // Error during initial fetch
 
@@ -23,7 +22,6 @@ class SearchState {
     this.showHelp = true, // Show help initially
     this.searchError,
     // Initial fetch defaults
-    this.allInstalledPrograms = const [],
     this.isLoadingInstalledPrograms = true, // Start in loading state
     this.installedProgramsError,
   });
@@ -36,7 +34,6 @@ class SearchState {
     bool? showHelp,
     String? searchError,
     // New fields
-    List<ProgramInfo>? allInstalledPrograms,
     bool? isLoadingInstalledPrograms,
     String? installedProgramsError,
     bool clearSearchError = false, // Helper to clear error easily
@@ -50,7 +47,6 @@ class SearchState {
       showHelp: showHelp ?? this.showHelp,
       searchError: clearSearchError ? null : searchError ?? this.searchError,
       // New fields
-      allInstalledPrograms: allInstalledPrograms ?? this.allInstalledPrograms,
       isLoadingInstalledPrograms:
           isLoadingInstalledPrograms ?? this.isLoadingInstalledPrograms,
       installedProgramsError: clearInstalledProgramsError
@@ -70,8 +66,6 @@ class SearchState {
           isLoading == other.isLoading &&
           showHelp == other.showHelp &&
           searchError == other.searchError &&
-          listEquals(allInstalledPrograms,
-              other.allInstalledPrograms) && // Use listEquals
           isLoadingInstalledPrograms == other.isLoadingInstalledPrograms &&
           installedProgramsError == other.installedProgramsError;
 
@@ -83,7 +77,6 @@ class SearchState {
       isLoading.hashCode ^
       showHelp.hashCode ^
       searchError.hashCode ^
-      allInstalledPrograms.hashCode ^ // Consider deep hash
       isLoadingInstalledPrograms.hashCode ^
       installedProgramsError.hashCode;
 }
@@ -5,11 +5,13 @@ import 'package:flutter/material.dart'; // For IconData
 // Keep SearchResult but adapt it to hold ProgramInfo data + action
 @immutable
 class SearchResult {
-  final String id; // Can use path+args or generate UUID
+  final int id; // ProgramInfo.id of the entry
   final String title;
   final String? description; // Often the path
   final IconData? icon; // Fallback icon
   final Uint8List? iconBytes; // Decoded icon from base64
+  // Fetches the icon on first draw when it was not sent with the row.
+  final Future<Uint8List?> Function()? loadIcon;
   final String path; // Execution path
   final String args; // Execution arguments
   final VoidCallback? onSelected; // Action to execute
@@ -20,23 +22,23 @@ class SearchResult {
     this.description,
     this.icon, // Keep fallback icon
     this.iconBytes, // Add bytes
+    this.loadIcon,
     required this.path, // Add path
     required this.args, // Add args
     this.onSelected,
   });
 
-  // Override equals and hashCode based on unique identifier (path + args)
+  // Override equals and hashCode based on the entry id (normalized path + args)
   // This is crucial for deduplication using Sets.
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
       other is SearchResult &&
           runtimeType == other.runtimeType &&
-          path == other.path &&
-          args == other.args;
+          id == other.id;
 
   @override
-  int get hashCode => path.hashCode ^ args.hashCode;
+  int get hashCode => id.hashCode;
 
   @override
   String toString() {
@@ -0,0 +1,97 @@
+// entry_id.dart
+import 'dart:convert'; // For utf8
+
+// FNV-1a 64. The offset basis is 14695981039346656037, written as the int64
+// with the same bits; Dart's native ints wrap like the runner's uint64_t.
+const int _fnvOffsetBasis = -3750763034362895579;
+const int _fnvPrime = 1099511628211;
+
+const int _backslash = 0x5C;
+const int _slash = 0x2F;
+const int _quote = 0x22;
+const int _colon = 0x3A;
+const int _bang = 0x21;
+const int _space = 0x20;
+
+/// The stable 64-bit id of the entry launched as [target] with [args].
+///
+/// Computes exactly what `utils::EntryId()` in
+/// windows/runner/native_utils/EntryId.cpp does, so entries the runner sent
+/// with an id and entries built without one agree. See there for the
+/// normalization; change both or neither.
+int entryId(String target, String args) {
+  var hash = _fnv1a(utf8.encode(_normalizeTarget(target)), _fnvOffsetBasis);
+  hash = _fnv1a(const [0], hash);
+  return _fnv1a(utf8.encode(_normalizeArguments(args)), hash);
+}
+
+int _fnv1a(List<int> bytes, int hash) {
+  for (final byte in bytes) {
+    hash ^= byte;
+    hash *= _fnvPrime;
+  }
+  return hash;
+}
+
+bool _isBlank(int c) => c == 0x20 || c == 0x09 || c == 0x0D || c == 0x0A;
+
+int _foldAscii(int c) => (c >= 0x41 && c <= 0x5A) ? c + 0x20 : c;
+
+List<int> _trim(List<int> units) {
+  var start = 0;
+  var end = units.length;
+  while (start < end && _isBlank(units[start])) {
+    start++;
+  }
+  while (end > start && _isBlank(units[end - 1])) {
+    end--;
+  }
+  return units.sublist(start, end);
+}
+
+String _normalizeTarget(String target) {
+  var units = _trim(target.codeUnits);
+  if (units.length >= 2 && units.first == _quote && units.last == _quote) {
+    units = _trim(units.sublist(1, units.length - 1));
+  }
+
+  final normalized = <int>[];
+  var separators = false; // Any '\' at all, i.e. not a bare AUMID
+  for (var c in units) {
+    c = c == _slash ? _backslash : _foldAscii(c);
+    if (c == _backslash) {
+      separators = true;
+      // Collapse runs, but keep the two that open a UNC path.
+      if (normalized.length > 1 && normalized.last == _backslash) continue;
+    }
+    normalized.add(c);
+  }
+  final n = normalized.length;
+  if (n > 1 &&
+      normalized[n - 1] == _backslash &&
+      normalized[n - 2] != _colon &&
+      !(n == 2 && normalized[0] == _backslash)) {
+    normalized.removeLast();
+  }
+
+  final text = String.fromCharCodes(normalized);
+  if (!separators && normalized.contains(_bang) && !normalized.contains(_colon)) {
+    return 'shell:appsfolder\\$text';
+  }
+  return text;
+}
+
+String _normalizeArguments(String args) {
+  final units = _trim(args.codeUnits);
+  final normalized = <int>[];
+  var quoted = false;
+  for (final c in units) {
+    if (c == _quote) quoted = !quoted;
+    if (!quoted && _isBlank(c)) {
+      if (normalized.last != _space) normalized.add(_space);
+      continue;
+    }
+    normalized.add(_foldAscii(c));
+  }
+  return String.fromCharCodes(normalized);
+}
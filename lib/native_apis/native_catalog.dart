@@ -0,0 +1,168 @@
+// native_catalog.dart
+import 'dart:convert'; // For utf8
+import 'dart:ffi';
+import 'dart:io' show Platform;
+import 'dart:typed_data';
+
+import 'package:flutter/foundation.dart'; // For kDebugMode
+
+import 'program_info.dart';
+
+// Mirrors of the structs in windows/runner/native_utils/VxSearchApi.h.
+final class _VxCatalog extends Opaque {}
+
+final class _VxResults extends Opaque {}
+
+final class _VxStr extends Struct {
+  external Pointer<Uint8> data;
+  @Uint32()
+  external int size;
+}
+
+final class _VxResult extends Struct {
+  external _VxStr name;
+  external _VxStr path;
+  external _VxStr args;
+  external _VxStr kind;
+  external _VxStr description;
+  external _VxStr icon;
+  @Uint64()
+  external int id; // From ABI version 3
+}
+
+typedef _AbiVersionNative = Uint32 Function();
+typedef _AbiVersion = int Function();
+typedef _CatalogOpenNative = Pointer<_VxCatalog> Function();
+typedef _CatalogCloseNative = Void Function(Pointer<_VxCatalog>);
+typedef _CatalogClose = void Function(Pointer<_VxCatalog>);
+typedef _SearchNative = Pointer<_VxResults> Function(
+    Pointer<_VxCatalog>, Pointer<Uint8>, Uint32, Uint32);
+typedef _Search = Pointer<_VxResults> Function(
+    Pointer<_VxCatalog>, Pointer<Uint8>, int, int);
+typedef _ResultCountNative = Uint32 Function(Pointer<_VxResults>);
+typedef _ResultCount = int Function(Pointer<_VxResults>);
+typedef _ResultAtNative = Pointer<_VxResult> Function(
+    Pointer<_VxResults>, Uint32);
+typedef _ResultAt = Pointer<_VxResult> Function(Pointer<_VxResults>, int);
+typedef _ResultsFreeNative = Void Function(Pointer<_VxResults>);
+typedef _ResultsFree = void Function(Pointer<_VxResults>);
+typedef _AllocNative = Pointer<Uint8> Function(Uint32);
+typedef _Alloc = Pointer<Uint8> Function(int);
+typedef _FreeNative = Void Function(Pointer<Uint8>);
+typedef _Free = void Function(Pointer<Uint8>);
+
+/// The runner exports a small C ABI (`vx_search`, `vx_result_at`, ...) from
+/// its executable. A query costs no platform-channel hop: it runs on the
+/// calling isolate, and the matches are read straight out of native memory.
+/// The results are the catalog provider's, so the Windows Search Index and
+/// settings pages still arrive through `startSearch` frames.
+class NativeCatalog {
+  static const int _abiVersion = 1;
+  static const int _idAbiVersion = 3;
+
+  final Pointer<_VxCatalog> _catalog;
+  final _CatalogClose _close;
+  final _Search _search;
+  final _ResultCount _resultCount;
+  final _ResultAt _resultAt;
+  final _ResultsFree _resultsFree;
+  final _Alloc _alloc;
+  final _Free _free;
+  final bool _resultIds; // vx_result carries the entry id
+
+  // Reused UTF-8 buffer for the query.
+  Pointer<Uint8> _queryBuffer = nullptr;
+  int _queryCapacity = 0;
+
+  NativeCatalog._(this._catalog, this._close, this._search, this._resultCount,
+      this._resultAt, this._resultsFree, this._alloc, this._free, this._resultIds);
+
+  /// Attaches to the runner's catalog, or returns null when the exports are
+  /// missing (another platform, an older runner) or no catalog is published yet.
+  static NativeCatalog? open() {
+    if (!Platform.isWindows) return null;
+    try {
+      final lib = DynamicLibrary.executable();
+      final abiVersion =
+          lib.lookupFunction<_AbiVersionNative, _AbiVersion>('vx_abi_version');
+      final version = abiVersion();
+      if (version < _abiVersion) return null;
+      final catalog = lib
+          .lookupFunction<_CatalogOpenNative, _CatalogOpenNative>(
+              'vx_catalog_open')
+          .call();
+      if (catalog == nullptr) return null;
+      return NativeCatalog._(
+        catalog,
+        lib.lookupFunction<_CatalogCloseNative, _CatalogClose>(
+            'vx_catalog_close'),
+        lib.lookupFunction<_SearchNative, _Search>('vx_search'),
+        lib.lookupFunction<_ResultCountNative, _ResultCount>('vx_result_count'),
+        lib.lookupFunction<_ResultAtNative, _ResultAt>('vx_result_at'),
+        lib.lookupFunction<_ResultsFreeNative, _ResultsFree>('vx_results_free'),
+        lib.lookupFunction<_AllocNative, _Alloc>('vx_alloc'),
+        lib.lookupFunction<_FreeNative, _Free>('vx_free'),
+        version >= _idAbiVersion,
+      );
+    } on ArgumentError catch (e) {
+      if (kDebugMode) {
+        print("[NativeCatalog] FFI exports unavailable: $e");
+      }
+      return null;
+    }
+  }
+
+  /// Catalog entries whose name or path contains [query], ignoring ASCII case,
+  /// best first in `SearchResultSorter`'s order; the best [limit] of them, 0
+  /// for all.
+  List<ProgramInfo> search(String query, {int limit = 0}) {
+    final Uint8List bytes = utf8.encode(query);
+    if (bytes.length > _queryCapacity) {
+      if (_queryBuffer != nullptr) _free(_queryBuffer);
+      _queryCapacity = bytes.length < 256 ? 256 : bytes.length;
+      _queryBuffer = _alloc(_queryCapacity);
+      if (_queryBuffer == nullptr) {
+        _queryCapacity = 0;
+        return const [];
+      }
+    }
+    if (bytes.isNotEmpty) {
+      _queryBuffer.asTypedList(bytes.length).setAll(0, bytes);
+    }
+
+    final results = _search(_catalog, _queryBuffer, bytes.length, limit);
+    if (results == nullptr) return const [];
+    try {
+      final count = _resultCount(results);
+      final programs = <ProgramInfo>[];
+      for (var i = 0; i < count; i++) {
+        final _VxResult row = _resultAt(results, i).ref;
+        final icon = _read(row.icon);
+        programs.add(ProgramInfo(
+          name: _read(row.name),
+          path: _read(row.path),
+          args: _read(row.args),
+          kind: _read(row.kind),
+          desc: _read(row.description),
+          iconBase64: icon.isNotEmpty ? icon : null,
+          id: _resultIds ? row.id : null,
+        ));
+      }
+      return programs;
+    } finally {
+      _resultsFree(results);
+    }
+  }
+
+  void close() {
+    if (_queryBuffer != nullptr) {
+      _free(_queryBuffer);
+      _queryBuffer = nullptr;
+      _queryCapacity = 0;
+    }
+    _close(_catalog);
+  }
+
+  static String _read(_VxStr text) =>
+      text.size == 0 ? '' : utf8.decode(text.data.asTypedList(text.size));
+}
@@ -2,6 +2,8 @@
 import 'package:flutter/foundation.dart'; // For @immutable
 import 'dart:convert'; // For base64Decode
 
+import 'entry_id.dart';
+
 @immutable // Marking as immutable since its fields are final
 class ProgramInfo {
   final String name;
@@ -10,15 +12,23 @@ class ProgramInfo {
   final String kind; // Default empty string for kind
   final String desc; // Default empty string for desc
   final String? iconBase64; // Icon can be null or empty
+  // Paged results carry an id for the native result pager (fetchIcons)
+  // instead of [iconBase64]; 0 when there is none.
+  final int iconId;
+  // Stable identity (entryId): the runner sends it, otherwise it is computed
+  // here the same way. Equality and hashing use only this.
+  final int id;
 
-  const ProgramInfo({
+  ProgramInfo({
     required this.name,
     required this.path,
     this.kind = "",
     this.desc = "",
     this.args = "",
     this.iconBase64,
-  });
+    this.iconId = 0,
+    int? id,
+  }) : id = id ?? entryId(path, args);
 
   // Factory constructor to parse from the Map received from platform channel
   factory ProgramInfo.fromMap(Map<dynamic, dynamic> map) {
@@ -29,6 +39,8 @@ class ProgramInfo {
     final kind = map['kind'] is String ? map['kind'] as String : '';
     final desc = map['desc'] is String ? map['desc'] as String : '';
     final icon = map['icon'] is String ? map['icon'] as String : null;
+    final iconId = map['iconId'] is int ? map['iconId'] as int : 0;
+    final id = map['id'] is int ? map['id'] as int : null;
 
     return ProgramInfo(
       name: name,
@@ -38,20 +50,22 @@ class ProgramInfo {
       desc: desc,
       // Store null if the icon string is empty, simplifying checks later
       iconBase64: (icon != null && icon.isNotEmpty) ? icon : null,
+      iconId: iconId,
+      id: id,
     );
   }
 
-  // Override equals and hashCode to allow using Sets for deduplication based on path and args
+  // Override equals and hashCode to allow using Sets for deduplication based on
+  // the entry id, which already folds path and args the way the runner does
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
       other is ProgramInfo &&
           runtimeType == other.runtimeType &&
-          args == other.args && // Uniqueness based on args
-          path == other.path; // Uniqueness based on path
+          id == other.id;
 
   @override
-  int get hashCode => path.hashCode ^ args.hashCode; // Combine hashCodes
+  int get hashCode => id.hashCode;
 
   @override
   String toString() {
@@ -1,4 +1,5 @@
 // lib/widgets/search_result_item.dart
+import 'dart:typed_data'; // For Uint8List
 import 'package:flutter/material.dart';
 import 'package:vxkonsol/models/search_result.dart'; // Use the adapted SearchResult
 
@@ -41,6 +42,30 @@ class SearchResultItem extends StatelessWidget {
         // Optional: Add a placeholder while loading, though local icons should be fast
         // placeholder: (context, url) => SizedBox(width: 20, height: 20, child: CircularProgressIndicator(strokeWidth: 1)),
       );
+    } else if (result.loadIcon != null) {
+      // Paged row: the icon is fetched once the row is actually built.
+      return FutureBuilder<Uint8List?>(
+        future: result.loadIcon!(),
+        builder: (context, snapshot) {
+          final loaded = snapshot.data;
+          if (loaded != null && loaded.isNotEmpty) {
+            return Image.memory(
+              loaded,
+              width: 22,
+              height: 22,
+              fit: BoxFit.contain,
+              gaplessPlayback: true,
+              filterQuality: FilterQuality.medium,
+              errorBuilder: (context, error, stackTrace) => Icon(
+                  result.icon ?? Icons.apps_outlined,
+                  size: 20,
+                  color: color),
+            );
+          }
+          return Icon(result.icon ?? Icons.apps_outlined,
+              size: 20, color: color);
+        },
+      );
     } else if (result.icon != null) {
       // Use the fallback IconData if bytes are not available
       return Icon(result.icon, size: 20, color: color);
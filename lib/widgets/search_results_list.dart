@@ -27,10 +27,21 @@ class _SearchResultsListState extends State<SearchResultsList> {
   final ScrollController _scrollController = ScrollController();
   // Keep item height, adjust if needed after testing visuals
   final double _itemHeight = 58.0;
+  // Rows before the end of what is loaded at which the next page is requested.
+  static const int _prefetchRows = 10;
+  // Rows already built, by result id. Results the cubit carried over from the
+  // previous list are the same objects, so their row is handed back as is and
+  // Flutter skips rebuilding it; keys let the row follow its result around.
+  final Map<int, _BuiltRow> _rows = <int, _BuiltRow>{};
+  Map<int, int> _indexById = const {};
 
   @override
   void didUpdateWidget(covariant SearchResultsList oldWidget) {
     super.didUpdateWidget(oldWidget);
+    if (!identical(widget.results, oldWidget.results)) {
+      _indexResults();
+      _rows.removeWhere((id, _) => !_indexById.containsKey(id));
+    }
     // Scroll to selected is important
     if (widget.selectedIndex != oldWidget.selectedIndex &&
         widget.selectedIndex >= 0 && // Ensure index is valid
@@ -114,6 +125,18 @@ class _SearchResultsListState extends State<SearchResultsList> {
     );
   }
 
+  @override
+  void initState() {
+    super.initState();
+    _indexResults();
+  }
+
+  void _indexResults() {
+    _indexById = {
+      for (var i = 0; i < widget.results.length; i++) widget.results[i].id: i,
+    };
+  }
+
   @override
   void dispose() {
     _scrollController.dispose();
@@ -162,32 +185,64 @@ class _SearchResultsListState extends State<SearchResultsList> {
         padding: const EdgeInsets.symmetric(vertical: 5, horizontal: 18),
         itemCount: widget.results.length,
         itemExtent: _itemHeight, // Use the defined item height
+        findChildIndexCallback: (key) =>
+            key is ValueKey<int> ? _indexById[key.value] : null,
         itemBuilder: (context, index) {
           final result = widget.results[index];
-          return AnimationConfiguration.staggeredList(
-            position: index,
-            duration: const Duration(
-                milliseconds: 300), // Faster total duration for list items
-            child: SlideAnimation(
-              verticalOffset: 30.0, // Slightly smaller offset for quicker feel
-              child: FadeInAnimation(
-                child: SearchResultItem(
-                  result: result,
-                  isSelected: index == widget.selectedIndex,
-                  onTap: () {
-                    log("Item tapped: ${result.title} at index $index");
-
-                    // context.read<SearchCubit>().executeSelectedAction();
-                    context.read<SearchCubit>().selectAndExecuteAction(index);
-                  },
-                ),
-              ),
-            ),
-          );
+          if (index >= widget.results.length - _prefetchRows) {
+            context.read<SearchCubit>().loadMoreResults();
+          }
+          final bool isSelected = index == widget.selectedIndex;
+          final cached = _rows[result.id];
+          if (cached != null &&
+              identical(cached.result, result) &&
+              cached.isSelected == isSelected) {
+            return cached.row;
+          }
+          final row = KeyedSubtree(
+              key: ValueKey<int>(result.id),
+              child: _buildRow(result, index, isSelected));
+          _rows[result.id] = _BuiltRow(result, isSelected, row);
+          return row;
         },
       ),
     );
   }
+
+  // Uses the state's context: a cached row outlives the element it was built in.
+  Widget _buildRow(SearchResult result, int index, bool isSelected) {
+    return AnimationConfiguration.staggeredList(
+      position: index,
+      duration: const Duration(
+          milliseconds: 300), // Faster total duration for list items
+      child: SlideAnimation(
+        verticalOffset: 30.0, // Slightly smaller offset for quicker feel
+        child: FadeInAnimation(
+          child: SearchResultItem(
+            result: result,
+            isSelected: isSelected,
+            onTap: () {
+              // The row may have moved since it was built.
+              final int current = _indexById[result.id] ?? index;
+              log("Item tapped: ${result.title} at index $current");
+
+              // context.read<SearchCubit>().executeSelectedAction();
+              context.read<SearchCubit>().selectAndExecuteAction(current);
+            },
+          ),
+        ),
+      ),
+    );
+  }
+}
+
+// A row as last built, with what it was built from.
+class _BuiltRow {
+  final SearchResult result;
+  final bool isSelected;
+  final Widget row;
+
+  _BuiltRow(this.result, this.isSelected, this.row);
 }
 
 // Helper function for list comparison (if not already available)
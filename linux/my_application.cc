@@ -14,6 +14,17 @@ struct _MyApplication {
 
 G_DEFINE_TYPE(MyApplication, my_application, GTK_TYPE_APPLICATION)
 
+void my_application_trace_startup(const gchar* event) {
+  static const gint64 started = g_get_monotonic_time();
+  g_debug("[startup] %s at %" G_GINT64_FORMAT " ms", event,
+          (g_get_monotonic_time() - started) / 1000);
+}
+
+// Called when the view has drawn its first frame.
+static void first_frame_cb(FlView* view, gpointer user_data) {
+  my_application_trace_startup("first frame");
+}
+
 // Implements GApplication::activate.
 static void my_application_activate(GApplication* application) {
   MyApplication* self = MY_APPLICATION(application);
@@ -54,12 +65,18 @@ static void my_application_activate(GApplication* application) {
   fl_dart_project_set_dart_entrypoint_arguments(project, self->dart_entrypoint_arguments);
 
   FlView* view = fl_view_new(project);
+  my_application_trace_startup("engine created");
+  // Older engines have no such signal; the trace then ends above.
+  if (g_signal_lookup("first-frame", G_OBJECT_TYPE(view)) != 0) {
+    g_signal_connect(view, "first-frame", G_CALLBACK(first_frame_cb), nullptr);
+  }
   gtk_widget_show(GTK_WIDGET(view));
   gtk_container_add(GTK_CONTAINER(window), GTK_WIDGET(view));
 
   fl_register_plugins(FL_PLUGIN_REGISTRY(view));
 
   gtk_widget_grab_focus(GTK_WIDGET(view));
+  my_application_trace_startup("view attached");
 }
 
 // Implements GApplication::local_command_line.
@@ -15,4 +15,14 @@ G_DECLARE_FINAL_TYPE(MyApplication, my_application, MY, APPLICATION,
  */
 MyApplication* my_application_new();
 
+/**
+ * my_application_trace_startup:
+ * @event: what just happened.
+ *
+ * Logs "[startup] <event> at <ms> ms" at debug level (shown with
+ * G_MESSAGES_DEBUG=all), timed from the first call, which main makes before
+ * anything else. The same trace the Windows runner writes to the debugger.
+ */
+void my_application_trace_startup(const gchar* event);
+
 #endif  // FLUTTER_MY_APPLICATION_H_
@@ -0,0 +1,93 @@
+#include "catalog_warmup.h"
+
+#include <windows.h>
+
+#include <string>
+#include <utility>
+
+#include "native_utils/ScannerHelper.h"
+
+std::shared_ptr<CatalogWarmup> CatalogWarmup::Start() {
+  std::shared_ptr<CatalogWarmup> warmup(new CatalogWarmup());
+  warmup->thread_ = std::thread(&CatalogWarmup::Run, warmup.get());
+  return warmup;
+}
+
+CatalogWarmup::CatalogWarmup() : started_(std::chrono::steady_clock::now()) {}
+
+CatalogWarmup::~CatalogWarmup() {
+  Cancel();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void CatalogWarmup::OnReady(Consumer consumer) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!finished_) {
+    consumer_ = std::move(consumer);
+    return;
+  }
+  if (consumed_ || cancellation_.IsCancelled()) {
+    return;
+  }
+  Programs programs = std::move(programs_);
+  consumed_ = true;
+  lock.unlock();
+  consumer(std::move(programs));
+}
+
+void CatalogWarmup::OnFinished(Finished done) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!finished_) {
+    on_finished_.push_back(std::move(done));
+    return;
+  }
+  const bool consumed = consumed_;
+  lock.unlock();
+  done(consumed);
+}
+
+void CatalogWarmup::Cancel() {
+  cancellation_.Cancel();
+}
+
+long long CatalogWarmup::ElapsedMs() const {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - started_)
+      .count();
+}
+
+void CatalogWarmup::Trace(const wchar_t* event) const {
+  std::wstring line = L"[startup] ";
+  line += event;
+  line += L" at " + std::to_wstring(ElapsedMs()) + L" ms\n";
+  ::OutputDebugStringW(line.c_str());
+}
+
+void CatalogWarmup::Run() {
+  // Starts behind the engine for the disk and the CPU, not ahead of it.
+  ::SetThreadPriority(::GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+  Programs programs = ProgramFinder::GetRawProgramsIsolated(cancellation_.Token());
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!cancellation_.IsCancelled()) {
+    Trace(L"catalog scan finished");
+    if (consumer_) {
+      Consumer consumer = std::move(consumer_);
+      lock.unlock();
+      consumer(std::move(programs));
+      lock.lock();
+      consumed_ = true;
+    } else {
+      programs_ = std::move(programs);
+    }
+  }
+  finished_ = true;
+  std::vector<Finished> on_finished = std::move(on_finished_);
+  const bool consumed = consumed_;
+  lock.unlock();
+  for (Finished& done : on_finished) {
+    done(consumed);
+  }
+}
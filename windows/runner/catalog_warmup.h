@@ -0,0 +1,71 @@
+#ifndef RUNNER_CATALOG_WARMUP_H_
+#define RUNNER_CATALOG_WARMUP_H_
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "native_utils/CancellationToken.h"
+#include "native_utils/Program.h"
+
+// Runs the first program scan on a worker thread while the engine and the
+// window are still being created, so the first getAllPrograms finds the
+// catalog already built instead of scanning on the platform thread.
+//
+// Started first thing in wWinMain and owned there; the window only borrows it.
+// Destroying it cancels a scan still in progress and waits for the thread.
+class CatalogWarmup {
+ public:
+  using Programs = std::vector<utils::Program>;
+  using Consumer = std::function<void(Programs&&)>;
+  using Finished = std::function<void(bool consumed)>;
+
+  // Starts the scan and the startup clock.
+  static std::shared_ptr<CatalogWarmup> Start();
+
+  ~CatalogWarmup();
+
+  CatalogWarmup(const CatalogWarmup&) = delete;
+  CatalogWarmup& operator=(const CatalogWarmup&) = delete;
+
+  // Hands the scan result to |consumer| exactly once: on the warmup thread when
+  // the scan finishes, or right away on the calling thread if it already has.
+  // A cancelled scan is never handed over.
+  void OnReady(Consumer consumer);
+
+  // Calls |done| once the scan has finished and been handed to the consumer
+  // set with OnReady: on the warmup thread, or right away on the calling
+  // thread if that has already happened. |consumed| is false if the scan was
+  // cancelled or nobody consumed it. Nothing waits on a thread meanwhile.
+  void OnFinished(Finished done);
+
+  void Cancel();
+
+  // Milliseconds since Start(), for the startup trace.
+  long long ElapsedMs() const;
+
+  // Writes "[startup] <event> at <ms> ms" to the debugger output.
+  void Trace(const wchar_t* event) const;
+
+ private:
+  CatalogWarmup();
+
+  void Run();
+
+  const std::chrono::steady_clock::time_point started_;
+  utils::CancellationSource cancellation_;
+
+  std::mutex mutex_;
+  bool finished_ = false;
+  bool consumed_ = false;
+  Programs programs_;
+  Consumer consumer_;
+  std::vector<Finished> on_finished_;
+
+  std::thread thread_;
+};
+
+#endif  // RUNNER_CATALOG_WARMUP_H_
@@ -3,6 +3,12 @@
 #include "native_utils/ShellExecution.h"
 #include "native_utils/common_utils.h"
 #include "native_utils/ProgramFinder.h"
+#include "native_utils/SearchProviders.h"
+#include "native_utils/ScannerHelper.h"
+#include "native_utils/SettingsPages.h"
+#include "native_utils/StatCache.h"
+#include "native_utils/TaskExecutor.h"
+#include "native_utils/VxSearchApi.h"
 #include "native_utils/winsearch.h"
 #include <flutter/event_channel.h>
 #include <flutter/event_sink.h>
@@ -10,15 +16,214 @@
 #include <flutter/method_channel.h>
 #include <flutter/standard_method_codec.h>
 #include <windows.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <limits>
 #include <memory>
+#include <set>
 #include "flutter/generated_plugin_registrant.h"
 
+namespace {
 
-FlutterWindow::FlutterWindow(const flutter::DartProject& project)
-    : project_(project) {}
+// Converts a native program record into the map shape ProgramInfo.fromMap expects.
+flutter::EncodableValue EncodeProgram(const utils::Program& item) {
+  flutter::EncodableMap flutter_item;
+  flutter_item[flutter::EncodableValue("name")] = flutter::EncodableValue(item.name);
+  flutter_item[flutter::EncodableValue("path")] = flutter::EncodableValue(item.executablePath);
+  flutter_item[flutter::EncodableValue("args")] = flutter::EncodableValue(item.arguments);
+  flutter_item[flutter::EncodableValue("kind")] = flutter::EncodableValue(item.kind);
+  flutter_item[flutter::EncodableValue("desc")] = flutter::EncodableValue(item.description);
+  flutter_item[flutter::EncodableValue("icon")] = flutter::EncodableValue(item.iconDataBase64);
+  flutter_item[flutter::EncodableValue("id")] = flutter::EncodableValue(static_cast<int64_t>(item.id));
+  return flutter::EncodableValue(std::move(flutter_item));
+}
+
+flutter::EncodableList EncodePrograms(const std::vector<utils::Program>& items) {
+  flutter::EncodableList flutter_list;
+  flutter_list.reserve(items.size());
+  for (const auto& item : items) {
+    flutter_list.push_back(EncodeProgram(item));
+  }
+  return flutter_list;
+}
+
+// As above, but moves the strings out of |items|, which search frames own.
+flutter::EncodableList EncodePrograms(std::vector<utils::Program>&& items) {
+  flutter::EncodableList flutter_list;
+  flutter_list.reserve(items.size());
+  for (auto& item : items) {
+    flutter::EncodableMap flutter_item;
+    flutter_item[flutter::EncodableValue("name")] = flutter::EncodableValue(std::move(item.name));
+    flutter_item[flutter::EncodableValue("path")] = flutter::EncodableValue(std::move(item.executablePath));
+    flutter_item[flutter::EncodableValue("args")] = flutter::EncodableValue(std::move(item.arguments));
+    flutter_item[flutter::EncodableValue("kind")] = flutter::EncodableValue(std::move(item.kind));
+    flutter_item[flutter::EncodableValue("desc")] = flutter::EncodableValue(std::move(item.description));
+    flutter_item[flutter::EncodableValue("icon")] = flutter::EncodableValue(std::move(item.iconDataBase64));
+    flutter_item[flutter::EncodableValue("id")] = flutter::EncodableValue(static_cast<int64_t>(item.id));
+    flutter_list.push_back(flutter::EncodableValue(std::move(flutter_item)));
+  }
+  return flutter_list;
+}
+
+// Display rows of a paged result set; icons are fetched separately by id.
+flutter::EncodableList EncodeRows(std::vector<SearchEngine::ResultRow>&& rows) {
+  flutter::EncodableList flutter_list;
+  flutter_list.reserve(rows.size());
+  for (auto& row : rows) {
+    flutter::EncodableMap flutter_item;
+    flutter_item[flutter::EncodableValue("name")] = flutter::EncodableValue(std::move(row.name));
+    flutter_item[flutter::EncodableValue("path")] = flutter::EncodableValue(std::move(row.path));
+    flutter_item[flutter::EncodableValue("args")] = flutter::EncodableValue(std::move(row.args));
+    flutter_item[flutter::EncodableValue("kind")] = flutter::EncodableValue(std::move(row.kind));
+    flutter_item[flutter::EncodableValue("desc")] = flutter::EncodableValue(std::move(row.description));
+    flutter_item[flutter::EncodableValue("iconId")] =
+        flutter::EncodableValue(static_cast<int64_t>(row.iconId));
+    flutter_item[flutter::EncodableValue("id")] = flutter::EncodableValue(static_cast<int64_t>(row.id));
+    flutter_list.push_back(flutter::EncodableValue(std::move(flutter_item)));
+  }
+  return flutter_list;
+}
+
+// Rows [first, first + rows.size()) of a paged session holding |total|.
+struct PageSlice {
+  size_t total = 0;
+  size_t first = 0;
+  std::vector<SearchEngine::ResultRow> rows;
+};
+
+// The best |rows| of the paged session of |seq|. The session is ranked, so a
+// batch that arrives later can still move rows into the first page; the UI's
+// list of the query is always such a prefix.
+PageSlice TopRows(const SearchEngine::ResultPager& pager, int64_t seq, size_t rows) {
+  PageSlice slice;
+  slice.total = pager.Count(seq).value_or(0);
+  slice.rows = pager.Fetch(seq, 0, rows);
+  return slice;
+}
+
+// How many rows the UI's list holds of |seq|, at least a page of |page_rows|.
+size_t RowsHeld(const SearchEngine::ResultView& view, int64_t seq, size_t page_rows) {
+  return std::max(page_rows, view.Seq() == seq ? view.Size() : 0);
+}
+
+// {total, first, next} of |slice|, |next| being the session index after it.
+flutter::EncodableMap EncodePageBounds(const PageSlice& slice) {
+  flutter::EncodableMap page;
+  page[flutter::EncodableValue("total")] = flutter::EncodableValue(static_cast<int64_t>(slice.total));
+  page[flutter::EncodableValue("first")] = flutter::EncodableValue(static_cast<int64_t>(slice.first));
+  page[flutter::EncodableValue("next")] =
+      flutter::EncodableValue(static_cast<int64_t>(slice.first + slice.rows.size()));
+  return page;
+}
+
+// A page of rows for Dart, sent as a patch to the list |view| mirrors:
+// {total, first, next, base, version, removes, moves, inserts, items, updates,
+// updated}. |items| holds the inserted rows, |updated| the ones replaced in
+// place. Rows of a query older than the shown one get no patch and no items.
+// |replace| may start the list of |seq|; otherwise only that list changes.
+flutter::EncodableMap EncodeViewPage(SearchEngine::ResultView& view, int64_t seq, bool replace,
+                                     PageSlice&& slice) {
+  flutter::EncodableMap page = EncodePageBounds(slice);
+  page[flutter::EncodableValue("items")] = flutter::EncodableValue(flutter::EncodableList());
+  std::optional<SearchEngine::ResultView::Update> update;
+  if (replace || view.Seq() == seq) {
+    update = view.Replace(seq, std::move(slice.rows));
+  }
+  if (update) {
+    page[flutter::EncodableValue("base")] = flutter::EncodableValue(static_cast<int64_t>(update->base));
+    page[flutter::EncodableValue("version")] = flutter::EncodableValue(static_cast<int64_t>(update->version));
+    page[flutter::EncodableValue("removes")] = flutter::EncodableValue(std::move(update->patch.removes));
+    page[flutter::EncodableValue("moves")] = flutter::EncodableValue(std::move(update->patch.moves));
+    page[flutter::EncodableValue("inserts")] = flutter::EncodableValue(std::move(update->patch.inserts));
+    page[flutter::EncodableValue("items")] = flutter::EncodableValue(EncodeRows(std::move(update->inserted)));
+    page[flutter::EncodableValue("updates")] = flutter::EncodableValue(std::move(update->patch.updates));
+    page[flutter::EncodableValue("updated")] = flutter::EncodableValue(EncodeRows(std::move(update->updated)));
+  }
+  return page;
+}
+
+// Dart ints arrive as int32 or int64 depending on magnitude.
+std::optional<int64_t> GetInt64(const flutter::EncodableValue& value) {
+  if (std::holds_alternative<int32_t>(value)) {
+    return std::get<int32_t>(value);
+  }
+  if (std::holds_alternative<int64_t>(value)) {
+    return std::get<int64_t>(value);
+  }
+  return std::nullopt;
+}
+
+// Adds the fields every "searchFrame" event on windows_native_events has to
+// |event|, which already holds the frame's results.
+void AddSearchFrameHeader(flutter::EncodableMap& event, int64_t seq, int index, bool is_final,
+                          std::vector<std::string>&& provider_names) {
+  flutter::EncodableList providers;
+  for (auto& name : provider_names) {
+    providers.push_back(flutter::EncodableValue(std::move(name)));
+  }
+  event[flutter::EncodableValue("type")] = flutter::EncodableValue("searchFrame");
+  event[flutter::EncodableValue("seq")] = flutter::EncodableValue(seq);
+  event[flutter::EncodableValue("frame")] = flutter::EncodableValue(index);
+  event[flutter::EncodableValue("final")] = flutter::EncodableValue(is_final);
+  event[flutter::EncodableValue("providers")] = flutter::EncodableValue(std::move(providers));
+}
+
+// Timer that trims native memory once the window has stayed hidden this long.
+constexpr UINT_PTR kTrimMemoryTimer = 1;
+constexpr UINT kTrimMemoryDelayMs = 5000;
+
+// Full scans and index queries at once; more only slow each other down.
+constexpr size_t kExpensiveCallLimit = 2;
+// The key of the one full scan in flight.
+constexpr int kFullScan = 0;
+
+// Where the launch history is kept between runs, next to the scan caches.
+std::filesystem::path LaunchHistoryPath() {
+  std::filesystem::path directory = utils::GetLocalDataDirectory();
+  return directory.empty() ? std::filesystem::path() : directory / L"launch-history.bin";
+}
+
+// Drops what the native side can rebuild: the persisted scan caches, catalog
+// generations retired while a search held them, and then the freed pages.
+flutter::EncodableMap TrimNativeMemory(SearchEngine::ProgramCatalog& catalog) {
+  const bool caches_released = ProgramFinder::ReleaseCaches();
+  catalog.Reclaim();
+  const utils::MemoryTrim trim = utils::TrimProcessMemory();
+  flutter::EncodableMap stats;
+  stats[flutter::EncodableValue("cachesReleased")] = flutter::EncodableValue(caches_released);
+  stats[flutter::EncodableValue("workingSetBefore")] =
+      flutter::EncodableValue(static_cast<int64_t>(trim.workingSetBefore));
+  stats[flutter::EncodableValue("workingSetAfter")] =
+      flutter::EncodableValue(static_cast<int64_t>(trim.workingSetAfter));
+  return stats;
+}
+
+}  // namespace
+
+
+FlutterWindow::FlutterWindow(const flutter::DartProject& project,
+                             std::shared_ptr<CatalogWarmup> catalog_warmup)
+    : project_(project), catalog_warmup_(std::move(catalog_warmup)) {}
 
 FlutterWindow::~FlutterWindow() {}
 
+uint64_t FlutterWindow::ChannelState::Park(std::unique_ptr<flutter::MethodResult<>> result) {
+  const uint64_t id = next_result_id++;
+  pending_results[id] = std::move(result);
+  return id;
+}
+
+void FlutterWindow::ChannelState::Answer(uint64_t id, const flutter::EncodableValue& reply) {
+  auto it = pending_results.find(id);
+  if (it == pending_results.end()) {
+    return;
+  }
+  std::unique_ptr<flutter::MethodResult<>> result = std::move(it->second);
+  pending_results.erase(it);
+  result->Success(reply);
+}
+
 bool FlutterWindow::OnCreate() {
   if (!Win32Window::OnCreate()) {
     return false;
@@ -36,59 +241,436 @@ bool FlutterWindow::OnCreate() {
   }
   RegisterPlugins(flutter_controller_->engine());
 
+  platform_tasks_ = std::make_shared<PlatformTaskQueue>(GetHandle());
+  channel_state_ = std::make_shared<ChannelState>();
+
+  catalog_ = std::make_shared<SearchEngine::ProgramCatalog>();
+  launch_history_ = std::make_shared<SearchEngine::LaunchHistory>();
+  // A few KiB; read before the first short-query tables are ranked by it.
+  if (std::filesystem::path path = LaunchHistoryPath(); !path.empty()) {
+    launch_history_->Load(path);
+  }
+  short_queries_ = std::make_shared<SearchEngine::ShortQueryIndex>(launch_history_);
+  search_scheduler_ = std::make_unique<SearchEngine::ProviderScheduler>();
+  result_pager_ = std::make_shared<SearchEngine::ResultPager>();
+  scan_flights_ = std::make_shared<ScanFlights>();
+  // On their own pool: these calls mostly wait, and must not hold the workers
+  // keystrokes are answered on.
+  expensive_calls_ = std::make_shared<utils::ConcurrencyLimiter>(kExpensiveCallLimit,
+                                                                 utils::BlockingExecutor());
+  search_scheduler_->AddProvider(
+      std::make_shared<SearchEngine::CatalogProvider>(catalog_, short_queries_));
+  search_scheduler_->AddProvider(std::make_shared<SearchEngine::SettingsPagesProvider>());
+  // Index queries repeated while one runs share it, and wait their turn with
+  // the full scans.
+  index_provider_ = std::make_shared<SearchEngine::CoalescingProvider>(
+      std::make_shared<SearchEngine::WindowsIndexProvider>(), expensive_calls_);
+  search_scheduler_->AddProvider(index_provider_);
+  // Dart also reads the catalog synchronously through dart:ffi (VxSearchApi.h).
+  SearchEngine::PublishFfiCatalog(catalog_, short_queries_);
+
+  // Start Menu changes patch the catalog between full scans.
+  std::vector<SearchEngine::IncrementalCatalog::Root> start_menu_roots;
+  std::vector<std::string> watched_paths;
+  for (const ProgramFinder::StartMenuRoot& root : ProgramFinder::GetStartMenuRoots()) {
+    start_menu_roots.push_back({root.path, root.source});
+    watched_paths.push_back(root.path);
+  }
+  incremental_catalog_ = std::make_shared<SearchEngine::IncrementalCatalog>(
+      catalog_, std::move(start_menu_roots),
+      [](const std::string& path, const std::string& source) {
+        return ProgramFinder::ReadShortcutProgram(path, source);
+      },
+      [](std::vector<utils::Program>& programs) {
+        return utils::DeduplicatePrograms(programs);
+      });
+  std::shared_ptr<SearchEngine::IncrementalCatalog> incremental = incremental_catalog_;
+  if (catalog_warmup_) {
+    catalog_warmup_->Trace(L"engine created");
+    // Publishes as soon as the scan is done, and builds the short-query
+    // tables, so startSearch can answer from the catalog before Dart has asked
+    // for the program list.
+    catalog_warmup_->OnReady([incremental, catalog = catalog_, short_queries = short_queries_](
+                                 std::vector<utils::Program>&& programs) {
+      incremental->Reset(std::move(programs));
+      short_queries->Prepare(catalog->Current());
+    });
+  }
+  catalog_debouncer_ = std::make_unique<SearchEngine::ChangeDebouncer>(
+      [incremental](std::vector<SearchEngine::FileEvent>&& events) {
+        incremental->Apply(events);
+      });
+  SearchEngine::ChangeDebouncer* debouncer = catalog_debouncer_.get();
+  start_menu_watcher_ = SearchEngine::DirectoryWatcher::Create();
+  start_menu_watcher_->Start(
+      watched_paths, [debouncer](std::vector<SearchEngine::FileEvent>&& events) {
+        debouncer->Add(std::move(events));
+      });
+
+  // Maintenance waits until the palette is put away and yields to it as soon
+  // as it comes back.
+  refresh_scheduler_ = std::make_shared<SearchEngine::RefreshScheduler>();
+  SearchEngine::RefreshScheduler* refresh = refresh_scheduler_.get();
+  refresh_scheduler_->AddJob(
+      "catalog", std::chrono::minutes(30),
+      [incremental, refresh](const utils::CancellationToken& token) {
+        std::vector<utils::Program> programs = ProgramFinder::GetRawProgramsIsolated(token);
+        if (token.IsCancelled()) {
+          return;
+        }
+        incremental->Reset(std::move(programs));
+        refresh->RunSoon("validate");
+        refresh->RunSoon("deferred");
+      });
+  // Shortcut-cache hits skipped their existence checks; drop targets that
+  // vanished since.
+  refresh_scheduler_->AddJob(
+      "validate", std::chrono::hours(6),
+      [incremental](const utils::CancellationToken& token) {
+        utils::StatCache stats;
+        const std::vector<std::string> missing = incremental->Validate(
+            [&stats, &token](const std::string& path) {
+              // AUMIDs and other non-file targets are left to launch time; once
+              // cancelled, everything counts as present.
+              const std::filesystem::path target = std::filesystem::u8path(path);
+              return token.IsCancelled() || !target.is_absolute() || stats.Exists(target);
+            });
+        for (const std::string& origin : missing) {
+          ProgramFinder::ForgetShortcut(origin);
+        }
+      });
+  // Shortcuts that went over their time budget get another try away from the
+  // scan; timing out again quarantines them.
+  refresh_scheduler_->AddJob(
+      "deferred", std::chrono::minutes(10),
+      [incremental](const utils::CancellationToken& token) {
+        std::vector<std::string> retry = ProgramFinder::TakeDeferredShortcuts();
+        if (token.IsCancelled()) {
+          ProgramFinder::DeferShortcuts(retry);
+          return;
+        }
+        std::vector<SearchEngine::FileEvent> events;
+        for (const std::string& path : retry) {
+          events.push_back({SearchEngine::FileChange::Modified, path});
+        }
+        incremental->Apply(events);
+        const std::vector<std::string> timed_out = ProgramFinder::TakeDeferredShortcuts();
+        const std::set<std::string> failed(timed_out.begin(), timed_out.end());
+        std::vector<std::string> succeeded;
+        std::vector<std::string> newcomers;
+        for (const std::string& path : retry) {
+          if (!failed.count(path)) {
+            succeeded.push_back(path);
+          }
+        }
+        // Deferred by the watcher meanwhile; theirs is the next run.
+        const std::set<std::string> retried(retry.begin(), retry.end());
+        for (const std::string& path : timed_out) {
+          if (!retried.count(path)) {
+            newcomers.push_back(path);
+          }
+        }
+        ProgramFinder::RecordScanOutcomes(succeeded, timed_out, {});
+        ProgramFinder::DeferShortcuts(newcomers);
+      });
+
+  event_channel_ = std::make_unique<flutter::EventChannel<>>(
+      flutter_controller_->engine()->messenger(), "windows_native_events",
+      &flutter::StandardMethodCodec::GetInstance());
+  event_channel_->SetStreamHandler(
+      std::make_unique<flutter::StreamHandlerFunctions<>>(
+          [this](const flutter::EncodableValue*,
+                 std::unique_ptr<flutter::EventSink<>>&& events)
+              -> std::unique_ptr<flutter::StreamHandlerError<>> {
+            channel_state_->event_sink = std::move(events);
+            return nullptr;
+          },
+          [this](const flutter::EncodableValue*)
+              -> std::unique_ptr<flutter::StreamHandlerError<>> {
+            channel_state_->event_sink = nullptr;
+            return nullptr;
+          }));
+
   //Method channel for native windows apis
   flutter::MethodChannel<> channel(
     flutter_controller_->engine()->messenger(), "windows_native_channel",
     &flutter::StandardMethodCodec::GetInstance());
 channel.SetMethodCallHandler(
-    [](const flutter::MethodCall<>& call,
+    [this](const flutter::MethodCall<>& call,
        std::unique_ptr<flutter::MethodResult<>> result) {
         // Handle method calls on this channel.
-        if (call.method_name() == "searchWindowsIndex") {
-          // Extract the string argument from the method call
+        if (call.method_name() == "startSearch") {
+          // startSearch({query, seq, deadlineMs?, speculativeDelayMs?, pageRows?}):
+          // fans the query out to every provider; results arrive as searchFrame
+          // events tagged with |seq|. With pageRows, frames carry display rows
+          // of the first page only and the rest is read with fetchRows.
           const flutter::EncodableValue* args = call.arguments();
-          std::string query;
-          if (args && std::holds_alternative<std::string>(*args)) {
-            query = std::get<std::string>(*args);
-          } else {
+          if (!args || !std::holds_alternative<flutter::EncodableMap>(*args)) {
             return result->Error("INVALID_ARGUMENT", "Invalid argument");
           }
-          std::vector<utils::Program> items = SearchWindowsIndex(query);
-          flutter::EncodableList flutter_list;
-          for (const auto& item : items) {
-            flutter::EncodableMap flutter_item;
-            flutter_item[flutter::EncodableValue("name")] = flutter::EncodableValue(item.name);
-            flutter_item[flutter::EncodableValue("path")] = flutter::EncodableValue(item.executablePath);
-            flutter_item[flutter::EncodableValue("args")] = flutter::EncodableValue(item.arguments);
-            flutter_item[flutter::EncodableValue("kind")] = flutter::EncodableValue(item.kind);
-            flutter_item[flutter::EncodableValue("desc")] = flutter::EncodableValue(item.description);
-            if (item.iconDataBase64.empty()) {
-              flutter_item[flutter::EncodableValue("icon")] = flutter::EncodableValue("");
-            } else {
-              flutter_item[flutter::EncodableValue("icon")] = flutter::EncodableValue(item.iconDataBase64);
+          const auto& map = std::get<flutter::EncodableMap>(*args);
+          auto query_it = map.find(flutter::EncodableValue("query"));
+          auto seq_it = map.find(flutter::EncodableValue("seq"));
+          auto deadline_it = map.find(flutter::EncodableValue("deadlineMs"));
+          auto delay_it = map.find(flutter::EncodableValue("speculativeDelayMs"));
+          auto page_it = map.find(flutter::EncodableValue("pageRows"));
+          std::optional<int64_t> seq =
+              seq_it != map.end() ? GetInt64(seq_it->second) : std::nullopt;
+          if (query_it == map.end() || !std::holds_alternative<std::string>(query_it->second) || !seq) {
+            return result->Error("INVALID_ARGUMENT", "Invalid argument");
+          }
+          if (deadline_it != map.end()) {
+            if (std::optional<int64_t> deadline_ms = GetInt64(deadline_it->second)) {
+              search_scheduler_->SetDeadline(std::chrono::milliseconds(*deadline_ms));
             }
-            flutter_list.push_back(flutter::EncodableValue(flutter_item));
           }
-          result->Success(flutter::EncodableValue(flutter_list));
+          if (delay_it != map.end()) {
+            if (std::optional<int64_t> delay_ms = GetInt64(delay_it->second)) {
+              search_scheduler_->SetSpeculativeDelay(std::chrono::milliseconds(*delay_ms));
+            }
+          }
+
+          const int64_t page_rows =
+              page_it != map.end() ? GetInt64(page_it->second).value_or(0) : 0;
+
+          utils::CancellationToken token = channel_state_->search_cancellation.Register(*seq);
+          std::shared_ptr<PlatformTaskQueue> tasks = platform_tasks_;
+          std::shared_ptr<ChannelState> state = channel_state_;
+          std::shared_ptr<SearchEngine::ResultPager> pager = page_rows > 0 ? result_pager_ : nullptr;
+          const std::string& query = std::get<std::string>(query_it->second);
+          search_scheduler_->Run(
+              *seq, query, token,
+              [tasks, state, session = state->search_session, pager, query,
+               page_rows](SearchEngine::SearchFrame&& frame) {
+                // Ranking into the pager happens here on the worker; the page
+                // and its view patch are made on the platform thread, in the
+                // order the events are sent.
+                auto event = std::make_shared<flutter::EncodableMap>();
+                if (pager) {
+                  pager->Append(frame.seq, query, std::move(frame.items));
+                } else {
+                  (*event)[flutter::EncodableValue("items")] =
+                      flutter::EncodableValue(EncodePrograms(std::move(frame.items)));
+                }
+                const int64_t frame_seq = frame.seq;
+                const int frame_index = frame.index;
+                const bool is_final = frame.isFinal;
+                AddSearchFrameHeader(*event, frame_seq, frame_index, is_final, std::move(frame.providers));
+                tasks->Post([state, session, frame_seq, frame_index, is_final, event, pager,
+                             page_rows]() {
+                  // Its sequence number may belong to the new session too.
+                  if (state->search_session != session) {
+                    return;
+                  }
+                  if (is_final) {
+                    state->search_cancellation.Release(frame_seq);
+                  }
+                  if (pager) {
+                    PageSlice slice = TopRows(*pager, frame_seq,
+                                              RowsHeld(state->result_view, frame_seq, static_cast<size_t>(page_rows)));
+                    flutter::EncodableMap page =
+                        EncodeViewPage(state->result_view, frame_seq, frame_index == 0, std::move(slice));
+                    event->insert(std::make_move_iterator(page.begin()), std::make_move_iterator(page.end()));
+                  }
+                  if (state->event_sink) {
+                    state->event_sink->Success(flutter::EncodableValue(std::move(*event)));
+                  }
+                });
+              });
+          result->Success();
+        }
+        else if (call.method_name() == "cancel") {
+          // cancel(seq): aborts every native search registered with a sequence
+          // <= seq and drops their paged results.
+          const flutter::EncodableValue* args = call.arguments();
+          std::optional<int64_t> seq = args ? GetInt64(*args) : std::nullopt;
+          if (!seq) {
+            return result->Error("INVALID_ARGUMENT", "Invalid argument");
+          }
+          channel_state_->search_cancellation.CancelThrough(*seq);
+          result_pager_->CloseThrough(*seq);
+          result->Success();
+        }
+        else if (call.method_name() == "fetchRows") {
+          // fetchRows({seq, start, count}) -> a view page (see EncodeViewPage):
+          // the best start + count rows of the query on screen, as a patch to
+          // the list, which mostly appends. total is 0 once the session is gone.
+          const flutter::EncodableValue* args = call.arguments();
+          if (!args || !std::holds_alternative<flutter::EncodableMap>(*args)) {
+            return result->Error("INVALID_ARGUMENT", "Invalid argument");
+          }
+          const auto& map = std::get<flutter::EncodableMap>(*args);
+          auto seq_it = map.find(flutter::EncodableValue("seq"));
+          auto start_it = map.find(flutter::EncodableValue("start"));
+          auto count_it = map.find(flutter::EncodableValue("count"));
+          std::optional<int64_t> seq = seq_it != map.end() ? GetInt64(seq_it->second) : std::nullopt;
+          std::optional<int64_t> start = start_it != map.end() ? GetInt64(start_it->second) : std::nullopt;
+          std::optional<int64_t> count = count_it != map.end() ? GetInt64(count_it->second) : std::nullopt;
+          if (!seq || !start || !count || *start < 0 || *count < 0) {
+            return result->Error("INVALID_ARGUMENT", "Invalid argument");
+          }
+          PageSlice slice = TopRows(*result_pager_, *seq, static_cast<size_t>(*start + *count));
+          result->Success(flutter::EncodableValue(
+              EncodeViewPage(channel_state_->result_view, *seq, false, std::move(slice))));
+        }
+        else if (call.method_name() == "resetResultView") {
+          // resetResultView({newSession?}): empties the native copy of Dart's
+          // result list, e.g. after a lost update, and returns its version; Dart
+          // empties its list and continues from there. With newSession (hot
+          // restart, new SearchCubit) Dart numbers its searches from 1 again:
+          // the old ones are cancelled and the cancel and paging high-water
+          // marks start over.
+          const flutter::EncodableValue* args = call.arguments();
+          if (args && std::holds_alternative<flutter::EncodableMap>(*args)) {
+            const auto& map = std::get<flutter::EncodableMap>(*args);
+            auto session_it = map.find(flutter::EncodableValue("newSession"));
+            if (session_it != map.end() && std::holds_alternative<bool>(session_it->second) &&
+                std::get<bool>(session_it->second)) {
+              channel_state_->search_cancellation.Reset();
+              ++channel_state_->search_session;
+              // Frames still running append to the old pager, which goes with them.
+              result_pager_ = std::make_shared<SearchEngine::ResultPager>();
+            }
+          }
+          result->Success(flutter::EncodableValue(static_cast<int64_t>(channel_state_->result_view.Reset())));
+        }
+        else if (call.method_name() == "fetchIcons") {
+          // fetchIcons([iconId, ...]) -> [Base64 PNG, ...] in the same order; ""
+          // for ids whose session is gone.
+          const flutter::EncodableValue* args = call.arguments();
+          if (!args || !std::holds_alternative<flutter::EncodableList>(*args)) {
+            return result->Error("INVALID_ARGUMENT", "Invalid argument");
+          }
+          flutter::EncodableList icons;
+          for (const flutter::EncodableValue& id : std::get<flutter::EncodableList>(*args)) {
+            std::optional<int64_t> icon_id = GetInt64(id);
+            std::optional<std::string> icon =
+                icon_id ? result_pager_->Icon(static_cast<uint64_t>(*icon_id)) : std::nullopt;
+            icons.push_back(flutter::EncodableValue(icon ? std::move(*icon) : std::string()));
+          }
+          result->Success(flutter::EncodableValue(std::move(icons)));
         }
         else if(call.method_name() == "getAllPrograms") {
-          std::vector<utils::Program> items = ProgramFinder::GetAllPrograms();
-          flutter::EncodableList flutter_list;
-          for (const auto& item : items) {
-            flutter::EncodableMap flutter_item;
-            flutter_item[flutter::EncodableValue("name")] = flutter::EncodableValue(item.name);
-            flutter_item[flutter::EncodableValue("path")] = flutter::EncodableValue(item.executablePath);
-            flutter_item[flutter::EncodableValue("args")] = flutter::EncodableValue(item.arguments);
-            flutter_item[flutter::EncodableValue("kind")] = flutter::EncodableValue(item.kind);
-            flutter_item[flutter::EncodableValue("desc")] = flutter::EncodableValue(item.description);
-            if (item.iconDataBase64.empty()) {
-              flutter_item[flutter::EncodableValue("icon")] = flutter::EncodableValue("");
+          // Full rescan: the incremental catalog dedups it and publishes a new
+          // generation, which is also what Dart gets, plus the settings pages.
+          // The first call takes the scan started in wWinMain instead. Calls
+          // made while a scan runs are answered from that scan.
+          // getAllPrograms({summary: true}) replies {generation, count} only,
+          // for callers that just wait for the catalog; searches read it here.
+          const flutter::EncodableValue* args = call.arguments();
+          bool summary_only = false;
+          if (args && std::holds_alternative<flutter::EncodableMap>(*args)) {
+            const auto& map = std::get<flutter::EncodableMap>(*args);
+            auto summary_it = map.find(flutter::EncodableValue("summary"));
+            summary_only = summary_it != map.end() && std::holds_alternative<bool>(summary_it->second) &&
+                           std::get<bool>(summary_it->second);
+          }
+          // Encoded on the worker that finished the scan, so every caller that
+          // joined it gets its own kind of reply.
+          std::shared_ptr<ChannelState> state = channel_state_;
+          const uint64_t reply_id = state->Park(std::move(result));
+          std::shared_ptr<PlatformTaskQueue> tasks = platform_tasks_;
+          std::shared_ptr<SearchEngine::ProgramCatalog> catalog = catalog_;
+          std::weak_ptr<SearchEngine::RefreshScheduler> refresh = refresh_scheduler_;
+          auto reply_when_scanned = [tasks, state, reply_id, refresh, catalog, summary_only](
+                                        const ScanFlights::Result&, bool) {
+            flutter::EncodableValue reply;
+            if (summary_only) {
+              SearchEngine::ProgramCatalog::ReadGuard generation = catalog->Read();
+              flutter::EncodableMap map;
+              map[flutter::EncodableValue("generation")] =
+                  flutter::EncodableValue(static_cast<int64_t>(generation->number));
+              map[flutter::EncodableValue("count")] = flutter::EncodableValue(
+                  static_cast<int64_t>(generation->programs ? generation->programs->size() : 0));
+              reply = flutter::EncodableValue(std::move(map));
+            } else {
+              SearchEngine::ProgramCatalog::Snapshot installed = catalog->Current();
+              flutter::EncodableList flutter_list = EncodePrograms(*installed);
+              flutter::EncodableList settings = EncodePrograms(getAllSettingsPages());
+              flutter_list.insert(flutter_list.end(), std::make_move_iterator(settings.begin()),
+                                  std::make_move_iterator(settings.end()));
+              reply = flutter::EncodableValue(std::move(flutter_list));
+            }
+            tasks->Post([state, reply_id, refresh, reply = std::move(reply)]() {
+              state->Answer(reply_id, reply);
+              if (std::shared_ptr<SearchEngine::RefreshScheduler> scheduler = refresh.lock()) {
+                scheduler->RunSoon("validate");
+                scheduler->RunSoon("deferred");
+              }
+            });
+          };
+          std::shared_ptr<ScanFlights::Flight> flight =
+              scan_flights_->Join(kFullScan, scan_cancellation_.Token(), std::move(reply_when_scanned));
+          if (flight) {
+            std::shared_ptr<CatalogWarmup> warmup = std::move(catalog_warmup_);
+            // Ready before the first keystroke; later generations get theirs
+            // on first use. Weak, as the warmup holds this until it is done.
+            auto land = [flights = scan_flights_, flight, traced = std::weak_ptr<CatalogWarmup>(warmup),
+                         catalog, short_queries = short_queries_]() {
+              short_queries->Prepare(catalog->Current());
+              flights->Land(flight, std::make_shared<uint64_t>(catalog->GenerationNumber()));
+              if (std::shared_ptr<CatalogWarmup> warmup = traced.lock()) {
+                warmup->Trace(L"first getAllPrograms answered");
+              }
+            };
+            auto rescan = [incremental = incremental_catalog_, token = scan_cancellation_.Token(), land]() {
+              std::vector<utils::Program> programs = ProgramFinder::GetRawProgramsIsolated(token);
+              if (!token.IsCancelled()) {
+                incremental->Reset(std::move(programs));
+              }
+              land();
+            };
+            std::shared_ptr<utils::ConcurrencyLimiter> expensive = expensive_calls_;
+            if (warmup) {
+              // The warmup scan answers instead, once it is done; nothing
+              // waits for it meanwhile.
+              warmup->OnFinished([expensive, land, rescan](bool consumed) {
+                if (consumed) {
+                  utils::SharedExecutor().Post(utils::TaskPriority::Interactive, land);
+                } else {
+                  expensive->Post(utils::TaskPriority::Interactive, rescan);
+                }
+              });
             } else {
-              flutter_item[flutter::EncodableValue("icon")] = flutter::EncodableValue(item.iconDataBase64);
+              expensive->Post(utils::TaskPriority::Interactive, rescan);
             }
-            flutter_list.push_back(flutter::EncodableValue(flutter_item));
           }
-          result->Success(flutter::EncodableValue(flutter_list));
+        }
+        else if (call.method_name() == "getCallStats") {
+          // getCallStats(): how the coalesced, rate-limited calls fared: the full
+          // scans above and the index queries of searches.
+          const utils::ConcurrencyLimiter::Stats limiter = expensive_calls_->GetStats();
+          const ScanFlights::Stats scan = scan_flights_->GetStats();
+          const SearchEngine::CoalescingProvider::Stats index = index_provider_->GetStats();
+          flutter::EncodableMap stats;
+          stats[flutter::EncodableValue("limit")] = flutter::EncodableValue(static_cast<int64_t>(limiter.limit));
+          stats[flutter::EncodableValue("running")] = flutter::EncodableValue(static_cast<int64_t>(limiter.running));
+          stats[flutter::EncodableValue("queued")] = flutter::EncodableValue(static_cast<int64_t>(limiter.queued));
+          stats[flutter::EncodableValue("peakQueued")] =
+              flutter::EncodableValue(static_cast<int64_t>(limiter.peakQueued));
+          stats[flutter::EncodableValue("admitted")] = flutter::EncodableValue(static_cast<int64_t>(limiter.admitted));
+          stats[flutter::EncodableValue("waited")] = flutter::EncodableValue(static_cast<int64_t>(limiter.waited));
+          stats[flutter::EncodableValue("totalWaitMs")] = flutter::EncodableValue(limiter.totalWaitMs);
+          stats[flutter::EncodableValue("maxWaitMs")] = flutter::EncodableValue(limiter.maxWaitMs);
+          stats[flutter::EncodableValue("scans")] = flutter::EncodableValue(static_cast<int64_t>(scan.started));
+          stats[flutter::EncodableValue("scansJoined")] = flutter::EncodableValue(static_cast<int64_t>(scan.joined));
+          stats[flutter::EncodableValue("indexSearches")] = flutter::EncodableValue(static_cast<int64_t>(index.searches));
+          stats[flutter::EncodableValue("indexJoined")] = flutter::EncodableValue(static_cast<int64_t>(index.joined));
+          result->Success(flutter::EncodableValue(std::move(stats)));
+        }
+        else if (call.method_name() == "trimMemory") {
+          // trimMemory(): what hiding the window does after a delay, on demand.
+          // Replies {cachesReleased, workingSetBefore, workingSetAfter}.
+          std::shared_ptr<ChannelState> state = channel_state_;
+          const uint64_t reply_id = state->Park(std::move(result));
+          std::shared_ptr<PlatformTaskQueue> tasks = platform_tasks_;
+          utils::SharedExecutor().Post(utils::TaskPriority::Refresh,
+                                       [catalog = catalog_, tasks, state, reply_id]() {
+            flutter::EncodableMap stats = TrimNativeMemory(*catalog);
+            tasks->Post([state, reply_id, stats = std::move(stats)]() {
+              state->Answer(reply_id, flutter::EncodableValue(stats));
+            });
+          });
         }
         else if(call.method_name() == "OpenItem"){
           const flutter::EncodableValue* args = call.arguments();
@@ -102,6 +684,14 @@ channel.SetMethodCallHandler(
               std::string arguments = std::get<std::string>(arg_list[1]);
               // Call the OpenItem function with the extracted arguments
               ShellExecution::OpenItem(path, arguments);
+              launch_history_->Record(path, arguments);
+              short_queries_->OnLaunch(path, arguments);
+              utils::SharedExecutor().Post(utils::TaskPriority::Refresh,
+                                           [history = launch_history_]() {
+                if (std::filesystem::path file = LaunchHistoryPath(); !file.empty()) {
+                  history->Save(file);
+                }
+              });
               result->Success();
             } else {
               result->Error("INVALID_ARGUMENT", "Invalid argument");
@@ -130,6 +720,45 @@ channel.SetMethodCallHandler(
 }
 
 void FlutterWindow::OnDestroy() {
+  ::KillTimer(GetHandle(), kTrimMemoryTimer);
+  // Searches and scans before anything they answer through: running expensive
+  // calls are cancelled and waited for, and queued ones dropped with their
+  // flights. Frames and replies still on their way are dropped once
+  // |platform_tasks_| is detached below.
+  if (channel_state_) {
+    channel_state_->search_cancellation.CancelThrough(std::numeric_limits<int64_t>::max());
+  }
+  scan_cancellation_.Cancel();
+  if (expensive_calls_) {
+    expensive_calls_->Shutdown();
+  }
+  search_scheduler_ = nullptr;
+  index_provider_ = nullptr;
+  expensive_calls_ = nullptr;
+  scan_flights_ = nullptr;
+  // Cancels and joins a running job before the catalog pieces it uses go away.
+  refresh_scheduler_ = nullptr;
+  if (catalog_warmup_) {
+    catalog_warmup_->Cancel();
+    catalog_warmup_ = nullptr;
+  }
+  // Watcher first: it feeds the debouncer, which feeds the catalog.
+  if (start_menu_watcher_) {
+    start_menu_watcher_->Stop();
+    start_menu_watcher_ = nullptr;
+  }
+  catalog_debouncer_ = nullptr;
+  SearchEngine::PublishFfiCatalog(nullptr, nullptr);
+  if (platform_tasks_) {
+    platform_tasks_->Detach();
+  }
+  // Calls still waiting for a worker are dropped here, while the engine that
+  // carries their replies is still up.
+  if (channel_state_) {
+    channel_state_->pending_results.clear();
+    channel_state_->event_sink = nullptr;
+  }
+  event_channel_ = nullptr;
   if (flutter_controller_) {
     flutter_controller_ = nullptr;
   }
@@ -141,6 +770,33 @@ LRESULT
 FlutterWindow::MessageHandler(HWND hwnd, UINT const message,
                               WPARAM const wparam,
                               LPARAM const lparam) noexcept {
+  if (message == PlatformTaskQueue::kDrainMessage) {
+    if (platform_tasks_) {
+      platform_tasks_->Drain();
+    }
+    return 0;
+  }
+
+  // The palette spends most of its life hidden; give the memory back while it
+  // is, but not on a quick hide/show.
+  if (message == WM_SHOWWINDOW) {
+    if (refresh_scheduler_) {
+      refresh_scheduler_->SetForeground(wparam != 0);
+    }
+    if (wparam) {
+      ::KillTimer(hwnd, kTrimMemoryTimer);
+    } else {
+      ::SetTimer(hwnd, kTrimMemoryTimer, kTrimMemoryDelayMs, nullptr);
+    }
+  } else if (message == WM_TIMER && wparam == kTrimMemoryTimer) {
+    ::KillTimer(hwnd, kTrimMemoryTimer);
+    if (!::IsWindowVisible(hwnd) && catalog_) {
+      utils::SharedExecutor().Post(utils::TaskPriority::Refresh,
+                                   [catalog = catalog_]() { TrimNativeMemory(*catalog); });
+    }
+    return 0;
+  }
+
   // Give Flutter, including plugins, an opportunity to handle window messages.
   if (flutter_controller_) {
     std::optional<LRESULT> result =
@@ -2,17 +2,41 @@
 #define RUNNER_FLUTTER_WINDOW_H_
 
 #include <flutter/dart_project.h>
+#include <flutter/event_channel.h>
+#include <flutter/event_sink.h>
 #include <flutter/flutter_view_controller.h>
+#include <flutter/method_result.h>
 
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "catalog_warmup.h"
+#include "native_utils/CancellationToken.h"
+#include "native_utils/ChangeDebouncer.h"
+#include "native_utils/CoalescingProvider.h"
+#include "native_utils/ConcurrencyLimiter.h"
+#include "native_utils/DirectoryWatcher.h"
+#include "native_utils/IncrementalCatalog.h"
+#include "native_utils/ProviderScheduler.h"
+#include "native_utils/RefreshScheduler.h"
+#include "native_utils/ResultDiff.h"
+#include "native_utils/ResultPager.h"
+#include "native_utils/SearchProviders.h"
+#include "native_utils/SingleFlight.h"
+#include "platform_task_queue.h"
 #include "win32_window.h"
 
 // A window that does nothing but host a Flutter view.
 class FlutterWindow : public Win32Window {
  public:
   // Creates a new FlutterWindow hosting a Flutter view running |project|.
-  explicit FlutterWindow(const flutter::DartProject& project);
+  // |catalog_warmup|, if given, supplies the first program scan.
+  FlutterWindow(const flutter::DartProject& project,
+                std::shared_ptr<CatalogWarmup> catalog_warmup = nullptr);
   virtual ~FlutterWindow();
 
  protected:
@@ -28,6 +52,69 @@ class FlutterWindow : public Win32Window {
 
   // The Flutter instance hosted by this window.
   std::unique_ptr<flutter::FlutterViewController> flutter_controller_;
+
+  // Results of native work finished on worker threads, delivered back to the
+  // platform thread.
+  std::shared_ptr<PlatformTaskQueue> platform_tasks_;
+
+  // Installed programs from the last getAllPrograms scan, searched natively by
+  // |search_scheduler_| alongside the settings pages and the file index.
+  std::shared_ptr<SearchEngine::ProgramCatalog> catalog_;
+  // Items opened through OpenItem, and the short-query tables ranked by them.
+  std::shared_ptr<SearchEngine::LaunchHistory> launch_history_;
+  std::shared_ptr<SearchEngine::ShortQueryIndex> short_queries_;
+  std::unique_ptr<SearchEngine::ProviderScheduler> search_scheduler_;
+  // Complete result sets of paged queries; Dart pulls rows and icons from here.
+  std::shared_ptr<SearchEngine::ResultPager> result_pager_;
+
+  // Start Menu watch -> debounce -> per-entry catalog deltas.
+  std::shared_ptr<SearchEngine::IncrementalCatalog> incremental_catalog_;
+  std::unique_ptr<SearchEngine::ChangeDebouncer> catalog_debouncer_;
+  std::unique_ptr<SearchEngine::DirectoryWatcher> start_menu_watcher_;
+
+  // Periodic rescans and target validation, run only while the window is
+  // hidden.
+  std::shared_ptr<SearchEngine::RefreshScheduler> refresh_scheduler_;
+
+  // The scan started in wWinMain; released once the first getAllPrograms has
+  // used it.
+  std::shared_ptr<CatalogWarmup> catalog_warmup_;
+
+  // Full scans Dart may ask for in bursts: calls while one is in flight share
+  // it (it yields the catalog generation), and it queues for
+  // |expensive_calls_| with the other expensive work, the index queries of
+  // |index_provider_| included.
+  using ScanFlights = utils::SingleFlight<int, uint64_t>;
+  std::shared_ptr<ScanFlights> scan_flights_;
+  // Stops a full scan when the window goes.
+  utils::CancellationSource scan_cancellation_;
+  std::shared_ptr<utils::ConcurrencyLimiter> expensive_calls_;
+  std::shared_ptr<SearchEngine::CoalescingProvider> index_provider_;
+
+  // What work finished on a worker touches once back on the platform thread.
+  // Workers hold this, not the window, and only to post to |platform_tasks_|,
+  // which stops running their tasks when the window goes.
+  struct ChannelState {
+    // Parks a call that a worker will answer, and returns its id for Answer.
+    uint64_t Park(std::unique_ptr<flutter::MethodResult<>> result);
+    void Answer(uint64_t id, const flutter::EncodableValue& reply);
+
+    // In-flight searches keyed by the Dart search sequence number.
+    utils::CancellationRegistry search_cancellation;
+    // Bumped when Dart starts numbering searches again; frames of an older
+    // session are dropped.
+    uint64_t search_session = 0;
+    // What Dart's result list holds; frames are sent as patches to it.
+    SearchEngine::ResultView result_view;
+    // Pushes search frames to Dart; only set while Dart listens.
+    std::unique_ptr<flutter::EventSink<>> event_sink;
+    // Parked calls. Whatever is left when the window goes is dropped here,
+    // on the platform thread, while the engine is still up.
+    std::map<uint64_t, std::unique_ptr<flutter::MethodResult<>>> pending_results;
+    uint64_t next_result_id = 0;
+  };
+  std::shared_ptr<ChannelState> channel_state_;
+  std::unique_ptr<flutter::EventChannel<>> event_channel_;
 };
 
 #endif  // RUNNER_FLUTTER_WINDOW_H_
@@ -2,11 +2,24 @@
 #include <flutter/flutter_view_controller.h>
 #include <windows.h>
 
+#include "catalog_warmup.h"
 #include "flutter_window.h"
+#include "native_utils/ScannerHelper.h"
 #include "utils.h"
 
 int APIENTRY wWinMain(_In_ HINSTANCE instance, _In_opt_ HINSTANCE prev,
                       _In_ wchar_t *command_line, _In_ int show_command) {
+  // The same executable doubles as the out-of-process program scanner.
+  std::vector<std::string> command_line_arguments = GetCommandLineArguments();
+  if (command_line_arguments.size() == 2 &&
+      command_line_arguments[0] == ProgramFinder::kScannerHelperFlag) {
+    return ProgramFinder::RunScannerHelper(command_line_arguments[1]);
+  }
+
+  // Scan for programs while the engine starts; the first getAllPrograms picks
+  // up the result instead of scanning itself.
+  std::shared_ptr<CatalogWarmup> catalog_warmup = CatalogWarmup::Start();
+
   // Attach to console when present (e.g., 'flutter run') or create a
   // new console when running with a debugger.
   if (!::AttachConsole(ATTACH_PARENT_PROCESS) && ::IsDebuggerPresent()) {
@@ -19,12 +32,9 @@ int APIENTRY wWinMain(_In_ HINSTANCE instance, _In_opt_ HINSTANCE prev,
 
   flutter::DartProject project(L"data");
 
-  std::vector<std::string> command_line_arguments =
-      GetCommandLineArguments();
-
   project.set_dart_entrypoint_arguments(std::move(command_line_arguments));
 
-  FlutterWindow window(project);
+  FlutterWindow window(project, catalog_warmup);
   Win32Window::Point origin(10, 10);
   Win32Window::Size size(1280, 720);
   if (!window.Create(L"vxkonsol", origin, size)) {
@@ -0,0 +1,160 @@
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace utils
+{
+
+    /**
+     * @brief Appends fixed-width little-endian fields to a byte buffer.
+     *
+     * @details Used for the on-disk caches under the local app data folder. The
+     *          byte order is fixed so a file written on one machine reads back the
+     *          same everywhere; strings are a u32 length followed by the raw bytes (UTF-16 units for
+     *          wide strings).
+     */
+    class BinaryWriter
+    {
+    public:
+        void U8(uint8_t value) { buffer_.push_back(static_cast<char>(value)); }
+        void U32(uint32_t value) { Put(value, 4); }
+        void U64(uint64_t value) { Put(value, 8); }
+        void I32(int32_t value) { U32(static_cast<uint32_t>(value)); }
+        void I64(int64_t value) { U64(static_cast<uint64_t>(value)); }
+
+        void String(std::string_view value)
+        {
+            U32(static_cast<uint32_t>(value.size()));
+            buffer_.append(value.data(), value.size());
+        }
+
+        // UTF-16 code units, which is what wchar_t holds on Windows.
+        void WString(std::wstring_view value)
+        {
+            U32(static_cast<uint32_t>(value.size()));
+            for (wchar_t c : value)
+                Put(static_cast<uint16_t>(c), 2);
+        }
+
+        const std::string &Data() const { return buffer_; }
+
+    private:
+        void Put(uint64_t value, int bytes)
+        {
+            for (int i = 0; i < bytes; ++i)
+                buffer_.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+
+        std::string buffer_;
+    };
+
+    /**
+     * @brief Reads what BinaryWriter wrote, failing softly on truncated input.
+     *
+     * @details Every accessor returns false once the input runs out and keeps
+     *          returning false afterwards, so a caller can read a whole record and
+     *          check once.
+     */
+    class BinaryReader
+    {
+    public:
+        explicit BinaryReader(std::string_view data) : data_(data) {}
+
+        bool U8(uint8_t &value)
+        {
+            uint64_t raw = 0;
+            if (!Get(raw, 1))
+                return false;
+            value = static_cast<uint8_t>(raw);
+            return true;
+        }
+        bool U32(uint32_t &value)
+        {
+            uint64_t raw = 0;
+            if (!Get(raw, 4))
+                return false;
+            value = static_cast<uint32_t>(raw);
+            return true;
+        }
+        bool U64(uint64_t &value) { return Get(value, 8); }
+        bool I32(int32_t &value)
+        {
+            uint32_t raw = 0;
+            if (!U32(raw))
+                return false;
+            value = static_cast<int32_t>(raw);
+            return true;
+        }
+        bool I64(int64_t &value)
+        {
+            uint64_t raw = 0;
+            if (!U64(raw))
+                return false;
+            value = static_cast<int64_t>(raw);
+            return true;
+        }
+
+        bool String(std::string &value)
+        {
+            uint32_t size = 0;
+            if (!U32(size) || size > data_.size() - offset_)
+                return ok_ = false;
+            value.assign(data_.data() + offset_, size);
+            offset_ += size;
+            return true;
+        }
+
+        bool WString(std::wstring &value)
+        {
+            uint32_t size = 0;
+            if (!U32(size) || size > (data_.size() - offset_) / 2)
+                return ok_ = false;
+            value.resize(size);
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                uint64_t unit = 0;
+                Get(unit, 2);
+                value[i] = static_cast<wchar_t>(unit);
+            }
+            return true;
+        }
+
+        bool Ok() const { return ok_; }
+        bool AtEnd() const { return offset_ == data_.size(); }
+        size_t Offset() const { return offset_; }
+
+    private:
+        bool Get(uint64_t &value, int bytes)
+        {
+            if (!ok_ || data_.size() - offset_ < static_cast<size_t>(bytes))
+                return ok_ = false;
+            value = 0;
+            for (int i = 0; i < bytes; ++i)
+                value |= static_cast<uint64_t>(static_cast<uint8_t>(data_[offset_ + i])) << (8 * i);
+            offset_ += bytes;
+            return true;
+        }
+
+        std::string_view data_;
+        size_t offset_ = 0;
+        bool ok_ = true;
+    };
+
+    // FNV-1a over |data|; the integrity check the binary caches append. Pass a
+    // previous result as |hash| to continue it over more data.
+    inline uint64_t Fnv1a64(std::string_view data, uint64_t hash = 14695981039346656037ull)
+    {
+        for (char c : data)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+} // namespace utils
+
+#endif // BINARY_IO_H
@@ -0,0 +1,169 @@
+#include "BudgetedRunner.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <utility>
+
+namespace utils
+{
+
+    // State shared by the runner and one worker thread; outlives the runner's
+    // interest in it when the worker is abandoned.
+    struct BudgetedRunner::Worker
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::function<void()> job;
+        bool pending = false;
+        bool done = false;
+        bool stop = false;
+    };
+
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+    } // namespace
+
+    BudgetedRunner::BudgetedRunner() : BudgetedRunner(Options()) {}
+
+    BudgetedRunner::BudgetedRunner(Options options)
+        : options_(std::move(options)), abandoned_(std::make_shared<std::atomic<size_t>>(0))
+    {
+        samples_.reserve(options_.latencySamples);
+    }
+
+    BudgetedRunner::~BudgetedRunner()
+    {
+        std::lock_guard<std::mutex> lock(runMutex_);
+        if (!worker_)
+            return;
+        {
+            std::lock_guard<std::mutex> guard(worker_->mutex);
+            worker_->stop = true;
+        }
+        worker_->cv.notify_all();
+        thread_.join();
+    }
+
+    void BudgetedRunner::StartWorker()
+    {
+        worker_ = std::make_shared<Worker>();
+        thread_ = std::thread(WorkerLoop, worker_, options_.threadStart, options_.threadExit, abandoned_);
+    }
+
+    void BudgetedRunner::WorkerLoop(std::shared_ptr<Worker> worker, std::function<void()> threadStart,
+                                    std::function<void()> threadExit, std::shared_ptr<std::atomic<size_t>> abandoned)
+    {
+        if (threadStart)
+            threadStart();
+        std::unique_lock<std::mutex> lock(worker->mutex);
+        for (;;)
+        {
+            worker->cv.wait(lock, [&worker] { return worker->pending || worker->stop; });
+            if (!worker->pending)
+                break;
+            std::function<void()> job = std::move(worker->job);
+            worker->pending = false;
+            lock.unlock();
+            job();
+            // Captures go before the runner hears back, so none outlive an on-time job.
+            job = nullptr;
+            lock.lock();
+            worker->done = true;
+            worker->cv.notify_all();
+            if (worker->stop)
+            {
+                // Abandoned while running the job.
+                abandoned->fetch_sub(1);
+                break;
+            }
+        }
+        lock.unlock();
+        if (threadExit)
+            threadExit();
+    }
+
+    bool BudgetedRunner::Run(std::function<void()> job)
+    {
+        std::lock_guard<std::mutex> lock(runMutex_);
+        if (Saturated())
+        {
+            std::lock_guard<std::mutex> guard(statsMutex_);
+            ++refused_;
+            return false;
+        }
+        if (!worker_)
+            StartWorker();
+
+        const Clock::time_point start = Clock::now();
+        std::unique_lock<std::mutex> guard(worker_->mutex);
+        worker_->job = std::move(job);
+        worker_->pending = true;
+        worker_->done = false;
+        worker_->cv.notify_all();
+        if (worker_->cv.wait_until(guard, start + options_.budget, [this] { return worker_->done; }))
+        {
+            guard.unlock();
+            RecordLatency(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start));
+            std::lock_guard<std::mutex> stats(statsMutex_);
+            ++completed_;
+            return true;
+        }
+
+        // Leave the job to finish on its own thread; the worker exits after it.
+        worker_->stop = true;
+        abandoned_->fetch_add(1);
+        guard.unlock();
+        thread_.detach();
+        worker_.reset();
+        RecordLatency(options_.budget);
+        std::lock_guard<std::mutex> stats(statsMutex_);
+        ++overran_;
+        return false;
+    }
+
+    bool BudgetedRunner::Saturated() const
+    {
+        return abandoned_->load() >= options_.maxAbandoned;
+    }
+
+    void BudgetedRunner::RecordLatency(std::chrono::microseconds latency)
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        if (options_.latencySamples == 0)
+            return;
+        if (samples_.size() < options_.latencySamples)
+            samples_.push_back(latency);
+        else
+            samples_[nextSample_] = latency;
+        nextSample_ = (nextSample_ + 1) % options_.latencySamples;
+    }
+
+    BudgetedRunner::Stats BudgetedRunner::GetStats() const
+    {
+        Stats stats;
+        std::vector<std::chrono::microseconds> sorted;
+        {
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            stats.completed = completed_;
+            stats.overran = overran_;
+            stats.refused = refused_;
+            sorted = samples_;
+        }
+        stats.abandoned = abandoned_->load();
+        if (sorted.empty())
+            return stats;
+        std::sort(sorted.begin(), sorted.end());
+        // Nearest-rank percentiles.
+        const auto rank = [&sorted](size_t percent) {
+            const size_t index = (sorted.size() * percent + 99) / 100;
+            return sorted[std::max<size_t>(index, 1) - 1];
+        };
+        stats.p50 = rank(50);
+        stats.p95 = rank(95);
+        stats.p99 = rank(99);
+        stats.max = sorted.back();
+        return stats;
+    }
+
+} // namespace utils
@@ -0,0 +1,108 @@
+#ifndef BUDGETED_RUNNER_H
+#define BUDGETED_RUNNER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace utils
+{
+
+    /**
+     * @brief Runs jobs one at a time on a worker thread and stops waiting for any that overrun a time budget.
+     *
+     * @details A job that is still running when |budget| expires is abandoned, not
+     *          interrupted: its thread is detached and keeps the job's captures alive
+     *          until the job returns, and the next Run() starts a fresh worker. Jobs
+     *          must therefore own (or share) everything they touch. Once
+     *          |maxAbandoned| threads are stuck this way the runner is saturated and
+     *          refuses new jobs rather than leak more threads.
+     *
+     *          |threadStart| and |threadExit| run on every worker thread around its
+     *          jobs, e.g. to initialize COM.
+     *
+     *          The latency of the last |latencySamples| jobs is kept for GetStats();
+     *          an overrun counts as the full budget. Run() is serialized; the other
+     *          members are thread-safe.
+     */
+    class BudgetedRunner
+    {
+    public:
+        struct Options
+        {
+            std::chrono::milliseconds budget{std::chrono::seconds(2)};
+            size_t maxAbandoned = 4;
+            size_t latencySamples = 1024;
+            std::function<void()> threadStart;
+            std::function<void()> threadExit;
+        };
+
+        struct Stats
+        {
+            size_t completed = 0;
+            size_t overran = 0;
+            size_t refused = 0;  // Not started because the runner was saturated
+            size_t abandoned = 0; // Overrunning jobs still running now
+            std::chrono::microseconds p50{0};
+            std::chrono::microseconds p95{0};
+            std::chrono::microseconds p99{0};
+            std::chrono::microseconds max{0};
+        };
+
+        BudgetedRunner();
+        explicit BudgetedRunner(Options options);
+        // Stops the current worker once its job is done; abandoned jobs finish on their own.
+        ~BudgetedRunner();
+
+        BudgetedRunner(const BudgetedRunner &) = delete;
+        BudgetedRunner &operator=(const BudgetedRunner &) = delete;
+
+        // Returns true if |job| finished within the budget, false if it overran or
+        // was refused.
+        bool Run(std::function<void()> job);
+
+        // Runs |job| and returns its result, or nullopt if it overran or was refused.
+        template <typename Result>
+        std::optional<Result> Call(std::function<Result()> job)
+        {
+            // Shared, because an abandoned job still writes its result.
+            auto slot = std::make_shared<std::optional<Result>>();
+            if (!Run([slot, job = std::move(job)] { *slot = job(); }))
+                return std::nullopt;
+            return std::move(*slot);
+        }
+
+        bool Saturated() const;
+        Stats GetStats() const;
+
+    private:
+        struct Worker;
+
+        static void WorkerLoop(std::shared_ptr<Worker> worker, std::function<void()> threadStart,
+                               std::function<void()> threadExit, std::shared_ptr<std::atomic<size_t>> abandoned);
+        void StartWorker();
+        void RecordLatency(std::chrono::microseconds latency);
+
+        const Options options_;
+        std::mutex runMutex_;
+        std::shared_ptr<Worker> worker_;
+        std::thread thread_;
+        std::shared_ptr<std::atomic<size_t>> abandoned_;
+
+        mutable std::mutex statsMutex_;
+        std::vector<std::chrono::microseconds> samples_; // Ring of the latest latencies
+        size_t nextSample_ = 0;
+        size_t completed_ = 0;
+        size_t overran_ = 0;
+        size_t refused_ = 0;
+    };
+
+} // namespace utils
+
+#endif // BUDGETED_RUNNER_H
@@ -0,0 +1,53 @@
+#include "CancellationToken.h"
+
+namespace utils
+{
+
+    CancellationToken CancellationRegistry::Register(int64_t seq)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        CancellationSource &source = active_[seq];
+        if (anyCancelled_ && seq <= cancelledThrough_)
+        {
+            source.Cancel();
+        }
+        return source.Token();
+    }
+
+    void CancellationRegistry::CancelThrough(int64_t seq)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!anyCancelled_ || seq > cancelledThrough_)
+        {
+            cancelledThrough_ = seq;
+            anyCancelled_ = true;
+        }
+        auto end = active_.upper_bound(seq);
+        for (auto it = active_.begin(); it != end; ++it)
+        {
+            it->second.Cancel();
+        }
+        // Cancelled jobs still call Release() when they unwind; dropping them here
+        // keeps the map from growing if a job never finishes.
+        active_.erase(active_.begin(), end);
+    }
+
+    void CancellationRegistry::Release(int64_t seq)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        active_.erase(seq);
+    }
+
+    void CancellationRegistry::Reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &entry : active_)
+        {
+            entry.second.Cancel();
+        }
+        active_.clear();
+        cancelledThrough_ = INT64_MIN;
+        anyCancelled_ = false;
+    }
+
+} // namespace utils
@@ -0,0 +1,85 @@
+#ifndef CANCELLATION_TOKEN_H
+#define CANCELLATION_TOKEN_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace utils
+{
+
+    /**
+     * @brief Read-only view of a cancellation flag shared with a CancellationSource.
+     *
+     * @details Cheap to copy and safe to poll from any thread. A default-constructed
+     *          token is never cancelled, so callers that don't care can pass `{}`.
+     *          Long-running loops are expected to poll IsCancelled() once per row /
+     *          entry and bail out early.
+     */
+    class CancellationToken
+    {
+    public:
+        CancellationToken() = default;
+
+        bool IsCancelled() const
+        {
+            return flag_ && flag_->load(std::memory_order_relaxed);
+        }
+
+    private:
+        friend class CancellationSource;
+        explicit CancellationToken(std::shared_ptr<const std::atomic<bool>> flag) : flag_(std::move(flag)) {}
+
+        std::shared_ptr<const std::atomic<bool>> flag_;
+    };
+
+    /**
+     * @brief Owner side of a cancellation flag. Cancel() is sticky and thread-safe.
+     */
+    class CancellationSource
+    {
+    public:
+        CancellationSource() : flag_(std::make_shared<std::atomic<bool>>(false)) {}
+
+        CancellationToken Token() const { return CancellationToken(flag_); }
+        void Cancel() { flag_->store(true, std::memory_order_relaxed); }
+        bool IsCancelled() const { return flag_->load(std::memory_order_relaxed); }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> flag_;
+    };
+
+    /**
+     * @brief Maps Dart-side search sequence numbers to cancellation sources.
+     *
+     * @details Sequence numbers are monotonic on the Dart side, so CancelThrough(seq)
+     *          cancels every job registered with a sequence <= seq. The high-water
+     *          mark is remembered, which makes a cancel that overtakes its own
+     *          Register() call (the two travel through different isolates) harmless:
+     *          the late registration simply receives an already-cancelled token.
+     *
+     *          The mark outlives no Dart session: when Dart starts numbering
+     *          again (hot restart, new SearchCubit) it calls Reset(), or every
+     *          new search would register already cancelled.
+     */
+    class CancellationRegistry
+    {
+    public:
+        CancellationToken Register(int64_t seq);
+        void CancelThrough(int64_t seq);
+        void Release(int64_t seq);
+        // Cancels every registered job and forgets the high-water mark.
+        void Reset();
+
+    private:
+        std::mutex mutex_;
+        std::map<int64_t, CancellationSource> active_;
+        int64_t cancelledThrough_ = INT64_MIN;
+        bool anyCancelled_ = false;
+    };
+
+} // namespace utils
+
+#endif // CANCELLATION_TOKEN_H
@@ -0,0 +1,113 @@
+#include "ChangeDebouncer.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace SearchEngine
+{
+
+    namespace
+    {
+        // Net effect of |previous| followed by |next| on the same path; false if the
+        // two cancel out.
+        bool Merge(FileChange previous, FileChange next, FileChange &merged)
+        {
+            if (previous == FileChange::Added && next == FileChange::Removed)
+                return false;
+            if (previous == FileChange::Added && next == FileChange::Modified)
+                merged = FileChange::Added;
+            else if (previous == FileChange::Removed && next == FileChange::Added)
+                merged = FileChange::Modified;
+            else
+                merged = next;
+            return true;
+        }
+    } // namespace
+
+    ChangeDebouncer::ChangeDebouncer(FlushCallback onFlush, std::chrono::milliseconds quiet, std::chrono::milliseconds maxDelay)
+        : onFlush_(std::move(onFlush)), quiet_(quiet), maxDelay_(maxDelay)
+    {
+        thread_ = std::thread([this]() { Run(); });
+    }
+
+    ChangeDebouncer::~ChangeDebouncer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    void ChangeDebouncer::Add(std::vector<FileEvent> &&events)
+    {
+        if (events.empty())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const Clock::time_point now = Clock::now();
+            if (pending_.empty() && overflowRoots_.empty())
+                firstEvent_ = now;
+            lastEvent_ = now;
+
+            for (FileEvent &event : events)
+            {
+                if (event.change == FileChange::Overflow)
+                {
+                    if (std::find(overflowRoots_.begin(), overflowRoots_.end(), event.path) == overflowRoots_.end())
+                        overflowRoots_.push_back(std::move(event.path));
+                    continue;
+                }
+                auto it = pending_.find(event.path);
+                if (it == pending_.end())
+                {
+                    pending_.emplace(std::move(event.path), event.change);
+                    continue;
+                }
+                FileChange merged;
+                if (Merge(it->second, event.change, merged))
+                    it->second = merged;
+                else
+                    pending_.erase(it);
+            }
+        }
+        cv_.notify_all();
+    }
+
+    void ChangeDebouncer::Run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;)
+        {
+            cv_.wait(lock, [this]() { return stopping_ || !pending_.empty() || !overflowRoots_.empty(); });
+            if (stopping_)
+                return;
+
+            // Wait for a quiet period, bounded by maxDelay since the first event.
+            for (;;)
+            {
+                const Clock::time_point flushAt = std::min(lastEvent_ + quiet_, firstEvent_ + maxDelay_);
+                if (Clock::now() >= flushAt)
+                    break;
+                cv_.wait_until(lock, flushAt, [this]() { return stopping_; });
+                if (stopping_)
+                    return;
+            }
+
+            std::vector<FileEvent> batch;
+            // A lost-events rescan covers everything below its root; list it first.
+            for (std::string &root : overflowRoots_)
+                batch.push_back({FileChange::Overflow, std::move(root)});
+            for (auto &[path, change] : pending_)
+                batch.push_back({change, path});
+            overflowRoots_.clear();
+            pending_.clear();
+
+            lock.unlock();
+            onFlush_(std::move(batch));
+            lock.lock();
+        }
+    }
+
+} // namespace SearchEngine
@@ -0,0 +1,66 @@
+#ifndef CHANGE_DEBOUNCER_H
+#define CHANGE_DEBOUNCER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DirectoryWatcher.h"
+
+namespace SearchEngine
+{
+
+    /**
+     * @brief Coalesces raw watcher events and flushes them once the tree is quiet.
+     *
+     * @details An installer touches the same shortcut several times in a row
+     *          (create, write, rename), so events are merged per path: Added then
+     *          Removed cancels out, Removed then Added becomes Modified, and so on.
+     *          The merged batch is handed to |onFlush| on the debouncer's own thread
+     *          after |quiet| has passed without new events, or after |maxDelay| at the
+     *          latest while events keep arriving.
+     */
+    class ChangeDebouncer
+    {
+    public:
+        using FlushCallback = std::function<void(std::vector<FileEvent> &&)>;
+
+        ChangeDebouncer(FlushCallback onFlush,
+                        std::chrono::milliseconds quiet = std::chrono::milliseconds(300),
+                        std::chrono::milliseconds maxDelay = std::chrono::milliseconds(2000));
+        // Drops anything still pending.
+        ~ChangeDebouncer();
+
+        ChangeDebouncer(const ChangeDebouncer &) = delete;
+        ChangeDebouncer &operator=(const ChangeDebouncer &) = delete;
+
+        // Thread-safe; suitable as a DirectoryWatcher callback.
+        void Add(std::vector<FileEvent> &&events);
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        void Run();
+
+        FlushCallback onFlush_;
+        const std::chrono::milliseconds quiet_;
+        const std::chrono::milliseconds maxDelay_;
+
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::map<std::string, FileChange> pending_;
+        std::vector<std::string> overflowRoots_;
+        Clock::time_point firstEvent_;
+        Clock::time_point lastEvent_;
+        bool stopping_ = false;
+        std::thread thread_;
+    };
+
+} // namespace SearchEngine
+
+#endif // CHANGE_DEBOUNCER_H
@@ -0,0 +1,181 @@
+#include "ChildProcess.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+#include "common_utils.h"
+#else
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+#endif
+
+namespace utils
+{
+
+#ifdef _WIN32
+
+    namespace
+    {
+        // Quotes one argument so CommandLineToArgvW gives it back unchanged.
+        void AppendQuoted(std::wstring &line, const std::wstring &argument)
+        {
+            if (!argument.empty() && argument.find_first_of(L" \t\n\v\"") == std::wstring::npos)
+            {
+                line += argument;
+                return;
+            }
+            line += L'"';
+            size_t backslashes = 0;
+            for (wchar_t c : argument)
+            {
+                if (c == L'\\')
+                {
+                    ++backslashes;
+                    continue;
+                }
+                // Backslashes only need doubling in front of a quote.
+                line.append(c == L'"' ? backslashes * 2 + 1 : backslashes, L'\\');
+                line += c;
+                backslashes = 0;
+            }
+            line.append(backslashes * 2, L'\\');
+            line += L'"';
+        }
+    } // namespace
+
+    std::unique_ptr<ChildProcess> ChildProcess::Spawn(const std::vector<std::string> &argv)
+    {
+        if (argv.empty())
+            return nullptr;
+        std::wstring commandLine;
+        for (const std::string &argument : argv)
+        {
+            if (!commandLine.empty())
+                commandLine += L' ';
+            AppendQuoted(commandLine, Utf8ToWide(argument));
+        }
+
+        HANDLE job = CreateJobObjectW(nullptr, nullptr);
+        if (job)
+        {
+            JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits = {};
+            limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+            SetInformationJobObject(job, JobObjectExtendedLimitInformation, &limits, sizeof(limits));
+        }
+
+        const std::wstring executable = Utf8ToWide(argv[0]);
+        STARTUPINFOW startup = {};
+        startup.cb = sizeof(startup);
+        PROCESS_INFORMATION info = {};
+        // Suspended until it is in the job, so nothing it starts can escape.
+        if (!CreateProcessW(executable.c_str(), commandLine.data(), nullptr, nullptr, FALSE,
+                            CREATE_NO_WINDOW | CREATE_SUSPENDED | BELOW_NORMAL_PRIORITY_CLASS,
+                            nullptr, nullptr, &startup, &info))
+        {
+            if (job)
+                CloseHandle(job);
+            return nullptr;
+        }
+        if (job)
+            AssignProcessToJobObject(job, info.hProcess);
+        ResumeThread(info.hThread);
+        CloseHandle(info.hThread);
+
+        std::unique_ptr<ChildProcess> child(new ChildProcess());
+        child->process_ = info.hProcess;
+        child->job_ = job;
+        return child;
+    }
+
+    ChildProcess::~ChildProcess()
+    {
+        if (IsRunning())
+        {
+            Kill();
+            WaitForSingleObject(process_, INFINITE);
+        }
+        if (process_)
+            CloseHandle(process_);
+        if (job_)
+            CloseHandle(job_);
+    }
+
+    bool ChildProcess::IsRunning()
+    {
+        return !ExitCode().has_value();
+    }
+
+    void ChildProcess::Kill()
+    {
+        TerminateProcess(process_, 1);
+    }
+
+    std::optional<int> ChildProcess::ExitCode()
+    {
+        if (!exitCode_ && WaitForSingleObject(process_, 0) == WAIT_OBJECT_0)
+        {
+            DWORD code = 0;
+            GetExitCodeProcess(process_, &code);
+            exitCode_ = static_cast<int>(code);
+        }
+        return exitCode_;
+    }
+
+#else
+
+    std::unique_ptr<ChildProcess> ChildProcess::Spawn(const std::vector<std::string> &argv)
+    {
+        if (argv.empty())
+            return nullptr;
+        std::vector<char *> args;
+        for (const std::string &argument : argv)
+            args.push_back(const_cast<char *>(argument.c_str()));
+        args.push_back(nullptr);
+
+        pid_t pid = -1;
+        if (posix_spawn(&pid, args[0], nullptr, nullptr, args.data(), environ) != 0)
+            return nullptr;
+        std::unique_ptr<ChildProcess> child(new ChildProcess());
+        child->pid_ = pid;
+        return child;
+    }
+
+    ChildProcess::~ChildProcess()
+    {
+        if (!exitCode_)
+        {
+            Kill();
+            int status = 0;
+            waitpid(pid_, &status, 0);
+        }
+    }
+
+    bool ChildProcess::IsRunning()
+    {
+        return !ExitCode().has_value();
+    }
+
+    void ChildProcess::Kill()
+    {
+        if (!exitCode_)
+            kill(pid_, SIGKILL);
+    }
+
+    std::optional<int> ChildProcess::ExitCode()
+    {
+        if (!exitCode_)
+        {
+            int status = 0;
+            if (waitpid(pid_, &status, WNOHANG) == pid_)
+                exitCode_ = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+        }
+        return exitCode_;
+    }
+
+#endif
+
+} // namespace utils
@@ -0,0 +1,50 @@
+#ifndef CHILD_PROCESS_H
+#define CHILD_PROCESS_H
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace utils
+{
+
+    /**
+     * @brief A helper process started by the launcher, killed if it is still running when released.
+     *
+     * @details On Windows the child is also put in a kill-on-close job object, so
+     *          it does not outlive the launcher if the launcher itself dies.
+     */
+    class ChildProcess
+    {
+    public:
+        // |argv[0]| is the executable path; arguments are UTF-8. nullptr if the
+        // process cannot be started.
+        static std::unique_ptr<ChildProcess> Spawn(const std::vector<std::string> &argv);
+
+        // Kills the child if it is still running and waits for it.
+        ~ChildProcess();
+
+        ChildProcess(const ChildProcess &) = delete;
+        ChildProcess &operator=(const ChildProcess &) = delete;
+
+        bool IsRunning();
+        void Kill();
+        // Exit code once it has exited; nullopt while it runs.
+        std::optional<int> ExitCode();
+
+    private:
+        ChildProcess() = default;
+
+#ifdef _WIN32
+        void *process_ = nullptr;
+        void *job_ = nullptr;
+#else
+        int pid_ = -1;
+#endif
+        std::optional<int> exitCode_;
+    };
+
+} // namespace utils
+
+#endif // CHILD_PROCESS_H
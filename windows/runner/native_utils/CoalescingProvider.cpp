@@ -0,0 +1,113 @@
+#include "CoalescingProvider.h"
+
+#include <future>
+#include <utility>
+
+#include "QueryArena.h"
+
+namespace SearchEngine
+{
+
+    struct CoalescingProvider::State
+    {
+        using Flights = utils::SingleFlight<std::string, std::vector<utils::Program>>;
+
+        State(std::shared_ptr<SearchProvider> provider, std::shared_ptr<utils::ConcurrencyLimiter> calls)
+            : inner(std::move(provider)), limiter(std::move(calls)) {}
+
+        static void Join(const std::shared_ptr<State> &state, const std::string &query,
+                         const utils::CancellationToken &token, Completion done)
+        {
+            auto onLanded = [state, query, token, done = std::move(done)](const Flights::Result &result, bool sole) mutable {
+                if (!result)
+                {
+                    // The flight's own query was cancelled before it finished.
+                    if (token.IsCancelled())
+                        done({});
+                    else
+                        Join(state, query, token, std::move(done));
+                    return;
+                }
+                if (sole)
+                {
+                    done(std::move(*result));
+                    return;
+                }
+                std::vector<utils::Program> copy;
+                copy.reserve(result->size());
+                for (const utils::Program &program : *result)
+                    copy.push_back(CloneProgram(program));
+                done(std::move(copy));
+            };
+            std::shared_ptr<Flights::Flight> flight = state->flights.Join(query, token, std::move(onLanded));
+            if (!flight)
+                return;
+
+            state->limiter->Post(utils::TaskPriority::Interactive, [state, flight, query, token]() {
+                Flights::Result result;
+                if (!token.IsCancelled())
+                {
+                    try
+                    {
+                        utils::QueryArena::Scope arena;
+                        result = std::make_shared<std::vector<utils::Program>>(state->inner->Search(query, token));
+                    }
+                    catch (...)
+                    {
+                        state->flights.Land(flight, std::make_shared<std::vector<utils::Program>>());
+                        throw;
+                    }
+                }
+                // Cut short by the cancellation, so not what the others asked for.
+                if (token.IsCancelled())
+                    result = nullptr;
+                state->flights.Land(flight, std::move(result));
+            });
+        }
+
+        const std::shared_ptr<SearchProvider> inner;
+        const std::shared_ptr<utils::ConcurrencyLimiter> limiter;
+        Flights flights; // Keyed by query
+    };
+
+    CoalescingProvider::CoalescingProvider(std::shared_ptr<SearchProvider> inner,
+                                           std::shared_ptr<utils::ConcurrencyLimiter> limiter)
+        : state_(std::make_shared<State>(std::move(inner), std::move(limiter)))
+    {
+    }
+
+    const char *CoalescingProvider::Name() const
+    {
+        return state_->inner->Name();
+    }
+
+    bool CoalescingProvider::IsExpensive() const
+    {
+        return state_->inner->IsExpensive();
+    }
+
+    std::vector<utils::Program> CoalescingProvider::Search(const std::string &query, const utils::CancellationToken &token)
+    {
+        auto answered = std::make_shared<std::promise<std::vector<utils::Program>>>();
+        std::future<std::vector<utils::Program>> results = answered->get_future();
+        SearchAsync(query, token, [answered](std::vector<utils::Program> &&programs) {
+            answered->set_value(std::move(programs));
+        });
+        return results.get();
+    }
+
+    void CoalescingProvider::SearchAsync(const std::string &query, const utils::CancellationToken &token, Completion done)
+    {
+        State::Join(state_, query, token, std::move(done));
+    }
+
+    CoalescingProvider::Stats CoalescingProvider::GetStats() const
+    {
+        const State::Flights::Stats flights = state_->flights.GetStats();
+        Stats stats;
+        stats.searches = flights.started;
+        stats.joined = flights.joined;
+        return stats;
+    }
+
+} // namespace SearchEngine
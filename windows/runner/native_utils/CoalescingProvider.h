@@ -0,0 +1,64 @@
+#ifndef COALESCING_PROVIDER_H
+#define COALESCING_PROVIDER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "ConcurrencyLimiter.h"
+#include "Program.h"
+#include "SearchProviders.h"
+#include "SingleFlight.h"
+
+namespace SearchEngine
+{
+
+    /**
+     * @brief Puts an expensive provider behind a SingleFlight and a
+     *        ConcurrencyLimiter.
+     *
+     * @details Identical queries that overlap share one inner Search(), and
+     *          inner searches queue for |limiter| along with the other calls
+     *          that are expensive outside this process, holding no worker while
+     *          they wait. A search whose query was cancelled before its turn
+     *          never starts.
+     *
+     *          A flight runs under the token of the query that started it. If
+     *          that is cancelled, its partial results go to nobody: queries
+     *          that joined it and are still live start or join a new flight.
+     *          If the inner provider throws, the queries that shared the call
+     *          get no results and the limiter counts the failure.
+     *
+     *          Flights keep the inner provider and the limiter's state alive
+     *          until they land. Queries still queued when the limiter is
+     *          destroyed never answer.
+     */
+    class CoalescingProvider : public SearchProvider
+    {
+    public:
+        struct Stats
+        {
+            uint64_t searches = 0; // Flights started, including ones cancelled before their turn
+            uint64_t joined = 0;   // Queries that shared one already running
+        };
+
+        CoalescingProvider(std::shared_ptr<SearchProvider> inner, std::shared_ptr<utils::ConcurrencyLimiter> limiter);
+
+        const char *Name() const override;
+        bool IsExpensive() const override;
+        // Blocks until the shared search has answered.
+        std::vector<utils::Program> Search(const std::string &query, const utils::CancellationToken &token) override;
+        void SearchAsync(const std::string &query, const utils::CancellationToken &token, Completion done) override;
+
+        Stats GetStats() const;
+
+    private:
+        struct State;
+        std::shared_ptr<State> state_; // Shared with the flights in the air
+    };
+
+} // namespace SearchEngine
+
+#endif // COALESCING_PROVIDER_H
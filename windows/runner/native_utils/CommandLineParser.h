@@ -0,0 +1,292 @@
+#ifndef COMMAND_LINE_PARSER_H
+#define COMMAND_LINE_PARSER_H
+
+#include <cstddef>
+#include <string_view>
+
+namespace utils
+{
+
+    /**
+     * @brief Splits a Windows command line the way CommandLineToArgvW does, without allocating.
+     *
+     * @details The program name follows the argv[0] rules: a leading quote runs to the
+     *          next quote with no escapes, otherwise it ends at the first space or
+     *          tab. Later arguments follow the argument rules: whitespace separates
+     *          outside quotes, 2n backslashes before a quote become n and the quote
+     *          toggles quoting, 2n+1 become n and a literal quote, other backslashes
+     *          are literal, and a doubled quote inside quotes is a literal quote that
+     *          also ends the quoted run.
+     *
+     *          Everything handed out is a view into the source line. Arguments come
+     *          back raw (as written); Unescape() decodes one into a caller buffer when
+     *          the decoded form is actually needed. Works on char and wchar_t so the
+     *          rules can be checked off Windows.
+     */
+    template <typename Char>
+    class BasicCommandLineParser
+    {
+    public:
+        using View = std::basic_string_view<Char>;
+
+        explicit BasicCommandLineParser(View line) : line_(line)
+        {
+            size_t pos = 0;
+            if (!line_.empty() && line_[0] == Char('"'))
+            {
+                const size_t close = line_.find(Char('"'), 1);
+                program_ = line_.substr(1, close == View::npos ? View::npos : close - 1);
+                pos = close == View::npos ? line_.size() : close + 1;
+            }
+            else
+            {
+                while (pos < line_.size() && !IsBlank(line_[pos]))
+                    ++pos;
+                program_ = line_.substr(0, pos);
+            }
+            while (pos < line_.size() && IsBlank(line_[pos]))
+                ++pos;
+            arguments_ = line_.substr(pos);
+            next_ = pos;
+        }
+
+        // argv[0] with its quotes removed; never needs unescaping.
+        View Program() const { return program_; }
+
+        // Everything after the program name and the whitespace that follows it,
+        // exactly as written.
+        View Arguments() const { return arguments_; }
+
+        // The next raw argument, quotes and escapes included. False once exhausted.
+        bool NextArgument(View &raw)
+        {
+            if (next_ >= line_.size())
+                return false;
+            size_t length = 0;
+            const size_t end = Scan(line_, next_, nullptr, 0, length);
+            raw = line_.substr(next_, end - next_);
+            next_ = end;
+            while (next_ < line_.size() && IsBlank(line_[next_]))
+                ++next_;
+            return true;
+        }
+
+        // Decodes a raw argument from NextArgument(). Writes at most |capacity|
+        // characters to |out| and returns the full decoded length, which may be
+        // larger; no terminator is written.
+        static size_t Unescape(View raw, Char *out, size_t capacity)
+        {
+            size_t length = 0;
+            Scan(raw, 0, out, capacity, length);
+            return length;
+        }
+
+        // True if |raw| decodes to itself; quotes are the only thing that changes
+        // an argument, and backslashes only matter in front of one.
+        static bool IsVerbatim(View raw) { return raw.find(Char('"')) == View::npos; }
+
+        static bool IsBlank(Char c) { return c == Char(' ') || c == Char('\t'); }
+
+    private:
+        // Runs the argument state machine from |pos| to the end of one argument and
+        // returns where it stopped. |length| is the decoded length; characters that
+        // fit are written to |out|. A backslash run is written as-is and trimmed
+        // when a quote turns out to follow it.
+        static size_t Scan(View s, size_t pos, Char *out, size_t capacity, size_t &length)
+        {
+            const auto put = [&](Char c) {
+                if (out && length < capacity)
+                    out[length] = c;
+                ++length;
+            };
+
+            size_t quotes = 0;
+            size_t backslashes = 0;
+            while (pos < s.size())
+            {
+                const Char c = s[pos];
+                if (IsBlank(c) && quotes == 0)
+                    break;
+                if (c == Char('\\'))
+                {
+                    put(c);
+                    ++backslashes;
+                    ++pos;
+                    continue;
+                }
+                if (c != Char('"'))
+                {
+                    put(c);
+                    backslashes = 0;
+                    ++pos;
+                    continue;
+                }
+
+                if (backslashes % 2 == 0)
+                {
+                    length -= backslashes / 2;
+                    ++quotes;
+                }
+                else
+                {
+                    length -= backslashes / 2 + 1;
+                    put(Char('"'));
+                }
+                backslashes = 0;
+                ++pos;
+                // Runs of quotes: every third one is literal.
+                while (pos < s.size() && s[pos] == Char('"'))
+                {
+                    if (++quotes == 3)
+                    {
+                        put(Char('"'));
+                        quotes = 0;
+                    }
+                    ++pos;
+                }
+                if (quotes == 2)
+                    quotes = 0;
+            }
+            return pos;
+        }
+
+        View line_;
+        View program_;
+        View arguments_;
+        size_t next_ = 0;
+    };
+
+    using CommandLineParser = BasicCommandLineParser<char>;
+    using WideCommandLineParser = BasicCommandLineParser<wchar_t>;
+
+    enum class UninstallForm
+    {
+        Command,  // Any other executable
+        MsiExec,  // MsiExec.exe /X{ProductCode} and friends
+        Rundll32, // rundll32.exe "path\to.dll",Entry ...
+    };
+
+    template <typename Char>
+    struct UninstallCommand
+    {
+        std::basic_string_view<Char> program;   // Without quotes
+        std::basic_string_view<Char> arguments; // Raw, as written
+        UninstallForm form = UninstallForm::Command;
+        // The product code (braces included) for MsiExec, the DLL path for Rundll32.
+        std::basic_string_view<Char> target;
+        // False if an unquoted program was cut at the first blank because no
+        // ".exe" boundary was found; the whole line may still name a file.
+        bool exactProgram = true;
+    };
+
+    namespace detail
+    {
+        template <typename Char>
+        Char FoldAscii(Char c)
+        {
+            return (c >= Char('A') && c <= Char('Z')) ? static_cast<Char>(c - Char('A') + Char('a')) : c;
+        }
+
+        // Case-insensitive ASCII comparison against a lowercase literal.
+        template <typename Char>
+        bool EqualsFolded(std::basic_string_view<Char> text, const char *lower)
+        {
+            size_t i = 0;
+            for (; lower[i] != '\0'; ++i)
+            {
+                if (i >= text.size() || FoldAscii(text[i]) != static_cast<Char>(lower[i]))
+                    return false;
+            }
+            return i == text.size();
+        }
+
+        // The file name of |path| without a trailing ".exe".
+        template <typename Char>
+        std::basic_string_view<Char> BaseName(std::basic_string_view<Char> path)
+        {
+            size_t start = path.size();
+            while (start > 0 && path[start - 1] != Char('\\') && path[start - 1] != Char('/'))
+                --start;
+            std::basic_string_view<Char> name = path.substr(start);
+            if (name.size() >= 4 && EqualsFolded(name.substr(name.size() - 4), ".exe"))
+                name.remove_suffix(4);
+            return name;
+        }
+    } // namespace detail
+
+    /**
+     * @brief Splits an Uninstall registry command into program and arguments.
+     *
+     * @details Quoted programs follow the argv[0] rules. Unquoted ones commonly
+     *          contain spaces ("C:\Program Files\App\uninst.exe /S"), so the program
+     *          ends at the first ".exe" that is followed by a blank or the end, which
+     *          is where CreateProcess would find it; without one it ends at the first
+     *          blank. MsiExec and rundll32 commands also expose their target.
+     */
+    template <typename Char>
+    UninstallCommand<Char> ParseUninstallString(std::basic_string_view<Char> line)
+    {
+        using View = std::basic_string_view<Char>;
+        while (!line.empty() && BasicCommandLineParser<Char>::IsBlank(line.front()))
+            line.remove_prefix(1);
+
+        UninstallCommand<Char> command;
+        bool split = false;
+        if (line.empty() || line.front() != Char('"'))
+        {
+            for (size_t i = 0; i + 4 <= line.size(); ++i)
+            {
+                const size_t end = i + 4;
+                if (detail::EqualsFolded(line.substr(i, 4), ".exe") &&
+                    (end == line.size() || BasicCommandLineParser<Char>::IsBlank(line[end])))
+                {
+                    command.program = line.substr(0, end);
+                    size_t pos = end;
+                    while (pos < line.size() && BasicCommandLineParser<Char>::IsBlank(line[pos]))
+                        ++pos;
+                    command.arguments = line.substr(pos);
+                    split = true;
+                    break;
+                }
+            }
+        }
+        if (!split)
+        {
+            BasicCommandLineParser<Char> parser(line);
+            command.program = parser.Program();
+            command.arguments = parser.Arguments();
+            command.exactProgram = line.empty() || line.front() == Char('"') || command.arguments.empty();
+        }
+
+        const View name = detail::BaseName(command.program);
+        if (detail::EqualsFolded(name, "msiexec"))
+        {
+            command.form = UninstallForm::MsiExec;
+            const size_t open = command.arguments.find(Char('{'));
+            const size_t close = open == View::npos ? View::npos : command.arguments.find(Char('}'), open);
+            if (close != View::npos)
+                command.target = command.arguments.substr(open, close - open + 1);
+        }
+        else if (detail::EqualsFolded(name, "rundll32"))
+        {
+            command.form = UninstallForm::Rundll32;
+            View args = command.arguments;
+            if (!args.empty() && args.front() == Char('"'))
+            {
+                const size_t close = args.find(Char('"'), 1);
+                command.target = args.substr(1, close == View::npos ? View::npos : close - 1);
+            }
+            else
+            {
+                size_t end = 0;
+                while (end < args.size() && args[end] != Char(',') && !BasicCommandLineParser<Char>::IsBlank(args[end]))
+                    ++end;
+                command.target = args.substr(0, end);
+            }
+        }
+        return command;
+    }
+
+} // namespace utils
+
+#endif // COMMAND_LINE_PARSER_H
@@ -0,0 +1,145 @@
+#include "ConcurrencyLimiter.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace utils
+{
+
+    struct ConcurrencyLimiter::State
+    {
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr size_t kPriorities = 3;
+
+        struct Waiting
+        {
+            TaskPriority priority = TaskPriority::Interactive;
+            TaskExecutor::Task task;
+            Clock::time_point since;
+        };
+
+        State(size_t maxRunning, TaskExecutor &pool) : limit(std::max<size_t>(maxRunning, 1)), executor(pool) {}
+
+        // Passes the slot on when it goes out of scope, however the task ended.
+        struct SlotRelease
+        {
+            ~SlotRelease() { Finish(state); }
+            std::shared_ptr<State> state;
+        };
+
+        // Runs |task| on the executor; the slot it holds passes on when it ends.
+        // An exception ends the task, not the worker.
+        static void Start(const std::shared_ptr<State> &state, TaskPriority priority, TaskExecutor::Task task)
+        {
+            state->executor.Post(priority, [state, task = std::move(task)]() {
+                SlotRelease release{state};
+                try
+                {
+                    task();
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    ++state->stats.failed;
+                }
+            });
+        }
+
+        static void Finish(const std::shared_ptr<State> &state)
+        {
+            Waiting next;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                std::deque<Waiting> *queue = nullptr;
+                for (std::deque<Waiting> &candidate : state->queues)
+                {
+                    if (!candidate.empty())
+                    {
+                        queue = &candidate;
+                        break;
+                    }
+                }
+                if (state->stopped || !queue)
+                {
+                    if (--state->stats.running == 0)
+                        state->idle.notify_all();
+                    return;
+                }
+                next = std::move(queue->front());
+                queue->pop_front();
+                --state->stats.queued;
+                const double waitMs = std::chrono::duration<double, std::milli>(Clock::now() - next.since).count();
+                state->stats.totalWaitMs += waitMs;
+                state->stats.maxWaitMs = std::max(state->stats.maxWaitMs, waitMs);
+                ++state->stats.admitted;
+            }
+            // The slot goes straight to |next|, so |running| stays the same.
+            Start(state, next.priority, std::move(next.task));
+        }
+
+        const size_t limit;
+        TaskExecutor &executor;
+
+        mutable std::mutex mutex; // Guards everything below
+        std::condition_variable idle; // Signalled when |running| drops to 0
+        std::deque<Waiting> queues[kPriorities]; // Indexed by TaskPriority
+        Stats stats;
+        bool stopped = false;
+    };
+
+    ConcurrencyLimiter::ConcurrencyLimiter(size_t limit, TaskExecutor &executor)
+        : state_(std::make_shared<State>(limit, executor))
+    {
+        state_->stats.limit = state_->limit;
+    }
+
+    ConcurrencyLimiter::~ConcurrencyLimiter()
+    {
+        // Destroyed after the lock is released, on this thread.
+        std::deque<State::Waiting> dropped[State::kPriorities];
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->stopped = true;
+        for (size_t p = 0; p < State::kPriorities; ++p)
+            dropped[p].swap(state_->queues[p]);
+        state_->stats.queued = 0;
+    }
+
+    void ConcurrencyLimiter::Shutdown()
+    {
+        std::deque<State::Waiting> dropped[State::kPriorities];
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        state_->stopped = true;
+        for (size_t p = 0; p < State::kPriorities; ++p)
+            dropped[p].swap(state_->queues[p]);
+        state_->stats.queued = 0;
+        state_->idle.wait(lock, [this]() { return state_->stats.running == 0; });
+    }
+
+    void ConcurrencyLimiter::Post(TaskPriority priority, TaskExecutor::Task task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            if (state_->stopped)
+                return;
+            if (state_->stats.running >= state_->limit)
+            {
+                state_->queues[static_cast<size_t>(priority)].push_back(
+                    {priority, std::move(task), State::Clock::now()});
+                ++state_->stats.waited;
+                state_->stats.peakQueued = std::max(state_->stats.peakQueued, ++state_->stats.queued);
+                return;
+            }
+            ++state_->stats.running;
+            ++state_->stats.admitted;
+        }
+        State::Start(state_, priority, std::move(task));
+    }
+
+    ConcurrencyLimiter::Stats ConcurrencyLimiter::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->stats;
+    }
+
+} // namespace utils
@@ -0,0 +1,71 @@
+#ifndef CONCURRENCY_LIMITER_H
+#define CONCURRENCY_LIMITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "TaskExecutor.h"
+
+namespace utils
+{
+
+    /**
+     * @brief Runs tasks on a TaskExecutor with at most |limit| of them at once.
+     *
+     * @details A counting semaphore that never blocks a thread: Post() starts the
+     *          task right away while fewer than |limit| run, and otherwise queues
+     *          it; each task that finishes starts the oldest queued task of the
+     *          most urgent priority. Meant for calls that are expensive outside
+     *          this process, e.g. a full scan or an index connection, where
+     *          running many at once only makes each slower.
+     *
+     *          Queued tasks hold no worker, so a burst cannot starve the pool. A
+     *          task that throws still frees its slot; the exception is counted
+     *          in Stats and goes no further.
+     *          Tasks still queued when the limiter is destroyed or shut down are
+     *          dropped. Thread-safe.
+     */
+    class ConcurrencyLimiter
+    {
+    public:
+        struct Stats
+        {
+            size_t limit = 0;
+            size_t running = 0;
+            size_t queued = 0;
+            size_t peakQueued = 0;
+            uint64_t admitted = 0; // Tasks started, whether they waited or not
+            uint64_t waited = 0;   // Tasks that were queued first
+            double totalWaitMs = 0;
+            double maxWaitMs = 0;
+            uint64_t failed = 0; // Tasks that ended with an exception
+        };
+
+        explicit ConcurrencyLimiter(size_t limit, TaskExecutor &executor = SharedExecutor());
+        ~ConcurrencyLimiter();
+
+        ConcurrencyLimiter(const ConcurrencyLimiter &) = delete;
+        ConcurrencyLimiter &operator=(const ConcurrencyLimiter &) = delete;
+
+        void Post(TaskPriority priority, TaskExecutor::Task task);
+
+        // Drops the queued tasks and any posted from now on, and waits for the
+        // running ones to finish. Must not be called from a task of this limiter.
+        void Shutdown();
+
+        Stats GetStats() const;
+
+    private:
+        struct State;
+
+        std::shared_ptr<State> state_; // Shared with the tasks in flight
+    };
+
+} // namespace utils
+
+#endif // CONCURRENCY_LIMITER_H
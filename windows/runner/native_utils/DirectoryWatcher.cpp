@@ -0,0 +1,393 @@
+#include "DirectoryWatcher.h"
+
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#include "common_utils.h"
+#elif defined(__linux__)
+#include <algorithm>
+#include <filesystem>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <unordered_map>
+#endif
+
+namespace SearchEngine
+{
+
+    namespace
+    {
+#ifdef _WIN32
+
+        class Win32DirectoryWatcher : public DirectoryWatcher
+        {
+        public:
+            ~Win32DirectoryWatcher() override { Stop(); }
+
+            bool Start(const std::vector<std::string> &roots, Callback onEvents) override
+            {
+                onEvents_ = std::move(onEvents);
+                stopEvent_ = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+                if (!stopEvent_)
+                    return false;
+
+                for (const std::string &rootPath : roots)
+                {
+                    auto root = std::make_unique<Root>();
+                    root->path = rootPath;
+                    root->directory = CreateFileW(utils::Utf8ToWide(rootPath).c_str(), FILE_LIST_DIRECTORY,
+                                                  FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                                                  FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+                    if (root->directory == INVALID_HANDLE_VALUE)
+                        continue;
+                    root->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+                    if (!root->overlapped.hEvent || !Arm(*root))
+                    {
+                        Close(*root);
+                        continue;
+                    }
+                    roots_.push_back(std::move(root));
+                }
+                if (roots_.empty())
+                    return false;
+
+                thread_ = std::thread([this]() { Run(); });
+                return true;
+            }
+
+            void Stop() override
+            {
+                if (thread_.joinable())
+                {
+                    SetEvent(stopEvent_);
+                    thread_.join();
+                }
+                for (auto &root : roots_)
+                    Close(*root);
+                roots_.clear();
+                if (stopEvent_)
+                {
+                    CloseHandle(stopEvent_);
+                    stopEvent_ = nullptr;
+                }
+            }
+
+        private:
+            struct Root
+            {
+                std::string path;
+                HANDLE directory = INVALID_HANDLE_VALUE;
+                OVERLAPPED overlapped = {};
+                // DWORD elements keep FILE_NOTIFY_INFORMATION records aligned.
+                DWORD buffer[16 * 1024] = {};
+            };
+
+            static bool Arm(Root &root)
+            {
+                HANDLE event = root.overlapped.hEvent;
+                root.overlapped = {};
+                root.overlapped.hEvent = event;
+                return ReadDirectoryChangesW(root.directory, root.buffer, sizeof(root.buffer), TRUE,
+                                             FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE,
+                                             nullptr, &root.overlapped, nullptr) != FALSE;
+            }
+
+            static void Close(Root &root)
+            {
+                if (root.directory != INVALID_HANDLE_VALUE)
+                {
+                    DWORD ignored = 0;
+                    CancelIoEx(root.directory, &root.overlapped);
+                    GetOverlappedResult(root.directory, &root.overlapped, &ignored, TRUE);
+                    CloseHandle(root.directory);
+                    root.directory = INVALID_HANDLE_VALUE;
+                }
+                if (root.overlapped.hEvent)
+                {
+                    CloseHandle(root.overlapped.hEvent);
+                    root.overlapped.hEvent = nullptr;
+                }
+            }
+
+            void Run()
+            {
+                std::vector<HANDLE> handles{stopEvent_};
+                for (auto &root : roots_)
+                    handles.push_back(root->overlapped.hEvent);
+
+                for (;;)
+                {
+                    const DWORD signalled = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE, INFINITE);
+                    if (signalled == WAIT_OBJECT_0 || signalled >= WAIT_OBJECT_0 + handles.size())
+                        return;
+
+                    const size_t index = signalled - WAIT_OBJECT_0 - 1;
+                    Root &root = *roots_[index];
+                    DWORD bytes = 0;
+                    std::vector<FileEvent> events;
+                    if (!GetOverlappedResult(root.directory, &root.overlapped, &bytes, FALSE) || bytes == 0)
+                    {
+                        events.push_back({FileChange::Overflow, root.path});
+                    }
+                    else
+                    {
+                        const BYTE *cursor = reinterpret_cast<const BYTE *>(root.buffer);
+                        for (;;)
+                        {
+                            const auto *info = reinterpret_cast<const FILE_NOTIFY_INFORMATION *>(cursor);
+                            std::wstring name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+                            std::string path = root.path + "\\" + utils::WideToUtf8(name);
+                            switch (info->Action)
+                            {
+                            case FILE_ACTION_ADDED:
+                            case FILE_ACTION_RENAMED_NEW_NAME:
+                                events.push_back({FileChange::Added, std::move(path)});
+                                break;
+                            case FILE_ACTION_REMOVED:
+                            case FILE_ACTION_RENAMED_OLD_NAME:
+                                events.push_back({FileChange::Removed, std::move(path)});
+                                break;
+                            default:
+                                events.push_back({FileChange::Modified, std::move(path)});
+                                break;
+                            }
+                            if (info->NextEntryOffset == 0)
+                                break;
+                            cursor += info->NextEntryOffset;
+                        }
+                    }
+
+                    // A root that cannot be re-armed (deleted, say) would leave its
+                    // manual-reset event signalled and this loop spinning. Report it
+                    // once, so the consumer rescans, and stop watching it.
+                    if (!Arm(root))
+                    {
+                        ResetEvent(root.overlapped.hEvent);
+                        events.push_back({FileChange::Overflow, root.path});
+                        Close(root);
+                        roots_.erase(roots_.begin() + index);
+                        handles.erase(handles.begin() + index + 1);
+                    }
+                    onEvents_(std::move(events));
+                }
+            }
+
+            Callback onEvents_;
+            HANDLE stopEvent_ = nullptr;
+            std::vector<std::unique_ptr<Root>> roots_;
+            std::thread thread_;
+        };
+
+#elif defined(__linux__)
+
+        class InotifyDirectoryWatcher : public DirectoryWatcher
+        {
+        public:
+            ~InotifyDirectoryWatcher() override { Stop(); }
+
+            bool Start(const std::vector<std::string> &roots, Callback onEvents) override
+            {
+                onEvents_ = std::move(onEvents);
+                fd_ = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+                if (fd_ < 0 || pipe(stopPipe_) != 0)
+                {
+                    Stop();
+                    return false;
+                }
+                for (const std::string &root : roots)
+                {
+                    if (AddTree(root))
+                        roots_.push_back(root);
+                }
+                if (roots_.empty())
+                {
+                    Stop();
+                    return false;
+                }
+                thread_ = std::thread([this]() { Run(); });
+                return true;
+            }
+
+            void Stop() override
+            {
+                if (thread_.joinable())
+                {
+                    const char wake = 1;
+                    (void)!write(stopPipe_[1], &wake, 1);
+                    thread_.join();
+                }
+                for (int *fd : {&fd_, &stopPipe_[0], &stopPipe_[1]})
+                {
+                    if (*fd >= 0)
+                        close(*fd);
+                    *fd = -1;
+                }
+                directories_.clear();
+                roots_.clear();
+            }
+
+        private:
+            static constexpr uint32_t kMask =
+                IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MOVE_SELF | IN_CLOSE_WRITE | IN_ONLYDIR;
+
+            // Watches |root| and every directory below it. inotify is not recursive.
+            bool AddTree(const std::string &root)
+            {
+                const int wd = inotify_add_watch(fd_, root.c_str(), kMask);
+                if (wd < 0)
+                    return false;
+                directories_[wd] = root;
+
+                std::error_code ec;
+                for (std::filesystem::recursive_directory_iterator it(root, std::filesystem::directory_options::skip_permission_denied, ec), end;
+                     !ec && it != end; it.increment(ec))
+                {
+                    if (it->is_directory(ec) && !ec)
+                    {
+                        const int childWd = inotify_add_watch(fd_, it->path().c_str(), kMask);
+                        if (childWd >= 0)
+                            directories_[childWd] = it->path().string();
+                    }
+                }
+                return true;
+            }
+
+            // Stops watching |path| and every directory below it. A directory
+            // moved elsewhere keeps its watches, which would report its new
+            // contents under the old path; a move within the tree re-adds them
+            // under the new one (IN_MOVED_TO).
+            void RemoveTree(const std::string &path)
+            {
+                for (auto it = directories_.begin(); it != directories_.end();)
+                {
+                    const std::string &watched = it->second;
+                    if (watched.compare(0, path.size(), path) == 0 &&
+                        (watched.size() == path.size() || watched[path.size()] == '/'))
+                    {
+                        inotify_rm_watch(fd_, it->first);
+                        it = directories_.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+            }
+
+            void Run()
+            {
+                alignas(inotify_event) char buffer[64 * 1024];
+                pollfd fds[2] = {{fd_, POLLIN, 0}, {stopPipe_[0], POLLIN, 0}};
+                for (;;)
+                {
+                    if (poll(fds, 2, -1) < 0)
+                        continue;
+                    if (fds[1].revents)
+                        return;
+
+                    const ssize_t length = read(fd_, buffer, sizeof(buffer));
+                    if (length <= 0)
+                        continue;
+
+                    std::vector<FileEvent> events;
+                    for (ssize_t offset = 0; offset < length;)
+                    {
+                        const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+                        offset += sizeof(inotify_event) + event->len;
+
+                        if (event->mask & IN_Q_OVERFLOW)
+                        {
+                            for (const std::string &root : roots_)
+                                events.push_back({FileChange::Overflow, root});
+                            continue;
+                        }
+                        if (event->mask & IN_IGNORED)
+                        {
+                            directories_.erase(event->wd);
+                            continue;
+                        }
+                        auto dir = directories_.find(event->wd);
+                        if (dir == directories_.end())
+                            continue;
+                        if (event->mask & IN_MOVE_SELF)
+                        {
+                            // Subfolders are handled by their parent's IN_MOVED_FROM;
+                            // a root that moved away leaves nothing to watch.
+                            const std::string moved = dir->second;
+                            if (std::find(roots_.begin(), roots_.end(), moved) != roots_.end())
+                            {
+                                RemoveTree(moved);
+                                events.push_back({FileChange::Overflow, moved});
+                            }
+                            continue;
+                        }
+                        if (event->len == 0)
+                            continue;
+
+                        std::string path = dir->second + "/" + event->name;
+                        if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                        {
+                            // Watch new folders before anything lands in them; the
+                            // Added event makes the consumer rescan what already did.
+                            if (event->mask & IN_ISDIR)
+                                AddTree(path);
+                            events.push_back({FileChange::Added, std::move(path)});
+                        }
+                        else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+                        {
+                            if ((event->mask & (IN_MOVED_FROM | IN_ISDIR)) == (IN_MOVED_FROM | IN_ISDIR))
+                                RemoveTree(path);
+                            events.push_back({FileChange::Removed, std::move(path)});
+                        }
+                        else if (event->mask & IN_CLOSE_WRITE)
+                        {
+                            events.push_back({FileChange::Modified, std::move(path)});
+                        }
+                    }
+                    if (!events.empty())
+                        onEvents_(std::move(events));
+                }
+            }
+
+            Callback onEvents_;
+            int fd_ = -1;
+            int stopPipe_[2] = {-1, -1};
+            std::unordered_map<int, std::string> directories_; // Watch descriptor -> path
+            std::vector<std::string> roots_;
+            std::thread thread_;
+        };
+
+#else
+
+        class NullDirectoryWatcher : public DirectoryWatcher
+        {
+        public:
+            bool Start(const std::vector<std::string> &, Callback) override { return false; }
+            void Stop() override {}
+        };
+
+#endif
+    } // namespace
+
+    std::unique_ptr<DirectoryWatcher> DirectoryWatcher::Create()
+    {
+#ifdef _WIN32
+        return std::make_unique<Win32DirectoryWatcher>();
+#elif defined(__linux__)
+        return std::make_unique<InotifyDirectoryWatcher>();
+#else
+        return std::make_unique<NullDirectoryWatcher>();
+#endif
+    }
+
+} // namespace SearchEngine
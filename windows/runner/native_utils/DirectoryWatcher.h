@@ -0,0 +1,54 @@
+#ifndef DIRECTORY_WATCHER_H
+#define DIRECTORY_WATCHER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SearchEngine
+{
+
+    enum class FileChange
+    {
+        Added,
+        Removed,
+        Modified,
+        // Events were lost (kernel buffer overflow); |path| is the watched root and
+        // everything below it must be rescanned.
+        Overflow,
+    };
+
+    struct FileEvent
+    {
+        FileChange change = FileChange::Modified;
+        std::string path; // Absolute, UTF-8
+    };
+
+    /**
+     * @brief Recursive change notifications for a set of directory trees.
+     *
+     * @details ReadDirectoryChangesW on Windows and inotify on Linux, behind one
+     *          interface. Renames are reported as Removed(old) + Added(new). Events
+     *          are delivered in batches on a watcher-owned thread; they are raw, so
+     *          feed them through a ChangeDebouncer before acting on them.
+     */
+    class DirectoryWatcher
+    {
+    public:
+        using Callback = std::function<void(std::vector<FileEvent> &&)>;
+
+        virtual ~DirectoryWatcher() = default;
+
+        // Returns false if none of |roots| could be watched. Call at most once.
+        virtual bool Start(const std::vector<std::string> &roots, Callback onEvents) = 0;
+        // Blocks until the watcher thread has exited; no callback runs afterwards.
+        virtual void Stop() = 0;
+
+        // The implementation for the current platform.
+        static std::unique_ptr<DirectoryWatcher> Create();
+    };
+
+} // namespace SearchEngine
+
+#endif // DIRECTORY_WATCHER_H
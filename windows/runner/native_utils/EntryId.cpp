@@ -0,0 +1,140 @@
+#include "EntryId.h"
+
+#include "BinaryIO.h"
+#include "TextFold.h"
+
+namespace utils
+{
+
+    namespace
+    {
+        constexpr std::string_view kAppsFolder = "shell:appsfolder\\";
+
+        bool IsBlank(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        std::string_view Trim(std::string_view text)
+        {
+            while (!text.empty() && IsBlank(text.front()))
+                text.remove_prefix(1);
+            while (!text.empty() && IsBlank(text.back()))
+                text.remove_suffix(1);
+            return text;
+        }
+    } // namespace
+
+    std::string NormalizeTarget(std::string_view target)
+    {
+        target = Trim(target);
+        if (target.size() >= 2 && target.front() == '"' && target.back() == '"')
+            target = Trim(target.substr(1, target.size() - 2));
+
+        std::string normalized;
+        normalized.reserve(target.size() + kAppsFolder.size());
+        bool separators = false; // Any '\' at all, i.e. not a bare AUMID
+        for (char c : target)
+        {
+            c = c == '/' ? '\\' : FoldAscii(c);
+            if (c == '\\')
+            {
+                separators = true;
+                // Collapse runs, but keep the two that open a UNC path.
+                if (!normalized.empty() && normalized.back() == '\\' && normalized.size() > 1)
+                    continue;
+            }
+            normalized.push_back(c);
+        }
+        if (normalized.size() > 1 && normalized.back() == '\\' && normalized[normalized.size() - 2] != ':' &&
+            normalized != "\\\\")
+            normalized.pop_back();
+
+        if (!separators && normalized.find('!') != std::string::npos && normalized.find(':') == std::string::npos)
+            normalized.insert(0, kAppsFolder);
+        return normalized;
+    }
+
+    std::string NormalizeArguments(std::string_view arguments)
+    {
+        arguments = Trim(arguments);
+        std::string normalized;
+        normalized.reserve(arguments.size());
+        bool quoted = false;
+        for (char c : arguments)
+        {
+            if (c == '"')
+                quoted = !quoted;
+            if (!quoted && IsBlank(c))
+            {
+                if (normalized.back() != ' ')
+                    normalized.push_back(' ');
+                continue;
+            }
+            normalized.push_back(FoldAscii(c));
+        }
+        return normalized;
+    }
+
+    uint64_t EntryId(std::string_view target, std::string_view arguments)
+    {
+        uint64_t hash = Fnv1a64(NormalizeTarget(target));
+        hash = Fnv1a64(std::string_view("\0", 1), hash);
+        return Fnv1a64(NormalizeArguments(arguments), hash);
+    }
+
+    uint64_t EntryId(const Program &program)
+    {
+        return program.id != 0 ? program.id : EntryId(program.executablePath, program.arguments);
+    }
+
+    uint64_t AssignEntryId(Program &program)
+    {
+        if (program.id == 0)
+            program.id = EntryId(program.executablePath, program.arguments);
+        return program.id;
+    }
+
+    int SourcePrecedence(std::string_view source)
+    {
+        if (source.rfind("Start Menu (User)", 0) == 0)
+            return 0;
+        if (source.rfind("Start Menu", 0) == 0)
+            return 1;
+        // The scan writes "HKCU Uninstall"; older code spelled it "Registry (HKCU) Uninstall".
+        if (source.find("HKCU") != std::string_view::npos)
+            return 2;
+        if (source.find("HKLM") != std::string_view::npos)
+            return 3;
+        return 4;
+    }
+
+    bool PrefersEntry(const Program &candidate, const Program &kept)
+    {
+        const int candidateRank = SourcePrecedence(candidate.source);
+        const int keptRank = SourcePrecedence(kept.source);
+        if (candidateRank != keptRank)
+            return candidateRank < keptRank;
+        return !candidate.iconDataBase64.empty() && kept.iconDataBase64.empty();
+    }
+
+    void MergeDuplicateEntry(Program &kept, Program &&duplicate)
+    {
+        if (kept.name.empty())
+            kept.name = std::move(duplicate.name);
+        if (kept.description.empty())
+            kept.description = std::move(duplicate.description);
+        if (kept.kind.empty())
+            kept.kind = std::move(duplicate.kind);
+        if (kept.originPath.empty())
+            kept.originPath = std::move(duplicate.originPath);
+        // The icon moves as a whole, so path and index keep matching the data.
+        if (kept.iconDataBase64.empty() && !duplicate.iconDataBase64.empty())
+        {
+            kept.iconDataBase64 = std::move(duplicate.iconDataBase64);
+            kept.iconPath = std::move(duplicate.iconPath);
+            kept.iconIndex = duplicate.iconIndex;
+        }
+    }
+
+} // namespace utils
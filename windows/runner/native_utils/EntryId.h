@@ -0,0 +1,57 @@
+#ifndef ENTRY_ID_H
+#define ENTRY_ID_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "Program.h"
+
+namespace utils
+{
+
+    /**
+     * @brief Stable 64-bit identity of a launchable entry, the same whichever
+     *        provider found it.
+     *
+     * @details The id is FNV-1a 64 over the normalized target, a NUL, and the
+     *          normalized arguments, so it depends on nothing but those bytes:
+     *          it is the same across runs, builds and processes, and the Dart
+     *          side computes it identically (lib/native_apis/entry_id.dart) for
+     *          entries that arrive without one. Change both or neither.
+     *
+     *          Normalization is ASCII-only, like TextFold.h: surrounding blanks
+     *          and quotes go, case is folded, '/' becomes '\', repeated
+     *          separators collapse (a leading UNC "\\" stays) and a trailing one
+     *          is dropped except after a drive. A bare AUMID ("Pkg_hash!App",
+     *          as shortcuts to Store apps resolve) becomes the
+     *          "shell:appsfolder\..." target UwpFinder launches it by. Arguments
+     *          are trimmed, folded, and have blank runs outside quotes collapsed.
+     */
+    std::string NormalizeTarget(std::string_view target);
+    std::string NormalizeArguments(std::string_view arguments);
+
+    uint64_t EntryId(std::string_view target, std::string_view arguments);
+
+    // |program|'s id if it has one, otherwise computed from its path and arguments.
+    uint64_t EntryId(const Program &program);
+
+    // Sets |program.id| if it is still 0 and returns it.
+    uint64_t AssignEntryId(Program &program);
+
+    // How much a source is trusted when two entries share an id, lower first:
+    // Start Menu (user, then common), then Uninstall registry (HKCU, then HKLM),
+    // then everything else (UWP, the file index, settings pages).
+    int SourcePrecedence(std::string_view source);
+
+    // True if |candidate| should replace |kept| as the entry for their shared id:
+    // its source comes first, or the same source and only it has an icon.
+    bool PrefersEntry(const Program &candidate, const Program &kept);
+
+    // Folds |duplicate| into |kept|, the entry that won: fields |kept| lacks
+    // (name, description, kind, icon, origin) are taken from |duplicate|.
+    void MergeDuplicateEntry(Program &kept, Program &&duplicate);
+
+} // namespace utils
+
+#endif // ENTRY_ID_H
@@ -0,0 +1,108 @@
+#include "EpochReclamation.h"
+
+#include <thread>
+
+namespace utils
+{
+
+    EpochDomain::Guard &EpochDomain::Guard::operator=(Guard &&other) noexcept
+    {
+        if (this != &other)
+        {
+            Release();
+            domain_ = std::exchange(other.domain_, nullptr);
+            slot_ = other.slot_;
+        }
+        return *this;
+    }
+
+    void EpochDomain::Guard::Release()
+    {
+        if (!domain_)
+            return;
+        domain_->slots_[slot_].store(kFree);
+        // The last reader of an old generation frees it instead of waiting for the
+        // next publish. try_lock keeps unpinning non-blocking.
+        if (domain_->pending_.load() != 0)
+        {
+            std::unique_lock<std::mutex> lock(domain_->retiredMutex_, std::try_to_lock);
+            if (lock.owns_lock())
+            {
+                lock.unlock();
+                domain_->Collect();
+            }
+        }
+        domain_ = nullptr;
+    }
+
+    EpochDomain::~EpochDomain()
+    {
+        for (auto &entry : retired_)
+            entry.second();
+    }
+
+    EpochDomain::Guard EpochDomain::Pin()
+    {
+        // Spread threads over the slots so concurrent readers rarely collide.
+        const size_t start = std::hash<std::thread::id>()(std::this_thread::get_id()) % kSlots;
+        for (;;)
+        {
+            const uint64_t epoch = epoch_.load();
+            for (size_t i = 0; i < kSlots; ++i)
+            {
+                const size_t slot = (start + i) % kSlots;
+                uint64_t expected = kFree;
+                if (slots_[slot].compare_exchange_strong(expected, epoch))
+                    return Guard(this, slot);
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void EpochDomain::Retire(std::function<void()> reclaim)
+    {
+        // Readers pinned at or before this epoch may hold the retired object;
+        // readers pinning later already see its replacement.
+        const uint64_t retiredAt = epoch_.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(retiredMutex_);
+            retired_.emplace_back(retiredAt, std::move(reclaim));
+            pending_.store(retired_.size());
+        }
+        Collect();
+    }
+
+    size_t EpochDomain::Collect()
+    {
+        // Anything retired from here on gets an epoch >= |oldestPinned| and stays.
+        uint64_t oldestPinned = epoch_.load();
+        for (const auto &slot : slots_)
+        {
+            const uint64_t epoch = slot.load();
+            if (epoch != kFree && epoch < oldestPinned)
+                oldestPinned = epoch;
+        }
+
+        std::vector<std::function<void()>> ready;
+        size_t remaining = 0;
+        {
+            std::lock_guard<std::mutex> lock(retiredMutex_);
+            auto keep = retired_.begin();
+            for (auto it = retired_.begin(); it != retired_.end(); ++it)
+            {
+                if (it->first < oldestPinned)
+                    ready.push_back(std::move(it->second));
+                else
+                    *keep++ = std::move(*it);
+            }
+            retired_.erase(keep, retired_.end());
+            remaining = retired_.size();
+            pending_.store(remaining);
+        }
+        // Reclaim outside the lock; destructors may be arbitrarily expensive.
+        for (auto &reclaim : ready)
+            reclaim();
+        return remaining;
+    }
+
+} // namespace utils
@@ -0,0 +1,83 @@
+#ifndef EPOCH_RECLAMATION_H
+#define EPOCH_RECLAMATION_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace utils
+{
+
+    /**
+     * @brief Epoch-based reclamation for data published through an atomic pointer.
+     *
+     * @details Readers Pin() before loading the pointer and keep the guard for as long
+     *          as they dereference it; pinning is a single CAS on a reader slot, with
+     *          no lock and no reference count. A writer swaps the pointer, then hands
+     *          the old object to Retire(). It is destroyed once every reader that could
+     *          still see it has unpinned.
+     *
+     *          All operations are thread-safe. Retire() and Collect() take an internal
+     *          mutex; Pin() and Guard destruction never block on writers.
+     */
+    class EpochDomain
+    {
+    public:
+        static constexpr size_t kSlots = 64;
+
+        class Guard
+        {
+        public:
+            Guard() = default;
+            Guard(Guard &&other) noexcept : domain_(std::exchange(other.domain_, nullptr)), slot_(other.slot_) {}
+            Guard &operator=(Guard &&other) noexcept;
+            ~Guard() { Release(); }
+
+            Guard(const Guard &) = delete;
+            Guard &operator=(const Guard &) = delete;
+
+        private:
+            friend class EpochDomain;
+            Guard(EpochDomain *domain, size_t slot) : domain_(domain), slot_(slot) {}
+            void Release();
+
+            EpochDomain *domain_ = nullptr;
+            size_t slot_ = 0;
+        };
+
+        EpochDomain() = default;
+        // Runs every pending reclaim; no reader may still be pinned.
+        ~EpochDomain();
+
+        EpochDomain(const EpochDomain &) = delete;
+        EpochDomain &operator=(const EpochDomain &) = delete;
+
+        // Spins (yielding) if all kSlots readers are pinned at once.
+        Guard Pin();
+
+        // Call after the pointer to the retired object has been swapped out.
+        void Retire(std::function<void()> reclaim);
+
+        // Runs the reclaims that no pinned reader can observe any more.
+        // Returns how many are still pending.
+        size_t Collect();
+
+    private:
+        static constexpr uint64_t kFree = 0;
+
+        std::atomic<uint64_t> epoch_{1};
+        std::array<std::atomic<uint64_t>, kSlots> slots_{};
+
+        std::mutex retiredMutex_;
+        std::vector<std::pair<uint64_t, std::function<void()>>> retired_;
+        std::atomic<size_t> pending_{0};
+    };
+
+} // namespace utils
+
+#endif // EPOCH_RECLAMATION_H
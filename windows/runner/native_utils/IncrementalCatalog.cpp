@@ -0,0 +1,264 @@
+#include "IncrementalCatalog.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+#include "TextFold.h"
+
+namespace SearchEngine
+{
+
+    namespace fs = std::filesystem;
+
+    namespace
+    {
+        bool IsSeparator(char c)
+        {
+            return c == '\\' || c == '/';
+        }
+
+        // True if folded path |path| is |folded| itself or lies below it.
+        bool IsUnder(const std::string &path, const std::string &folded)
+        {
+            if (path.compare(0, folded.size(), folded) != 0)
+                return false;
+            return path.size() == folded.size() || IsSeparator(path[folded.size()]) ||
+                   (!folded.empty() && IsSeparator(folded.back()));
+        }
+
+        bool IsShortcut(const fs::path &path)
+        {
+            return utils::FoldCase(path.extension().u8string()) == ".lnk";
+        }
+    } // namespace
+
+    std::string FilenameKey(const std::string &path)
+    {
+        size_t start = path.size();
+        while (start > 0 && !IsSeparator(path[start - 1]))
+            --start;
+        return utils::FoldCase(std::string_view(path).substr(start));
+    }
+
+    IncrementalCatalog::IncrementalCatalog(std::shared_ptr<ProgramCatalog> catalog, std::vector<Root> roots, Resolver resolve, Deduplicator dedup)
+        : catalog_(std::move(catalog)), roots_(std::move(roots)), resolve_(std::move(resolve)), dedup_(std::move(dedup))
+    {
+    }
+
+    void IncrementalCatalog::Reset(std::vector<utils::Program> rawPrograms)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rawGroups_.clear();
+        dedupedGroups_.clear();
+        origins_.clear();
+
+        std::vector<std::string> touched;
+        for (utils::Program &program : rawPrograms)
+            InsertRawLocked(std::move(program), touched);
+        for (const auto &group : rawGroups_)
+            DedupGroupLocked(group.first);
+
+        initialized_ = true;
+        PublishLocked();
+    }
+
+    size_t IncrementalCatalog::Apply(const std::vector<FileEvent> &events)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!initialized_)
+            return 0;
+
+        size_t changes = 0;
+        std::vector<std::string> touched;
+        for (const FileEvent &event : events)
+        {
+            switch (event.change)
+            {
+            case FileChange::Removed:
+                changes += RemoveUnderLocked(event.path, touched);
+                break;
+            case FileChange::Modified:
+            {
+                // A folder's own timestamp changes with its children, which report
+                // their own events.
+                std::error_code ec;
+                if (fs::is_directory(fs::u8path(event.path), ec))
+                    break;
+                changes += RemoveUnderLocked(event.path, touched);
+                AddPathLocked(event.path, touched, changes);
+                break;
+            }
+            case FileChange::Added:
+            case FileChange::Overflow:
+                changes += RemoveUnderLocked(event.path, touched);
+                AddPathLocked(event.path, touched, changes);
+                break;
+            }
+        }
+
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        for (const std::string &group : touched)
+            DedupGroupLocked(group);
+        if (!touched.empty())
+            PublishLocked();
+        return changes;
+    }
+
+    std::vector<std::string> IncrementalCatalog::Validate(const std::function<bool(const std::string &path)> &exists)
+    {
+        std::vector<std::pair<std::string, std::string>> targets; // (origin, executable)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto &group : rawGroups_)
+            {
+                for (const utils::Program &program : group.second)
+                {
+                    if (!program.originPath.empty())
+                        targets.emplace_back(program.originPath, program.executablePath);
+                }
+            }
+        }
+
+        std::vector<std::string> missing;
+        for (const auto &[origin, executable] : targets)
+        {
+            if (!exists(executable))
+                missing.push_back(origin);
+        }
+        if (missing.empty())
+            return missing;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::string> touched;
+        for (const std::string &origin : missing)
+            RemoveUnderLocked(origin, touched);
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        for (const std::string &group : touched)
+            DedupGroupLocked(group);
+        if (!touched.empty())
+            PublishLocked();
+        return missing;
+    }
+
+    size_t IncrementalCatalog::RemoveUnderLocked(const std::string &path, std::vector<std::string> &touched)
+    {
+        // Everything below |path| shares its prefix, so the candidates are one
+        // contiguous range; siblings like "Foo Bar" next to "Foo" are skipped.
+        const std::string folded = utils::FoldCase(path);
+        size_t removed = 0;
+        for (auto it = origins_.lower_bound(folded); it != origins_.end() && it->first.compare(0, folded.size(), folded) == 0;)
+        {
+            if (!IsUnder(it->first, folded))
+            {
+                ++it;
+                continue;
+            }
+            auto group = rawGroups_.find(it->second);
+            if (group != rawGroups_.end())
+            {
+                auto &programs = group->second;
+                const size_t before = programs.size();
+                programs.erase(std::remove_if(programs.begin(), programs.end(),
+                                              [&it](const utils::Program &program) { return utils::FoldCase(program.originPath) == it->first; }),
+                               programs.end());
+                removed += before - programs.size();
+            }
+            touched.push_back(it->second);
+            it = origins_.erase(it);
+        }
+        return removed;
+    }
+
+    void IncrementalCatalog::AddPathLocked(const std::string &path, std::vector<std::string> &touched, size_t &changes)
+    {
+        const Root *root = RootOf(path);
+        if (!root)
+            return;
+
+        const auto addShortcut = [&](const fs::path &shortcut) {
+            const std::string shortcutPath = shortcut.u8string();
+            std::optional<utils::Program> program = resolve_(shortcutPath, root->source);
+            if (!program)
+                return;
+            if (program->originPath.empty())
+                program->originPath = shortcutPath;
+            InsertRawLocked(std::move(*program), touched);
+            ++changes;
+        };
+
+        std::error_code ec;
+        const fs::path fsPath = fs::u8path(path);
+        if (fs::is_directory(fsPath, ec))
+        {
+            for (fs::recursive_directory_iterator it(fsPath, fs::directory_options::skip_permission_denied, ec), end; !ec && it != end; it.increment(ec))
+            {
+                std::error_code fileEc;
+                if (it->is_regular_file(fileEc) && !fileEc && IsShortcut(it->path()))
+                    addShortcut(it->path());
+            }
+        }
+        else if (fs::is_regular_file(fsPath, ec) && IsShortcut(fsPath))
+        {
+            addShortcut(fsPath);
+        }
+    }
+
+    void IncrementalCatalog::InsertRawLocked(utils::Program program, std::vector<std::string> &touched)
+    {
+        std::string group = FilenameKey(program.executablePath);
+        if (!program.originPath.empty())
+            origins_[utils::FoldCase(program.originPath)] = group;
+        touched.push_back(group);
+        rawGroups_[group].push_back(std::move(program));
+    }
+
+    void IncrementalCatalog::DedupGroupLocked(const std::string &group)
+    {
+        auto raw = rawGroups_.find(group);
+        if (raw == rawGroups_.end() || raw->second.empty())
+        {
+            if (raw != rawGroups_.end())
+                rawGroups_.erase(raw);
+            dedupedGroups_.erase(group);
+            return;
+        }
+        std::vector<utils::Program> candidates;
+        candidates.reserve(raw->second.size());
+        for (const utils::Program &program : raw->second)
+            candidates.push_back(CloneProgram(program));
+        dedupedGroups_[group] = dedup_(candidates);
+    }
+
+    void IncrementalCatalog::PublishLocked()
+    {
+        size_t count = 0;
+        for (const auto &group : dedupedGroups_)
+            count += group.second.size();
+        std::vector<utils::Program> programs;
+        programs.reserve(count);
+        for (const auto &group : dedupedGroups_)
+        {
+            for (const utils::Program &program : group.second)
+                programs.push_back(CloneProgram(program));
+        }
+        catalog_->Publish(std::move(programs));
+    }
+
+    const IncrementalCatalog::Root *IncrementalCatalog::RootOf(const std::string &path) const
+    {
+        const std::string folded = utils::FoldCase(path);
+        const Root *best = nullptr;
+        for (const Root &root : roots_)
+        {
+            const std::string rootFolded = utils::FoldCase(root.path);
+            if (IsUnder(folded, rootFolded) && (!best || root.path.size() > best->path.size()))
+                best = &root;
+        }
+        return best;
+    }
+
+} // namespace SearchEngine
@@ -0,0 +1,85 @@
+#ifndef INCREMENTAL_CATALOG_H
+#define INCREMENTAL_CATALOG_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DirectoryWatcher.h"
+#include "Program.h"
+#include "SearchProviders.h"
+
+namespace SearchEngine
+{
+
+    /**
+     * @brief Keeps the ProgramCatalog current from file events instead of full rescans.
+     *
+     * @details Holds the raw (pre-dedup) scan results grouped by case-folded target
+     *          filename, which is the key both dedup rules share, so groups are
+     *          independent. Apply() re-resolves only the shortcuts named by the
+     *          events, re-runs dedup only for the groups they touched, and publishes
+     *          one new catalog generation per batch.
+     *
+     *          Shortcut resolution and dedup are injected so the Windows build uses
+     *          the exact ProgramFinder / utils code paths of the full scan.
+     */
+    class IncrementalCatalog
+    {
+    public:
+        struct Root
+        {
+            std::string path;
+            std::string source; // Program::source for shortcuts below |path|
+        };
+
+        // Builds the entry for one shortcut, or nullopt if it cannot be resolved.
+        using Resolver = std::function<std::optional<utils::Program>(const std::string &path, const std::string &source)>;
+        using Deduplicator = std::function<std::vector<utils::Program>(std::vector<utils::Program> &)>;
+
+        IncrementalCatalog(std::shared_ptr<ProgramCatalog> catalog, std::vector<Root> roots, Resolver resolve, Deduplicator dedup);
+
+        // Replaces everything with a full scan and publishes it. Until the first
+        // Reset(), Apply() ignores events.
+        void Reset(std::vector<utils::Program> rawPrograms);
+
+        // Returns the number of raw entries added, replaced or removed.
+        size_t Apply(const std::vector<FileEvent> &events);
+
+        // Drops shortcut entries whose target |exists| rejects and returns the .lnk
+        // paths they came from. Meant as a background pass after Reset(): entries
+        // answered from the shortcut cache skipped their existence checks. |exists|
+        // runs without the lock held.
+        std::vector<std::string> Validate(const std::function<bool(const std::string &path)> &exists);
+
+    private:
+        size_t RemoveUnderLocked(const std::string &path, std::vector<std::string> &touched);
+        void AddPathLocked(const std::string &path, std::vector<std::string> &touched, size_t &changes);
+        void InsertRawLocked(utils::Program program, std::vector<std::string> &touched);
+        void DedupGroupLocked(const std::string &group);
+        void PublishLocked();
+        const Root *RootOf(const std::string &path) const;
+
+        std::shared_ptr<ProgramCatalog> catalog_;
+        std::vector<Root> roots_;
+        Resolver resolve_;
+        Deduplicator dedup_;
+
+        std::mutex mutex_;
+        bool initialized_ = false;
+        std::unordered_map<std::string, std::vector<utils::Program>> rawGroups_;
+        std::unordered_map<std::string, std::vector<utils::Program>> dedupedGroups_;
+        std::map<std::string, std::string> origins_; // Folded .lnk path -> group
+    };
+
+    // Case-folded file name of |path| (either separator); the dedup group key.
+    std::string FilenameKey(const std::string &path);
+
+} // namespace SearchEngine
+
+#endif // INCREMENTAL_CATALOG_H
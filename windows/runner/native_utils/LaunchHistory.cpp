@@ -0,0 +1,167 @@
+#include "LaunchHistory.h"
+
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+#include "BinaryIO.h"
+#include "TextFold.h"
+
+namespace SearchEngine
+{
+
+    namespace fs = std::filesystem;
+
+    namespace
+    {
+        constexpr uint32_t kMagic = 0x484C5856; // "VXLH"
+        constexpr uint32_t kVersion = 1;
+
+        int64_t Seconds(LaunchHistory::Clock::time_point time)
+        {
+            return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+        }
+    } // namespace
+
+    std::string LaunchHistory::Key(const std::string &path, const std::string &args)
+    {
+        return utils::FoldCase(path) + '|' + args;
+    }
+
+    bool LaunchHistory::Load(const fs::path &file)
+    {
+        std::ifstream stream(file, std::ios::binary);
+        std::string data;
+        if (stream)
+            data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+
+        std::unordered_map<std::string, Entry> loaded;
+        bool valid = data.size() >= 8;
+        if (valid)
+        {
+            const std::string_view payload(data.data(), data.size() - 8);
+            utils::BinaryReader trailer(std::string_view(data).substr(payload.size()));
+            uint64_t checksum = 0;
+            valid = trailer.U64(checksum) && checksum == utils::Fnv1a64(payload);
+
+            utils::BinaryReader in(payload);
+            uint32_t magic = 0, version = 0, count = 0;
+            valid = valid && in.U32(magic) && in.U32(version) && in.U32(count) && magic == kMagic && version == kVersion;
+            for (uint32_t i = 0; valid && i < count; ++i)
+            {
+                std::string key;
+                Entry entry;
+                uint32_t visits = 0;
+                in.String(key);
+                in.U32(entry.count);
+                valid = in.U32(visits) && visits >= 1 && visits <= kRecentVisits;
+                for (uint32_t v = 0; valid && v < visits; ++v)
+                {
+                    int64_t seconds = 0;
+                    valid = in.I64(seconds);
+                    entry.recent.push_back(Clock::time_point(std::chrono::seconds(seconds)));
+                }
+                if (valid)
+                    loaded[std::move(key)] = std::move(entry);
+            }
+            valid = valid && in.AtEnd();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_ = valid ? std::move(loaded) : std::unordered_map<std::string, Entry>();
+        dirty_ = false;
+        return valid;
+    }
+
+    bool LaunchHistory::Save(const fs::path &file)
+    {
+        utils::BinaryWriter out;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!dirty_)
+                return true;
+            out.U32(kMagic);
+            out.U32(kVersion);
+            out.U32(static_cast<uint32_t>(entries_.size()));
+            for (const auto &[key, entry] : entries_)
+            {
+                out.String(key);
+                out.U32(entry.count);
+                out.U32(static_cast<uint32_t>(entry.recent.size()));
+                for (const Clock::time_point &visit : entry.recent)
+                    out.I64(Seconds(visit));
+            }
+            dirty_ = false;
+        }
+        out.U64(utils::Fnv1a64(out.Data()));
+
+        std::error_code ec;
+        fs::create_directories(file.parent_path(), ec);
+        fs::path temp = file;
+        temp += ".tmp";
+        {
+            std::ofstream stream(temp, std::ios::binary | std::ios::trunc);
+            stream.write(out.Data().data(), static_cast<std::streamsize>(out.Data().size()));
+            if (!stream)
+                ec = std::make_error_code(std::errc::io_error);
+        }
+        if (!ec)
+            fs::rename(temp, file, ec);
+        if (ec)
+        {
+            fs::remove(temp, ec);
+            std::lock_guard<std::mutex> lock(mutex_);
+            dirty_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    void LaunchHistory::Record(const std::string &path, const std::string &args, Clock::time_point when)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry &entry = entries_[Key(path, args)];
+        ++entry.count;
+        entry.recent.push_back(when);
+        if (entry.recent.size() > kRecentVisits)
+            entry.recent.pop_front();
+        dirty_ = true;
+
+        // Over the cap: forget the item opened longest ago.
+        if (entries_.size() > kMaxEntries)
+        {
+            auto oldest = entries_.end();
+            for (auto it = entries_.begin(); it != entries_.end(); ++it)
+            {
+                if (oldest == entries_.end() || it->second.recent.back() < oldest->second.recent.back())
+                    oldest = it;
+            }
+            entries_.erase(oldest);
+        }
+    }
+
+    double LaunchHistory::Frecency(const std::string &path, const std::string &args, Clock::time_point now) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(Key(path, args));
+        if (it == entries_.end() || it->second.recent.empty())
+            return 0.0;
+
+        using Days = std::chrono::duration<double, std::ratio<86400>>;
+        double total = 0.0;
+        for (const Clock::time_point &visit : it->second.recent)
+        {
+            const double ageDays = std::chrono::duration_cast<Days>(now - visit).count();
+            if (ageDays <= 4)
+                total += 100;
+            else if (ageDays <= 14)
+                total += 70;
+            else if (ageDays <= 90)
+                total += 50;
+            else
+                total += 30;
+        }
+        return it->second.count * total / static_cast<double>(it->second.recent.size());
+    }
+
+} // namespace SearchEngine
@@ -0,0 +1,66 @@
+#ifndef LAUNCH_HISTORY_H
+#define LAUNCH_HISTORY_H
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace SearchEngine
+{
+
+    /**
+     * @brief Record of which items the user opened and when.
+     *
+     * @details Feeds the frecency term of native ranking. Items are keyed by
+     *          case-folded path plus arguments, mirroring the path|args id of a
+     *          Dart SearchResult. Saved in the same versioned, checksummed format
+     *          as the other caches, so ranking survives a restart; only the
+     *          |kMaxEntries| most recently opened items are kept. Safe to use from
+     *          any thread.
+     */
+    class LaunchHistory
+    {
+    public:
+        using Clock = std::chrono::system_clock;
+
+        static constexpr size_t kMaxEntries = 2000;
+
+        // A missing or damaged file leaves the history empty and returns false.
+        bool Load(const std::filesystem::path &file);
+        // Writes only if something was recorded since the last Load() or Save().
+        bool Save(const std::filesystem::path &file);
+
+        void Record(const std::string &path, const std::string &args, Clock::time_point when = Clock::now());
+
+        /**
+         * @brief Frequency weighted by recency; 0 for items never opened.
+         *
+         * @details Each of the last kRecentVisits launches contributes a weight by age
+         *          (100 within 4 days, 70 within 2 weeks, 50 within 90 days, 30 older);
+         *          the average weight is scaled by the total launch count.
+         */
+        double Frecency(const std::string &path, const std::string &args, Clock::time_point now = Clock::now()) const;
+
+    private:
+        static constexpr size_t kRecentVisits = 10;
+
+        struct Entry
+        {
+            uint32_t count = 0;
+            std::deque<Clock::time_point> recent; // Newest last, at most kRecentVisits
+        };
+
+        static std::string Key(const std::string &path, const std::string &args);
+
+        mutable std::mutex mutex_;
+        std::unordered_map<std::string, Entry> entries_;
+        bool dirty_ = false;
+    };
+
+} // namespace SearchEngine
+
+#endif // LAUNCH_HISTORY_H
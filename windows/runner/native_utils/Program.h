@@ -0,0 +1,84 @@
+#ifndef PROGRAM_H
+#define PROGRAM_H
+
+#include <cstdint>
+#include <string>
+
+// Plain data records shared by every scanner and search provider. Kept free of
+// Windows headers so the portable parts of native_utils can use them.
+namespace utils
+{
+
+    // --- Internal Structure for Shortcut Data (Includes flag again) ---
+    struct ShortcutInfo
+    {
+        std::string resolvedTargetPathUtf8; // Path determined via resolution (could be exe, heuristic result, or fallback like .ico)
+        std::string argumentsUtf8;
+        std::string iconPathUtf8; // Path to the icon resource
+        int iconIndex = -1;
+        std::string iconDataBase64;
+        std::string kind=""; // Optional kind (e.g., "shortcut", "executable", etc.)
+        std::string descriptionUtf8=""; // Optional description (e.g., from registry)
+        bool isFallbackPath = false; // True if resolvedTargetPathUtf8 is the non-ideal path from GetPath (e.g. .ico)
+    };
+
+    struct Program
+    {
+        std::string name;
+        std::string executablePath;
+        std::string arguments;
+        std::string iconPath;
+        int iconIndex = -1;
+        std::string iconDataBase64;   // BMP icon data
+        std::string source;           // Where it was found (Registry, Start Menu)
+        std::string originPath;       // The .lnk a Start Menu entry was read from; empty otherwise
+        std::string description = ""; // Optional description (e.g., from registry)
+        uint64_t id = 0;              // utils::EntryId(); 0 until assigned
+        std::string kind = "";        // Optional kind (e.g., "shortcut", "executable", etc.)
+                                      /*
+                                       Possible string values for the System.Kind property (PKEY_Kind)
+                                       and their corresponding user-friendly display text:
+                              
+                                       Format: "internal value" -> User-friendly Text
+                              
+                                       "calendar"       -> Calendar
+                                       "communication"  -> Communication
+                                       "contact"        -> Contact
+                                       "document"       -> Document
+                                       "email"          -> E-mail
+                                       "feed"           -> Feed
+                                       "folder"         -> Folder
+                                       "game"           -> Game
+                                       "instantmessage" -> Instant Message
+                                       "journal"        -> Journal
+                                       "link"           -> Link
+                                       "movie"          -> Movie
+                                       "music"          -> Music
+                                       "note"           -> Note
+                                       "picture"        -> Picture
+                                       "playlist"       -> Playlist
+                                       "program"        -> Program        // <-- Value for program items
+                                       "recordedtv"     -> Recorded TV
+                                       "searchfolder"   -> Saved Search
+                                       "task"           -> Task
+                                       "video"          -> Video
+                                       "webhistory"     -> Web History
+                                       "unknown"        -> Unknown
+                              
+                                       Note: This property is a 'Multivalue String', meaning an item could potentially
+                                       have more than one kind associated with it, though typically one is primary.
+                                       For an item classified as a 'Program', the value stored would be "program".
+                                      */
+        // Default constructor and move constructor/assignment for efficiency
+        Program() = default;
+        Program(Program &&other) noexcept = default;
+        Program &operator=(Program &&other) noexcept = default;
+
+        // Delete copy constructor/assignment as iconData can be large
+        Program(const Program &) = delete;
+        Program &operator=(const Program &) = delete;
+    };
+
+} // namespace utils
+
+#endif // PROGRAM_H
@@ -0,0 +1,45 @@
+#ifndef PROGRAM_CODEC_H
+#define PROGRAM_CODEC_H
+
+#include "BinaryIO.h"
+#include "Program.h"
+
+namespace utils
+{
+
+    // One Program as a BinaryIO record. Shared by the on-disk caches and the
+    // scanner helper's result stream; changing it changes both formats.
+    inline void WriteProgram(BinaryWriter &out, const Program &program)
+    {
+        out.String(program.name);
+        out.String(program.executablePath);
+        out.String(program.arguments);
+        out.String(program.iconPath);
+        out.I32(program.iconIndex);
+        out.String(program.iconDataBase64);
+        out.String(program.source);
+        out.String(program.originPath);
+        out.String(program.description);
+        out.String(program.kind);
+    }
+
+    inline bool ReadProgram(BinaryReader &in, Program &program)
+    {
+        int32_t iconIndex = 0;
+        in.String(program.name);
+        in.String(program.executablePath);
+        in.String(program.arguments);
+        in.String(program.iconPath);
+        in.I32(iconIndex);
+        in.String(program.iconDataBase64);
+        in.String(program.source);
+        in.String(program.originPath);
+        in.String(program.description);
+        in.String(program.kind);
+        program.iconIndex = iconIndex;
+        return in.Ok();
+    }
+
+} // namespace utils
+
+#endif // PROGRAM_CODEC_H
@@ -26,11 +26,20 @@
 #include <system_error>   // For std::error_code
 #include <limits>         // For std::numeric_limits
 #include <knownfolders.h> // For KNOWNFOLDERID definitions
+#include <mutex>          // For std::mutex
+#include <chrono>         // For the per-shortcut time budget
+#include <shared_mutex>   // For std::shared_mutex
 
 // Assuming ProgramFinder.h defines the Program struct like this:
 #include "ProgramFinder.h"
 
 #include "SettingsPages.h"
+#include "BudgetedRunner.h"
+#include "CommandLineParser.h"
+#include "QuarantineList.h"
+#include "ShortcutCache.h"
+#include "StatCache.h"
+#include "UninstallEntryCache.h"
 // #include "UwpFinder.h"
 
 #pragma comment(lib, "Ole32.lib")
@@ -179,17 +188,283 @@ namespace ProgramFinder
         using LocalMemUniquePtr = std::unique_ptr<void, LocalMemDeleter>;
 
         // --- Registry Scanning ---
-        std::vector<utils::Program> GetInstalledProgramsFromRegistryInternal(); // Definition below (unchanged)
+        std::vector<utils::Program> GetInstalledProgramsFromRegistryInternal(const utils::CancellationToken &token); // Definition below
+
+        // --- Shortcut Resolution Cache ---
+        fs::path ShortcutCachePath()
+        {
+            fs::path directory = utils::GetLocalDataDirectory();
+            return directory.empty() ? fs::path() : directory / L"shortcut-cache.bin";
+        }
+
+        fs::path UninstallCachePath()
+        {
+            fs::path directory = utils::GetLocalDataDirectory();
+            return directory.empty() ? fs::path() : directory / L"uninstall-cache.bin";
+        }
+
+        // The shortcut and Uninstall caches, shared by full scans and the incremental
+        // catalog. They are loaded from disk on first use and may be released again
+        // by ReleaseCaches() while the launcher is idle.
+        struct PersistentCaches
+        {
+            std::shared_mutex use; // Shared by every CacheUse, exclusive while releasing
+            std::mutex loadMutex;
+            bool loaded = false;
+            utils::ShortcutCache shortcuts;
+            utils::UninstallEntryCache uninstall;
+        };
+
+        PersistentCaches &Caches()
+        {
+            static PersistentCaches caches;
+            return caches;
+        }
+
+        // Keeps the caches resident for its lifetime, loading them if needed. Anything
+        // that touches ShortcutCacheInstance() or UninstallCacheInstance() holds one.
+        class CacheUse
+        {
+        public:
+            CacheUse() : lock_(Caches().use)
+            {
+                PersistentCaches &caches = Caches();
+                std::lock_guard<std::mutex> guard(caches.loadMutex);
+                if (!caches.loaded)
+                {
+                    caches.shortcuts.Load(ShortcutCachePath());
+                    caches.uninstall.Load(UninstallCachePath());
+                    caches.loaded = true;
+                }
+            }
+
+        private:
+            std::shared_lock<std::shared_mutex> lock_;
+        };
+
+        utils::ShortcutCache &ShortcutCacheInstance()
+        {
+            return Caches().shortcuts;
+        }
+
+        // --- Scan Quarantine ---
+        fs::path QuarantinePath()
+        {
+            fs::path directory = utils::GetLocalDataDirectory();
+            return directory.empty() ? fs::path() : directory / L"scan-quarantine.bin";
+        }
+
+        // Loaded on first use. Only the launcher records outcomes, so the scanner
+        // helper never touches it.
+        utils::QuarantineList &QuarantineInstance()
+        {
+            static std::mutex loadMutex;
+            static bool loaded = false;
+            static utils::QuarantineList quarantine;
+            std::lock_guard<std::mutex> guard(loadMutex);
+            if (!loaded)
+            {
+                const fs::path path = QuarantinePath();
+                if (!path.empty())
+                    quarantine.Load(path);
+                loaded = true;
+            }
+            return quarantine;
+        }
+
+        void SaveQuarantine()
+        {
+            const fs::path path = QuarantinePath();
+            if (!path.empty())
+                QuarantineInstance().Save(path);
+        }
+
+        // --- Per-Shortcut Time Budget ---
+        // Long enough for a cold disk, short enough that a dead network share does not
+        // hold up the rest of the Start Menu.
+        constexpr std::chrono::milliseconds kShortcutBudget{2000};
+
+        thread_local std::optional<CoInitializer> workerCom;
+
+        // Resolves shortcuts, icons included, off the scanning thread.
+        utils::BudgetedRunner &ShortcutRunner()
+        {
+            static utils::BudgetedRunner runner([] {
+                utils::BudgetedRunner::Options options;
+                options.budget = kShortcutBudget;
+                options.threadStart = [] { workerCom.emplace(); };
+                options.threadExit = [] { workerCom.reset(); };
+                return options;
+            }());
+            return runner;
+        }
+
+        struct DeferredShortcuts
+        {
+            std::mutex mutex;
+            std::vector<std::string> paths; // UTF-8 .lnk paths
+        };
+
+        DeferredShortcuts &Deferred()
+        {
+            static DeferredShortcuts deferred;
+            return deferred;
+        }
 
         // --- Start Menu Scanning (Uses Fallback Flag) ---
         // --- Start Menu Scanning (Modified for Description/Kind) ---
-        std::vector<utils::Program> GetProgramsFromStartMenuInternal()
+        // Builds the catalog entry for one Start Menu .lnk, or nullopt if it cannot be resolved.
+        // |stamp| is the link's size/mtime if the caller already has it from a directory scan.
+        std::optional<utils::Program> ProgramFromShortcutInternal(const fs::path &entryPathFs, const char *source, const utils::CancellationToken &token,
+                                                                  std::optional<utils::FileStamp> stamp = std::nullopt)
+        {
+            // An unchanged link resolves to what it did last time, icon included.
+            utils::ShortcutCache &cache = ShortcutCacheInstance();
+            const std::string linkPathUtf8 = utils::WideToUtf8(entryPathFs.wstring());
+            if (!stamp)
+                stamp = utils::FileStamp::Of(entryPathFs);
+            std::optional<utils::ShortcutInfo> shortcutInfoOpt = stamp ? cache.Find(linkPathUtf8, *stamp) : std::nullopt;
+            const bool fromCache = shortcutInfoOpt.has_value();
+
+            // *** Assume utils::ResolveShortcut populates descriptionUtf8 and potentially iconDataBase64 ***
+            if (!fromCache)
+                shortcutInfoOpt = utils::ResolveShortcut(entryPathFs, token);
+            if (!shortcutInfoOpt)
+            {
+                DebugOutput(L"SM INFO: Skipping LNK ('", entryPathFs.wstring().c_str(), L"') - Resolve failed.");
+                return std::nullopt;
+            }
+
+            const utils::ShortcutInfo &shortcutInfo = *shortcutInfoOpt;
+            utils::Program p;
+            p.name = utils::WideToUtf8(entryPathFs.stem().wstring());
+            if (p.name.empty())
+            {
+                p.name = "Unnamed Shortcut Program";
+            }
+
+            p.arguments = shortcutInfo.argumentsUtf8;
+            p.iconPath = shortcutInfo.iconPathUtf8; // Assume already normalized by ResolveShortcut
+            p.iconIndex = shortcutInfo.iconIndex;
+            p.source = source;
+            p.originPath = linkPathUtf8;
+            p.kind = "link";                              // <-- Assign Kind for shortcuts
+            p.description = shortcutInfo.descriptionUtf8; // <-- Assign Description from shortcut
+
+            // Adjust executable path based on fallback flag
+            if (shortcutInfo.isFallbackPath)
+            {
+                p.executablePath = utils::NormalizePath(utils::WideToUtf8(entryPathFs.wstring())); // Use LNK path
+                DebugOutput(L"SM: Using LNK path as executable for '", utils::Utf8ToWide(p.name).c_str(), L"' because resolution used fallback path ('", utils::Utf8ToWide(shortcutInfo.resolvedTargetPathUtf8).c_str(), L"').");
+            }
+            else
+            {
+                p.executablePath = shortcutInfo.resolvedTargetPathUtf8; // Use resolved target (Assume already normalized)
+            }
+
+            // Final validation
+            if (p.executablePath.empty())
+            {
+                DebugOutput(L"SM ERR: Skipping '", utils::Utf8ToWide(p.name).c_str(), L"' - Final executable path empty.");
+                return std::nullopt;
+            }
+
+            // Fallback Icon Path if needed (iconPath wasn't set or ResolveShortcut failed normalization)
+            if (p.iconPath.empty())
+            {
+                p.iconPath = p.executablePath; // Fallback to executable
+                p.iconIndex = 0;
+            }
+            // Ensure non-negative index if path exists
+            if (p.iconIndex < 0 && !p.iconPath.empty())
+                p.iconIndex = 0;
+
+            // Get icon data: Use pre-extracted if available, otherwise extract now
+            if (!shortcutInfo.iconDataBase64.empty())
+            {
+                p.iconDataBase64 = shortcutInfo.iconDataBase64; // Copy if ResolveShortcut provided it
+                DebugOutput(L"SM: Using pre-extracted icon data for '", utils::Utf8ToWide(p.name).c_str(), L"'");
+            }
+            // Only try extracting if we have a valid path/index AND ResolveShortcut didn't provide data
+            else if (!p.iconPath.empty() && p.iconIndex >= 0)
+            {
+                auto encodedIconOpt = utils::ExtractAndEncodeIconAsBase64(p.iconPath, p.iconIndex, token);
+                if (encodedIconOpt)
+                {
+                    p.iconDataBase64 = std::move(*encodedIconOpt); // Move the data
+                }
+                else
+                {
+                    DebugOutput(L"SM: Icon extraction failed for '", utils::Utf8ToWide(p.name), L"' (Path: '", utils::Utf8ToWide(p.iconPath), L"', Index: ", p.iconIndex, L")");
+                }
+            }
+
+            if (stamp && !fromCache && !token.IsCancelled())
+            {
+                utils::ShortcutInfo resolved = shortcutInfo;
+                resolved.iconDataBase64 = p.iconDataBase64;
+                cache.Store(linkPathUtf8, *stamp, resolved);
+            }
+
+            DebugOutput(L"SM: Adding Program: Name='", utils::Utf8ToWide(p.name).c_str(),
+                        L"', FinalExecPath='", utils::Utf8ToWide(p.executablePath).c_str(),
+                        L"', Kind='", utils::Utf8ToWide(p.kind).c_str(),
+                        L"', Desc='", utils::Utf8ToWide(p.description).c_str(),
+                        L"', IconPath='", utils::Utf8ToWide(p.iconPath).c_str(), L"', IconIndex=", p.iconIndex);
+            return p;
+        }
+
+        enum class BudgetOutcome
+        {
+            Met,
+            Overran,
+            Refused, // Too many earlier shortcuts still stuck; not attempted
+        };
+
+        // ProgramFromShortcutInternal() within kShortcutBudget. A shortcut that takes
+        // longer is left to finish on its own and, with |queueDeferred|, queued for
+        // TakeDeferredShortcuts(), as is one the runner had no room for. The job owns
+        // copies of everything it uses, |statCache| included, since it may outlive
+        // the caller.
+        std::optional<utils::Program> ProgramFromShortcutBudgeted(const fs::path &entryPathFs, const std::string &source, const utils::CancellationToken &token,
+                                                                  std::optional<utils::FileStamp> stamp, std::shared_ptr<utils::StatCache> statCache,
+                                                                  BudgetOutcome &budget, bool queueDeferred = true)
+        {
+            using Outcome = std::optional<utils::Program>;
+            utils::BudgetedRunner &runner = ShortcutRunner();
+            const bool saturated = runner.Saturated();
+            std::optional<Outcome> outcome;
+            if (!saturated)
+            {
+                outcome = runner.Call<Outcome>([entryPathFs, source, token, stamp, statCache]() -> Outcome {
+                    CacheUse caches;
+                    std::optional<utils::StatCache::Scope> statScope;
+                    if (statCache)
+                        statScope.emplace(*statCache);
+                    return ProgramFromShortcutInternal(entryPathFs, source.c_str(), token, stamp);
+                });
+            }
+            budget = outcome ? BudgetOutcome::Met : saturated ? BudgetOutcome::Refused : BudgetOutcome::Overran;
+            if (outcome)
+                return std::move(*outcome);
+
+            DebugOutput(L"SM WARN: Deferring '", entryPathFs.wstring().c_str(), saturated ? L"' - resolver saturated." : L"' - over its budget.");
+            if (!queueDeferred)
+                return std::nullopt;
+            DeferredShortcuts &deferred = Deferred();
+            std::lock_guard<std::mutex> guard(deferred.mutex);
+            deferred.paths.push_back(utils::WideToUtf8(entryPathFs.wstring()));
+            return std::nullopt;
+        }
+
+        std::vector<utils::Program> GetProgramsFromStartMenuInternal(const utils::CancellationToken &token, const std::shared_ptr<utils::StatCache> &statCache)
         {
             std::vector<utils::Program> programs;
+            utils::QuarantineList &quarantine = QuarantineInstance();
             const KNOWNFOLDERID knownFolderIds[] = {FOLDERID_CommonPrograms, FOLDERID_Programs};
             const char *sourceNames[] = {"Start Menu (Common)", "Start Menu (User)"};
 
-            for (size_t i = 0; i < ARRAYSIZE(knownFolderIds); ++i)
+            for (size_t i = 0; i < ARRAYSIZE(knownFolderIds) && !token.IsCancelled(); ++i)
             {
                 PWSTR folderPathRaw = nullptr;
                 HRESULT hr = SHGetKnownFolderPath(knownFolderIds[i], KF_FLAG_DEFAULT, NULL, &folderPathRaw);
@@ -224,6 +499,11 @@ namespace ProgramFinder
 
                         while (dir_iter != end_iter)
                         {
+                            if (token.IsCancelled())
+                            {
+                                DebugOutput(L"SM: Scan cancelled.");
+                                break;
+                            }
                             try
                             {
                                 const auto &entry = *dir_iter;
@@ -231,87 +511,21 @@ namespace ProgramFinder
                                 std::error_code file_ec;
                                 if (entry.is_regular_file(file_ec) && !file_ec && entryPathFs.has_extension() && _wcsicmp(entryPathFs.extension().c_str(), L".lnk") == 0)
                                 {
-                                    // *** Assume utils::ResolveShortcut populates descriptionUtf8 and potentially iconDataBase64 ***
-                                    std::optional<utils::ShortcutInfo> shortcutInfoOpt = utils::ResolveShortcut(entryPathFs);
-
-                                    if (shortcutInfoOpt)
+                                    const std::string item = utils::WideToUtf8(entryPathFs.wstring());
+                                    if (quarantine.IsQuarantined(item))
                                     {
-                                        const utils::ShortcutInfo &shortcutInfo = *shortcutInfoOpt;
-                                        utils::Program p;
-                                        p.name = utils::WideToUtf8(entryPathFs.stem().wstring());
-                                        if (p.name.empty())
-                                        {
-                                            p.name = "Unnamed Shortcut Program";
-                                        }
-
-                                        p.arguments = shortcutInfo.argumentsUtf8;
-                                        p.iconPath = shortcutInfo.iconPathUtf8; // Assume already normalized by ResolveShortcut
-                                        p.iconIndex = shortcutInfo.iconIndex;
-                                        p.source = sourceNames[i];
-                                        p.kind = "link";                              // <-- Assign Kind for shortcuts
-                                        p.description = shortcutInfo.descriptionUtf8; // <-- Assign Description from shortcut
-
-                                        // Adjust executable path based on fallback flag
-                                        if (shortcutInfo.isFallbackPath)
-                                        {
-                                            p.executablePath = utils::NormalizePath(utils::WideToUtf8(entryPathFs.wstring())); // Use LNK path
-                                            DebugOutput(L"SM: Using LNK path as executable for '", utils::Utf8ToWide(p.name).c_str(), L"' because resolution used fallback path ('", utils::Utf8ToWide(shortcutInfo.resolvedTargetPathUtf8).c_str(), L"').");
-                                        }
-                                        else
-                                        {
-                                            p.executablePath = shortcutInfo.resolvedTargetPathUtf8; // Use resolved target (Assume already normalized)
-                                        }
-
-                                        // Final validation
-                                        if (p.executablePath.empty())
-                                        {
-                                            DebugOutput(L"SM ERR: Skipping '", utils::Utf8ToWide(p.name).c_str(), L"' - Final executable path empty.");
-                                            // Safe increment handled below, just continue loop iteration
-                                        }
-                                        else
-                                        {
-                                            // Fallback Icon Path if needed (iconPath wasn't set or ResolveShortcut failed normalization)
-                                            if (p.iconPath.empty())
-                                            {
-                                                p.iconPath = p.executablePath; // Fallback to executable
-                                                p.iconIndex = 0;
-                                            }
-                                            // Ensure non-negative index if path exists
-                                            if (p.iconIndex < 0 && !p.iconPath.empty())
-                                                p.iconIndex = 0;
-
-                                            // Get icon data: Use pre-extracted if available, otherwise extract now
-                                            if (!shortcutInfo.iconDataBase64.empty())
-                                            {
-                                                p.iconDataBase64 = shortcutInfo.iconDataBase64; // Copy if ResolveShortcut provided it
-                                                DebugOutput(L"SM: Using pre-extracted icon data for '", utils::Utf8ToWide(p.name).c_str(), L"'");
-                                            }
-                                            // Only try extracting if we have a valid path/index AND ResolveShortcut didn't provide data
-                                            else if (!p.iconPath.empty() && p.iconIndex >= 0)
-                                            {
-                                                // Call the extraction function defined within the anonymous namespace
-                                                auto encodedIconOpt = utils::ExtractAndEncodeIconAsBase64(p.iconPath, p.iconIndex);
-                                                if (encodedIconOpt)
-                                                {
-                                                    p.iconDataBase64 = std::move(*encodedIconOpt); // Move the data
-                                                }
-                                                else
-                                                {
-                                                    DebugOutput(L"SM: Icon extraction failed for '", utils::Utf8ToWide(p.name), L"' (Path: '", utils::Utf8ToWide(p.iconPath), L"', Index: ", p.iconIndex, L")");
-                                                }
-                                            }
-
-                                            DebugOutput(L"SM: Adding Program: Name='", utils::Utf8ToWide(p.name).c_str(),
-                                                        L"', FinalExecPath='", utils::Utf8ToWide(p.executablePath).c_str(),
-                                                        L"', Kind='", utils::Utf8ToWide(p.kind).c_str(),
-                                                        L"', Desc='", utils::Utf8ToWide(p.description).c_str(),
-                                                        L"', IconPath='", utils::Utf8ToWide(p.iconPath).c_str(), L"', IconIndex=", p.iconIndex);
-                                            programs.push_back(std::move(p));
-                                        }
+                                        DebugOutput(L"SM: Skipping quarantined '", entryPathFs.wstring().c_str(), L"'");
                                     }
                                     else
                                     {
-                                        DebugOutput(L"SM INFO: Skipping LNK ('", entryPathFs.wstring().c_str(), L"') - Resolve failed.");
+                                        BudgetOutcome budget = BudgetOutcome::Met;
+                                        std::optional<utils::Program> program = ProgramFromShortcutBudgeted(entryPathFs, sourceNames[i], token, utils::FileStamp::Of(entry), statCache, budget);
+                                        if (budget == BudgetOutcome::Overran)
+                                            quarantine.RecordTimeout(item);
+                                        else if (budget == BudgetOutcome::Met)
+                                            quarantine.RecordSuccess(item);
+                                        if (program)
+                                            programs.push_back(std::move(*program));
                                     }
                                 } // End if (is .lnk file)
                             } // End inner try
@@ -372,383 +586,263 @@ namespace ProgramFinder
         }
 
         // --- Registry Scanning (Modified for Description/Kind) ---
-        std::vector<utils::Program> GetInstalledProgramsFromRegistryInternal()
+        // Builds the catalog entry for one Uninstall subkey, or nullopt if it is filtered out.
+        std::optional<utils::Program> ProgramFromUninstallKeyInternal(const utils::RegistryKey &appKey, const std::wstring &subKeyName, const std::string &rootKeyName, const utils::CancellationToken &token)
         {
-            std::vector<utils::Program> programs;
-            const HKEY hiveRoots[] = {HKEY_LOCAL_MACHINE, HKEY_CURRENT_USER};
-            const WCHAR *uninstallKeysW[] = {
-                L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall",
-                L"SOFTWARE\\WOW6432Node\\Microsoft\\Windows\\CurrentVersion\\Uninstall"};
+            std::string displayNameUtf8;
+            std::string descriptionUtf8;   // For description
+            std::wstring executablePathW;  // Parsed executable path
+            std::wstring argumentsW;       // Parsed arguments
+            std::wstring iconPathW;        // Parsed icon path
+            int iconIndex = 0;             // Parsed icon index
+            std::wstring uninstallStringW; // Raw uninstall string
 
-            for (HKEY hRootKey : hiveRoots)
+            // --- Get DisplayName ---
+            std::wstring displayNameW = appKey.StringValue(L"DisplayName").value_or(L"");
+            if (!displayNameW.empty())
             {
-                std::string rootKeyName = (hRootKey == HKEY_LOCAL_MACHINE) ? "HKLM" : "HKCU";
-                for (const WCHAR *regPath : uninstallKeysW)
-                {
-                    REGSAM wow64Access = KEY_WOW64_64KEY;
-                    if (wcsstr(regPath, L"WOW6432Node") != nullptr)
-                        wow64Access = KEY_WOW64_32KEY;
+                displayNameUtf8 = utils::WideToUtf8(displayNameW);
+            }
+            else
+            {
+                displayNameUtf8 = utils::WideToUtf8(subKeyName); // Fallback to key name
+                displayNameW = subKeyName;
+            }
 
-                    HKEY hUninstallKeyRaw = NULL;
-                    LSTATUS openStatus = RegOpenKeyExW(hRootKey, regPath, 0, KEY_READ | KEY_ENUMERATE_SUB_KEYS | wow64Access, &hUninstallKeyRaw);
-                    if (openStatus != ERROR_SUCCESS)
-                    {
-                        if (openStatus != ERROR_FILE_NOT_FOUND)
-                        { // Don't log expected "not found" errors
-                            DebugOutput(L"REG WARN: Failed to open key '", regPath, L"' in ", utils::Utf8ToWide(rootKeyName).c_str(), L". Status: ", openStatus);
-                        }
-                        continue;
-                    }
-                    RegKeyUniquePtr hUninstallKey(hUninstallKeyRaw);
+            // --- Check Filters (SystemComponent, Updates etc.) ---
+            bool isSystemComponent = appKey.DwordValue(L"SystemComponent") == 1u;
+            bool isWindowsInstaller = appKey.DwordValue(L"WindowsInstaller") == 1u;
+            bool isUpdateEtc = (displayNameW.rfind(L"KB", 0) == 0 || displayNameW.find(L"Security Update") != std::wstring::npos || displayNameW.find(L"Update for Microsoft") != std::wstring::npos);
 
-                    DWORD subKeyIndex = 0;
-                    WCHAR subKeyNameW[256];
-                    while (true)
-                    {
-                        DWORD subKeyNameLen = ARRAYSIZE(subKeyNameW);
-                        LSTATUS enumStatus = RegEnumKeyExW(hUninstallKey.get(), subKeyIndex++, subKeyNameW, &subKeyNameLen, NULL, NULL, NULL, NULL);
-                        if (enumStatus == ERROR_NO_MORE_ITEMS)
-                            break;
-                        if (enumStatus != ERROR_SUCCESS)
-                            continue;
+            if (displayNameUtf8.empty() || isSystemComponent || isUpdateEtc)
+            {
+                DebugOutput(L"REG: Skipping '", displayNameW.c_str(), L"' (System/Update/Empty)");
+                return std::nullopt;
+            }
 
-                        HKEY hAppKeyRaw = NULL;
-                        LSTATUS appKeyStatus = RegOpenKeyExW(hUninstallKey.get(), subKeyNameW, 0, KEY_READ | wow64Access, &hAppKeyRaw);
-                        if (appKeyStatus == ERROR_SUCCESS)
-                        {
-                            RegKeyUniquePtr hAppKey(hAppKeyRaw);
-                            DWORD valueType = 0;
-                            std::string displayNameUtf8;
-                            std::string descriptionUtf8;   // For description
-                            std::wstring executablePathW;  // Parsed executable path
-                            std::wstring argumentsW;       // Parsed arguments
-                            std::wstring iconPathW;        // Parsed icon path
-                            int iconIndex = 0;             // Parsed icon index
-                            std::wstring uninstallStringW; // Raw uninstall string
-
-                            // --- Get DisplayName ---
-                            WCHAR displayNameW[512] = {0};
-                            DWORD displayNameSize = sizeof(displayNameW);
-                            LSTATUS nameStatus = RegQueryValueExW(hAppKey.get(), L"DisplayName", 0, &valueType, reinterpret_cast<LPBYTE>(displayNameW), &displayNameSize);
-                            if (nameStatus == ERROR_SUCCESS && valueType == REG_SZ && displayNameW[0] != L'\0')
-                            {
-                                displayNameUtf8 = utils::WideToUtf8(displayNameW);
-                            }
-                            else
-                            {
-                                displayNameUtf8 = utils::WideToUtf8(subKeyNameW); // Fallback to key name
-                                wcscpy_s(displayNameW, ARRAYSIZE(displayNameW), subKeyNameW);
-                            }
+            // --- Get UninstallString (or QuietUninstallString) ---
+            bool gotUninstall = false;
+            if (std::optional<std::wstring> quiet = appKey.StringValue(L"QuietUninstallString"); quiet && !quiet->empty())
+            {
+                uninstallStringW = std::move(*quiet);
+                gotUninstall = true;
+            }
+            if (!gotUninstall)
+            {
+                if (std::optional<std::wstring> uninstall = appKey.StringValue(L"UninstallString"); uninstall && !uninstall->empty())
+                {
+                    uninstallStringW = std::move(*uninstall);
+                    gotUninstall = true;
+                }
+            }
 
-                            // --- Check Filters (SystemComponent, Updates etc.) ---
-                            DWORD systemComponent = 0;
-                            DWORD systemComponentSize = sizeof(systemComponent);
-                            bool isSystemComponent = (RegQueryValueExW(hAppKey.get(), L"SystemComponent", 0, &valueType, reinterpret_cast<LPBYTE>(&systemComponent), &systemComponentSize) == ERROR_SUCCESS && valueType == REG_DWORD && systemComponent == 1);
+            if ((!gotUninstall || uninstallStringW.empty()) && isWindowsInstaller)
+            {
+                DebugOutput(L"REG: Skipping '", displayNameW.c_str(), L"' (WindowsInstaller entry without explicit UninstallString)");
+                return std::nullopt;
+            }
+            if (!gotUninstall || uninstallStringW.empty())
+            {
+                DebugOutput(L"REG: Skipping '", displayNameW.c_str(), L"' (No UninstallString found)");
+                return std::nullopt;
+            }
 
-                            bool isWindowsInstaller = false;
-                            DWORD winInstallerFlag = 0;
-                            DWORD winInstallerFlagSize = sizeof(winInstallerFlag);
-                            if (RegQueryValueExW(hAppKey.get(), L"WindowsInstaller", 0, &valueType, reinterpret_cast<LPBYTE>(&winInstallerFlag), &winInstallerFlagSize) == ERROR_SUCCESS && valueType == REG_DWORD && winInstallerFlag == 1)
-                            {
-                                isWindowsInstaller = true;
-                            }
-                            bool isUpdateEtc = (wcsstr(displayNameW, L"KB") == displayNameW || wcsstr(displayNameW, L"Security Update") != nullptr || wcsstr(displayNameW, L"Update for Microsoft") != nullptr);
+            // --- Parse Executable and Arguments from UninstallString ---
+            // Views into uninstallStringW; arguments are kept exactly as written.
+            const utils::UninstallCommand<wchar_t> command = utils::ParseUninstallString<wchar_t>(uninstallStringW);
+            WCHAR potentialPathW[MAX_PATH * 2] = {0};
+            DWORD searchResult = 0;
+            if (!command.exactProgram)
+            {
+                // No ".exe" boundary: the whole unquoted string may still name the file.
+                searchResult = SearchPathW(NULL, uninstallStringW.c_str(), L".exe", ARRAYSIZE(potentialPathW), potentialPathW, NULL);
+                if (searchResult > 0 && searchResult < ARRAYSIZE(potentialPathW)) // SearchPathW only returns existing files
+                {
+                    executablePathW = potentialPathW;
+                    DebugOutput(L"REG INFO: Unquoted UninstallString '", uninstallStringW.c_str(), L"' resolved directly for '", displayNameW.c_str(), L"'. Assuming no args.");
+                }
+            }
+            if (executablePathW.empty())
+            {
+                const std::wstring programW(command.program);
+                searchResult = SearchPathW(NULL, programW.c_str(), L".exe", ARRAYSIZE(potentialPathW), potentialPathW, NULL);
+                if (searchResult > 0 && searchResult < ARRAYSIZE(potentialPathW))
+                {
+                    executablePathW = potentialPathW; // Resolved path
+                }
+                else
+                {
+                    executablePathW = programW; // Fallback: the program as written
+                    DebugOutput(L"REG WARN: SearchPathW failed for '", programW.c_str(), L"' in '", displayNameW.c_str(), L"'. Using it as path.");
+                }
+                argumentsW = command.arguments;
+            }
 
-                            if (displayNameUtf8.empty() || isSystemComponent || isUpdateEtc)
-                            {
-                                DebugOutput(L"REG: Skipping '", displayNameW, L"' (System/Update/Empty)");
-                                continue;
-                            }
+            if (executablePathW.empty())
+            {
+                DebugOutput(L"REG: Skipping '", displayNameW.c_str(), L"' (Could not determine executable path)");
+                return std::nullopt;
+            }
 
-                            // --- Get UninstallString (or QuietUninstallString) ---
-                            WCHAR uninstallBufW[MAX_PATH * 2] = {0};
-                            DWORD uninstallBufSize = sizeof(uninstallBufW);
-                            bool gotUninstall = false;
-                            if (RegQueryValueExW(hAppKey.get(), L"QuietUninstallString", 0, &valueType, reinterpret_cast<LPBYTE>(uninstallBufW), &uninstallBufSize) == ERROR_SUCCESS && valueType == REG_SZ && uninstallBufW[0] != L'\0')
-                            {
-                                uninstallStringW = uninstallBufW;
-                                gotUninstall = true;
-                            }
-                            if (!gotUninstall)
-                            {
-                                uninstallBufSize = sizeof(uninstallBufW);
-                                if (RegQueryValueExW(hAppKey.get(), L"UninstallString", 0, &valueType, reinterpret_cast<LPBYTE>(uninstallBufW), &uninstallBufSize) == ERROR_SUCCESS && valueType == REG_SZ && uninstallBufW[0] != L'\0')
-                                {
-                                    uninstallStringW = uninstallBufW;
-                                    gotUninstall = true;
-                                }
-                            }
+            // --- Get DisplayIcon ---
+            iconIndex = 0; // Default index
 
-                            if ((!gotUninstall || uninstallStringW.empty()) && isWindowsInstaller)
-                            {
-                                DebugOutput(L"REG: Skipping '", displayNameW, L"' (WindowsInstaller entry without explicit UninstallString)");
-                                continue;
-                            }
-                            if (!gotUninstall || uninstallStringW.empty())
-                            {
-                                DebugOutput(L"REG: Skipping '", displayNameW, L"' (No UninstallString found)");
-                                continue;
-                            }
+            if (std::optional<std::wstring> displayIcon = appKey.StringValue(L"DisplayIcon"); displayIcon && !displayIcon->empty())
+            {
+                WCHAR displayIconW[MAX_PATH * 2] = {0};
+                wcsncpy_s(displayIconW, ARRAYSIZE(displayIconW), displayIcon->c_str(), _TRUNCATE);
 
-                            // --- NEW: Parse Executable and Arguments from UninstallString ---
-                            WCHAR potentialPathW[MAX_PATH * 2] = {0};
-                            bool isQuoted = (!uninstallStringW.empty() && uninstallStringW.front() == L'"');
+                // Expand environment variables (e.g., %SystemRoot%)
+                WCHAR expandedIconPathW[MAX_PATH * 2] = {0};
+                DWORD expandedLen = ExpandEnvironmentStringsW(displayIconW, expandedIconPathW, ARRAYSIZE(expandedIconPathW));
 
-                            if (isQuoted)
-                            {
-                                // Path is quoted, use CommandLineToArgvW
-                                int argc = 0;
-                                LocalMemUniquePtr argvW_ptr((LPWSTR *)CommandLineToArgvW(uninstallStringW.c_str(), &argc));
-                                if (argvW_ptr && argc > 0)
-                                {
-                                    LPWSTR *argvW = (LPWSTR *)argvW_ptr.get();
-                                    std::wstring firstArg = argvW[0];
-                                    // PathUnquoteSpacesW(&firstArg[0]); // CommandLineToArgvW handles quotes, PathUnquoteSpaces might remove needed internal quotes if any. SearchPathW should handle it.
-
-                                    // Resolve path using SearchPathW
-                                    DWORD searchResult = SearchPathW(NULL, firstArg.c_str(), L".exe", ARRAYSIZE(potentialPathW), potentialPathW, NULL);
-                                    if (searchResult > 0 && searchResult < ARRAYSIZE(potentialPathW))
-                                    {
-                                        executablePathW = potentialPathW; // Resolved path
-                                    }
-                                    else
-                                    {
-                                        // Fallback: Use the first argument as is, if it exists (less reliable for quoted)
-                                        executablePathW = firstArg; // Use unquoted first arg
-                                        DebugOutput(L"REG WARN: SearchPathW failed for quoted arg '", firstArg.c_str(), L"' in '", displayNameW, L"'. Using arg as path.");
-                                    }
+                // Use expanded path if successful, otherwise fallback to raw path
+                WCHAR *pathBuffer = (expandedLen > 0 && expandedLen < ARRAYSIZE(expandedIconPathW)) ? expandedIconPathW : displayIconW;
 
-                                    // Reconstruct arguments
-                                    std::wstringstream ssArgs;
-                                    for (int k = 1; k < argc; ++k)
-                                    {
-                                        std::wstring arg = argvW[k];
-                                        bool needsQuotes = (arg.find(L' ') != std::wstring::npos || arg.find(L'\t') != std::wstring::npos) && (arg.length() > 0 && arg.front() != L'"');
-                                        if (k > 1) ssArgs << L" ";
-                                        if (needsQuotes) ssArgs << L"\"";
-                                        ssArgs << arg;
-                                        if (needsQuotes) ssArgs << L"\"";
-                                    }
-                                    argumentsW = ssArgs.str();
-                                }
-                                else
-                                {
-                                    // Parsing failed, fallback to treating the whole (unquoted) string as path
-                                    std::wstring unquotedUninstall = uninstallStringW;
-                                    PathUnquoteSpacesW(&unquotedUninstall[0]); // Unquote the original string
-                                    executablePathW = unquotedUninstall;
-                                    argumentsW = L"";
-                                    DebugOutput(L"REG INFO: CommandLineToArgvW failed for quoted '", displayNameW, L"', using unquoted string as path.");
-                                }
-                            }
-                            else // Not quoted
-                            {
-                                // Try resolving the entire unquoted string first
-                                DWORD searchResult = SearchPathW(NULL, uninstallStringW.c_str(), L".exe", ARRAYSIZE(potentialPathW), potentialPathW, NULL);
-                                if (searchResult > 0 && searchResult < ARRAYSIZE(potentialPathW) && utils::DoesPathExist(potentialPathW))
-                                {
-                                    // Success: Entire string resolves to a valid executable path
-                                    executablePathW = potentialPathW;
-                                    argumentsW = L"";
-                                    DebugOutput(L"REG INFO: Unquoted UninstallString '", uninstallStringW.c_str(), L"' resolved directly for '", displayNameW, L"'. Assuming no args.");
-                                }
-                                else
-                                {
-                                    // Whole string didn't resolve, now try CommandLineToArgvW
-                                    int argc = 0;
-                                    LocalMemUniquePtr argvW_ptr((LPWSTR *)CommandLineToArgvW(uninstallStringW.c_str(), &argc));
-                                    if (argvW_ptr && argc > 0)
-                                    {
-                                        LPWSTR *argvW = (LPWSTR *)argvW_ptr.get();
-                                        std::wstring firstArg = argvW[0];
-                                        // PathUnquoteSpacesW(&firstArg[0]); // Not needed as it wasn't quoted initially
-
-                                        // Resolve first argument using SearchPathW
-                                        searchResult = SearchPathW(NULL, firstArg.c_str(), L".exe", ARRAYSIZE(potentialPathW), potentialPathW, NULL);
-                                        if (searchResult > 0 && searchResult < ARRAYSIZE(potentialPathW))
-                                        {
-                                            executablePathW = potentialPathW; // Resolved path from first arg
-                                        }
-                                        else
-                                        {
-                                            // Fallback: Use the first argument as is
-                                            executablePathW = firstArg;
-                                            DebugOutput(L"REG WARN: SearchPathW failed for first arg '", firstArg.c_str(), L"' of unquoted string for '", displayNameW, L"'. Using arg as path.");
-                                        }
-
-                                        // Reconstruct arguments from the rest
-                                        std::wstringstream ssArgs;
-                                        for (int k = 1; k < argc; ++k)
-                                        {
-                                            std::wstring arg = argvW[k];
-                                            bool needsQuotes = (arg.find(L' ') != std::wstring::npos || arg.find(L'\t') != std::wstring::npos) && (arg.length() > 0 && arg.front() != L'"');
-                                            if (k > 1) ssArgs << L" ";
-                                            if (needsQuotes) ssArgs << L"\"";
-                                            ssArgs << arg;
-                                            if (needsQuotes) ssArgs << L"\"";
-                                        }
-                                        argumentsW = ssArgs.str();
-                                    }
-                                    else
-                                    {
-                                        // Parsing failed completely, fallback to treating the whole string as path
-                                        executablePathW = uninstallStringW;
-                                        argumentsW = L"";
-                                        DebugOutput(L"REG INFO: CommandLineToArgvW failed for unquoted '", displayNameW, L"', using original string as path.");
-                                    }
-                                }
-                            }
-                            // --- END NEW PARSING LOGIC ---
+                // --- CORRECT USAGE OF PathParseIconLocationW ---
+                // 1. Call PathParseIconLocationW - it RETURNS the index and MODIFIES the buffer
+                iconIndex = PathParseIconLocationW(pathBuffer); // This returns the index and modifies pathBuffer
+                // 2. pathBuffer now holds ONLY the path part
+                iconPathW = pathBuffer; // Assign the modified buffer to iconPathW
+                // --- END CORRECT USAGE ---
 
+                // Check if the index is valid, default to 0 if negative
+                if (iconIndex < 0)
+                {
+                    DebugOutput(L"REG WARN: Negative icon index returned for '", displayNameW.c_str(), L"'. Defaulting to 0.");
+                    iconIndex = 0;
+                }
 
-                            if (executablePathW.empty())
-                            {
-                                DebugOutput(L"REG: Skipping '", displayNameW, L"' (Could not determine executable path)");
-                                continue;
-                            }
+                // Verify the path exists after parsing
+                if (!utils::DoesPathExist(iconPathW))
+                {
+                    DebugOutput(L"REG WARN: Parsed icon path '", iconPathW.c_str(), L"' does not exist for '", displayNameW.c_str(), L"'. Will fallback.");
+                    iconPathW.clear(); // Clear path so fallback is triggered
+                }
+            }
+            // If no valid DisplayIcon found or path didn't exist after parsing, iconPathW remains empty
 
-                            // --- Get DisplayIcon ---
-                            WCHAR displayIconW[MAX_PATH * 2] = {0};
-                            DWORD displayIconSize = sizeof(displayIconW);
-                            iconIndex = 0; // Default index
+            // --- Get Comments (Description) ---
+            if (std::optional<std::wstring> comments = appKey.StringValue(L"Comments"); comments && !comments->empty())
+            {
+                descriptionUtf8 = utils::WideToUtf8(*comments);
+            }
 
-                            if (RegQueryValueExW(hAppKey.get(), L"DisplayIcon", 0, &valueType, reinterpret_cast<LPBYTE>(displayIconW), &displayIconSize) == ERROR_SUCCESS && valueType == REG_SZ && displayIconW[0] != L'\0')
-                            {
-                                // Expand environment variables (e.g., %SystemRoot%)
-                                WCHAR expandedIconPathW[MAX_PATH * 2] = {0};
-                                DWORD expandedLen = ExpandEnvironmentStringsW(displayIconW, expandedIconPathW, ARRAYSIZE(expandedIconPathW));
-
-                                // Use expanded path if successful, otherwise fallback to raw path
-                                WCHAR *pathBuffer = (expandedLen > 0 && expandedLen < ARRAYSIZE(expandedIconPathW)) ? expandedIconPathW : displayIconW;
-
-                                // --- CORRECT USAGE OF PathParseIconLocationW ---
-                                // 1. Call PathParseIconLocationW - it RETURNS the index and MODIFIES the buffer
-                                iconIndex = PathParseIconLocationW(pathBuffer); // This returns the index and modifies pathBuffer
-                                // 2. pathBuffer now holds ONLY the path part
-                                iconPathW = pathBuffer; // Assign the modified buffer to iconPathW
-                                // --- END CORRECT USAGE ---
-
-                                // Check if the index is valid, default to 0 if negative
-                                if (iconIndex < 0)
-                                {
-                                    DebugOutput(L"REG WARN: Negative icon index returned for '", displayNameW, L"'. Defaulting to 0.");
-                                    iconIndex = 0;
-                                }
+            // --- Create and Populate Program Struct ---
+            utils::Program prog;
+            prog.name = displayNameUtf8;
+            prog.source = rootKeyName + " Uninstall";
+            prog.executablePath = utils::NormalizePath(utils::WideToUtf8(executablePathW));
+            prog.kind = "program";              // Assign Kind for registry entries
+            prog.description = descriptionUtf8; // Assign Description
 
-                                // Verify the path exists after parsing
-                                if (!utils::DoesPathExist(iconPathW))
-                                {
-                                    DebugOutput(L"REG WARN: Parsed icon path '", iconPathW.c_str(), L"' does not exist for '", displayNameW, L"'. Will fallback.");
-                                    iconPathW.clear(); // Clear path so fallback is triggered
-                                }
-                            }
-                            // If no valid DisplayIcon found or path didn't exist after parsing, iconPathW remains empty
+            if (prog.executablePath.empty() && !executablePathW.empty())
+            {
+                DebugOutput(L"REG WARN: Normalization/UTF8 failed for executable path '", executablePathW.c_str(), L"'. Skipping entry '", displayNameW.c_str(), L"'.");
+                return std::nullopt;
+            }
+            if (prog.executablePath.empty())
+            {
+                DebugOutput(L"REG WARN: Executable path became empty for '", displayNameW.c_str(), L"'. Skipping.");
+                return std::nullopt;
+            }
 
-                            // --- Get Comments (Description) ---
-                            WCHAR commentsW[1024] = {0}; // Buffer for comments
-                            DWORD commentsSize = sizeof(commentsW);
-                            if (RegQueryValueExW(hAppKey.get(), L"Comments", 0, &valueType, reinterpret_cast<LPBYTE>(commentsW), &commentsSize) == ERROR_SUCCESS && valueType == REG_SZ && commentsW[0] != L'\0')
-                            {
-                                descriptionUtf8 = utils::WideToUtf8(commentsW);
-                            }
+            prog.arguments = utils::WideToUtf8(argumentsW);
+            if (prog.arguments.empty() && !argumentsW.empty())
+            {
+                DebugOutput(L"REG WARN: UTF8 conversion failed for arguments '", argumentsW.c_str(), L"'. Args cleared.");
+                prog.arguments.clear();
+            }
 
-                            // --- Create and Populate Program Struct ---
-                            utils::Program prog;
-                            prog.name = displayNameUtf8;
-                            prog.source = rootKeyName + " Uninstall";
-                            prog.executablePath = utils::NormalizePath(utils::WideToUtf8(executablePathW));
-                            prog.kind = "program";              // Assign Kind for registry entries
-                            prog.description = descriptionUtf8; // Assign Description
+            // --- Finalize icon path ---
+            std::string finalIconPathUtf8;
+            int finalIconIndex = 0;
 
-                            if (prog.executablePath.empty() && !executablePathW.empty())
-                            {
-                                DebugOutput(L"REG WARN: Normalization/UTF8 failed for executable path '", executablePathW.c_str(), L"'. Skipping entry '", displayNameW, L"'.");
-                                continue;
-                            }
-                            if (prog.executablePath.empty())
-                            {
-                                DebugOutput(L"REG WARN: Executable path became empty for '", displayNameW, L"'. Skipping.");
-                                continue;
-                            }
+            // Use parsed iconPathW if it exists and is valid
+            if (!iconPathW.empty())
+            {
+                finalIconPathUtf8 = utils::NormalizePath(utils::WideToUtf8(iconPathW));
+                if (!finalIconPathUtf8.empty())
+                {
+                    finalIconIndex = iconIndex; // Use the index parsed from DisplayIcon
+                }
+                else
+                {
+                    DebugOutput(L"REG WARN: Normalization/UTF8 failed for icon path '", iconPathW, L"'. Will fallback.");
+                }
+            }
 
-                            prog.arguments = utils::WideToUtf8(argumentsW);
-                            if (prog.arguments.empty() && !argumentsW.empty())
-                            {
-                                DebugOutput(L"REG WARN: UTF8 conversion failed for arguments '", argumentsW.c_str(), L"'. Args cleared.");
-                                prog.arguments.clear();
-                            }
+            // If icon path is still empty (no DisplayIcon, parse failed, normalization failed, or path didn't exist),
+            // use the main executable path as the icon source.
+            if (finalIconPathUtf8.empty())
+            {
+                finalIconPathUtf8 = prog.executablePath; // Already normalized
+                finalIconIndex = 0;                      // Default index for executable
+            }
 
-                            // --- Finalize icon path ---
-                            std::string finalIconPathUtf8;
-                            int finalIconIndex = 0;
+            // Ensure index isn't negative (redundant check, but safe)
+            if (finalIconIndex < 0)
+                finalIconIndex = 0;
 
-                            // Use parsed iconPathW if it exists and is valid
-                            if (!iconPathW.empty())
-                            {
-                                finalIconPathUtf8 = utils::NormalizePath(utils::WideToUtf8(iconPathW));
-                                if (!finalIconPathUtf8.empty())
-                                {
-                                    finalIconIndex = iconIndex; // Use the index parsed from DisplayIcon
-                                }
-                                else
-                                {
-                                    DebugOutput(L"REG WARN: Normalization/UTF8 failed for icon path '", iconPathW, L"'. Will fallback.");
-                                }
-                            }
+            prog.iconPath = finalIconPathUtf8;
+            prog.iconIndex = finalIconIndex;
 
-                            // If icon path is still empty (no DisplayIcon, parse failed, normalization failed, or path didn't exist),
-                            // use the main executable path as the icon source.
-                            if (finalIconPathUtf8.empty())
-                            {
-                                finalIconPathUtf8 = prog.executablePath; // Already normalized
-                                finalIconIndex = 0;                      // Default index for executable
-                            }
+            // Extract and encode icon
+            if (!prog.iconPath.empty() && prog.iconIndex >= 0)
+            {
+                // Call the extraction function defined within the anonymous namespace
+                auto encodedIconOpt = utils::ExtractAndEncodeIconAsBase64(prog.iconPath, prog.iconIndex, token);
+                if (encodedIconOpt)
+                {
+                    prog.iconDataBase64 = std::move(*encodedIconOpt);
+                }
+                else
+                {
+                    DebugOutput(L"REG: Icon extraction failed for '", displayNameW.c_str(), L"' (Path: '", utils::Utf8ToWide(prog.iconPath).c_str(), L"', Index: ", prog.iconIndex, L")");
+                }
+            }
+            else
+            {
+                DebugOutput(L"REG INFO: No valid icon path/index for '", displayNameW.c_str(), L"'. No icon extracted.");
+            }
 
-                            // Ensure index isn't negative (redundant check, but safe)
-                            if (finalIconIndex < 0)
-                                finalIconIndex = 0;
+            DebugOutput(L"REG: Adding Program: Name='", displayNameW.c_str(),
+                        L"', ExecPath='", utils::Utf8ToWide(prog.executablePath).c_str(),
+                        L"', Args='", argumentsW.c_str(), // Log raw wide args for easier debug
+                        L"', Kind='", utils::Utf8ToWide(prog.kind).c_str(),
+                        L"', Desc='", utils::Utf8ToWide(prog.description).c_str(),
+                        L"', IconPath='", utils::Utf8ToWide(prog.iconPath).c_str(), L"', IconIndex=", prog.iconIndex);
+            return prog;
+        }
 
-                            prog.iconPath = finalIconPathUtf8;
-                            prog.iconIndex = finalIconIndex;
+        // --- Uninstall Entry Cache ---
+        utils::UninstallEntryCache &UninstallCacheInstance()
+        {
+            return Caches().uninstall;
+        }
 
-                            // Extract and encode icon
-                            if (!prog.iconPath.empty() && prog.iconIndex >= 0)
-                            {
-                                // Call the extraction function defined within the anonymous namespace
-                                auto encodedIconOpt = utils::ExtractAndEncodeIconAsBase64(prog.iconPath, prog.iconIndex);
-                                if (encodedIconOpt)
-                                {
-                                    prog.iconDataBase64 = std::move(*encodedIconOpt);
-                                }
-                                else
-                                {
-                                    DebugOutput(L"REG: Icon extraction failed for '", displayNameW, L"' (Path: '", utils::Utf8ToWide(prog.iconPath).c_str(), L"', Index: ", prog.iconIndex, L")");
-                                }
-                            }
-                            else
-                            {
-                                DebugOutput(L"REG INFO: No valid icon path/index for '", displayNameW, L"'. No icon extracted.");
-                            }
+        // Enumerates the Uninstall roots and parses only subkeys written since the last scan.
+        std::vector<utils::Program> GetInstalledProgramsFromRegistryInternal(const utils::CancellationToken &token)
+        {
+            const std::vector<utils::UninstallEntryCache::Root> roots = {
+                {utils::RegistryHive::LocalMachine, L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall", utils::RegistryView::Native64, "HKLM"},
+                {utils::RegistryHive::LocalMachine, L"SOFTWARE\\WOW6432Node\\Microsoft\\Windows\\CurrentVersion\\Uninstall", utils::RegistryView::Wow32, "HKLM"},
+                {utils::RegistryHive::CurrentUser, L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall", utils::RegistryView::Native64, "HKCU"},
+                {utils::RegistryHive::CurrentUser, L"SOFTWARE\\WOW6432Node\\Microsoft\\Windows\\CurrentVersion\\Uninstall", utils::RegistryView::Wow32, "HKCU"}};
 
-                            DebugOutput(L"REG: Adding Program: Name='", displayNameW,
-                                        L"', ExecPath='", utils::Utf8ToWide(prog.executablePath).c_str(),
-                                        L"', Args='", argumentsW.c_str(), // Log raw wide args for easier debug
-                                        L"', Kind='", utils::Utf8ToWide(prog.kind).c_str(),
-                                        L"', Desc='", utils::Utf8ToWide(prog.description).c_str(),
-                                        L"', IconPath='", utils::Utf8ToWide(prog.iconPath).c_str(), L"', IconIndex=", prog.iconIndex);
-                            programs.push_back(std::move(prog));
+            static const std::unique_ptr<utils::RegistryReader> reader = utils::RegistryReader::CreateSystem();
+            utils::UninstallEntryCache &cache = UninstallCacheInstance();
+            std::vector<utils::Program> programs = cache.Scan(
+                *reader, roots,
+                [&token](const utils::RegistryKey &appKey, const std::wstring &subKeyName, const std::string &rootKeyName)
+                { return ProgramFromUninstallKeyInternal(appKey, subKeyName, rootKeyName, token); },
+                token);
 
-                        } // End if (AppKey opened successfully)
-                        else
-                        {
-                            if (appKeyStatus != ERROR_ACCESS_DENIED)
-                            { // Don't log expected access denied
-                                DebugOutput(L"REG WARN: Failed to open app subkey '", subKeyNameW, L"'. Status: ", appKeyStatus);
-                            }
-                        }
-                    } // End while (enumerating subkeys)
-                } // End loop (uninstall registry paths)
-            } // End loop (hive roots)
+            const fs::path cachePath = UninstallCachePath();
+            if (!cachePath.empty())
+                cache.Save(cachePath);
+            const utils::UninstallEntryCache::Stats cacheStats = cache.GetStats();
+            DebugOutput(L"--- Uninstall cache: ", cacheStats.entries, L" entries, ", cacheStats.parsed, L" parsed, ", cacheStats.reused, L" reused ---");
             return programs;
         }
 
@@ -758,7 +852,7 @@ namespace ProgramFinder
     //-----------------------------------------------------------------------------
     // Public API Implementation
     //-----------------------------------------------------------------------------
-    std::vector<utils::Program> GetAllPrograms()
+    std::vector<utils::Program> GetRawPrograms(const utils::CancellationToken &token)
     {
         CoInitializer com_guard;
         if (!com_guard.IsInitialized())
@@ -769,12 +863,18 @@ namespace ProgramFinder
         }
 
         DebugOutput(L"----- Starting Program Scan -----");
+        CacheUse caches;
+        // Targets and icons cluster in a few folders; list each once for the whole scan.
+        // Shared with the shortcut jobs, which may outlive the scan.
+        std::shared_ptr<utils::StatCache> statCache = std::make_shared<utils::StatCache>();
+        utils::StatCache::Scope statScope(*statCache);
+        const utils::BudgetedRunner::Stats budgetBefore = GetShortcutLatency();
         std::vector<utils::Program> allFoundPrograms;
         allFoundPrograms.reserve(512);
         try
         {
             DebugOutput(L"--- Scanning Registry ---");
-            std::vector<utils::Program> regProgs = GetInstalledProgramsFromRegistryInternal();
+            std::vector<utils::Program> regProgs = GetInstalledProgramsFromRegistryInternal(token);
             DebugOutput(L"--- Finished Registry Scan (Found ", regProgs.size(), L") ---");
             allFoundPrograms.insert(allFoundPrograms.end(), std::make_move_iterator(regProgs.begin()), std::make_move_iterator(regProgs.end()));
             regProgs.clear();
@@ -787,10 +887,12 @@ namespace ProgramFinder
         {
             DebugOutput(L"Registry Scan Unknown Exception");
         }
+        utils::ShortcutCache &shortcutCache = ShortcutCacheInstance();
+        shortcutCache.BeginScan();
         try
         {
             DebugOutput(L"--- Scanning Start Menu ---");
-            std::vector<utils::Program> smProgs = GetProgramsFromStartMenuInternal();
+            std::vector<utils::Program> smProgs = GetProgramsFromStartMenuInternal(token, statCache);
             DebugOutput(L"--- Finished Start Menu Scan (Found ", smProgs.size(), L") ---");
             allFoundPrograms.insert(allFoundPrograms.end(), std::make_move_iterator(smProgs.begin()), std::make_move_iterator(smProgs.end()));
             smProgs.clear();
@@ -803,6 +905,37 @@ namespace ProgramFinder
         {
             DebugOutput(L"Start Menu Scan Unknown Exception");
         }
+        // A cancelled scan did not visit every link, so keep what it skipped.
+        if (!token.IsCancelled())
+            shortcutCache.EndScan();
+        const fs::path cachePath = ShortcutCachePath();
+        if (!cachePath.empty())
+            shortcutCache.Save(cachePath);
+        const utils::ShortcutCache::Stats cacheStats = shortcutCache.GetStats();
+        DebugOutput(L"--- Shortcut cache: ", cacheStats.entries, L" entries, ", cacheStats.hits, L" hits, ", cacheStats.misses, L" misses ---");
+        const utils::StatCache::Stats statStats = statCache->GetStats();
+        DebugOutput(L"--- Stat cache: ", statStats.probes, L" probes, ", statStats.listings, L" listings, ", statStats.direct, L" direct, ", statStats.canonicalHits, L" memoized canonicalizations ---");
+        SaveQuarantine();
+        const utils::BudgetedRunner::Stats budgetStats = GetShortcutLatency();
+        DebugOutput(L"--- Shortcut latency (recent): p50 ", budgetStats.p50.count(), L" us, p95 ", budgetStats.p95.count(), L" us, p99 ", budgetStats.p99.count(),
+                    L" us, max ", budgetStats.max.count(), L" us; ", budgetStats.overran - budgetBefore.overran, L" over budget, ",
+                    budgetStats.refused - budgetBefore.refused, L" refused, ", budgetStats.abandoned, L" still running ---");
+        return allFoundPrograms;
+    }
+
+    std::vector<utils::Program> GetRegistryPrograms(const utils::CancellationToken &token)
+    {
+        CoInitializer com_guard;
+        if (!com_guard.IsInitialized())
+            return {};
+        static GdiplusInitializer gdiplus_guard;
+        CacheUse caches;
+        return GetInstalledProgramsFromRegistryInternal(token);
+    }
+
+    std::vector<utils::Program> GetAllPrograms(const utils::CancellationToken &token)
+    {
+        std::vector<utils::Program> allFoundPrograms = GetRawPrograms(token);
         DebugOutput(L"--- Deduplicating Results (Initial count: ", allFoundPrograms.size(), L") ---");
         std::vector<utils::Program> finalPrograms = utils::DeduplicatePrograms(allFoundPrograms);
         allFoundPrograms.clear(); // Clear the original vector to free memory
@@ -820,4 +953,106 @@ namespace ProgramFinder
         return finalPrograms;
     }
 
+    std::vector<StartMenuRoot> GetStartMenuRoots()
+    {
+        std::vector<StartMenuRoot> roots;
+        const KNOWNFOLDERID knownFolderIds[] = {FOLDERID_CommonPrograms, FOLDERID_Programs};
+        const char *sourceNames[] = {"Start Menu (Common)", "Start Menu (User)"};
+        for (size_t i = 0; i < ARRAYSIZE(knownFolderIds); ++i)
+        {
+            PWSTR folderPathRaw = nullptr;
+            HRESULT hr = SHGetKnownFolderPath(knownFolderIds[i], KF_FLAG_DEFAULT, NULL, &folderPathRaw);
+            CoTaskMemUniquePtr<WCHAR> folderPathPtr(folderPathRaw);
+            if (SUCCEEDED(hr) && folderPathPtr && folderPathPtr.get()[0] != L'\0')
+                roots.push_back({utils::WideToUtf8(folderPathPtr.get()), sourceNames[i]});
+        }
+        return roots;
+    }
+
+    std::optional<utils::Program> ReadShortcutProgram(const std::string &lnkPath, const std::string &source, const utils::CancellationToken &token,
+                                                      bool *deferred)
+    {
+        static GdiplusInitializer gdiplus_guard;
+        BudgetOutcome budget = BudgetOutcome::Met;
+        std::optional<utils::Program> program = ProgramFromShortcutBudgeted(fs::path(utils::Utf8ToWide(lnkPath)), source, token, std::nullopt,
+                                                                            nullptr, budget, deferred == nullptr);
+        if (deferred)
+            *deferred = budget != BudgetOutcome::Met;
+        return program;
+    }
+
+    std::vector<std::string> TakeDeferredShortcuts()
+    {
+        DeferredShortcuts &deferred = Deferred();
+        std::lock_guard<std::mutex> guard(deferred.mutex);
+        std::vector<std::string> paths;
+        paths.swap(deferred.paths);
+        return paths;
+    }
+
+    void DeferShortcuts(const std::vector<std::string> &lnkPaths)
+    {
+        DeferredShortcuts &deferred = Deferred();
+        std::lock_guard<std::mutex> guard(deferred.mutex);
+        deferred.paths.insert(deferred.paths.end(), lnkPaths.begin(), lnkPaths.end());
+    }
+
+    utils::BudgetedRunner::Stats GetShortcutLatency()
+    {
+        return ShortcutRunner().GetStats();
+    }
+
+    std::vector<std::string> QuarantinedScanItems()
+    {
+        return QuarantineInstance().Quarantined();
+    }
+
+    void RecordScanOutcomes(const std::vector<std::string> &succeeded, const std::vector<std::string> &timedOut, const std::vector<std::string> &hung)
+    {
+        utils::QuarantineList &quarantine = QuarantineInstance();
+        for (const std::string &item : succeeded)
+            quarantine.RecordSuccess(item);
+        for (const std::string &item : timedOut)
+        {
+            if (quarantine.RecordTimeout(item))
+                DebugOutput(L"--- Quarantined '", utils::Utf8ToWide(item).c_str(), L"' after repeated timeouts ---");
+        }
+        for (const std::string &item : hung)
+        {
+            quarantine.RecordTimeout(item, true);
+            DebugOutput(L"--- Quarantined '", utils::Utf8ToWide(item).c_str(), L"' after it hung the scanner ---");
+        }
+        SaveQuarantine();
+    }
+
+    void ForgetShortcut(const std::string &lnkPath)
+    {
+        CacheUse caches;
+        ShortcutCacheInstance().Forget(lnkPath);
+    }
+
+    bool ReleaseCaches()
+    {
+        PersistentCaches &caches = Caches();
+        std::unique_lock<std::shared_mutex> exclusive(caches.use, std::try_to_lock);
+        if (!exclusive.owns_lock())
+            return false; // A scan is running; it needs them
+        std::lock_guard<std::mutex> guard(caches.loadMutex);
+        if (!caches.loaded)
+            return true;
+
+        // Only drop what is safely on disk; an unsaved cache would cost a full
+        // re-resolve on the next scan.
+        const fs::path shortcutPath = ShortcutCachePath();
+        const fs::path uninstallPath = UninstallCachePath();
+        if (shortcutPath.empty() || uninstallPath.empty() ||
+            !caches.shortcuts.Save(shortcutPath) || !caches.uninstall.Save(uninstallPath))
+            return false;
+        caches.shortcuts.Clear();
+        caches.uninstall.Clear();
+        caches.loaded = false;
+        DebugOutput(L"--- Released shortcut and Uninstall caches ---");
+        return true;
+    }
+
 } // namespace ProgramFinder
\ No newline at end of file
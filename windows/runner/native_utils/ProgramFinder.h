@@ -1,6 +1,8 @@
 #ifndef PROGRAM_FINDER_H
 #define PROGRAM_FINDER_H
 #include "common_utils.h"
+#include "BudgetedRunner.h"
+#include <optional>
 #include <vector>
 #include <string>
 #include <cstdint> // For uint8_t
@@ -15,10 +17,85 @@ namespace ProgramFinder {
      * @details Initializes COM for the duration of the call. Handles deduplication
      *          based on combined path+args and name+filename logic.
      *
+     * @param token Polled per Start Menu entry and per Uninstall subkey. A cancelled scan
+     *        returns early with whatever was collected so far.
      * @return std::vector<Program> A list of unique programs found. Returns an empty
      *         vector if COM initialization fails or critical errors occur.
      */
-    std::vector<utils::Program> GetAllPrograms();
+    std::vector<utils::Program> GetAllPrograms(const utils::CancellationToken &token = {});
+
+    /**
+     * @brief The Registry and Start Menu entries GetAllPrograms() is built from,
+     *        before deduplication.
+     *
+     * @details Start Menu entries carry the .lnk they came from in originPath, so the
+     *          incremental catalog can replace them one file at a time. Shortcuts in
+     *          the scan quarantine are skipped, and shortcuts over the per-item budget
+     *          are left out and queued for TakeDeferredShortcuts().
+     */
+    std::vector<utils::Program> GetRawPrograms(const utils::CancellationToken &token = {});
+
+    // The Uninstall-registry half of GetRawPrograms().
+    std::vector<utils::Program> GetRegistryPrograms(const utils::CancellationToken &token = {});
+
+    struct StartMenuRoot
+    {
+        std::string path;   // UTF-8
+        std::string source; // Program::source for entries found below |path|
+    };
+
+    // The common and per-user Start Menu "Programs" folders that exist on this machine.
+    std::vector<StartMenuRoot> GetStartMenuRoots();
+
+    /**
+     * @brief Resolves a single Start Menu shortcut exactly like the full scan does.
+     *
+     * @details Like the full scan, gives up on a shortcut whose target or icon takes
+     *          longer than the per-item budget (2 s); the shortcut is then queued for
+     *          TakeDeferredShortcuts() and reported as unresolvable for now. With
+     *          |deferred| given, it is reported there instead of being queued.
+     *
+     * @return The catalog entry, or std::nullopt if the shortcut cannot be resolved.
+     */
+    std::optional<utils::Program> ReadShortcutProgram(const std::string &lnkPath, const std::string &source, const utils::CancellationToken &token = {},
+                                                      bool *deferred = nullptr);
+
+    // The .lnk paths that went over the per-item budget since the last call, to be
+    // retried in the background.
+    std::vector<std::string> TakeDeferredShortcuts();
+
+    // Queues |lnkPaths| for TakeDeferredShortcuts(), e.g. ones the scanner helper gave up on.
+    void DeferShortcuts(const std::vector<std::string> &lnkPaths);
+
+    // Latency of the most recent shortcut resolutions in this process, for tail-latency reports.
+    utils::BudgetedRunner::Stats GetShortcutLatency();
+
+    // Scan items (.lnk paths, "registry") currently skipped for timing out repeatedly.
+    std::vector<std::string> QuarantinedScanItems();
+
+    /**
+     * @brief Updates the persisted scan quarantine with how items fared.
+     *
+     * @details A timeout is a strike; a second one in a row quarantines the item for
+     *          15 minutes, doubling with each further strike up to a week. |hung|
+     *          items had to be killed and are quarantined at once. |succeeded| items
+     *          start over with a clean record. GetRawPrograms() records its own.
+     */
+    void RecordScanOutcomes(const std::vector<std::string> &succeeded, const std::vector<std::string> &timedOut,
+                            const std::vector<std::string> &hung);
+
+    // Drops the cached resolution of |lnkPath| so the next scan resolves it again.
+    void ForgetShortcut(const std::string &lnkPath);
+
+    /**
+     * @brief Saves the shortcut and Uninstall caches and drops them from memory.
+     *
+     * @details The next scan or shortcut lookup loads them from disk again.
+     *
+     * @return false if a scan was using them or they could not be saved; they
+     *         stay resident in that case.
+     */
+    bool ReleaseCaches();
 
     /**
      * @brief Searches the list of unique programs for entries whose names contain the query string.
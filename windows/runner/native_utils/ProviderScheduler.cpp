@@ -0,0 +1,265 @@
+#include "ProviderScheduler.h"
+
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+
+#include "EntryId.h"
+#include "QueryArena.h"
+
+namespace SearchEngine
+{
+
+    struct ProviderScheduler::Shared
+    {
+        struct Entry
+        {
+            std::shared_ptr<SearchProvider> provider;
+            ProviderStats stats;
+            int consecutiveMisses = 0;
+            int consecutiveHits = 0;
+        };
+
+        mutable std::mutex mutex;
+        SchedulerOptions options;
+        std::vector<Entry> entries;
+        utils::TaskExecutor *executor = nullptr;
+
+        void Record(size_t index, double latencyMs, bool onTime)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Entry &entry = entries[index];
+            ProviderStats &stats = entry.stats;
+            stats.averageLatencyMs = stats.runs == 0 ? latencyMs : stats.averageLatencyMs * 0.8 + latencyMs * 0.2;
+            ++stats.runs;
+            if (onTime)
+            {
+                entry.consecutiveMisses = 0;
+                ++entry.consecutiveHits;
+                if (stats.demoted && entry.consecutiveHits >= options.promoteAfterHits)
+                    stats.demoted = false;
+            }
+            else
+            {
+                ++stats.misses;
+                entry.consecutiveHits = 0;
+                ++entry.consecutiveMisses;
+                if (!stats.demoted && entry.consecutiveMisses >= options.demoteAfterMisses)
+                    stats.demoted = true;
+            }
+        }
+    };
+
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // Per-query bookkeeping shared by the provider tasks and the first-frame timer.
+        struct QueryRun
+        {
+            std::mutex mutex;
+
+            int64_t seq = 0;
+            utils::CancellationToken token;
+            ProviderScheduler::FrameCallback onFrame;
+            Clock::time_point start;
+
+            std::chrono::milliseconds budget{0};
+            std::chrono::milliseconds speculativeDelay{0};
+
+            std::vector<std::string> names;
+            std::vector<bool> expensive;
+            std::vector<bool> waitFor; // False for demoted and expensive providers
+            std::vector<bool> done;
+            std::vector<std::vector<utils::Program>> early; // Results that beat the first frame
+            size_t remaining = 0;
+            bool firstFrameSent = false;
+            int nextIndex = 1;
+            std::unordered_set<uint64_t> sent; // Entry ids already in a frame
+
+            // Moves the entries of |items| no earlier frame or provider had into |out|.
+            void Admit(std::vector<utils::Program> &items, std::vector<utils::Program> &out)
+            {
+                for (utils::Program &program : items)
+                {
+                    if (sent.insert(program.id).second)
+                        out.push_back(std::move(program));
+                }
+            }
+
+            bool ReadyForFirstFrame() const
+            {
+                for (size_t i = 0; i < done.size(); ++i)
+                {
+                    if (waitFor[i] && !done[i])
+                        return false;
+                }
+                return true;
+            }
+
+            // Sends frame 0 from whatever has finished. Called with |mutex| held.
+            void SendFirstFrame()
+            {
+                firstFrameSent = true;
+                if (token.IsCancelled())
+                    return;
+
+                SearchFrame frame;
+                frame.seq = seq;
+                frame.index = 0;
+                frame.isFinal = remaining == 0;
+                size_t count = 0;
+                for (const auto &items : early)
+                    count += items.size();
+                frame.items.reserve(count);
+                for (size_t i = 0; i < done.size(); ++i)
+                {
+                    if (!done[i])
+                        continue;
+                    frame.providers.push_back(names[i]);
+                    Admit(early[i], frame.items);
+                    early[i].clear();
+                }
+                onFrame(std::move(frame));
+            }
+        };
+    } // namespace
+
+    ProviderScheduler::ProviderScheduler(SchedulerOptions options, utils::TaskExecutor &executor)
+        : shared_(std::make_shared<Shared>())
+    {
+        shared_->options = options;
+        shared_->executor = &executor;
+    }
+
+    // In-flight queries keep |shared_| alive through their own references.
+    ProviderScheduler::~ProviderScheduler() = default;
+
+    void ProviderScheduler::AddProvider(std::shared_ptr<SearchProvider> provider)
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        Shared::Entry entry;
+        entry.stats.name = provider->Name();
+        entry.provider = std::move(provider);
+        shared_->entries.push_back(std::move(entry));
+    }
+
+    void ProviderScheduler::SetDeadline(std::chrono::milliseconds deadline)
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        shared_->options.deadline = deadline;
+    }
+
+    void ProviderScheduler::SetSpeculativeDelay(std::chrono::milliseconds delay)
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        shared_->options.speculativeDelay = delay;
+    }
+
+    std::vector<ProviderStats> ProviderScheduler::Stats() const
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        std::vector<ProviderStats> stats;
+        stats.reserve(shared_->entries.size());
+        for (const auto &entry : shared_->entries)
+            stats.push_back(entry.stats);
+        return stats;
+    }
+
+    void ProviderScheduler::Run(int64_t seq, const std::string &query, const utils::CancellationToken &token, FrameCallback onFrame)
+    {
+        auto run = std::make_shared<QueryRun>();
+        std::vector<std::shared_ptr<SearchProvider>> providers;
+        {
+            std::lock_guard<std::mutex> lock(shared_->mutex);
+            run->start = Clock::now();
+            run->budget = shared_->options.deadline;
+            run->speculativeDelay = shared_->options.speculativeDelay;
+            for (const auto &entry : shared_->entries)
+            {
+                const bool expensive = entry.provider->IsExpensive();
+                providers.push_back(entry.provider);
+                run->names.push_back(entry.stats.name);
+                run->expensive.push_back(expensive);
+                run->waitFor.push_back(!entry.stats.demoted && !expensive);
+            }
+        }
+        run->seq = seq;
+        run->token = token;
+        run->onFrame = std::move(onFrame);
+        run->done.assign(providers.size(), false);
+        run->early.resize(providers.size());
+        run->remaining = providers.size();
+
+        std::shared_ptr<Shared> shared = shared_;
+        utils::TaskExecutor &executor = *shared_->executor;
+        for (size_t i = 0; i < providers.size(); ++i)
+        {
+            auto task = [shared, run, provider = providers[i], i, query]() {
+                const Clock::time_point started = Clock::now();
+                // Runs once the provider has answered, here or on whichever
+                // thread its SearchAsync() finished on.
+                auto finish = [shared, run, i, started](std::vector<utils::Program> &&items) {
+                    for (utils::Program &program : items)
+                        utils::AssignEntryId(program);
+                    const Clock::time_point finished = Clock::now();
+                    if (!run->token.IsCancelled())
+                    {
+                        const double latencyMs = std::chrono::duration<double, std::milli>(finished - started).count();
+                        shared->Record(i, latencyMs, finished - started <= run->budget);
+                    }
+
+                    std::lock_guard<std::mutex> lock(run->mutex);
+                    run->done[i] = true;
+                    --run->remaining;
+                    if (!run->firstFrameSent)
+                    {
+                        run->early[i] = std::move(items);
+                        if (run->ReadyForFirstFrame())
+                            run->SendFirstFrame();
+                        return;
+                    }
+                    if (run->token.IsCancelled())
+                        return;
+
+                    SearchFrame frame;
+                    frame.seq = run->seq;
+                    frame.index = run->nextIndex++;
+                    frame.isFinal = run->remaining == 0;
+                    frame.providers.push_back(run->names[i]);
+                    run->Admit(items, frame.items);
+                    run->onFrame(std::move(frame));
+                };
+                if (run->token.IsCancelled())
+                {
+                    finish({});
+                    return;
+                }
+                // Providers draw their scratch data from this worker's arena.
+                utils::QueryArena::Scope arena;
+                provider->SearchAsync(query, run->token, std::move(finish));
+            };
+            // Speculative start: a query cancelled before the timer fires costs the
+            // provider nothing but the cancellation check.
+            if (run->expensive[i])
+                executor.PostAfter(run->speculativeDelay, utils::TaskPriority::Interactive, std::move(task));
+            else
+                executor.Post(utils::TaskPriority::Interactive, std::move(task));
+        }
+
+        // The first frame goes out when the last provider it waits for finishes, or
+        // from this timer at the deadline. With nothing to wait for, it goes now.
+        bool ready;
+        {
+            std::lock_guard<std::mutex> lock(run->mutex);
+            ready = run->ReadyForFirstFrame();
+        }
+        executor.PostAfter(ready ? std::chrono::milliseconds::zero() : run->budget, utils::TaskPriority::Interactive,
+                           [run]() {
+                               std::lock_guard<std::mutex> lock(run->mutex);
+                               if (!run->firstFrameSent)
+                                   run->SendFirstFrame();
+                           });
+    }
+
+} // namespace SearchEngine
@@ -0,0 +1,111 @@
+#ifndef PROVIDER_SCHEDULER_H
+#define PROVIDER_SCHEDULER_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "Program.h"
+#include "SearchProviders.h"
+#include "TaskExecutor.h"
+
+namespace SearchEngine
+{
+
+    /**
+     * @brief A batch of results for one query.
+     *
+     * @details Frame 0 carries everything that finished within the deadline. Every
+     *          provider that finishes later produces one more frame (index 1, 2, ...)
+     *          whose items are appended to what the UI already shows. The last frame
+     *          of a query has isFinal set. Every item has its utils::EntryId() set,
+     *          and no id appears twice in a query's frames: when providers find the
+     *          same entry, the copy in the earlier frame is kept, and within
+     *          frame 0 the one from the provider added first.
+     */
+    struct SearchFrame
+    {
+        int64_t seq = 0;
+        int index = 0;
+        bool isFinal = false;
+        std::vector<std::string> providers; // Providers whose results are in |items|
+        std::vector<utils::Program> items;
+    };
+
+    struct SchedulerOptions
+    {
+        // Budget for the first frame, measured from Run().
+        std::chrono::milliseconds deadline{30};
+        // Consecutive missed deadlines before a provider stops holding back the first frame.
+        int demoteAfterMisses = 3;
+        // Consecutive on-time runs before a demoted provider is waited for again.
+        int promoteAfterHits = 5;
+        // How long expensive providers wait before starting. A query cancelled
+        // within this window (the next keystroke) never starts them at all.
+        std::chrono::milliseconds speculativeDelay{0};
+    };
+
+    struct ProviderStats
+    {
+        std::string name;
+        bool demoted = false;
+        uint64_t runs = 0;
+        uint64_t misses = 0;
+        double averageLatencyMs = 0.0; // Exponentially weighted
+    };
+
+    /**
+     * @brief Fans a query out to every registered provider in parallel and streams
+     *        the results back as frames under a per-keystroke deadline.
+     *
+     * @details Run() returns immediately. The first frame is sent as soon as every
+     *          non-demoted provider has answered or the deadline passes, whichever
+     *          comes first; stragglers are appended in later frames. Providers that
+     *          keep missing the deadline are demoted: they still run, but the first
+     *          frame no longer waits for them. Once cancelled, a query emits nothing
+     *          further.
+     *
+     *          Cheap providers start immediately. Expensive ones start after the
+     *          speculative delay unless the query is cancelled first, and are never
+     *          waited for by the first frame, so a query can be issued per keystroke.
+     *          Deadlines and latency stats are measured from each provider's own start.
+     *
+     *          Providers run as interactive tasks on |executor|; the speculative delay
+     *          and the deadline are executor timers, so a waiting query holds no thread.
+     *          Each is called through SearchAsync(), so one that queues for something
+     *          shared frees the worker meanwhile and answers from another thread.
+     *          |onFrame| is invoked on executor workers, one call at a time per query
+     *          and in frame order. It must be cheap (e.g. post to another thread).
+     */
+    class ProviderScheduler
+    {
+    public:
+        using FrameCallback = std::function<void(SearchFrame &&)>;
+
+        explicit ProviderScheduler(SchedulerOptions options = {},
+                                   utils::TaskExecutor &executor = utils::SharedExecutor());
+        ~ProviderScheduler();
+
+        ProviderScheduler(const ProviderScheduler &) = delete;
+        ProviderScheduler &operator=(const ProviderScheduler &) = delete;
+
+        void AddProvider(std::shared_ptr<SearchProvider> provider);
+        void SetDeadline(std::chrono::milliseconds deadline);
+        void SetSpeculativeDelay(std::chrono::milliseconds delay);
+
+        void Run(int64_t seq, const std::string &query, const utils::CancellationToken &token, FrameCallback onFrame);
+
+        std::vector<ProviderStats> Stats() const;
+
+    private:
+        struct Shared;
+        std::shared_ptr<Shared> shared_;
+    };
+
+} // namespace SearchEngine
+
+#endif // PROVIDER_SCHEDULER_H
@@ -0,0 +1,158 @@
+#include "QuarantineList.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+#include "BinaryIO.h"
+
+namespace utils
+{
+
+    namespace fs = std::filesystem;
+
+    namespace
+    {
+        constexpr uint32_t kMagic = 0x4C515856; // "VXQL"
+        constexpr uint32_t kVersion = 1;
+    } // namespace
+
+    int64_t QuarantineList::Seconds(Clock::time_point time)
+    {
+        return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+    }
+
+    bool QuarantineList::Load(const fs::path &file)
+    {
+        std::ifstream stream(file, std::ios::binary);
+        std::string data;
+        if (stream)
+            data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+
+        std::unordered_map<std::string, Entry> loaded;
+        bool valid = data.size() >= 8;
+        if (valid)
+        {
+            const std::string_view payload(data.data(), data.size() - 8);
+            BinaryReader trailer(std::string_view(data).substr(payload.size()));
+            uint64_t checksum = 0;
+            valid = trailer.U64(checksum) && checksum == Fnv1a64(payload);
+
+            BinaryReader in(payload);
+            uint32_t magic = 0, version = 0, count = 0;
+            valid = valid && in.U32(magic) && in.U32(version) && in.U32(count) && magic == kMagic && version == kVersion;
+            for (uint32_t i = 0; valid && i < count; ++i)
+            {
+                std::string item;
+                Entry entry;
+                in.String(item);
+                in.U32(entry.strikes);
+                valid = in.I64(entry.until);
+                if (valid)
+                    loaded[std::move(item)] = entry;
+            }
+            valid = valid && in.AtEnd();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_ = valid ? std::move(loaded) : std::unordered_map<std::string, Entry>();
+        dirty_ = false;
+        return valid;
+    }
+
+    bool QuarantineList::Save(const fs::path &file)
+    {
+        BinaryWriter out;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!dirty_)
+                return true;
+            out.U32(kMagic);
+            out.U32(kVersion);
+            out.U32(static_cast<uint32_t>(entries_.size()));
+            for (const auto &[item, entry] : entries_)
+            {
+                out.String(item);
+                out.U32(entry.strikes);
+                out.I64(entry.until);
+            }
+            dirty_ = false;
+        }
+        out.U64(Fnv1a64(out.Data()));
+
+        std::error_code ec;
+        fs::create_directories(file.parent_path(), ec);
+        fs::path temp = file;
+        temp += ".tmp";
+        {
+            std::ofstream stream(temp, std::ios::binary | std::ios::trunc);
+            stream.write(out.Data().data(), static_cast<std::streamsize>(out.Data().size()));
+            if (!stream)
+                ec = std::make_error_code(std::errc::io_error);
+        }
+        if (!ec)
+            fs::rename(temp, file, ec);
+        if (ec)
+        {
+            fs::remove(temp, ec);
+            std::lock_guard<std::mutex> lock(mutex_);
+            dirty_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    void QuarantineList::Clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::unordered_map<std::string, Entry>().swap(entries_);
+        dirty_ = false;
+    }
+
+    bool QuarantineList::IsQuarantined(const std::string &item, Clock::time_point now) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(item);
+        return it != entries_.end() && it->second.until > Seconds(now);
+    }
+
+    std::vector<std::string> QuarantineList::Quarantined(Clock::time_point now) const
+    {
+        const int64_t seconds = Seconds(now);
+        std::vector<std::string> items;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &[item, entry] : entries_)
+        {
+            if (entry.until > seconds)
+                items.push_back(item);
+        }
+        return items;
+    }
+
+    bool QuarantineList::RecordTimeout(const std::string &item, bool severe, Clock::time_point now)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry &entry = entries_[item];
+        ++entry.strikes;
+        if (severe)
+            entry.strikes = std::max(entry.strikes, policy_.strikesBeforeQuarantine);
+        dirty_ = true;
+        if (entry.strikes < policy_.strikesBeforeQuarantine)
+            return false;
+
+        // base, 2 * base, 4 * base, ... capped; the shift is bounded so it cannot overflow.
+        const uint32_t doublings = std::min<uint32_t>(entry.strikes - policy_.strikesBeforeQuarantine, 30);
+        const int64_t backoff = std::min<int64_t>(policy_.base.count() << doublings, policy_.cap.count());
+        entry.until = Seconds(now) + backoff;
+        return true;
+    }
+
+    void QuarantineList::RecordSuccess(const std::string &item)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entries_.erase(item) != 0)
+            dirty_ = true;
+    }
+
+} // namespace utils
@@ -0,0 +1,72 @@
+#ifndef QUARANTINE_LIST_H
+#define QUARANTINE_LIST_H
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace utils
+{
+
+    /**
+     * @brief Persistent record of scan items that keep timing out, with exponential backoff.
+     *
+     * @details One timeout is a strike and nothing more; the item is retried in the
+     *          background and on the next scan. From the second consecutive strike on
+     *          the item is quarantined: skipped by scans for |base|, doubling with each
+     *          further strike up to |cap|. A hang that had to be killed quarantines
+     *          right away. Any success clears the record.
+     *
+     *          Times are wall-clock seconds so the backoff survives restarts. Saved in
+     *          the same versioned, checksummed format as the other caches. Thread-safe.
+     */
+    class QuarantineList
+    {
+    public:
+        using Clock = std::chrono::system_clock;
+
+        struct Policy
+        {
+            std::chrono::seconds base{std::chrono::minutes(15)};
+            std::chrono::seconds cap{std::chrono::hours(24 * 7)};
+            uint32_t strikesBeforeQuarantine = 2;
+        };
+
+        QuarantineList() = default;
+        explicit QuarantineList(Policy policy) : policy_(policy) {}
+
+        bool Load(const std::filesystem::path &file);
+        bool Save(const std::filesystem::path &file);
+        void Clear();
+
+        bool IsQuarantined(const std::string &item, Clock::time_point now = Clock::now()) const;
+        // Items quarantined at |now|.
+        std::vector<std::string> Quarantined(Clock::time_point now = Clock::now()) const;
+
+        // Adds a strike. |severe| (the item hung and was killed) quarantines at once.
+        // Returns true if the item is now quarantined.
+        bool RecordTimeout(const std::string &item, bool severe = false, Clock::time_point now = Clock::now());
+        void RecordSuccess(const std::string &item);
+
+    private:
+        struct Entry
+        {
+            uint32_t strikes = 0;
+            int64_t until = 0; // Seconds since the epoch; 0 while not quarantined
+        };
+
+        static int64_t Seconds(Clock::time_point time);
+
+        const Policy policy_;
+        mutable std::mutex mutex_;
+        std::unordered_map<std::string, Entry> entries_;
+        bool dirty_ = false;
+    };
+
+} // namespace utils
+
+#endif // QUARANTINE_LIST_H
@@ -0,0 +1,80 @@
+#include "QueryArena.h"
+
+#include <algorithm>
+
+namespace utils
+{
+
+    namespace
+    {
+        thread_local int scopeDepth = 0;
+    } // namespace
+
+    QueryArena::Scope::Scope()
+    {
+        ++scopeDepth;
+    }
+
+    QueryArena::Scope::~Scope()
+    {
+        if (--scopeDepth == 0)
+            ForThread().Reset();
+    }
+
+    QueryArena::QueryArena(size_t capacity)
+        : block_(new std::byte[capacity]), capacity_(capacity)
+    {
+        arena_.emplace(block_.get(), capacity_, &upstream_);
+        stats_.capacity = capacity_;
+    }
+
+    void QueryArena::Reset()
+    {
+        ++stats_.resets;
+        // Blocks from upstream go back to the heap here.
+        arena_->release();
+        if (upstream_.allocations == 0)
+            return;
+
+        stats_.upstreamAllocations += upstream_.allocations;
+        const size_t needed = std::min(capacity_ + upstream_.bytes, kMaxCapacity);
+        upstream_.bytes = 0;
+        upstream_.allocations = 0;
+        if (needed <= capacity_)
+            return;
+        arena_.reset();
+        block_.reset(new std::byte[needed]);
+        capacity_ = needed;
+        arena_.emplace(block_.get(), capacity_, &upstream_);
+        stats_.capacity = capacity_;
+    }
+
+    std::pmr::memory_resource *QueryArena::Current()
+    {
+        return scopeDepth > 0 ? ForThread().Resource() : std::pmr::get_default_resource();
+    }
+
+    QueryArena &QueryArena::ForThread()
+    {
+        thread_local QueryArena arena;
+        return arena;
+    }
+
+    void *QueryArena::Upstream::do_allocate(size_t size, size_t alignment)
+    {
+        bytes += size;
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    void QueryArena::Upstream::do_deallocate(void *p, size_t size, size_t alignment)
+    {
+        std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+    }
+
+    bool QueryArena::Upstream::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+    {
+        return this == &other;
+    }
+
+} // namespace utils
@@ -0,0 +1,91 @@
+#ifndef QUERY_ARENA_H
+#define QUERY_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace utils
+{
+
+    /**
+     * @brief Bump allocator for the transient data of one search query.
+     *
+     * @details Folded queries, candidate lists and other scratch buffers of a
+     *          provider's Search() come from here and are all freed at once by
+     *          Reset() instead of one by one from the global heap. Reset() keeps
+     *          the block: a query that outgrew it makes the next block big
+     *          enough (up to |kMaxCapacity|), so after the first few keystrokes
+     *          a query allocates nothing from the heap for its scratch data.
+     *
+     *          Each thread has its own arena; a Scope marks one query on it and
+     *          resets the arena when the outermost Scope ends. Nothing allocated
+     *          from Current() may outlive the Scope, so results handed back to
+     *          the scheduler must use the default allocator. Not thread-safe;
+     *          use only the calling thread's arena.
+     */
+    class QueryArena
+    {
+    public:
+        static constexpr size_t kDefaultCapacity = 64 * 1024;
+        static constexpr size_t kMaxCapacity = 1024 * 1024;
+
+        struct Stats
+        {
+            size_t resets = 0;
+            size_t capacity = 0;            // Current block size
+            size_t upstreamAllocations = 0; // Blocks added because a query outgrew the block
+        };
+
+        // Makes the calling thread's arena Current() until destroyed; nests.
+        class Scope
+        {
+        public:
+            Scope();
+            ~Scope();
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+        };
+
+        explicit QueryArena(size_t capacity = kDefaultCapacity);
+
+        QueryArena(const QueryArena &) = delete;
+        QueryArena &operator=(const QueryArena &) = delete;
+
+        std::pmr::memory_resource *Resource() { return &*arena_; }
+
+        // Frees everything allocated since the last reset.
+        void Reset();
+
+        Stats GetStats() const { return stats_; }
+
+        // The calling thread's arena inside a Scope, the default resource outside one.
+        static std::pmr::memory_resource *Current();
+        // The calling thread's arena, created on first use.
+        static QueryArena &ForThread();
+
+    private:
+        // Forwards to the heap and counts what a query needed beyond the block.
+        class Upstream : public std::pmr::memory_resource
+        {
+        public:
+            size_t bytes = 0;
+            size_t allocations = 0;
+
+        private:
+            void *do_allocate(size_t size, size_t alignment) override;
+            void do_deallocate(void *p, size_t size, size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+        };
+
+        std::unique_ptr<std::byte[]> block_;
+        size_t capacity_;
+        Upstream upstream_;
+        std::optional<std::pmr::monotonic_buffer_resource> arena_;
+        Stats stats_;
+    };
+
+} // namespace utils
+
+#endif // QUERY_ARENA_H
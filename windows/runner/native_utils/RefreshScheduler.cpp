@@ -0,0 +1,158 @@
+#include "RefreshScheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "ThreadPriority.h"
+
+namespace SearchEngine
+{
+
+    RefreshScheduler::RefreshScheduler() : RefreshScheduler(Options()) {}
+
+    RefreshScheduler::RefreshScheduler(Options options)
+        : options_(options), tokens_(options.burst), refilledAt_(Clock::now())
+    {
+        thread_ = std::thread([this]() { Run(); });
+    }
+
+    RefreshScheduler::~RefreshScheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            if (running_)
+                running_->Cancel();
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    void RefreshScheduler::AddJob(std::string name, std::chrono::milliseconds interval, Job job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            entries_.push_back({std::move(name), interval, std::move(job), Clock::now() + interval});
+        }
+        cv_.notify_all();
+    }
+
+    void RefreshScheduler::RunSoon(const std::string &name)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (Entry &entry : entries_)
+            {
+                if (entry.name == name)
+                    entry.due = std::min(entry.due, Clock::now());
+            }
+        }
+        cv_.notify_all();
+    }
+
+    void RefreshScheduler::SetForeground(bool visible)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (visible == visible_)
+                return;
+            visible_ = visible;
+            if (visible && running_)
+                running_->Cancel();
+            if (!visible)
+                hiddenSince_ = Clock::now();
+        }
+        cv_.notify_all();
+    }
+
+    RefreshScheduler::Stats RefreshScheduler::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    void RefreshScheduler::RefillLocked(Clock::time_point now)
+    {
+        const double earned = std::chrono::duration<double>(now - refilledAt_) /
+                              std::chrono::duration<double>(options_.refillInterval);
+        tokens_ = std::min(options_.burst, tokens_ + earned);
+        refilledAt_ = now;
+    }
+
+    void RefreshScheduler::Run()
+    {
+        if (options_.backgroundPriority)
+            utils::EnterBackgroundMode();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        bool waitingForToken = false;
+        while (!stopping_)
+        {
+            if (visible_)
+            {
+                cv_.wait(lock, [this]() { return stopping_ || !visible_; });
+                continue;
+            }
+            Clock::time_point now = Clock::now();
+            const Clock::time_point resumeAt = hiddenSince_ + options_.resumeDelay;
+            if (now < resumeAt)
+            {
+                cv_.wait_until(lock, resumeAt, [this]() { return stopping_ || visible_; });
+                continue;
+            }
+
+            auto next = std::min_element(entries_.begin(), entries_.end(),
+                                         [](const Entry &a, const Entry &b) { return a.due < b.due; });
+            if (next == entries_.end())
+            {
+                cv_.wait(lock);
+                continue;
+            }
+            if (next->due > now)
+            {
+                // Woken early by RunSoon, AddJob or a visibility change; re-evaluate.
+                cv_.wait_until(lock, next->due);
+                continue;
+            }
+
+            RefillLocked(now);
+            if (tokens_ < 1)
+            {
+                if (!waitingForToken)
+                    ++stats_.throttled;
+                waitingForToken = true;
+                const auto missing = std::chrono::duration<double>(options_.refillInterval) * (1 - tokens_);
+                cv_.wait_until(lock, now + std::chrono::duration_cast<Clock::duration>(missing));
+                continue;
+            }
+            waitingForToken = false;
+            tokens_ -= 1;
+
+            // Entries are only ever appended; hold on to the index, not the iterator.
+            const size_t index = static_cast<size_t>(next - entries_.begin());
+            Job job = entries_[index].job;
+            // Parked while running; a RunSoon() from here on pulls it back in.
+            entries_[index].due = Clock::time_point::max();
+            running_.emplace();
+            const utils::CancellationToken token = running_->Token();
+            lock.unlock();
+            job(token);
+            lock.lock();
+
+            running_.reset();
+            Entry &entry = entries_[index];
+            if (token.IsCancelled())
+            {
+                ++stats_.cancelled;
+                entry.due = std::min(entry.due, Clock::now());
+            }
+            else
+            {
+                ++stats_.completed;
+                if (entry.due == Clock::time_point::max())
+                    entry.due = Clock::now() + entry.interval;
+            }
+        }
+    }
+
+} // namespace SearchEngine
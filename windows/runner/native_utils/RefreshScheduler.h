@@ -0,0 +1,104 @@
+#ifndef REFRESH_SCHEDULER_H
+#define REFRESH_SCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CancellationToken.h"
+
+namespace SearchEngine
+{
+
+    /**
+     * @brief Runs periodic maintenance jobs (catalog rescans, target validation) while the user is away.
+     *
+     * @details Jobs run one at a time on a single thread in background CPU and I/O
+     *          priority (utils::EnterBackgroundMode). Nothing starts while the palette
+     *          is visible or within |resumeDelay| of it being hidden, and showing it
+     *          cancels the running job through its token; a cancelled job is run
+     *          again at the next opportunity. Starts are rate-limited by a token
+     *          bucket of |burst| runs refilled one per |refillInterval|, so a burst
+     *          of RunSoon() calls cannot keep the disk busy.
+     *
+     *          The scheduler starts out in the foreground; call SetForeground(false)
+     *          once the window is hidden. Thread-safe.
+     */
+    class RefreshScheduler
+    {
+    public:
+        using Job = std::function<void(const utils::CancellationToken &token)>;
+
+        struct Options
+        {
+            std::chrono::milliseconds resumeDelay{std::chrono::seconds(10)};
+            double burst = 3;
+            std::chrono::milliseconds refillInterval{std::chrono::minutes(1)};
+            // Set false to leave the worker at normal priority.
+            bool backgroundPriority = true;
+        };
+
+        struct Stats
+        {
+            size_t completed = 0;
+            size_t cancelled = 0; // Runs cut short by SetForeground(true)
+            size_t throttled = 0; // Times a due job waited for a token
+        };
+
+        RefreshScheduler();
+        explicit RefreshScheduler(Options options);
+        // Cancels the running job and waits for it to return.
+        ~RefreshScheduler();
+
+        RefreshScheduler(const RefreshScheduler &) = delete;
+        RefreshScheduler &operator=(const RefreshScheduler &) = delete;
+
+        // Runs |job| every |interval|, the first time one |interval| from now.
+        void AddJob(std::string name, std::chrono::milliseconds interval, Job job);
+
+        // Makes |name| due now; it still waits for the background and a token.
+        void RunSoon(const std::string &name);
+
+        // True while the palette is on screen. Showing it cancels the running job.
+        void SetForeground(bool visible);
+
+        Stats GetStats() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Entry
+        {
+            std::string name;
+            std::chrono::milliseconds interval;
+            Job job;
+            Clock::time_point due;
+        };
+
+        void Run();
+        // Adds the tokens earned since the last refill, up to |burst|.
+        void RefillLocked(Clock::time_point now);
+
+        const Options options_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+        std::vector<Entry> entries_;
+        bool visible_ = true;
+        Clock::time_point hiddenSince_;
+        double tokens_;
+        Clock::time_point refilledAt_;
+        std::optional<utils::CancellationSource> running_;
+        Stats stats_;
+        bool stopping_ = false;
+        std::thread thread_;
+    };
+
+} // namespace SearchEngine
+
+#endif // REFRESH_SCHEDULER_H
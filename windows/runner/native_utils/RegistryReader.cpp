@@ -0,0 +1,140 @@
+#include "RegistryReader.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#pragma comment(lib, "Advapi32.lib")
+#endif
+
+namespace utils
+{
+
+    namespace
+    {
+#ifdef _WIN32
+
+        struct RegKeyDeleter
+        {
+            void operator()(HKEY h) const
+            {
+                if (h && h != INVALID_HANDLE_VALUE)
+                    RegCloseKey(h);
+            }
+        };
+        using RegKeyUniquePtr = std::unique_ptr<HKEY__, RegKeyDeleter>;
+
+        class Win32RegistryKey : public RegistryKey
+        {
+        public:
+            Win32RegistryKey(HKEY key, REGSAM viewAccess) : key_(key), viewAccess_(viewAccess) {}
+
+            std::vector<RegistrySubkey> Subkeys() const override
+            {
+                std::vector<RegistrySubkey> subkeys;
+                DWORD count = 0, maxNameLength = 0;
+                if (RegQueryInfoKeyW(key_.get(), nullptr, nullptr, nullptr, &count, &maxNameLength,
+                                     nullptr, nullptr, nullptr, nullptr, nullptr, nullptr) != ERROR_SUCCESS)
+                    return subkeys;
+
+                subkeys.reserve(count);
+                std::wstring name(static_cast<size_t>(maxNameLength) + 1, L'\0');
+                for (DWORD index = 0;; ++index)
+                {
+                    DWORD nameLength = static_cast<DWORD>(name.size());
+                    FILETIME lastWrite = {};
+                    const LSTATUS status = RegEnumKeyExW(key_.get(), index, &name[0], &nameLength, nullptr, nullptr, nullptr, &lastWrite);
+                    if (status == ERROR_NO_MORE_ITEMS)
+                        break;
+                    if (status == ERROR_MORE_DATA)
+                    {
+                        // A longer key appeared since RegQueryInfoKeyW; grow and retry.
+                        name.resize(name.size() * 2);
+                        --index;
+                        continue;
+                    }
+                    if (status != ERROR_SUCCESS)
+                        continue;
+                    const int64_t ticks = (static_cast<int64_t>(lastWrite.dwHighDateTime) << 32) | lastWrite.dwLowDateTime;
+                    subkeys.push_back({name.substr(0, nameLength), ticks});
+                }
+                return subkeys;
+            }
+
+            std::unique_ptr<RegistryKey> OpenSubkey(const std::wstring &name) const override
+            {
+                HKEY child = nullptr;
+                if (RegOpenKeyExW(key_.get(), name.c_str(), 0, KEY_READ | viewAccess_, &child) != ERROR_SUCCESS)
+                    return nullptr;
+                return std::make_unique<Win32RegistryKey>(child, viewAccess_);
+            }
+
+            std::optional<std::wstring> StringValue(const wchar_t *name) const override
+            {
+                DWORD type = 0, size = 0;
+                if (RegQueryValueExW(key_.get(), name, nullptr, &type, nullptr, &size) != ERROR_SUCCESS || type != REG_SZ)
+                    return std::nullopt;
+                std::wstring value(size / sizeof(wchar_t) + 1, L'\0');
+                size = static_cast<DWORD>(value.size() * sizeof(wchar_t));
+                if (RegQueryValueExW(key_.get(), name, nullptr, &type, reinterpret_cast<LPBYTE>(&value[0]), &size) != ERROR_SUCCESS || type != REG_SZ)
+                    return std::nullopt;
+                // Stored strings may or may not include their terminator.
+                value.resize(size / sizeof(wchar_t));
+                while (!value.empty() && value.back() == L'\0')
+                    value.pop_back();
+                return value;
+            }
+
+            std::optional<uint32_t> DwordValue(const wchar_t *name) const override
+            {
+                DWORD type = 0, value = 0, size = sizeof(value);
+                if (RegQueryValueExW(key_.get(), name, nullptr, &type, reinterpret_cast<LPBYTE>(&value), &size) != ERROR_SUCCESS || type != REG_DWORD)
+                    return std::nullopt;
+                return static_cast<uint32_t>(value);
+            }
+
+        private:
+            RegKeyUniquePtr key_;
+            REGSAM viewAccess_;
+        };
+
+        class Win32RegistryReader : public RegistryReader
+        {
+        public:
+            std::unique_ptr<RegistryKey> Open(RegistryHive hive, const std::wstring &path, RegistryView view) const override
+            {
+                const HKEY root = hive == RegistryHive::LocalMachine ? HKEY_LOCAL_MACHINE : HKEY_CURRENT_USER;
+                const REGSAM viewAccess = view == RegistryView::Wow32 ? KEY_WOW64_32KEY : KEY_WOW64_64KEY;
+                HKEY key = nullptr;
+                if (RegOpenKeyExW(root, path.c_str(), 0, KEY_READ | KEY_ENUMERATE_SUB_KEYS | viewAccess, &key) != ERROR_SUCCESS)
+                    return nullptr;
+                return std::make_unique<Win32RegistryKey>(key, viewAccess);
+            }
+        };
+
+#else
+
+        class NullRegistryReader : public RegistryReader
+        {
+        public:
+            std::unique_ptr<RegistryKey> Open(RegistryHive, const std::wstring &, RegistryView) const override { return nullptr; }
+        };
+
+#endif
+    } // namespace
+
+    std::unique_ptr<RegistryReader> RegistryReader::CreateSystem()
+    {
+#ifdef _WIN32
+        return std::make_unique<Win32RegistryReader>();
+#else
+        return std::make_unique<NullRegistryReader>();
+#endif
+    }
+
+} // namespace utils
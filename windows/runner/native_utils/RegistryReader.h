@@ -0,0 +1,69 @@
+#ifndef REGISTRY_READER_H
+#define REGISTRY_READER_H
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace utils
+{
+
+    enum class RegistryHive
+    {
+        LocalMachine,
+        CurrentUser,
+    };
+
+    // Which registry view a key is opened in (KEY_WOW64_64KEY / KEY_WOW64_32KEY).
+    enum class RegistryView
+    {
+        Native64,
+        Wow32,
+    };
+
+    struct RegistrySubkey
+    {
+        std::wstring name;
+        int64_t lastWrite = 0; // FILETIME ticks; changes whenever a value below the key does
+    };
+
+    /**
+     * @brief An open registry key, reduced to the reads the program scanner needs.
+     *
+     * @details Kept free of Windows headers so scanning logic built on it (and its
+     *          caches) can run against an in-memory registry off Windows.
+     */
+    class RegistryKey
+    {
+    public:
+        virtual ~RegistryKey() = default;
+
+        // Direct children with their last-write times, in enumeration order.
+        virtual std::vector<RegistrySubkey> Subkeys() const = 0;
+        // Opens a direct child in the same view; nullptr if it cannot be opened.
+        virtual std::unique_ptr<RegistryKey> OpenSubkey(const std::wstring &name) const = 0;
+
+        // REG_SZ values only, without the terminating null; nullopt if the value is
+        // missing or of another type.
+        virtual std::optional<std::wstring> StringValue(const wchar_t *name) const = 0;
+        // REG_DWORD values only.
+        virtual std::optional<uint32_t> DwordValue(const wchar_t *name) const = 0;
+    };
+
+    class RegistryReader
+    {
+    public:
+        virtual ~RegistryReader() = default;
+
+        // nullptr if the key does not exist or cannot be read.
+        virtual std::unique_ptr<RegistryKey> Open(RegistryHive hive, const std::wstring &path, RegistryView view) const = 0;
+
+        // The Win32 registry; off Windows, a reader in which no key exists.
+        static std::unique_ptr<RegistryReader> CreateSystem();
+    };
+
+} // namespace utils
+
+#endif // REGISTRY_READER_H
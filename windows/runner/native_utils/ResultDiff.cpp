@@ -0,0 +1,155 @@
+#include "ResultDiff.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace SearchEngine
+{
+
+    namespace
+    {
+        bool SameContent(const ResultRow &a, const ResultRow &b)
+        {
+            return a.name == b.name && a.path == b.path && a.args == b.args && a.kind == b.kind &&
+                   a.description == b.description && a.iconId == b.iconId;
+        }
+    } // namespace
+
+    ListPatch DiffLists(const std::vector<uint64_t> &before, const std::vector<uint64_t> &after)
+    {
+        ListPatch patch;
+        std::unordered_map<uint64_t, int32_t> newIndex;
+        newIndex.reserve(after.size());
+        for (size_t j = 0; j < after.size(); ++j)
+            newIndex.emplace(after[j], static_cast<int32_t>(j));
+
+        // Entries in both lists, in old order, with their old and new positions.
+        std::vector<int32_t> oldPos;
+        std::vector<int32_t> newPos;
+        std::unordered_set<uint64_t> kept;
+        for (size_t i = 0; i < before.size(); ++i)
+        {
+            auto it = newIndex.find(before[i]);
+            if (it == newIndex.end())
+            {
+                patch.removes.push_back(static_cast<int32_t>(i));
+                continue;
+            }
+            oldPos.push_back(static_cast<int32_t>(i));
+            newPos.push_back(it->second);
+            kept.insert(before[i]);
+        }
+
+        // Longest increasing run of new positions: those entries stay put.
+        std::vector<size_t> tails;
+        std::vector<size_t> previous(newPos.size(), SIZE_MAX);
+        for (size_t k = 0; k < newPos.size(); ++k)
+        {
+            auto slot = std::lower_bound(tails.begin(), tails.end(), newPos[k],
+                                         [&newPos](size_t index, int32_t value) { return newPos[index] < value; });
+            if (slot != tails.begin())
+                previous[k] = *(slot - 1);
+            if (slot == tails.end())
+                tails.push_back(k);
+            else
+                *slot = k;
+        }
+        std::vector<bool> stays(newPos.size(), false);
+        for (size_t k = tails.empty() ? SIZE_MAX : tails.back(); k != SIZE_MAX; k = previous[k])
+            stays[k] = true;
+
+        for (size_t k = 0; k < newPos.size(); ++k)
+        {
+            if (!stays[k])
+            {
+                patch.moves.push_back(oldPos[k]);
+                patch.moves.push_back(newPos[k]);
+            }
+        }
+        for (size_t j = 0; j < after.size(); ++j)
+        {
+            if (!kept.count(after[j]))
+                patch.inserts.push_back(static_cast<int32_t>(j));
+        }
+        return patch;
+    }
+
+    std::optional<ResultView::Update> ResultView::Replace(int64_t seq, std::vector<ResultRow> &&rows)
+    {
+        if (seq < seq_)
+            return std::nullopt;
+
+        std::vector<uint64_t> ids;
+        std::unordered_set<uint64_t> present;
+        std::vector<ResultRow> unique;
+        ids.reserve(rows.size());
+        unique.reserve(rows.size());
+        for (ResultRow &row : rows)
+        {
+            if (present.insert(row.id).second)
+            {
+                ids.push_back(row.id);
+                unique.push_back(std::move(row));
+            }
+        }
+
+        Update update;
+        update.base = version_;
+        update.version = ++version_;
+        update.patch = DiffLists(ids_, ids);
+        update.inserted.reserve(update.patch.inserts.size());
+        for (int32_t index : update.patch.inserts)
+            update.inserted.push_back(unique[index]);
+
+        // Kept rows whose content changed since the UI got them.
+        std::unordered_map<uint64_t, size_t> oldIndex;
+        oldIndex.reserve(ids_.size());
+        for (size_t i = 0; i < ids_.size(); ++i)
+            oldIndex.emplace(ids_[i], i);
+        for (size_t j = 0; j < unique.size(); ++j)
+        {
+            auto it = oldIndex.find(unique[j].id);
+            if (it != oldIndex.end() && !SameContent(rows_[it->second], unique[j]))
+            {
+                update.patch.updates.push_back(static_cast<int32_t>(j));
+                update.updated.push_back(unique[j]);
+            }
+        }
+
+        seq_ = seq;
+        ids_ = std::move(ids);
+        rows_ = std::move(unique);
+        present_ = std::move(present);
+        return update;
+    }
+
+    std::optional<ResultView::Update> ResultView::Append(int64_t seq, std::vector<ResultRow> &&rows)
+    {
+        if (seq != seq_)
+            return std::nullopt;
+
+        Update update;
+        update.base = version_;
+        update.version = ++version_;
+        for (ResultRow &row : rows)
+        {
+            if (!present_.insert(row.id).second)
+                continue;
+            update.patch.inserts.push_back(static_cast<int32_t>(ids_.size()));
+            ids_.push_back(row.id);
+            update.inserted.push_back(row);
+            rows_.push_back(std::move(row));
+        }
+        return update;
+    }
+
+    uint64_t ResultView::Reset()
+    {
+        seq_ = -1;
+        ids_.clear();
+        rows_.clear();
+        present_.clear();
+        return ++version_;
+    }
+
+} // namespace SearchEngine
@@ -0,0 +1,88 @@
+#ifndef RESULT_DIFF_H
+#define RESULT_DIFF_H
+
+#include <cstdint>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+#include "ResultPager.h"
+
+namespace SearchEngine
+{
+
+    /**
+     * @brief Edits that turn one list of unique ids into another.
+     *
+     * @details |removes| and the first index of each |moves| pair are positions
+     *          in the old list; the second index of each pair and |inserts| are
+     *          positions in the new one. The edits apply all at once: moved and
+     *          inserted entries take their new positions, and the entries no edit
+     *          mentions keep their relative order and fill the remaining slots.
+     *          Only entries outside a longest run that kept its order are moved,
+     *          so the number of moves is minimal.
+     *
+     *          |updates| are positions in the new list of entries that were kept
+     *          (moved or not) but whose content changed; the receiver replaces
+     *          them in place after the other edits. DiffLists() only sees ids and
+     *          leaves them empty; ResultView fills them in.
+     */
+    struct ListPatch
+    {
+        std::vector<int32_t> removes; // Ascending
+        std::vector<int32_t> moves;   // from, to, from, to, ...
+        std::vector<int32_t> inserts; // Ascending
+        std::vector<int32_t> updates; // Ascending
+    };
+
+    // |before| and |after| must not hold an id twice.
+    ListPatch DiffLists(const std::vector<uint64_t> &before, const std::vector<uint64_t> &after);
+
+    /**
+     * @brief The native copy of the result list the UI holds, so that what is
+     *        sent for each frame is a patch to that list rather than a new one.
+     *
+     * @details Every update is numbered: it applies to the list at version |base|
+     *          and leaves it at |version|, so the receiver can apply updates in
+     *          order however they arrive. Replace() starts a query's list (frame
+     *          0); Append() adds its later rows. Rows of an older query than the
+     *          one shown produce no update, and rows already in the list are
+     *          dropped. A row Replace() keeps is sent again, as an in-place
+     *          update, if any field of it differs from the copy the UI has. The
+     *          icon id counts too; it hashes the image, so it only differs when
+     *          the icon does. Not thread-safe: updates must be made in the order
+     *          they are sent.
+     */
+    class ResultView
+    {
+    public:
+        struct Update
+        {
+            uint64_t base = 0;
+            uint64_t version = 0;
+            ListPatch patch;
+            std::vector<ResultRow> inserted; // The rows at patch.inserts, in order
+            std::vector<ResultRow> updated;  // The rows at patch.updates, in order
+        };
+
+        std::optional<Update> Replace(int64_t seq, std::vector<ResultRow> &&rows);
+        std::optional<Update> Append(int64_t seq, std::vector<ResultRow> &&rows);
+
+        // Empties the list and returns its new version, which the next update
+        // has as its base.
+        uint64_t Reset();
+
+        int64_t Seq() const { return seq_; }
+        size_t Size() const { return ids_.size(); }
+
+    private:
+        int64_t seq_ = -1;
+        uint64_t version_ = 0;
+        std::vector<uint64_t> ids_;
+        std::vector<ResultRow> rows_; // The UI's copy of each row, by position
+        std::unordered_set<uint64_t> present_;
+    };
+
+} // namespace SearchEngine
+
+#endif // RESULT_DIFF_H
@@ -0,0 +1,132 @@
+#include "ResultPager.h"
+
+#include <algorithm>
+
+#include "BinaryIO.h"
+#include "EntryId.h"
+#include "TextFold.h"
+
+namespace SearchEngine
+{
+
+    namespace
+    {
+        // Never 0, which stands for no icon.
+        uint64_t IconId(std::string_view icon)
+        {
+            const uint64_t hash = utils::Fnv1a64(icon);
+            return hash ? hash : 1;
+        }
+    } // namespace
+
+    ResultPager::ResultPager(size_t maxSessions) : maxSessions_(std::max<size_t>(maxSessions, 1)) {}
+
+    size_t ResultPager::Append(int64_t seq, std::string_view query, std::vector<utils::Program> &&items)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (seq <= closedThrough_)
+            return 0;
+
+        auto it = sessions_.find(seq);
+        if (it == sessions_.end())
+        {
+            while (order_.size() >= maxSessions_)
+            {
+                closedThrough_ = std::max(closedThrough_, order_.front());
+                sessions_.erase(order_.front());
+                order_.pop_front();
+            }
+            if (seq <= closedThrough_)
+                return 0;
+            it = sessions_.emplace(seq, Session()).first;
+            order_.push_back(seq);
+        }
+
+        Session &session = it->second;
+        const std::string foldedQuery = utils::FoldCase(query);
+        const size_t kept = session.rows.size();
+        session.rows.reserve(kept + items.size());
+        for (utils::Program &program : items)
+        {
+            // Providers other than the scheduler's may repeat an entry.
+            if (!session.ids.insert(utils::AssignEntryId(program)).second)
+                continue;
+            Row row;
+            if (!program.iconDataBase64.empty())
+            {
+                row.icon = IconId(program.iconDataBase64);
+                session.icons.try_emplace(row.icon, std::move(program.iconDataBase64));
+                program.iconDataBase64.clear();
+            }
+            row.rank = RankOf(program, foldedQuery);
+            row.program = std::move(program);
+            session.rows.push_back(std::move(row));
+        }
+
+        const auto better = [](const Row &a, const Row &b) { return RanksBefore(a.program, a.rank, b.program, b.rank); };
+        std::sort(session.rows.begin() + kept, session.rows.end(), better);
+        std::inplace_merge(session.rows.begin(), session.rows.begin() + kept, session.rows.end(), better);
+        return session.rows.size();
+    }
+
+    std::vector<ResultRow> ResultPager::Fetch(int64_t seq, size_t start, size_t count) const
+    {
+        std::vector<ResultRow> rows;
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(seq);
+        if (it == sessions_.end() || start >= it->second.rows.size())
+            return rows;
+
+        const Session &session = it->second;
+        const size_t end = start + std::min(count, session.rows.size() - start);
+        rows.reserve(end - start);
+        for (size_t i = start; i < end; ++i)
+        {
+            const Row &row = session.rows[i];
+            rows.push_back({row.program.name, row.program.executablePath, row.program.arguments, row.program.kind,
+                            row.program.description,
+                            row.icon, row.program.id});
+        }
+        return rows;
+    }
+
+    std::optional<size_t> ResultPager::Count(int64_t seq) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(seq);
+        if (it == sessions_.end())
+            return std::nullopt;
+        return it->second.rows.size();
+    }
+
+    std::optional<std::string> ResultPager::Icon(uint64_t iconId) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &entry : sessions_)
+        {
+            auto icon = entry.second.icons.find(iconId);
+            if (icon != entry.second.icons.end())
+                return icon->second;
+        }
+        return std::nullopt;
+    }
+
+    void ResultPager::CloseThrough(int64_t seq)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closedThrough_ = std::max(closedThrough_, seq);
+        for (auto it = order_.begin(); it != order_.end();)
+        {
+            if (*it <= seq)
+            {
+                sessions_.erase(*it);
+                it = order_.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+} // namespace SearchEngine
@@ -0,0 +1,104 @@
+#ifndef RESULT_PAGER_H
+#define RESULT_PAGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Program.h"
+#include "ResultRank.h"
+
+namespace SearchEngine
+{
+
+    // What the UI shows for one result, without the icon itself.
+    struct ResultRow
+    {
+        std::string name;
+        std::string path;
+        std::string args;
+        std::string kind;
+        std::string description;
+        uint64_t iconId = 0; // Content hash of the icon, for ResultPager::Icon(); 0 for none
+        uint64_t id = 0;     // utils::EntryId() of the program
+    };
+
+    /**
+     * @brief Holds the complete result set of recent queries so the UI can pull
+     *        the rows it shows a window at a time.
+     *
+     * @details Each query (keyed by its search sequence number) gets a session
+     *          that its result batches are merged into, best first by
+     *          RanksBefore(), so the first page holds the best results of every
+     *          batch so far whatever order they came in. Fetch() copies out a
+     *          range of rows with display fields only; icons stay here,
+     *          stored once per distinct image, and are fetched by id when a row
+     *          is actually drawn. A query with 5,000 hits then costs what its
+     *          visible page does. Icon ids hash the image, so a row keeps its
+     *          id from one query to the next and the UI's icon cache stays
+     *          valid while the user types.
+     *
+     *          Only the |maxSessions| newest sessions are kept; older ones go
+     *          when a newer one opens or through CloseThrough(). An entry whose
+     *          utils::EntryId() the session already holds is not appended again,
+     *          so counts and pages are free of duplicates. Rows and icons
+     *          of a closed session are simply no longer found. Thread-safe.
+     */
+    class ResultPager
+    {
+    public:
+        explicit ResultPager(size_t maxSessions = 4);
+
+        ResultPager(const ResultPager &) = delete;
+        ResultPager &operator=(const ResultPager &) = delete;
+
+        // Merges |items|, ranked for |query|, into the session of |seq|, opening it
+        // if needed, and returns the session's size afterwards. Sequence numbers
+        // at or below one already closed or evicted are ignored and return 0.
+        size_t Append(int64_t seq, std::string_view query, std::vector<utils::Program> &&items);
+
+        // Rows [start, start + count) of the session, clamped to its size.
+        std::vector<ResultRow> Fetch(int64_t seq, size_t start, size_t count) const;
+
+        // Size of the session, or nullopt if there is none for |seq|.
+        std::optional<size_t> Count(int64_t seq) const;
+
+        // The Base64 icon behind |iconId|, or nullopt once no session holds it.
+        std::optional<std::string> Icon(uint64_t iconId) const;
+
+        // Drops every session with a sequence number <= |seq|.
+        void CloseThrough(int64_t seq);
+
+    private:
+        struct Row
+        {
+            utils::Program program; // iconDataBase64 moved into |icons|
+            RankKey rank;
+            uint64_t icon = 0; // Key into |icons|; 0 for none
+        };
+
+        struct Session
+        {
+            std::vector<Row> rows;
+            std::unordered_set<uint64_t> ids; // Entry ids in |rows|
+            std::unordered_map<uint64_t, std::string> icons; // By content hash
+        };
+
+        const size_t maxSessions_;
+        mutable std::mutex mutex_;
+        std::unordered_map<int64_t, Session> sessions_;
+        std::deque<int64_t> order_; // Oldest first
+        int64_t closedThrough_ = std::numeric_limits<int64_t>::min();
+    };
+
+} // namespace SearchEngine
+
+#endif // RESULT_PAGER_H
@@ -0,0 +1,124 @@
+#include "ResultRank.h"
+
+#include <algorithm>
+
+#include "TextFold.h"
+
+namespace SearchEngine
+{
+
+    namespace
+    {
+        struct Extension
+        {
+            std::string_view text;
+            uint8_t type;
+        };
+
+        // SearchResultSorter._getTypePriority's extension lists.
+        constexpr Extension kExtensions[] = {
+            {".exe", 1}, {".msi", 1}, {".lnk", 2}, {".bat", 3}, {".cmd", 3}, {".ps1", 3}, {".url", 4},
+            {".doc", 6}, {".docx", 6}, {".odt", 6}, {".pdf", 6}, {".xls", 6}, {".xlsx", 6}, {".ods", 6},
+            {".csv", 6}, {".ppt", 6}, {".pptx", 6}, {".odp", 6}, {".rtf", 6},
+            {".png", 7}, {".jpg", 7}, {".jpeg", 7}, {".gif", 7}, {".bmp", 7}, {".ico", 7}, {".tif", 7},
+            {".tiff", 7}, {".webp", 7}, {".svg", 7}, {".mp3", 7}, {".wav", 7}, {".ogg", 7}, {".flac", 7},
+            {".aac", 7}, {".wma", 7}, {".m4a", 7}, {".mp4", 7}, {".mkv", 7}, {".avi", 7}, {".mov", 7},
+            {".wmv", 7}, {".flv", 7}, {".webm", 7},
+            {".txt", 8}, {".log", 8}, {".md", 8}, {".chm", 8}, {".scr", 8}, {".html", 8}, {".htm", 8},
+            {".xml", 8}, {".css", 8}, {".js", 8}, {".zip", 8}, {".rar", 8}, {".7z", 8}, {".tar", 8},
+            {".gz", 8}, {".bz2", 8}, {".ttf", 8}, {".otf", 8}, {".woff", 8}, {".woff2", 8},
+        };
+
+        bool IsSeparator(char c)
+        {
+            return c == '\\' || c == '/';
+        }
+
+        // path.extension(): from the last dot of the last component, unless the
+        // component starts with it. Trailing separators are ignored.
+        std::string_view ExtensionOf(std::string_view path)
+        {
+            while (!path.empty() && IsSeparator(path.back()))
+                path.remove_suffix(1);
+            size_t start = path.size();
+            while (start > 0 && !IsSeparator(path[start - 1]))
+                --start;
+            const std::string_view name = path.substr(start);
+            const size_t dot = name.rfind('.');
+            if (dot == std::string_view::npos || dot == 0)
+                return {};
+            return name.substr(dot);
+        }
+
+        bool EqualsFolded(std::string_view text, std::string_view folded)
+        {
+            return text.size() == folded.size() && utils::StartsWithFolded(text, folded);
+        }
+
+        uint8_t TypePriority(const utils::Program &program)
+        {
+            const std::string_view name = program.name;
+            const std::string_view path = program.executablePath;
+            if (EqualsFolded(name, "settings") || utils::ContainsFolded(path, "systemsettings.exe") ||
+                utils::ContainsFolded(path, "explorer.exe"))
+                return 0;
+
+            uint8_t type = 99;
+            const std::string_view extension = ExtensionOf(path);
+            for (const Extension &known : kExtensions)
+            {
+                if (EqualsFolded(extension, known.text))
+                    type = known.type;
+            }
+            // The two shells count as scripts whatever their path, but do not
+            // outrank an executable or a shortcut.
+            if (type > 3 && (EqualsFolded(name, "command prompt") || EqualsFolded(name, "powershell")))
+                return 3;
+            if (type == 99 && extension.empty() && !path.empty() && IsSeparator(path.back()))
+                return 5;
+            return type;
+        }
+
+        // <0, 0 or >0 as |a| sorts before, with or after |b| ignoring ASCII case.
+        int CompareFolded(std::string_view a, std::string_view b)
+        {
+            const size_t length = std::min(a.size(), b.size());
+            for (size_t i = 0; i < length; ++i)
+            {
+                const unsigned char x = static_cast<unsigned char>(utils::FoldAscii(a[i]));
+                const unsigned char y = static_cast<unsigned char>(utils::FoldAscii(b[i]));
+                if (x != y)
+                    return x < y ? -1 : 1;
+            }
+            return a.size() == b.size() ? 0 : (a.size() < b.size() ? -1 : 1);
+        }
+    } // namespace
+
+    RankKey RankOf(const utils::Program &program, std::string_view foldedQuery)
+    {
+        RankKey key;
+        key.type = TypePriority(program);
+        if (foldedQuery.empty())
+            return key;
+        if (utils::StartsWithFolded(program.name, foldedQuery))
+            key.relevance = 3;
+        else if (utils::ContainsFolded(program.name, foldedQuery))
+            key.relevance = 2;
+        else if (utils::ContainsFolded(program.description, foldedQuery))
+            key.relevance = 1;
+        return key;
+    }
+
+    bool RanksBefore(const utils::Program &a, const RankKey &aKey, const utils::Program &b, const RankKey &bKey)
+    {
+        if (aKey.type != bKey.type)
+            return aKey.type < bKey.type;
+        if (aKey.relevance != bKey.relevance)
+            return aKey.relevance > bKey.relevance;
+        const int names = CompareFolded(a.name, b.name);
+        if (names != 0)
+            return names < 0;
+        return a.id < b.id;
+    }
+
+} // namespace SearchEngine
@@ -0,0 +1,37 @@
+#ifndef RESULT_RANK_H
+#define RESULT_RANK_H
+
+#include <cstdint>
+#include <string_view>
+
+#include "Program.h"
+
+namespace SearchEngine
+{
+
+    // Where a result stands for one query, before the name tie-break.
+    struct RankKey
+    {
+        uint8_t type = 99;     // Lower first: system items, executables, shortcuts, ...
+        uint8_t relevance = 0; // Higher first: name prefix 3, name substring 2, description 1
+    };
+
+    /**
+     * @brief The order SearchResultSorter (lib/core/search_result_sorter.dart) gives
+     *        results, computed natively so a result set can be cut or paged best
+     *        first.
+     *
+     * @details Type priority from the path's extension and a few well-known names,
+     *          then relevance to the query, then the name ignoring case. Entry ids
+     *          break the remaining ties, so the order is total and two sorts of the
+     *          same results agree. Case is folded for ASCII only (utils::FoldCase),
+     *          like the rest of the native matching. Neither function allocates.
+     */
+    RankKey RankOf(const utils::Program &program, std::string_view foldedQuery);
+
+    // True if |a| (with key |aKey|) goes before |b|.
+    bool RanksBefore(const utils::Program &a, const RankKey &aKey, const utils::Program &b, const RankKey &bKey);
+
+} // namespace SearchEngine
+
+#endif // RESULT_RANK_H
@@ -0,0 +1,273 @@
+#include "ScanSupervisor.h"
+
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <thread>
+#include <utility>
+
+#include "BinaryIO.h"
+#include "ProgramCodec.h"
+#include "SharedMemory.h"
+#include "ShmRing.h"
+
+namespace SearchEngine
+{
+
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // Record tags. Control ring (launcher -> helper): Skip, Go.
+        // Data ring (helper -> launcher): Begin, Program, Deferred, End, Done.
+        constexpr char kSkip = 'S';
+        constexpr char kGo = 'G';
+        constexpr char kBegin = 'B';
+        constexpr char kProgram = 'P';
+        constexpr char kDeferred = 'T';
+        constexpr char kEnd = 'E';
+        constexpr char kDone = 'D';
+
+        constexpr std::chrono::milliseconds kPollInterval{1};
+        // How long the helper waits on a launcher that stopped reading.
+        constexpr std::chrono::seconds kHelperWriteTimeout{30};
+
+        // Channel layout: this header, then the control ring, then the data ring,
+        // each starting on a 64-byte boundary.
+        struct ChannelHeader
+        {
+            uint64_t controlBytes;
+            uint64_t dataBytes;
+        };
+        constexpr size_t kHeaderBytes = 64;
+        static_assert(sizeof(ChannelHeader) <= kHeaderBytes, "channel header too large");
+
+        size_t RoundUp(size_t value)
+        {
+            return (value + 63) & ~static_cast<size_t>(63);
+        }
+
+        std::string ChannelName(unsigned counter)
+        {
+            static const unsigned long long instance = std::random_device()();
+            char name[64];
+            std::snprintf(name, sizeof(name), "vxkonsol-scan-%llx-%u", instance, counter);
+            return name;
+        }
+
+        std::string Tagged(char tag, std::string_view payload = {})
+        {
+            std::string record(1, tag);
+            record.append(payload.data(), payload.size());
+            return record;
+        }
+    } // namespace
+
+    int RunScanHelper(const std::string &channel, ScanSource &source)
+    {
+        std::unique_ptr<utils::SharedMemory> memory = utils::SharedMemory::Open(channel);
+        if (!memory || memory->Size() < kHeaderBytes)
+            return 2;
+        ChannelHeader header;
+        std::memcpy(&header, memory->Data(), sizeof(header));
+        if (kHeaderBytes + header.controlBytes + header.dataBytes > memory->Size())
+            return 2;
+        char *base = static_cast<char *>(memory->Data());
+        utils::ShmRing control = utils::ShmRing::Attach(base + kHeaderBytes, static_cast<size_t>(header.controlBytes));
+        utils::ShmRing data = utils::ShmRing::Attach(base + kHeaderBytes + header.controlBytes, static_cast<size_t>(header.dataBytes));
+        if (!control.IsValid() || !data.IsValid())
+            return 2;
+
+        // The launcher writes the whole control stream before starting us.
+        std::set<std::string> skip;
+        std::string record;
+        bool go = false;
+        while (control.TryRead(record))
+        {
+            if (record.empty())
+                continue;
+            if (record[0] == kSkip)
+                skip.insert(record.substr(1));
+            else if (record[0] == kGo)
+                go = true;
+        }
+        if (!go)
+            return 2;
+
+        const auto write = [&data](const std::string &out) {
+            const Clock::time_point giveUp = Clock::now() + kHelperWriteTimeout;
+            while (!data.TryWrite(out))
+            {
+                if (Clock::now() > giveUp)
+                    return false;
+                std::this_thread::sleep_for(kPollInterval);
+            }
+            return true;
+        };
+
+        for (const std::string &item : source.Items())
+        {
+            if (skip.count(item))
+                continue;
+            if (!write(Tagged(kBegin, item)))
+                return 3;
+            const ScanSource::Resolution resolution = source.Resolve(item);
+            for (const utils::Program &program : resolution.programs)
+            {
+                utils::BinaryWriter out;
+                utils::WriteProgram(out, program);
+                if (!write(Tagged(kProgram, out.Data())))
+                    return 3;
+            }
+            if (resolution.deferred && !write(Tagged(kDeferred)))
+                return 3;
+            if (!write(Tagged(kEnd)))
+                return 3;
+        }
+        if (!write(Tagged(kDone)))
+            return 3;
+        data.Close();
+        return 0;
+    }
+
+    ScanSupervisor::ScanSupervisor(Launcher launch) : ScanSupervisor(std::move(launch), Options()) {}
+
+    ScanSupervisor::ScanSupervisor(Launcher launch, Options options)
+        : launch_(std::move(launch)), options_(options) {}
+
+    ScanSupervisor::Result ScanSupervisor::Scan(const utils::CancellationToken &token)
+    {
+        return Scan({}, token);
+    }
+
+    ScanSupervisor::Result ScanSupervisor::Scan(const std::set<std::string> &skip, const utils::CancellationToken &token)
+    {
+        std::lock_guard<std::mutex> lock(scanMutex_);
+        Result result;
+        std::set<std::string> done = skip;
+        for (int attempt = 0;; ++attempt)
+        {
+            const Attempt outcome = RunAttempt(done, result, token);
+            if (outcome == Attempt::Complete)
+            {
+                result.complete = true;
+                break;
+            }
+            if (outcome != Attempt::Restart || attempt >= options_.maxRestarts)
+                break;
+            ++result.restarts;
+        }
+        return result;
+    }
+
+    ScanSupervisor::Attempt ScanSupervisor::RunAttempt(std::set<std::string> &done, Result &result,
+                                                       const utils::CancellationToken &token)
+    {
+        std::vector<std::string> control;
+        for (const std::string &item : done)
+            control.push_back(Tagged(kSkip, item));
+        control.push_back(Tagged(kGo));
+
+        size_t controlCapacity = 0;
+        for (const std::string &record : control)
+            controlCapacity += 4 + record.size();
+        const size_t controlBytes = RoundUp(utils::ShmRing::RequiredBytes(controlCapacity + 4));
+        const size_t dataBytes = RoundUp(utils::ShmRing::RequiredBytes(options_.dataRingBytes));
+
+        const std::string channel = ChannelName(++channelCounter_);
+        std::unique_ptr<utils::SharedMemory> memory =
+            utils::SharedMemory::Create(channel, kHeaderBytes + controlBytes + dataBytes);
+        if (!memory)
+            return Attempt::Failed;
+        const ChannelHeader header{controlBytes, dataBytes};
+        std::memcpy(memory->Data(), &header, sizeof(header));
+        char *base = static_cast<char *>(memory->Data());
+        utils::ShmRing controlRing = utils::ShmRing::Format(base + kHeaderBytes, controlBytes);
+        utils::ShmRing data = utils::ShmRing::Format(base + kHeaderBytes + controlBytes, dataBytes);
+        for (const std::string &record : control)
+            controlRing.TryWrite(record);
+        controlRing.Close();
+
+        std::unique_ptr<utils::ChildProcess> child = launch_(channel);
+        if (!child)
+            return Attempt::Failed;
+
+        std::optional<std::string> current;
+        std::vector<utils::Program> pending;
+        bool deferred = false;
+        Clock::time_point lastProgress = Clock::now();
+        std::string record;
+        for (;;)
+        {
+            if (token.IsCancelled())
+                return Attempt::Cancelled;
+
+            // Checked before reading, so records written just before an exit are
+            // still drained below.
+            const bool exited = !child->IsRunning();
+            bool progressed = false;
+            while (data.TryRead(record))
+            {
+                progressed = true;
+                if (record.empty())
+                    continue;
+                switch (record[0])
+                {
+                case kBegin:
+                    current = record.substr(1);
+                    pending.clear();
+                    deferred = false;
+                    break;
+                case kProgram:
+                {
+                    utils::BinaryReader in(std::string_view(record).substr(1));
+                    utils::Program program;
+                    if (utils::ReadProgram(in, program))
+                        pending.push_back(std::move(program));
+                    break;
+                }
+                case kDeferred:
+                    deferred = true;
+                    break;
+                case kEnd:
+                    if (current)
+                    {
+                        done.insert(*current);
+                        result.finished.push_back(*current);
+                        if (deferred)
+                            result.deferred.push_back(*current);
+                    }
+                    for (utils::Program &program : pending)
+                        result.programs.push_back(std::move(program));
+                    pending.clear();
+                    current.reset();
+                    break;
+                case kDone:
+                    return Attempt::Complete;
+                default:
+                    break;
+                }
+            }
+            if (progressed)
+            {
+                lastProgress = Clock::now();
+                continue;
+            }
+
+            const bool overdue = Clock::now() - lastProgress > options_.itemDeadline;
+            if (exited || overdue)
+            {
+                child->Kill();
+                if (current)
+                {
+                    done.insert(*current);
+                    result.hung.push_back(*current);
+                }
+                return Attempt::Restart;
+            }
+            std::this_thread::sleep_for(kPollInterval);
+        }
+    }
+
+} // namespace SearchEngine
@@ -0,0 +1,120 @@
+#ifndef SCAN_SUPERVISOR_H
+#define SCAN_SUPERVISOR_H
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "ChildProcess.h"
+#include "Program.h"
+
+namespace SearchEngine
+{
+
+    /**
+     * @brief What the scanner helper scans, as a list of independently resolvable items.
+     *
+     * @details Item ids must be stable across runs (a .lnk path, "registry", ...),
+     *          since they are what gets skipped and quarantined.
+     */
+    class ScanSource
+    {
+    public:
+        struct Resolution
+        {
+            std::vector<utils::Program> programs;
+            // The item went over its own time budget and should be retried later.
+            bool deferred = false;
+        };
+
+        virtual ~ScanSource() = default;
+        // Every item, in the order the results should come back.
+        virtual std::vector<std::string> Items() = 0;
+        virtual Resolution Resolve(const std::string &item) = 0;
+    };
+
+    /**
+     * @brief Helper-process side of a supervised scan.
+     *
+     * @details Attaches to the shared memory named |channel|, reads the items to
+     *          skip from the control ring, then resolves every other item and
+     *          streams it back on the data ring: a begin record, one record per
+     *          program, a deferral record if the source gave up on it, an end
+     *          record. A final record marks the scan complete.
+     *
+     * @return The helper's exit code: 0 on a complete scan.
+     */
+    int RunScanHelper(const std::string &channel, ScanSource &source);
+
+    /**
+     * @brief Runs scans in a helper process and restarts it around items that hang or crash it.
+     *
+     * @details Each attempt creates a fresh shared-memory channel (a control ring
+     *          towards the helper, a data ring back) and launches the helper on it.
+     *          Results are kept per item, so an item cut short leaves nothing behind.
+     *          If the helper spends longer than |itemDeadline| on one item, or dies
+     *          inside it, the helper is killed, the item is reported as hung and a new
+     *          helper carries on from the next item, skipping everything already
+     *          done. The same deadline bounds the time before the first item.
+     *
+     *          What to skip across scans is the caller's call, through |skip|.
+     *          Scan() is not reentrant; concurrent callers are serialized.
+     */
+    class ScanSupervisor
+    {
+    public:
+        // Starts the helper so that it runs RunScanHelper(channel, ...).
+        using Launcher = std::function<std::unique_ptr<utils::ChildProcess>(const std::string &channel)>;
+
+        struct Options
+        {
+            std::chrono::milliseconds itemDeadline{std::chrono::seconds(5)};
+            // Helper launches per scan beyond the first.
+            int maxRestarts = 5;
+            size_t dataRingBytes = 4 << 20;
+        };
+
+        struct Result
+        {
+            std::vector<utils::Program> programs;
+            std::vector<std::string> finished; // Items resolved, deferred ones included
+            std::vector<std::string> deferred; // Items the helper gave up on within budget
+            std::vector<std::string> hung;     // Items the helper was killed in
+            int restarts = 0;
+            // False if the helper could not be started, gave up, or the scan was
+            // cancelled; |programs| then holds what was finished.
+            bool complete = false;
+        };
+
+        explicit ScanSupervisor(Launcher launch);
+        ScanSupervisor(Launcher launch, Options options);
+
+        Result Scan(const utils::CancellationToken &token = {});
+        Result Scan(const std::set<std::string> &skip, const utils::CancellationToken &token = {});
+
+    private:
+        enum class Attempt
+        {
+            Complete,
+            Restart,
+            Failed,
+            Cancelled,
+        };
+
+        // |done| holds the items skipped or completed by earlier attempts of this scan.
+        Attempt RunAttempt(std::set<std::string> &done, Result &result, const utils::CancellationToken &token);
+
+        Launcher launch_;
+        const Options options_;
+        std::mutex scanMutex_;
+        unsigned channelCounter_ = 0;
+    };
+
+} // namespace SearchEngine
+
+#endif // SCAN_SUPERVISOR_H
@@ -0,0 +1,146 @@
+#include "ScannerHelper.h"
+
+#include <windows.h>
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <set>
+#include <memory>
+#include <system_error>
+
+#include "ChildProcess.h"
+#include "ProgramFinder.h"
+#include "ScanSupervisor.h"
+#include "StatCache.h"
+#include "common_utils.h"
+
+namespace ProgramFinder
+{
+
+    namespace fs = std::filesystem;
+
+    namespace
+    {
+        constexpr char kRegistryItem[] = "registry";
+
+        // The helper's work list: the Uninstall registry as one item, then each
+        // Start Menu shortcut, the same order GetRawPrograms() returns them in.
+        class SystemScanSource : public SearchEngine::ScanSource
+        {
+        public:
+            std::vector<std::string> Items() override
+            {
+                std::vector<std::string> items = {kRegistryItem};
+                for (const StartMenuRoot &root : GetStartMenuRoots())
+                {
+                    std::error_code ec;
+                    fs::recursive_directory_iterator entries(fs::u8path(root.path), fs::directory_options::skip_permission_denied, ec);
+                    for (fs::recursive_directory_iterator end; !ec && entries != end; entries.increment(ec))
+                    {
+                        const fs::path &path = entries->path();
+                        std::error_code file_ec;
+                        if (!entries->is_regular_file(file_ec) || file_ec || _wcsicmp(path.extension().c_str(), L".lnk") != 0)
+                            continue;
+                        std::string item = utils::PathToUtf8(path);
+                        sources_[item] = root.source;
+                        items.push_back(std::move(item));
+                    }
+                }
+                return items;
+            }
+
+            Resolution Resolve(const std::string &item) override
+            {
+                Resolution resolution;
+                if (item == kRegistryItem)
+                {
+                    resolution.programs = GetRegistryPrograms();
+                    return resolution;
+                }
+                // Over its budget, this item is reported rather than queued here;
+                // the launcher retries it and keeps count.
+                std::optional<utils::Program> program = ReadShortcutProgram(item, sources_[item], {}, &resolution.deferred);
+                if (program)
+                    resolution.programs.push_back(std::move(*program));
+                return resolution;
+            }
+
+        private:
+            std::map<std::string, std::string> sources_; // .lnk path -> Program::source
+        };
+
+        std::string ExecutablePath()
+        {
+            std::wstring path(MAX_PATH, L'\0');
+            for (;;)
+            {
+                const DWORD length = GetModuleFileNameW(nullptr, path.data(), static_cast<DWORD>(path.size()));
+                if (length == 0)
+                    return {};
+                if (length < path.size())
+                {
+                    path.resize(length);
+                    return utils::WideToUtf8(path);
+                }
+                path.resize(path.size() * 2);
+            }
+        }
+
+        SearchEngine::ScanSupervisor &Supervisor()
+        {
+            static SearchEngine::ScanSupervisor supervisor([](const std::string &channel) -> std::unique_ptr<utils::ChildProcess> {
+                const std::string executable = ExecutablePath();
+                if (executable.empty())
+                    return nullptr;
+                return utils::ChildProcess::Spawn({executable, kScannerHelperFlag, channel});
+            });
+            return supervisor;
+        }
+    } // namespace
+
+    int RunScannerHelper(const std::string &channel)
+    {
+        const HRESULT hr = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+        int code = 0;
+        {
+            utils::StatCache statCache;
+            utils::StatCache::Scope statScope(statCache);
+            SystemScanSource source;
+            code = SearchEngine::RunScanHelper(channel, source);
+        }
+        const utils::BudgetedRunner::Stats latency = GetShortcutLatency();
+        const std::wstring line = L"Scanner helper: shortcut p50 " + std::to_wstring(latency.p50.count()) + L" us, p95 " +
+                                  std::to_wstring(latency.p95.count()) + L" us, p99 " + std::to_wstring(latency.p99.count()) +
+                                  L" us, max " + std::to_wstring(latency.max.count()) + L" us, " +
+                                  std::to_wstring(latency.overran) + L" over budget\n";
+        OutputDebugStringW(line.c_str());
+        ReleaseCaches();
+        if (SUCCEEDED(hr))
+            CoUninitialize();
+        return code;
+    }
+
+    std::vector<utils::Program> GetRawProgramsIsolated(const utils::CancellationToken &token)
+    {
+        const std::vector<std::string> quarantined = QuarantinedScanItems();
+        SearchEngine::ScanSupervisor::Result result =
+            Supervisor().Scan(std::set<std::string>(quarantined.begin(), quarantined.end()), token);
+        const bool neverStarted = !result.complete && result.restarts == 0 && result.programs.empty();
+        if (neverStarted && !token.IsCancelled())
+            return GetRawPrograms(token);
+
+        // The helper's deferrals are ours to retry.
+        std::set<std::string> deferred(result.deferred.begin(), result.deferred.end());
+        std::vector<std::string> succeeded;
+        for (const std::string &item : result.finished)
+        {
+            if (!deferred.count(item))
+                succeeded.push_back(item);
+        }
+        RecordScanOutcomes(succeeded, result.deferred, result.hung);
+        DeferShortcuts(result.deferred);
+        return std::move(result.programs);
+    }
+
+} // namespace ProgramFinder
@@ -0,0 +1,43 @@
+#ifndef SCANNER_HELPER_H
+#define SCANNER_HELPER_H
+
+#include <string>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "Program.h"
+
+namespace ProgramFinder
+{
+
+    // First argument that makes the runner executable act as the scanner helper;
+    // the second is the channel name.
+    constexpr char kScannerHelperFlag[] = "--scanner-helper";
+
+    /**
+     * @brief Entry point of the scanner helper process.
+     *
+     * @details Resolves the Uninstall registry and every Start Menu shortcut, one
+     *          item at a time, and streams the results to the launcher over
+     *          |channel| (see SearchEngine::RunScanHelper). Saves the on-disk caches
+     *          before returning.
+     *
+     * @return The process exit code.
+     */
+    int RunScannerHelper(const std::string &channel);
+
+    /**
+     * @brief GetRawPrograms() run in the scanner helper, under a watchdog.
+     *
+     * @details Shell extensions loaded while resolving shortcuts and extracting
+     *          icons can hang or crash; in the helper that costs one item, which is
+     *          quarantined (RecordScanOutcomes), instead of the launcher. Quarantined
+     *          items are skipped and shortcuts the helper deferred are queued for
+     *          TakeDeferredShortcuts(). Falls back to an in-process scan if the helper
+     *          cannot be started.
+     */
+    std::vector<utils::Program> GetRawProgramsIsolated(const utils::CancellationToken &token = {});
+
+} // namespace ProgramFinder
+
+#endif // SCANNER_HELPER_H
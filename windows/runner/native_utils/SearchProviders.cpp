@@ -0,0 +1,193 @@
+#include "SearchProviders.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "EntryId.h"
+#include "QueryArena.h"
+#include "ResultRank.h"
+#include "SettingsPages.h"
+#include "TextFold.h"
+
+namespace SearchEngine
+{
+
+    namespace
+    {
+        bool MatchesProgram(const utils::Program &program, std::string_view foldedQuery)
+        {
+            return utils::ContainsFolded(program.name, foldedQuery) ||
+                   utils::ContainsFolded(program.executablePath, foldedQuery);
+        }
+    } // namespace
+
+    utils::Program CloneProgram(const utils::Program &program)
+    {
+        utils::Program copy;
+        copy.name = program.name;
+        copy.executablePath = program.executablePath;
+        copy.arguments = program.arguments;
+        copy.iconPath = program.iconPath;
+        copy.iconIndex = program.iconIndex;
+        copy.iconDataBase64 = program.iconDataBase64;
+        copy.source = program.source;
+        copy.originPath = program.originPath;
+        copy.description = program.description;
+        copy.id = program.id;
+        copy.kind = program.kind;
+        return copy;
+    }
+
+    ProgramCatalog::ProgramCatalog() : current_(new Generation()) {}
+
+    ProgramCatalog::~ProgramCatalog()
+    {
+        delete current_.load();
+    }
+
+    uint64_t ProgramCatalog::Publish(std::vector<utils::Program> programs)
+    {
+        // Ids are computed once here rather than by every search that copies an
+        // entry out. Entries sharing an id become one, at the first one's position:
+        // the preferred entry (utils::PrefersEntry) with the others merged into it.
+        std::unordered_map<uint64_t, size_t> byId; // Entry id -> index of its kept entry
+        byId.reserve(programs.size());
+        size_t kept = 0;
+        for (utils::Program &program : programs)
+        {
+            auto [it, inserted] = byId.emplace(utils::AssignEntryId(program), kept);
+            if (!inserted)
+            {
+                utils::Program &existing = programs[it->second];
+                if (utils::PrefersEntry(program, existing))
+                    std::swap(existing, program);
+                utils::MergeDuplicateEntry(existing, std::move(program));
+                continue;
+            }
+            if (&programs[kept] != &program)
+                programs[kept] = std::move(program);
+            ++kept;
+        }
+        programs.resize(kept);
+        auto next = std::make_unique<Generation>();
+        next->programs = std::make_shared<const std::vector<utils::Program>>(std::move(programs));
+
+        std::lock_guard<std::mutex> lock(publishMutex_);
+        next->number = current_.load()->number + 1;
+        const uint64_t number = next->number;
+        const Generation *previous = current_.exchange(next.release());
+        epochs_.Retire([previous]() { delete previous; });
+        return number;
+    }
+
+    ProgramCatalog::ReadGuard ProgramCatalog::Read() const
+    {
+        // Pin before loading so the generation cannot be reclaimed in between.
+        utils::EpochDomain::Guard pin = epochs_.Pin();
+        const Generation *generation = current_.load();
+        return ReadGuard(std::move(pin), generation);
+    }
+
+    ProgramCatalog::Snapshot ProgramCatalog::Current() const
+    {
+        return Read()->programs;
+    }
+
+    uint64_t ProgramCatalog::GenerationNumber() const
+    {
+        return Read()->number;
+    }
+
+    size_t ProgramCatalog::Reclaim()
+    {
+        return epochs_.Collect();
+    }
+
+    void MatchCatalog(const ProgramCatalog::Snapshot &snapshot, std::string_view foldedQuery, ShortQueryIndex *shortQueries,
+                      const utils::CancellationToken &token, size_t limit, std::pmr::vector<size_t> &indices)
+    {
+        indices.clear();
+        if (!snapshot)
+            return;
+        // The index's order is this one, with launch frecency breaking ties before the name.
+        if (shortQueries && shortQueries->Lookup(snapshot, foldedQuery, indices))
+        {
+            if (limit != 0 && indices.size() > limit)
+                indices.resize(limit);
+            return;
+        }
+
+        const std::vector<utils::Program> &programs = *snapshot;
+
+        // Candidates live in the same resource as |indices|, usually the query arena.
+        struct Candidate
+        {
+            size_t index;
+            RankKey key;
+        };
+        std::pmr::vector<Candidate> candidates(indices.get_allocator().resource());
+        const auto better = [&programs](const Candidate &a, const Candidate &b) {
+            return RanksBefore(programs[a.index], a.key, programs[b.index], b.key);
+        };
+
+        // With a limit, a heap of the best |limit| so far, the worst on top.
+        for (size_t index = 0; index < programs.size() && !token.IsCancelled(); ++index)
+        {
+            if (!MatchesProgram(programs[index], foldedQuery))
+                continue;
+            const Candidate candidate{index, RankOf(programs[index], foldedQuery)};
+            if (limit == 0 || candidates.size() < limit)
+            {
+                candidates.push_back(candidate);
+                if (limit != 0)
+                    std::push_heap(candidates.begin(), candidates.end(), better);
+            }
+            else if (better(candidate, candidates.front()))
+            {
+                std::pop_heap(candidates.begin(), candidates.end(), better);
+                candidates.back() = candidate;
+                std::push_heap(candidates.begin(), candidates.end(), better);
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end(), better);
+        if (limit != 0 && candidates.size() > limit)
+            candidates.resize(limit);
+        indices.clear();
+        indices.reserve(candidates.size());
+        for (const Candidate &candidate : candidates)
+            indices.push_back(candidate.index);
+    }
+
+    std::vector<utils::Program> CatalogProvider::Search(const std::string &query, const utils::CancellationToken &token)
+    {
+        std::vector<utils::Program> results;
+        ProgramCatalog::ReadGuard generation = catalog_->Read();
+        const ProgramCatalog::Snapshot &snapshot = generation->programs;
+        if (!snapshot)
+            return results;
+
+        // Scratch data comes from the query arena; only the best |topK_| are copied out.
+        std::pmr::memory_resource *arena = utils::QueryArena::Current();
+        const std::pmr::string foldedQuery = utils::FoldCase(query, arena);
+        std::pmr::vector<size_t> indices(arena);
+        MatchCatalog(snapshot, foldedQuery, shortQueries_.get(), token, topK_, indices);
+
+        results.reserve(indices.size());
+        for (size_t index : indices)
+            results.push_back(CloneProgram((*snapshot)[index]));
+        return results;
+    }
+
+    std::vector<utils::Program> SettingsPagesProvider::Search(const std::string &query, const utils::CancellationToken &token)
+    {
+        uint16_t hits[kSettingsPageCount];
+        const size_t count = FindSettingsPages(query, hits, kSettingsPageCount);
+        std::vector<utils::Program> results;
+        results.reserve(count);
+        for (size_t i = 0; i < count && !token.IsCancelled(); ++i)
+            results.push_back(SettingsPageProgram(kSettingsPages[hits[i]]));
+        return results;
+    }
+
+} // namespace SearchEngine
@@ -0,0 +1,160 @@
+#ifndef SEARCH_PROVIDERS_H
+#define SEARCH_PROVIDERS_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "EpochReclamation.h"
+#include "Program.h"
+#include "ShortQueryIndex.h"
+
+namespace SearchEngine
+{
+
+    /**
+     * @brief One source of search results (installed programs, settings pages, the
+     *        file index, future plugins).
+     *
+     * @details Search() runs on a scheduler worker thread and may be called
+     *          concurrently for overlapping queries. Implementations should poll
+     *          |token| at row/entry granularity and return early once it fires.
+     */
+    class SearchProvider
+    {
+    public:
+        virtual ~SearchProvider() = default;
+
+        using Completion = std::function<void(std::vector<utils::Program> &&results)>;
+
+        virtual const char *Name() const = 0;
+        virtual std::vector<utils::Program> Search(const std::string &query, const utils::CancellationToken &token) = 0;
+
+        // What the scheduler calls: |done| gets the results exactly once, on this
+        // thread or a later one. Providers that wait their turn for something
+        // shared override it so the wait holds no worker; the rest answer here.
+        virtual void SearchAsync(const std::string &query, const utils::CancellationToken &token, Completion done)
+        {
+            done(Search(query, token));
+        }
+
+        // Expensive providers (disk/COM/IPC bound) are started speculatively by the
+        // scheduler and never hold back the first frame.
+        virtual bool IsExpensive() const { return false; }
+    };
+
+    /**
+     * @brief Natively cached copy of the installed-program catalog.
+     *
+     * @details Each Publish() builds an immutable generation off to the side and
+     *          swaps it in with one atomic pointer exchange. Readers never take a
+     *          lock: Read() pins an epoch and returns the generation that was current
+     *          at that moment, which stays valid until the guard is dropped even if a
+     *          refresh publishes meanwhile. Old generations are reclaimed once their
+     *          last reader unpins. Code that keeps the program list beyond a single
+     *          query takes the reference-counted Current() snapshot instead.
+     *
+     *          Entry ids are unique within a generation.
+     */
+    class ProgramCatalog
+    {
+    public:
+        using Snapshot = std::shared_ptr<const std::vector<utils::Program>>;
+
+        struct Generation
+        {
+            uint64_t number = 0; // 0 until the first Publish()
+            Snapshot programs;
+        };
+
+        class ReadGuard
+        {
+        public:
+            const Generation &operator*() const { return *generation_; }
+            const Generation *operator->() const { return generation_; }
+
+        private:
+            friend class ProgramCatalog;
+            ReadGuard(utils::EpochDomain::Guard pin, const Generation *generation) : pin_(std::move(pin)), generation_(generation) {}
+
+            utils::EpochDomain::Guard pin_;
+            const Generation *generation_;
+        };
+
+        ProgramCatalog();
+        ~ProgramCatalog();
+
+        ProgramCatalog(const ProgramCatalog &) = delete;
+        ProgramCatalog &operator=(const ProgramCatalog &) = delete;
+
+        // Returns the number of the new generation. Entries without an id get
+        // their utils::EntryId() here. Entries with the same id are merged into
+        // one: the utils::PrefersEntry() winner, filled in from the others.
+        uint64_t Publish(std::vector<utils::Program> programs);
+
+        ReadGuard Read() const;
+        Snapshot Current() const;
+        uint64_t GenerationNumber() const;
+
+        // Frees retired generations that were still pinned when they were replaced;
+        // otherwise they wait for the next Publish(). Returns how many remain.
+        size_t Reclaim();
+
+    private:
+        mutable utils::EpochDomain epochs_;
+        std::atomic<const Generation *> current_;
+        std::mutex publishMutex_; // Serializes writers
+    };
+
+    // Indices into *snapshot of the entries whose name or path contains |foldedQuery|
+    // (folded with utils::FoldCase), best first by RanksBefore(). At most |limit| of
+    // them, the best |limit| of all matches; 0 for all. One- and two-character
+    // queries come from |shortQueries| when it can answer, which holds the
+    // ShortQueryIndex::kTopK best in the same order, launch frecency breaking
+    // ties before the name.
+    void MatchCatalog(const ProgramCatalog::Snapshot &snapshot, std::string_view foldedQuery, ShortQueryIndex *shortQueries,
+                      const utils::CancellationToken &token, size_t limit, std::pmr::vector<size_t> &indices);
+
+    // Matches catalog entries whose name or path contains the query, like the Dart local filter,
+    // and returns the best |topK| of them (0 for all). One- and two-character queries are
+    // answered from |shortQueries| when given.
+    class CatalogProvider : public SearchProvider
+    {
+    public:
+        // More rows than anyone scrolls through for a program name.
+        static constexpr size_t kDefaultTopK = 200;
+
+        explicit CatalogProvider(std::shared_ptr<const ProgramCatalog> catalog, std::shared_ptr<ShortQueryIndex> shortQueries = nullptr,
+                                 size_t topK = kDefaultTopK)
+            : catalog_(std::move(catalog)), shortQueries_(std::move(shortQueries)), topK_(topK) {}
+
+        const char *Name() const override { return "catalog"; }
+        std::vector<utils::Program> Search(const std::string &query, const utils::CancellationToken &token) override;
+
+    private:
+        std::shared_ptr<const ProgramCatalog> catalog_;
+        std::shared_ptr<ShortQueryIndex> shortQueries_;
+        const size_t topK_;
+    };
+
+    // Answers from the compile-time ms-settings: page index (FindSettingsPages), keywords included.
+    class SettingsPagesProvider : public SearchProvider
+    {
+    public:
+        const char *Name() const override { return "settings"; }
+        std::vector<utils::Program> Search(const std::string &query, const utils::CancellationToken &token) override;
+    };
+
+    // Field-by-field copy; utils::Program is move-only to avoid accidental icon copies.
+    utils::Program CloneProgram(const utils::Program &program);
+
+} // namespace SearchEngine
+
+#endif // SEARCH_PROVIDERS_H
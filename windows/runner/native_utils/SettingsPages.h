@@ -1,8 +1,47 @@
 #ifndef SETTINGS_PAGES_H
 #define SETTINGS_PAGES_H
-#include "common_utils.h"
-#include <stdlib.h>
+#include "Program.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 #include <vector>
 
+// One ms-settings: page. Every field views a string literal, so the table below
+// is built at compile time and never allocates.
+struct SettingsPage
+{
+    std::string_view name;
+    std::string_view uri; // Opened through explorer.exe
+    std::string_view description;
+    std::string_view keywords; // Space-separated extra search terms
+};
+
+// Generated from SettingsPages.def, in display order.
+inline constexpr SettingsPage kSettingsPages[] = {
+#define SETTINGS_PAGE(name, uri, description, keywords) {name, uri, description, keywords},
+#include "SettingsPages.def"
+#undef SETTINGS_PAGE
+};
+inline constexpr size_t kSettingsPageCount = sizeof(kSettingsPages) / sizeof(kSettingsPages[0]);
+
+// The launchable catalog entry for |page|, its id assigned.
+utils::Program SettingsPageProgram(const SettingsPage &page);
+
 std::vector<utils::Program> getAllSettingsPages();
-#endif
\ No newline at end of file
+
+/**
+ * @brief Finds the settings pages matching |query| without allocating.
+ *
+ * @details Pages are indexed by the words of their name, description, URI and
+ *          keywords, case-insensitively. Every word of the query must match: a
+ *          word followed by a separator must match a page word exactly (through
+ *          a compile-time perfect hash), the last word may be a prefix (through
+ *          the sorted word table). Pages whose name starts with the query come
+ *          first, then pages whose name matched any word, each in table order.
+ *
+ * @param out Receives indices into kSettingsPages.
+ * @return How many indices were written, at most |capacity|.
+ */
+size_t FindSettingsPages(std::string_view query, uint16_t *out, size_t capacity);
+
+#endif
@@ -0,0 +1,146 @@
+#include "SharedMemory.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utils
+{
+
+#ifdef _WIN32
+
+    namespace
+    {
+        std::wstring MappingName(const std::string &name)
+        {
+            // Names are generated ASCII; no conversion needed.
+            return L"Local\\" + std::wstring(name.begin(), name.end());
+        }
+    } // namespace
+
+    std::unique_ptr<SharedMemory> SharedMemory::Create(const std::string &name, size_t size)
+    {
+        const unsigned long long size64 = size;
+        HANDLE handle = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                           static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64 & 0xFFFFFFFF),
+                                           MappingName(name).c_str());
+        if (!handle)
+            return nullptr;
+        if (GetLastError() == ERROR_ALREADY_EXISTS)
+        {
+            CloseHandle(handle);
+            return nullptr;
+        }
+        void *data = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (!data)
+        {
+            CloseHandle(handle);
+            return nullptr;
+        }
+        std::unique_ptr<SharedMemory> memory(new SharedMemory());
+        memory->handle_ = handle;
+        memory->data_ = data;
+        memory->size_ = size;
+        memory->name_ = name;
+        memory->owner_ = true;
+        return memory;
+    }
+
+    std::unique_ptr<SharedMemory> SharedMemory::Open(const std::string &name)
+    {
+        HANDLE handle = OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, MappingName(name).c_str());
+        if (!handle)
+            return nullptr;
+        void *data = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        MEMORY_BASIC_INFORMATION info = {};
+        if (!data || VirtualQuery(data, &info, sizeof(info)) == 0)
+        {
+            if (data)
+                UnmapViewOfFile(data);
+            CloseHandle(handle);
+            return nullptr;
+        }
+        std::unique_ptr<SharedMemory> memory(new SharedMemory());
+        memory->handle_ = handle;
+        memory->data_ = data;
+        memory->size_ = info.RegionSize; // Rounded up to whole pages
+        memory->name_ = name;
+        return memory;
+    }
+
+    SharedMemory::~SharedMemory()
+    {
+        if (data_)
+            UnmapViewOfFile(data_);
+        if (handle_)
+            CloseHandle(handle_);
+    }
+
+#else
+
+    namespace
+    {
+        std::string MappingName(const std::string &name)
+        {
+            return "/" + name;
+        }
+    } // namespace
+
+    std::unique_ptr<SharedMemory> SharedMemory::Create(const std::string &name, size_t size)
+    {
+        const std::string path = MappingName(name);
+        const int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0)
+            return nullptr;
+        void *data = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+            data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+        {
+            shm_unlink(path.c_str());
+            return nullptr;
+        }
+        std::unique_ptr<SharedMemory> memory(new SharedMemory());
+        memory->data_ = data;
+        memory->size_ = size;
+        memory->name_ = name;
+        memory->owner_ = true;
+        return memory;
+    }
+
+    std::unique_ptr<SharedMemory> SharedMemory::Open(const std::string &name)
+    {
+        const int fd = shm_open(MappingName(name).c_str(), O_RDWR, 0600);
+        if (fd < 0)
+            return nullptr;
+        struct stat info = {};
+        void *data = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && info.st_size > 0)
+            data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+            return nullptr;
+        std::unique_ptr<SharedMemory> memory(new SharedMemory());
+        memory->data_ = data;
+        memory->size_ = static_cast<size_t>(info.st_size);
+        memory->name_ = name;
+        return memory;
+    }
+
+    SharedMemory::~SharedMemory()
+    {
+        if (data_)
+            munmap(data_, size_);
+        if (owner_)
+            shm_unlink(MappingName(name_).c_str());
+    }
+
+#endif
+
+} // namespace utils
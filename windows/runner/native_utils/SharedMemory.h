@@ -0,0 +1,49 @@
+#ifndef SHARED_MEMORY_H
+#define SHARED_MEMORY_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace utils
+{
+
+    /**
+     * @brief A named, zero-filled memory mapping shared between processes.
+     *
+     * @details A named file mapping on Windows ("Local\" namespace), POSIX shared
+     *          memory elsewhere. The creator owns the name: on POSIX it is unlinked
+     *          when the creator's mapping goes away; on Windows the section lives
+     *          until every handle is closed.
+     */
+    class SharedMemory
+    {
+    public:
+        // nullptr if the mapping cannot be created (or already exists).
+        static std::unique_ptr<SharedMemory> Create(const std::string &name, size_t size);
+        // Maps an existing mapping in full. nullptr if it does not exist.
+        static std::unique_ptr<SharedMemory> Open(const std::string &name);
+
+        ~SharedMemory();
+
+        SharedMemory(const SharedMemory &) = delete;
+        SharedMemory &operator=(const SharedMemory &) = delete;
+
+        void *Data() const { return data_; }
+        size_t Size() const { return size_; }
+
+    private:
+        SharedMemory() = default;
+
+        void *data_ = nullptr;
+        size_t size_ = 0;
+        std::string name_;
+        bool owner_ = false;
+#ifdef _WIN32
+        void *handle_ = nullptr;
+#endif
+    };
+
+} // namespace utils
+
+#endif // SHARED_MEMORY_H
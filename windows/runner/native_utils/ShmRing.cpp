@@ -0,0 +1,117 @@
+#include "ShmRing.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace utils
+{
+
+    namespace
+    {
+        constexpr uint32_t kMagic = 0x52535856; // "VXSR"
+        constexpr size_t kLengthBytes = 4;
+    } // namespace
+
+    size_t ShmRing::RequiredBytes(size_t capacity)
+    {
+        return sizeof(Header) + capacity;
+    }
+
+    ShmRing ShmRing::Format(void *memory, size_t bytes)
+    {
+        if (!memory || bytes <= sizeof(Header) + kLengthBytes)
+            return ShmRing();
+        Header *header = new (memory) Header();
+        header->magic = kMagic;
+        header->closed.store(0);
+        header->capacity = bytes - sizeof(Header);
+        header->head.store(0);
+        header->tail.store(0, std::memory_order_release);
+        return ShmRing(header, static_cast<char *>(memory) + sizeof(Header));
+    }
+
+    ShmRing ShmRing::Attach(void *memory, size_t bytes)
+    {
+        if (!memory || bytes <= sizeof(Header))
+            return ShmRing();
+        Header *header = static_cast<Header *>(memory);
+        if (header->magic != kMagic || header->capacity > bytes - sizeof(Header))
+            return ShmRing();
+        return ShmRing(header, static_cast<char *>(memory) + sizeof(Header));
+    }
+
+    size_t ShmRing::Capacity() const
+    {
+        return header_ ? static_cast<size_t>(header_->capacity) : 0;
+    }
+
+    bool ShmRing::TryWrite(std::string_view record)
+    {
+        const uint64_t capacity = header_->capacity;
+        const uint64_t head = header_->head.load(std::memory_order_relaxed);
+        const uint64_t tail = header_->tail.load(std::memory_order_acquire);
+        const uint64_t needed = kLengthBytes + record.size();
+        if (needed > capacity - (head - tail))
+            return false;
+
+        uint8_t length[kLengthBytes];
+        for (size_t i = 0; i < kLengthBytes; ++i)
+            length[i] = static_cast<uint8_t>((record.size() >> (8 * i)) & 0xFF);
+        CopyIn(head, length, kLengthBytes);
+        CopyIn(head + kLengthBytes, record.data(), record.size());
+        header_->head.store(head + needed, std::memory_order_release);
+        return true;
+    }
+
+    void ShmRing::Close()
+    {
+        header_->closed.store(1, std::memory_order_release);
+    }
+
+    bool ShmRing::TryRead(std::string &record)
+    {
+        const uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+        const uint64_t head = header_->head.load(std::memory_order_acquire);
+        if (head - tail < kLengthBytes)
+            return false;
+
+        uint8_t length[kLengthBytes];
+        CopyOut(tail, length, kLengthBytes);
+        uint64_t size = 0;
+        for (size_t i = 0; i < kLengthBytes; ++i)
+            size |= static_cast<uint64_t>(length[i]) << (8 * i);
+        if (size > head - tail - kLengthBytes)
+            return false; // Torn header; the producer is broken
+        record.resize(static_cast<size_t>(size));
+        CopyOut(tail + kLengthBytes, record.data(), record.size());
+        header_->tail.store(tail + kLengthBytes + size, std::memory_order_release);
+        return true;
+    }
+
+    bool ShmRing::IsDrained() const
+    {
+        // Closed is set after the last write, so checking it first cannot miss data.
+        return header_->closed.load(std::memory_order_acquire) != 0 &&
+               header_->head.load(std::memory_order_acquire) == header_->tail.load(std::memory_order_relaxed);
+    }
+
+    void ShmRing::CopyIn(uint64_t position, const void *source, size_t size)
+    {
+        const size_t capacity = static_cast<size_t>(header_->capacity);
+        const size_t offset = static_cast<size_t>(position % capacity);
+        const size_t first = std::min(size, capacity - offset);
+        std::memcpy(data_ + offset, source, first);
+        std::memcpy(data_, static_cast<const char *>(source) + first, size - first);
+    }
+
+    void ShmRing::CopyOut(uint64_t position, void *target, size_t size) const
+    {
+        const size_t capacity = static_cast<size_t>(header_->capacity);
+        const size_t offset = static_cast<size_t>(position % capacity);
+        const size_t first = std::min(size, capacity - offset);
+        std::memcpy(target, data_ + offset, first);
+        std::memcpy(static_cast<char *>(target) + first, data_, size - first);
+    }
+
+} // namespace utils
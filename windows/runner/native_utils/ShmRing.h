@@ -0,0 +1,77 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace utils
+{
+
+    /**
+     * @brief Single-producer, single-consumer queue of byte records in caller-provided memory.
+     *
+     * @details Built to live in SharedMemory between two processes, so it holds no
+     *          pointers: a small header (monotonic head and tail byte counters on
+     *          separate cache lines) followed by the data area. Each record is a u32
+     *          length and its bytes, wrapping around the end of the area. Neither side
+     *          blocks; callers poll and decide how long to wait for the other process.
+     *
+     *          One process calls Format() once, before the other side attaches. A
+     *          record larger than Capacity() - 4 can never be written.
+     */
+    class ShmRing
+    {
+    public:
+        // Bytes of memory needed for a ring with |capacity| bytes of record space.
+        static size_t RequiredBytes(size_t capacity);
+
+        // Lays out an empty ring over |bytes| of |memory|.
+        static ShmRing Format(void *memory, size_t bytes);
+        // Uses a ring another process formatted. Invalid if |memory| was not formatted.
+        static ShmRing Attach(void *memory, size_t bytes);
+
+        ShmRing() = default;
+
+        bool IsValid() const { return header_ != nullptr; }
+        size_t Capacity() const;
+
+        // Producer. False if the record does not fit right now.
+        bool TryWrite(std::string_view record);
+        // Producer. Tells the consumer nothing more will come.
+        void Close();
+
+        // Consumer. False if nothing is queued.
+        bool TryRead(std::string &record);
+        // Consumer. True once Close() was called and everything was read.
+        bool IsDrained() const;
+
+    private:
+        struct Header
+        {
+            uint32_t magic;
+            std::atomic<uint32_t> closed;
+            uint64_t capacity;
+            // Explicit padding rather than alignas: mappings are page-aligned, so
+            // this puts each counter on its own cache line.
+            char padding0[48];
+            std::atomic<uint64_t> head; // Bytes ever written
+            char padding1[56];
+            std::atomic<uint64_t> tail; // Bytes ever read
+        };
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring counters must be lock-free to be shared");
+
+        ShmRing(Header *header, char *data) : header_(header), data_(data) {}
+
+        void CopyIn(uint64_t position, const void *source, size_t size);
+        void CopyOut(uint64_t position, void *target, size_t size) const;
+
+        Header *header_ = nullptr;
+        char *data_ = nullptr;
+    };
+
+} // namespace utils
+
+#endif // SHM_RING_H
@@ -0,0 +1,353 @@
+#include "ShortQueryIndex.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "ResultRank.h"
+#include "TextFold.h"
+
+namespace SearchEngine
+{
+
+    namespace
+    {
+        // Single characters and bigrams share one key space.
+        uint32_t CharKey(char c)
+        {
+            return 0x10000u | static_cast<unsigned char>(c);
+        }
+
+        uint32_t BigramKey(char a, char b)
+        {
+            return (static_cast<uint32_t>(static_cast<unsigned char>(a)) << 8) | static_cast<unsigned char>(b);
+        }
+
+        std::string KeyText(uint32_t key)
+        {
+            if (key & 0x10000u)
+                return std::string(1, static_cast<char>(key & 0xff));
+            return {static_cast<char>(key >> 8), static_cast<char>(key & 0xff)};
+        }
+
+        bool IsWordChar(char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || static_cast<unsigned char>(c) >= 0x80;
+        }
+
+        // Relevance dominates; frecency only orders entries of equal relevance.
+        constexpr double kRelevanceWeight = 1e6;
+
+        struct Ranked
+        {
+            size_t index;
+            double score;
+        };
+
+        // The folded text of one snapshot; shared by every version of its tables.
+        struct Folded
+        {
+            std::vector<std::string> names;
+            std::vector<std::string> paths;
+            std::vector<std::string> descriptions;
+            std::vector<uint8_t> types; // RankKey::type
+            std::vector<uint64_t> ids;
+            std::unordered_set<uint32_t> bigramKeys;
+        };
+
+        // RanksBefore() with frecency between relevance and the name.
+        bool Better(const Folded &folded, const Ranked &a, const Ranked &b)
+        {
+            if (folded.types[a.index] != folded.types[b.index])
+                return folded.types[a.index] < folded.types[b.index];
+            if (a.score != b.score)
+                return a.score > b.score;
+            const int names = folded.names[a.index].compare(folded.names[b.index]);
+            if (names != 0)
+                return names < 0;
+            return folded.ids[a.index] < folded.ids[b.index];
+        }
+
+        double Score(const Folded &folded, size_t index, std::string_view foldedKey)
+        {
+            const std::string &name = folded.names[index];
+            if (name.compare(0, foldedKey.size(), foldedKey) == 0)
+                return 3;
+            if (name.find(foldedKey) != std::string::npos)
+                return 2;
+            if (folded.descriptions[index].find(foldedKey) != std::string::npos)
+                return 1;
+            return 0;
+        }
+
+        // Every table entry |index| belongs to: the distinct characters and indexed
+        // bigrams of its name and path.
+        std::vector<uint32_t> KeysOf(const Folded &folded, size_t index)
+        {
+            std::vector<uint32_t> keys;
+            for (const std::string *text : {&folded.names[index], &folded.paths[index]})
+            {
+                for (size_t i = 0; i < text->size(); ++i)
+                {
+                    keys.push_back(CharKey((*text)[i]));
+                    if (i + 1 < text->size())
+                    {
+                        const uint32_t bigram = BigramKey((*text)[i], (*text)[i + 1]);
+                        if (folded.bigramKeys.count(bigram))
+                            keys.push_back(bigram);
+                    }
+                }
+            }
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+            return keys;
+        }
+
+        void Insert(const Folded &folded, std::vector<Ranked> &list, size_t index, double score)
+        {
+            const auto better = [&folded](const Ranked &a, const Ranked &b) { return Better(folded, a, b); };
+            auto existing = std::find_if(list.begin(), list.end(), [index](const Ranked &r) { return r.index == index; });
+            if (existing != list.end())
+                existing->score = score;
+            else if (list.size() < ShortQueryIndex::kTopK || better({index, score}, list.back()))
+                list.push_back({index, score});
+            else
+                return;
+
+            std::sort(list.begin(), list.end(), better);
+            if (list.size() > ShortQueryIndex::kTopK)
+                list.resize(ShortQueryIndex::kTopK);
+        }
+
+        // One immutable version of the tables. Readers copy the pointer and use it
+        // without a lock; changes build a new version and swap it in.
+        struct ShortQueryTables
+        {
+            ShortQueryIndex::Snapshot programs;
+            std::shared_ptr<const Folded> folded;
+            std::unordered_map<uint32_t, std::vector<Ranked>> lists;
+        };
+    } // namespace
+
+    struct ShortQueryIndex::Shared
+    {
+        std::shared_ptr<const LaunchHistory> history;
+        utils::TaskExecutor *executor = nullptr;
+
+        mutable std::mutex mutex; // Guards the members below; never held while building
+        std::shared_ptr<const ShortQueryTables> tables;
+        Snapshot building; // The snapshot a build is running for, if any
+        // Launches recorded while |building| ran, re-applied to its tables.
+        std::vector<std::pair<std::string, std::string>> launchesDuringBuild;
+
+        std::shared_ptr<const ShortQueryTables> Build(const Snapshot &programs) const
+        {
+            auto tables = std::make_shared<ShortQueryTables>();
+            tables->programs = programs;
+            auto folded = std::make_shared<Folded>();
+            const size_t count = programs->size();
+            folded->names.reserve(count);
+            folded->paths.reserve(count);
+            folded->descriptions.reserve(count);
+            folded->types.reserve(count);
+            folded->ids.reserve(count);
+            for (const utils::Program &program : *programs)
+            {
+                folded->names.push_back(utils::FoldCase(program.name));
+                folded->paths.push_back(utils::FoldCase(program.executablePath));
+                folded->descriptions.push_back(utils::FoldCase(program.description));
+                folded->types.push_back(RankOf(program, {}).type);
+                folded->ids.push_back(program.id);
+            }
+
+            // Bigram tables only for word starts ("co" in "Visual Studio Code"); other
+            // bigrams are rare as queries and fall back to the scan.
+            for (const std::string &name : folded->names)
+            {
+                for (size_t i = 0; i + 1 < name.size(); ++i)
+                {
+                    if ((i == 0 || !IsWordChar(name[i - 1])) && IsWordChar(name[i]) && IsWordChar(name[i + 1]))
+                        folded->bigramKeys.insert(BigramKey(name[i], name[i + 1]));
+                }
+            }
+
+            std::unordered_map<uint32_t, std::vector<Ranked>> candidates;
+            for (size_t index = 0; index < count; ++index)
+            {
+                const utils::Program &program = (*programs)[index];
+                const double frecency = history ? history->Frecency(program.executablePath, program.arguments) : 0.0;
+                for (uint32_t key : KeysOf(*folded, index))
+                    candidates[key].push_back({index, Score(*folded, index, KeyText(key)) * kRelevanceWeight + frecency});
+            }
+
+            const Folded &ranking = *folded;
+            for (auto &[key, list] : candidates)
+            {
+                const auto better = [&ranking](const Ranked &a, const Ranked &b) { return Better(ranking, a, b); };
+                if (list.size() > kTopK)
+                {
+                    std::partial_sort(list.begin(), list.begin() + kTopK, list.end(), better);
+                    list.resize(kTopK);
+                }
+                else
+                {
+                    std::sort(list.begin(), list.end(), better);
+                }
+                tables->lists.emplace(key, std::move(list));
+            }
+            tables->folded = std::move(folded);
+            return tables;
+        }
+
+        // Starts a build for |programs| unless its tables are built or being
+        // built. A build for another snapshot is replaced only if |supersede|.
+        static void Request(const std::shared_ptr<Shared> &shared, const Snapshot &programs, bool supersede);
+
+        // |tables| with the entries of |path|/|args| re-ranked, or nullptr if
+        // none of them is in the catalog.
+        std::shared_ptr<const ShortQueryTables> Relaunch(const ShortQueryTables &tables, const std::string &path,
+                                                         const std::string &args) const
+        {
+            std::shared_ptr<ShortQueryTables> next;
+            const std::string foldedPath = utils::FoldCase(path);
+            const Folded &folded = *tables.folded;
+            for (size_t index = 0; index < tables.programs->size(); ++index)
+            {
+                const utils::Program &program = (*tables.programs)[index];
+                if (folded.paths[index] != foldedPath || program.arguments != args)
+                    continue;
+                if (!next)
+                    next = std::make_shared<ShortQueryTables>(tables);
+
+                const double frecency = history ? history->Frecency(program.executablePath, program.arguments) : 0.0;
+                for (uint32_t key : KeysOf(folded, index))
+                {
+                    auto it = next->lists.find(key);
+                    if (it != next->lists.end())
+                        Insert(folded, it->second, index, Score(folded, index, KeyText(key)) * kRelevanceWeight + frecency);
+                }
+            }
+            return next;
+        }
+    };
+
+    void ShortQueryIndex::Shared::Request(const std::shared_ptr<Shared> &shared, const Snapshot &programs, bool supersede)
+    {
+        if (!programs)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            if (shared->building == programs || (shared->tables && shared->tables->programs == programs))
+                return;
+            if (shared->building && !supersede)
+                return;
+            shared->building = programs;
+            shared->launchesDuringBuild.clear();
+        }
+        shared->executor->Post(utils::TaskPriority::Refresh, [shared, programs]() {
+            {
+                // Superseded by another snapshot before it started.
+                std::lock_guard<std::mutex> lock(shared->mutex);
+                if (shared->building != programs)
+                    return;
+            }
+            std::shared_ptr<const ShortQueryTables> tables = shared->Build(programs);
+
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            if (shared->building != programs)
+                return;
+            for (const auto &[path, args] : shared->launchesDuringBuild)
+            {
+                if (std::shared_ptr<const ShortQueryTables> next = shared->Relaunch(*tables, path, args))
+                    tables = std::move(next);
+            }
+            shared->launchesDuringBuild.clear();
+            shared->building = nullptr;
+            shared->tables = std::move(tables);
+        });
+    }
+
+    ShortQueryIndex::ShortQueryIndex(std::shared_ptr<const LaunchHistory> history, utils::TaskExecutor &executor)
+        : shared_(std::make_shared<Shared>())
+    {
+        shared_->history = std::move(history);
+        shared_->executor = &executor;
+    }
+
+    ShortQueryIndex::~ShortQueryIndex() = default;
+
+    bool ShortQueryIndex::Lookup(const Snapshot &programs, std::string_view foldedQuery, std::pmr::vector<size_t> &indices)
+    {
+        if (!programs || foldedQuery.empty() || foldedQuery.size() > 2)
+            return false;
+
+        std::shared_ptr<const ShortQueryTables> tables;
+        {
+            std::lock_guard<std::mutex> lock(shared_->mutex);
+            tables = shared_->tables;
+        }
+        if (!tables || tables->programs != programs)
+        {
+            // A query on a snapshot already being replaced must not take over
+            // the build, so this one only starts a build if none runs.
+            Shared::Request(shared_, programs, false);
+            return false;
+        }
+
+        const uint32_t key = foldedQuery.size() == 1 ? CharKey(foldedQuery[0]) : BigramKey(foldedQuery[0], foldedQuery[1]);
+        auto it = tables->lists.find(key);
+        if (it == tables->lists.end())
+        {
+            // An unknown single character simply matches nothing; an unindexed
+            // bigram may still match and needs the scan.
+            indices.clear();
+            return foldedQuery.size() == 1;
+        }
+
+        indices.clear();
+        indices.reserve(it->second.size());
+        for (const Ranked &ranked : it->second)
+            indices.push_back(ranked.index);
+        return true;
+    }
+
+    void ShortQueryIndex::Prepare(const Snapshot &programs)
+    {
+        Shared::Request(shared_, programs, true);
+    }
+
+    bool ShortQueryIndex::Ready(const Snapshot &programs) const
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        return programs && shared_->tables && shared_->tables->programs == programs;
+    }
+
+    void ShortQueryIndex::OnLaunch(const std::string &path, const std::string &args)
+    {
+        std::shared_ptr<const ShortQueryTables> tables;
+        {
+            std::lock_guard<std::mutex> lock(shared_->mutex);
+            if (shared_->building)
+                shared_->launchesDuringBuild.emplace_back(path, args);
+            tables = shared_->tables;
+        }
+        while (tables)
+        {
+            std::shared_ptr<const ShortQueryTables> next = shared_->Relaunch(*tables, path, args);
+            if (!next)
+                return;
+            std::lock_guard<std::mutex> lock(shared_->mutex);
+            // Another launch or a rebuild swapped in newer tables meanwhile:
+            // re-rank those instead.
+            if (shared_->tables == tables)
+            {
+                shared_->tables = std::move(next);
+                return;
+            }
+            tables = shared_->tables;
+        }
+    }
+
+} // namespace SearchEngine
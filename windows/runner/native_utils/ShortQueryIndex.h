@@ -0,0 +1,80 @@
+#ifndef SHORT_QUERY_INDEX_H
+#define SHORT_QUERY_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LaunchHistory.h"
+#include "Program.h"
+#include "TaskExecutor.h"
+
+namespace SearchEngine
+{
+
+    /**
+     * @brief Precomputed top-K answers for one- and two-character queries.
+     *
+     * @details A single character or a bigram matches most of the catalog, so
+     *          scanning and ranking everything on the first keystrokes is the most
+     *          expensive search of all. This index keeps, for every folded ASCII
+     *          character and for every bigram that starts a word in some program
+     *          name, the kTopK best matching catalog entries. Matching is the
+     *          catalog rule (name or path contains the query); ranking is the
+     *          result order of ResultRank.h (type, then relevance) with frecency
+     *          from LaunchHistory breaking ties before the name.
+     *
+     *          Tables for a catalog snapshot are built by a Refresh task on
+     *          |executor|, requested by Prepare() or by the first Lookup() that
+     *          finds none, and swapped in whole once done. Until then Lookup()
+     *          declines and the caller scans, so no query waits for a build.
+     *          OnLaunch() re-ranks a copy of the affected tables and swaps that in
+     *          the same way. Thread-safe.
+     */
+    class ShortQueryIndex
+    {
+    public:
+        using Snapshot = std::shared_ptr<const std::vector<utils::Program>>;
+
+        static constexpr size_t kTopK = 64;
+
+        explicit ShortQueryIndex(std::shared_ptr<const LaunchHistory> history,
+                                 utils::TaskExecutor &executor = utils::SharedExecutor());
+        // A build still running finishes on its own and is discarded.
+        ~ShortQueryIndex();
+
+        ShortQueryIndex(const ShortQueryIndex &) = delete;
+        ShortQueryIndex &operator=(const ShortQueryIndex &) = delete;
+
+        /**
+         * @brief Serves |foldedQuery| from the tables if possible.
+         *
+         * @return True with |indices| (into *programs, best first) filled in, or false
+         *         if the query is not one or two characters, has no table, or the
+         *         tables for |programs| are not built yet; the caller then falls
+         *         back to a full scan.
+         */
+        bool Lookup(const Snapshot &programs, std::string_view foldedQuery, std::pmr::vector<size_t> &indices);
+
+        // Starts building the tables for |programs| unless they are built or
+        // being built already.
+        void Prepare(const Snapshot &programs);
+
+        // True once Lookup() answers from tables built for |programs|.
+        bool Ready(const Snapshot &programs) const;
+
+        // Re-ranks the tables containing |path|/|args| after a launch was recorded.
+        void OnLaunch(const std::string &path, const std::string &args);
+
+    private:
+        struct Shared;
+        std::shared_ptr<Shared> shared_;
+    };
+
+} // namespace SearchEngine
+
+#endif // SHORT_QUERY_INDEX_H
@@ -0,0 +1,229 @@
+#include "ShortcutCache.h"
+
+#include <fstream>
+#include <system_error>
+
+#include "BinaryIO.h"
+#include "TextFold.h"
+
+namespace utils
+{
+
+    namespace fs = std::filesystem;
+
+    namespace
+    {
+        constexpr uint32_t kMagic = 0x43535856; // "VXSC"
+        constexpr uint32_t kVersion = 1;
+
+        void WriteInfo(BinaryWriter &out, const ShortcutInfo &info)
+        {
+            out.String(info.resolvedTargetPathUtf8);
+            out.String(info.argumentsUtf8);
+            out.String(info.iconPathUtf8);
+            out.I32(info.iconIndex);
+            out.String(info.iconDataBase64);
+            out.String(info.kind);
+            out.String(info.descriptionUtf8);
+            out.U8(info.isFallbackPath ? 1 : 0);
+        }
+
+        bool ReadInfo(BinaryReader &in, ShortcutInfo &info)
+        {
+            int32_t iconIndex = 0;
+            uint8_t fallback = 0;
+            in.String(info.resolvedTargetPathUtf8);
+            in.String(info.argumentsUtf8);
+            in.String(info.iconPathUtf8);
+            in.I32(iconIndex);
+            in.String(info.iconDataBase64);
+            in.String(info.kind);
+            in.String(info.descriptionUtf8);
+            in.U8(fallback);
+            info.iconIndex = iconIndex;
+            info.isFallbackPath = fallback != 0;
+            return in.Ok();
+        }
+    } // namespace
+
+    std::optional<FileStamp> FileStamp::Of(const fs::directory_entry &entry)
+    {
+        std::error_code ec;
+        const uintmax_t size = entry.file_size(ec);
+        if (ec)
+            return std::nullopt;
+        const fs::file_time_type mtime = entry.last_write_time(ec);
+        if (ec)
+            return std::nullopt;
+        return FileStamp{static_cast<uint64_t>(size), static_cast<int64_t>(mtime.time_since_epoch().count())};
+    }
+
+    std::optional<FileStamp> FileStamp::Of(const fs::path &path)
+    {
+        std::error_code ec;
+        fs::directory_entry entry(path, ec);
+        if (ec)
+            return std::nullopt;
+        return Of(entry);
+    }
+
+    bool ShortcutCache::Load(const fs::path &file)
+    {
+        // One sized read: with every icon inline the file runs to megabytes.
+        std::ifstream stream(file, std::ios::binary | std::ios::ate);
+        std::string data;
+        if (stream)
+        {
+            data.resize(static_cast<size_t>(stream.tellg()));
+            stream.seekg(0);
+            stream.read(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!stream)
+                data.clear();
+        }
+
+        std::unordered_map<std::string, Entry> loaded;
+        bool valid = data.size() >= 8;
+        if (valid)
+        {
+            const std::string_view payload(data.data(), data.size() - 8);
+            BinaryReader trailer(std::string_view(data).substr(payload.size()));
+            uint64_t checksum = 0;
+            valid = trailer.U64(checksum) && checksum == Fnv1a64(payload);
+
+            BinaryReader in(payload);
+            uint32_t magic = 0, version = 0, count = 0;
+            valid = valid && in.U32(magic) && in.U32(version) && in.U32(count) && magic == kMagic && version == kVersion;
+            for (uint32_t i = 0; valid && i < count; ++i)
+            {
+                std::string key;
+                Entry entry;
+                in.String(key);
+                in.U64(entry.stamp.size);
+                in.I64(entry.stamp.mtime);
+                valid = ReadInfo(in, entry.info);
+                if (valid)
+                    loaded[std::move(key)] = std::move(entry);
+            }
+            valid = valid && in.AtEnd();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_ = valid ? std::move(loaded) : std::unordered_map<std::string, Entry>();
+        dirty_ = false;
+        return valid;
+    }
+
+    bool ShortcutCache::Save(const fs::path &file)
+    {
+        BinaryWriter out;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!dirty_)
+                return true;
+            out.U32(kMagic);
+            out.U32(kVersion);
+            out.U32(static_cast<uint32_t>(entries_.size()));
+            for (const auto &[key, entry] : entries_)
+            {
+                out.String(key);
+                out.U64(entry.stamp.size);
+                out.I64(entry.stamp.mtime);
+                WriteInfo(out, entry.info);
+            }
+            dirty_ = false;
+        }
+        out.U64(Fnv1a64(out.Data()));
+
+        std::error_code ec;
+        fs::create_directories(file.parent_path(), ec);
+        fs::path temp = file;
+        temp += ".tmp";
+        {
+            std::ofstream stream(temp, std::ios::binary | std::ios::trunc);
+            stream.write(out.Data().data(), static_cast<std::streamsize>(out.Data().size()));
+            if (!stream)
+                ec = std::make_error_code(std::errc::io_error);
+        }
+        if (!ec)
+            fs::rename(temp, file, ec);
+        if (ec)
+        {
+            fs::remove(temp, ec);
+            std::lock_guard<std::mutex> lock(mutex_);
+            dirty_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    void ShortcutCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::unordered_map<std::string, Entry>().swap(entries_);
+        dirty_ = false;
+    }
+
+    std::optional<ShortcutInfo> ShortcutCache::Find(const std::string &linkPath, const FileStamp &stamp)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(FoldCase(linkPath));
+        if (it == entries_.end() || it->second.stamp != stamp)
+        {
+            ++misses_;
+            return std::nullopt;
+        }
+        ++hits_;
+        it->second.scan = scan_;
+        return it->second.info;
+    }
+
+    void ShortcutCache::Store(const std::string &linkPath, const FileStamp &stamp, const ShortcutInfo &info)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry &entry = entries_[FoldCase(linkPath)];
+        entry.stamp = stamp;
+        entry.info = info;
+        entry.scan = scan_;
+        dirty_ = true;
+    }
+
+    void ShortcutCache::Forget(const std::string &linkPath)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entries_.erase(FoldCase(linkPath)) != 0)
+            dirty_ = true;
+    }
+
+    void ShortcutCache::BeginScan()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++scan_;
+    }
+
+    size_t ShortcutCache::EndScan()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t dropped = 0;
+        for (auto it = entries_.begin(); it != entries_.end();)
+        {
+            if (it->second.scan != scan_)
+            {
+                it = entries_.erase(it);
+                ++dropped;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        dirty_ = dirty_ || dropped > 0;
+        return dropped;
+    }
+
+    ShortcutCache::Stats ShortcutCache::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return {entries_.size(), hits_, misses_};
+    }
+
+} // namespace utils
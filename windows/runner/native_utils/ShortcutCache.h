@@ -0,0 +1,94 @@
+#ifndef SHORTCUT_CACHE_H
+#define SHORTCUT_CACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "Program.h"
+
+namespace utils
+{
+
+    // Size and last-write time of a file; a .lnk whose stamp is unchanged is
+    // assumed to resolve the same way it did last time.
+    struct FileStamp
+    {
+        uint64_t size = 0;
+        int64_t mtime = 0; // file_time_type ticks
+
+        bool operator==(const FileStamp &other) const { return size == other.size && mtime == other.mtime; }
+        bool operator!=(const FileStamp &other) const { return !(*this == other); }
+
+        // From a directory iterator entry; on Windows these come from the
+        // enumeration itself, so a whole folder is stamped without extra I/O.
+        static std::optional<FileStamp> Of(const std::filesystem::directory_entry &entry);
+        static std::optional<FileStamp> Of(const std::filesystem::path &path);
+    };
+
+    /**
+     * @brief Persistent map from (.lnk path, FileStamp) to its resolved ShortcutInfo.
+     *
+     * @details Resolving a shortcut costs a COM load, several path probes and
+     *          usually an icon extraction; a rescan of an unchanged Start Menu should
+     *          pay none of that. Callers look up with the stamp they just read and
+     *          resolve only on a miss. Entries not looked up or stored since the last
+     *          BeginScan() are dropped by EndScan(), so deleted shortcuts do not
+     *          accumulate.
+     *
+     *          The file format is a versioned little-endian record list with an
+     *          FNV-1a trailer; a file that fails to parse is ignored and rewritten on
+     *          the next Save(). Thread-safe.
+     */
+    class ShortcutCache
+    {
+    public:
+        struct Stats
+        {
+            size_t entries = 0;
+            size_t hits = 0;
+            size_t misses = 0;
+        };
+
+        // Replaces the contents with |file|. Returns false (and stays empty) if the
+        // file is missing, from another format version or corrupt.
+        bool Load(const std::filesystem::path &file);
+        // Writes through a temporary file and a rename. No-op if nothing changed.
+        bool Save(const std::filesystem::path &file);
+        // Drops every entry and frees the table; unsaved changes are lost.
+        void Clear();
+
+        std::optional<ShortcutInfo> Find(const std::string &linkPath, const FileStamp &stamp);
+        void Store(const std::string &linkPath, const FileStamp &stamp, const ShortcutInfo &info);
+        // Forces the next lookup of |linkPath| to miss, e.g. after its target vanished.
+        void Forget(const std::string &linkPath);
+
+        void BeginScan();
+        // Drops entries the scan did not touch; returns how many. Skip this for an
+        // aborted scan, which did not see everything.
+        size_t EndScan();
+
+        Stats GetStats() const;
+
+    private:
+        struct Entry
+        {
+            FileStamp stamp;
+            ShortcutInfo info;
+            uint32_t scan = 0;
+        };
+
+        mutable std::mutex mutex_;
+        std::unordered_map<std::string, Entry> entries_; // Keyed by folded path
+        uint32_t scan_ = 0;
+        bool dirty_ = false;
+        size_t hits_ = 0;
+        size_t misses_ = 0;
+    };
+
+} // namespace utils
+
+#endif // SHORTCUT_CACHE_H
@@ -0,0 +1,106 @@
+#ifndef SINGLE_FLIGHT_H
+#define SINGLE_FLIGHT_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "CancellationToken.h"
+
+namespace utils
+{
+
+    /**
+     * @brief Lets concurrent identical requests share one computation.
+     *
+     * @details The first Join() for a key starts a flight and gets it back; the
+     *          caller computes the value, wherever it likes, and passes it to
+     *          Land(). Joins for the same key until then only add their
+     *          callback. Land() runs every callback with the one value, on the
+     *          landing thread and in join order, and the next Join() starts a
+     *          new flight.
+     *
+     *          A flight carries the token of the request that started it. Once
+     *          that is cancelled, the computation may stop short, so a later
+     *          Join() starts a new flight instead of joining it; the cancelled
+     *          one still lands for the callbacks it has. Thread-safe.
+     */
+    template <typename Key, typename Value, typename Hash = std::hash<Key>>
+    class SingleFlight
+    {
+    public:
+        using Result = std::shared_ptr<Value>;
+        // |sole| is true for a flight's only callback, which may then move the
+        // value out; otherwise callbacks must leave it as it is.
+        using Callback = std::function<void(const Result &result, bool sole)>;
+
+        class Flight
+        {
+        private:
+            friend class SingleFlight;
+            Flight(Key key, CancellationToken token) : key_(std::move(key)), token_(std::move(token)) {}
+
+            Key key_;
+            CancellationToken token_;
+            std::vector<Callback> callbacks_;
+        };
+
+        struct Stats
+        {
+            uint64_t started = 0; // Flights, i.e. computations
+            uint64_t joined = 0;  // Requests that shared one already running
+        };
+
+        // Adds |onDone| to the flight for |key|. Returns the flight if this call
+        // started it, and the caller must Land() it; nullptr if it joined one.
+        std::shared_ptr<Flight> Join(const Key &key, const CancellationToken &token, Callback onDone)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = flights_.find(key);
+            if (it != flights_.end() && !it->second->token_.IsCancelled())
+            {
+                it->second->callbacks_.push_back(std::move(onDone));
+                ++stats_.joined;
+                return nullptr;
+            }
+            std::shared_ptr<Flight> flight(new Flight(key, token));
+            flight->callbacks_.push_back(std::move(onDone));
+            flights_[key] = flight;
+            ++stats_.started;
+            return flight;
+        }
+
+        void Land(const std::shared_ptr<Flight> &flight, Result result)
+        {
+            std::vector<Callback> callbacks;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = flights_.find(flight->key_);
+                if (it != flights_.end() && it->second == flight)
+                    flights_.erase(it);
+                callbacks.swap(flight->callbacks_);
+            }
+            const bool sole = callbacks.size() == 1;
+            for (Callback &callback : callbacks)
+                callback(result, sole);
+        }
+
+        Stats GetStats() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return stats_;
+        }
+
+    private:
+        mutable std::mutex mutex_;
+        std::unordered_map<Key, std::shared_ptr<Flight>, Hash> flights_;
+        Stats stats_;
+    };
+
+} // namespace utils
+
+#endif // SINGLE_FLIGHT_H
@@ -0,0 +1,190 @@
+#include "StatCache.h"
+
+#include <system_error>
+
+namespace utils
+{
+
+    namespace fs = std::filesystem;
+
+    namespace
+    {
+        thread_local StatCache *currentCache = nullptr;
+
+        using NativeString = fs::path::string_type;
+
+        NativeString Fold(NativeString text)
+        {
+#ifdef _WIN32
+            for (auto &c : text)
+            {
+                if (c >= L'A' && c <= L'Z')
+                    c = static_cast<wchar_t>(c - L'A' + L'a');
+            }
+#endif
+            return text;
+        }
+
+        // Probes a listing cannot answer: non-ASCII names (folding is ASCII-only)
+        // and 8.3 short names, which directory listings do not return.
+        bool NeedsDirectProbe(const NativeString &name)
+        {
+#ifdef _WIN32
+            for (auto c : name)
+            {
+                if (c > 0x7F || c == L'~')
+                    return true;
+            }
+#else
+            (void)name;
+#endif
+            return false;
+        }
+
+        bool IsPlainAbsolute(const fs::path &path)
+        {
+            if (!path.is_absolute() || !path.has_filename() || !path.has_parent_path())
+                return false;
+            for (const fs::path &part : path.relative_path())
+            {
+                if (part == "." || part == "..")
+                    return false;
+            }
+            return true;
+        }
+
+        bool ProbeDirect(const fs::path &path)
+        {
+            std::error_code ec;
+            return fs::exists(path, ec) && !ec;
+        }
+    } // namespace
+
+    StatCache::Scope::Scope(StatCache &cache) : previous_(currentCache)
+    {
+        currentCache = &cache;
+    }
+
+    StatCache::Scope::~Scope()
+    {
+        currentCache = previous_;
+    }
+
+    StatCache *StatCache::Current()
+    {
+        return currentCache;
+    }
+
+    bool StatCache::Exists(const fs::path &path)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++stats_.probes;
+        const NativeString name = path.filename().native();
+        if (!IsPlainAbsolute(path) || NeedsDirectProbe(name))
+        {
+            ++stats_.direct;
+            lock.unlock();
+            return ProbeDirect(path);
+        }
+
+        const Listing &listing = ListLocked(path.parent_path());
+        if (!listing.readable)
+        {
+            ++stats_.direct;
+            lock.unlock();
+            return ProbeDirect(path);
+        }
+        return listing.names.count(Fold(name)) != 0;
+    }
+
+    std::optional<fs::path> StatCache::WeaklyCanonical(const fs::path &path)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = canonical_.find(path.native());
+            if (it != canonical_.end())
+            {
+                ++stats_.canonicalHits;
+                return it->second;
+            }
+            ++stats_.canonicalMisses;
+        }
+
+        // Files share their folder's canonical form; resolve each folder once. A
+        // symlink as the last component is taken as-is.
+        std::optional<fs::path> result;
+        if (IsPlainAbsolute(path))
+        {
+            std::optional<fs::path> parent = CanonicalDirectory(path.parent_path());
+            if (parent)
+                result = *parent / path.filename();
+        }
+        else
+        {
+            result = CanonicalDirectory(path);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        canonical_.emplace(path.native(), result);
+        return result;
+    }
+
+    std::optional<fs::path> StatCache::CanonicalDirectory(const fs::path &directory)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = directories_.find(directory.native());
+            if (it != directories_.end())
+                return it->second;
+        }
+
+        std::error_code ec;
+        fs::path canonical = fs::weakly_canonical(directory, ec);
+        std::optional<fs::path> result;
+        if (!ec)
+            result = std::move(canonical);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        directories_.emplace(directory.native(), result);
+        return result;
+    }
+
+    StatCache::Stats StatCache::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    const StatCache::Listing &StatCache::ListLocked(const fs::path &directory)
+    {
+        NativeString key = Fold(directory.native());
+        auto it = listings_.find(key);
+        if (it != listings_.end())
+            return it->second;
+
+        ++stats_.listings;
+        Listing listing;
+        std::error_code ec;
+        fs::directory_iterator entries(directory, fs::directory_options::skip_permission_denied, ec);
+        if (!ec)
+        {
+            listing.readable = true;
+            for (fs::directory_iterator end; entries != end; entries.increment(ec))
+            {
+                if (ec)
+                {
+                    listing.readable = false;
+                    break;
+                }
+                listing.names.insert(Fold(entries->path().filename().native()));
+            }
+        }
+        else if (ec == std::errc::no_such_file_or_directory)
+        {
+            // A missing directory answers every probe below it: nothing exists.
+            listing.readable = true;
+        }
+        return listings_.emplace(std::move(key), std::move(listing)).first->second;
+    }
+
+} // namespace utils
@@ -0,0 +1,88 @@
+#ifndef STAT_CACHE_H
+#define STAT_CACHE_H
+
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace utils
+{
+
+    /**
+     * @brief Answers existence probes from one listing per directory and memoizes canonicalization.
+     *
+     * @details A scan probes hundreds of targets and icon paths, most of them in a
+     *          handful of folders (System32, Program Files\Vendor\App, ...). The first
+     *          probe into a directory lists it once; every later probe into the same
+     *          directory is a set lookup. Canonicalization is likewise done once per
+     *          directory.
+     *
+     *          Meant to live for one scan: it does not notice files created or
+     *          removed after their directory was listed. Names compare
+     *          case-insensitively on Windows. Thread-safe.
+     *
+     *          While a Scope is alive, utils::DoesPathExist() and utils::NormalizePath()
+     *          on that thread go through the cache.
+     */
+    class StatCache
+    {
+    public:
+        struct Stats
+        {
+            size_t probes = 0;
+            size_t listings = 0;      // Directories enumerated
+            size_t direct = 0;        // Probes a listing could not answer, sent to the file system
+            size_t canonicalHits = 0; // Canonicalizations answered from the memo
+            size_t canonicalMisses = 0;
+        };
+
+        // Installs |cache| for the calling thread until destroyed; nests.
+        class Scope
+        {
+        public:
+            explicit Scope(StatCache &cache);
+            ~Scope();
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+
+        private:
+            StatCache *previous_;
+        };
+
+        // The cache installed on this thread, or nullptr.
+        static StatCache *Current();
+
+        // True if |path| names an existing file or directory. Relative paths and
+        // paths with "." / ".." parts bypass the listing and are probed directly.
+        bool Exists(const std::filesystem::path &path);
+
+        // fs::weakly_canonical, memoized per directory: a file's result is its
+        // folder's canonical form plus its name. nullopt if it fails.
+        std::optional<std::filesystem::path> WeaklyCanonical(const std::filesystem::path &path);
+
+        Stats GetStats() const;
+
+    private:
+        struct Listing
+        {
+            bool readable = false;
+            std::unordered_set<std::filesystem::path::string_type> names; // Folded on Windows
+        };
+
+        const Listing &ListLocked(const std::filesystem::path &directory);
+        // fs::weakly_canonical of a whole path, memoized.
+        std::optional<std::filesystem::path> CanonicalDirectory(const std::filesystem::path &directory);
+
+        mutable std::mutex mutex_;
+        std::unordered_map<std::filesystem::path::string_type, Listing> listings_;
+        std::unordered_map<std::filesystem::path::string_type, std::optional<std::filesystem::path>> canonical_;
+        std::unordered_map<std::filesystem::path::string_type, std::optional<std::filesystem::path>> directories_;
+        Stats stats_;
+    };
+
+} // namespace utils
+
+#endif // STAT_CACHE_H
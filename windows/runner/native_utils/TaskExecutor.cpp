@@ -0,0 +1,315 @@
+#include "TaskExecutor.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <objbase.h>
+#endif
+
+namespace utils
+{
+
+    struct TaskExecutor::Worker
+    {
+        std::mutex mutex; // Guards queues; the owner and thieves both take it
+        std::deque<Task> queues[kPriorities];
+        // Tasks run in a row while less urgent work waited. Owner thread only.
+        size_t streak = 0;
+    };
+
+    namespace
+    {
+        // The executor and worker index of the current thread, if it is a worker.
+        thread_local const TaskExecutor *currentExecutor = nullptr;
+        thread_local size_t currentWorker = 0;
+
+#ifdef _WIN32
+        thread_local HRESULT workerCom = E_FAIL;
+#endif
+
+        size_t DefaultThreadCount()
+        {
+            return std::max<size_t>(std::thread::hardware_concurrency(), 2);
+        }
+
+        // Workers in a single-threaded COM apartment on Windows.
+        TaskExecutor *MakeComExecutor(size_t threads)
+        {
+            TaskExecutor::Options options;
+            options.threads = threads;
+#ifdef _WIN32
+            options.threadStart = []() {
+                workerCom = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
+            };
+            options.threadExit = []() {
+                if (SUCCEEDED(workerCom))
+                    CoUninitialize();
+            };
+#endif
+            return new TaskExecutor(std::move(options));
+        }
+    } // namespace
+
+    TaskExecutor::TaskExecutor() : TaskExecutor(Options()) {}
+
+    TaskExecutor::TaskExecutor(Options options) : options_(std::move(options))
+    {
+        for (size_t p = 0; p < kPriorities; ++p)
+        {
+            queued_[p] = 0;
+            executed_[p] = 0;
+        }
+        const size_t count = options_.threads != 0 ? options_.threads : DefaultThreadCount();
+        for (size_t i = 0; i < count; ++i)
+            workers_.push_back(std::make_unique<Worker>());
+        // Only start threads once every worker exists, since they steal from each other.
+        for (size_t i = 0; i < count; ++i)
+            threads_.emplace_back([this, i]() { WorkerLoop(i); });
+        timerThread_ = std::thread([this]() { TimerLoop(); });
+    }
+
+    TaskExecutor::~TaskExecutor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(timerMutex_);
+            timerStop_ = true;
+        }
+        timerCv_.notify_all();
+        timerThread_.join();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (std::thread &thread : threads_)
+            thread.join();
+    }
+
+    bool TaskExecutor::OnWorker() const
+    {
+        return currentExecutor == this;
+    }
+
+    void TaskExecutor::Post(TaskPriority priority, Task task)
+    {
+        const size_t p = static_cast<size_t>(priority);
+        // Counted before it is visible, so a worker that sees an empty count
+        // can sleep without missing it.
+        queued_[p].fetch_add(1);
+        if (OnWorker())
+        {
+            Worker &worker = *workers_[currentWorker];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.queues[p].push_back(std::move(task));
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            injected_[p].push_back(std::move(task));
+        }
+        Wake();
+    }
+
+    void TaskExecutor::PostAfter(std::chrono::milliseconds delay, TaskPriority priority, Task task)
+    {
+        if (delay <= std::chrono::milliseconds::zero())
+        {
+            Post(priority, std::move(task));
+            return;
+        }
+        const auto due = std::chrono::steady_clock::now() + delay;
+        {
+            std::lock_guard<std::mutex> lock(timerMutex_);
+            timers_.emplace(due, std::make_pair(priority, std::move(task)));
+        }
+        timerCv_.notify_one();
+    }
+
+    void TaskExecutor::Wake()
+    {
+        // Pairs with the idle_ increment in WorkerLoop: either the sleeper sees
+        // the new count or this sees the sleeper.
+        if (idle_.load() == 0)
+            return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        cv_.notify_one();
+    }
+
+    bool TaskExecutor::Pending() const
+    {
+        for (size_t p = 0; p < kPriorities; ++p)
+        {
+            if (queued_[p].load() != 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool TaskExecutor::TakeAt(size_t index, size_t priority, Task &task)
+    {
+        // Own deque, newest first: its captures are most likely still in cache.
+        {
+            Worker &own = *workers_[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            std::deque<Task> &queue = own.queues[priority];
+            if (!queue.empty())
+            {
+                task = std::move(queue.back());
+                queue.pop_back();
+                return true;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::deque<Task> &queue = injected_[priority];
+            if (!queue.empty())
+            {
+                task = std::move(queue.front());
+                queue.pop_front();
+                return true;
+            }
+        }
+        // Steal the oldest task, starting with the next worker so thieves spread out.
+        for (size_t k = 1; k < workers_.size(); ++k)
+        {
+            Worker &victim = *workers_[(index + k) % workers_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            std::deque<Task> &queue = victim.queues[priority];
+            if (!queue.empty())
+            {
+                task = std::move(queue.front());
+                queue.pop_front();
+                stolen_.fetch_add(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool TaskExecutor::Take(size_t index, Task &task)
+    {
+        Worker &worker = *workers_[index];
+        const auto taken = [this](size_t p) {
+            queued_[p].fetch_sub(1);
+            executed_[p].fetch_add(1);
+        };
+
+        if (worker.streak >= options_.starvationLimit)
+        {
+            for (size_t p = kPriorities; p-- > 1;)
+            {
+                if (queued_[p].load() != 0 && TakeAt(index, p, task))
+                {
+                    taken(p);
+                    worker.streak = 0;
+                    for (size_t q = 0; q < p; ++q)
+                    {
+                        if (queued_[q].load() != 0)
+                        {
+                            aged_.fetch_add(1);
+                            break;
+                        }
+                    }
+                    return true;
+                }
+            }
+            worker.streak = 0;
+        }
+
+        for (size_t p = 0; p < kPriorities; ++p)
+        {
+            if (queued_[p].load() == 0 || !TakeAt(index, p, task))
+                continue;
+            taken(p);
+            bool lessUrgentWaiting = false;
+            for (size_t q = p + 1; q < kPriorities; ++q)
+                lessUrgentWaiting = lessUrgentWaiting || queued_[q].load() != 0;
+            worker.streak = lessUrgentWaiting ? worker.streak + 1 : 0;
+            return true;
+        }
+        return false;
+    }
+
+    void TaskExecutor::WorkerLoop(size_t index)
+    {
+        currentExecutor = this;
+        currentWorker = index;
+        if (options_.threadStart)
+            options_.threadStart();
+        Task task;
+        while (!stop_.load())
+        {
+            if (Take(index, task))
+            {
+                // A throwing task must not take the worker, and every task
+                // queued behind it, down with it.
+                try
+                {
+                    task();
+                }
+                catch (...)
+                {
+                    failed_.fetch_add(1);
+                }
+                // Captures go now, not when the next task replaces them.
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            idle_.fetch_add(1);
+            cv_.wait(lock, [this]() { return stop_.load() || Pending(); });
+            idle_.fetch_sub(1);
+        }
+        if (options_.threadExit)
+            options_.threadExit();
+        currentExecutor = nullptr;
+    }
+
+    void TaskExecutor::TimerLoop()
+    {
+        std::unique_lock<std::mutex> lock(timerMutex_);
+        while (!timerStop_)
+        {
+            if (timers_.empty())
+            {
+                timerCv_.wait(lock);
+                continue;
+            }
+            auto first = timers_.begin();
+            if (first->first > std::chrono::steady_clock::now())
+            {
+                timerCv_.wait_until(lock, first->first);
+                continue;
+            }
+            std::pair<TaskPriority, Task> entry = std::move(first->second);
+            timers_.erase(first);
+            lock.unlock();
+            Post(entry.first, std::move(entry.second));
+            lock.lock();
+        }
+    }
+
+    TaskExecutor::Stats TaskExecutor::GetStats() const
+    {
+        Stats stats;
+        for (size_t p = 0; p < kPriorities; ++p)
+            stats.executed[p] = executed_[p].load();
+        stats.stolen = stolen_.load();
+        stats.aged = aged_.load();
+        stats.failed = failed_.load();
+        return stats;
+    }
+
+    TaskExecutor &SharedExecutor()
+    {
+        static TaskExecutor *executor = MakeComExecutor(0);
+        return *executor;
+    }
+
+    TaskExecutor &BlockingExecutor()
+    {
+        static TaskExecutor *executor = MakeComExecutor(kBlockingThreads);
+        return *executor;
+    }
+
+} // namespace utils
@@ -0,0 +1,155 @@
+#ifndef TASK_EXECUTOR_H
+#define TASK_EXECUTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace utils
+{
+
+    // Most urgent first.
+    enum class TaskPriority
+    {
+        Interactive = 0, // Work the current keystroke is waiting for
+        VisibleIcons,    // Icons for rows on screen
+        Refresh,         // Rescans, validation, trimming
+    };
+
+    /**
+     * @brief A work-stealing thread pool shared by the providers, scanners and icon jobs.
+     *
+     * @details Every worker has one deque per priority. A task posted from a worker
+     *          goes to that worker's own deque and is taken back newest-first; tasks
+     *          posted from other threads go to a shared injection queue. An idle
+     *          worker takes, for the most urgent priority that has work, from its own
+     *          deque, then the injection queue, then the oldest end of another
+     *          worker's deque.
+     *
+     *          Priorities are strict with one exception: a worker that has run
+     *          |starvationLimit| tasks in a row while less urgent work waited runs
+     *          one of those next, so a steady stream of queries cannot stall a
+     *          refresh indefinitely.
+     *
+     *          |threadStart| and |threadExit| run on every worker around its tasks,
+     *          e.g. to enter a COM apartment. Tasks must not block on a future of
+     *          the same executor; chain work by posting from the task instead.
+     *
+     *          Tasks still queued, or delayed, when the executor is destroyed are
+     *          dropped; the destructor waits only for running ones. Thread-safe.
+     */
+    class TaskExecutor
+    {
+    public:
+        using Task = std::function<void()>;
+
+        struct Options
+        {
+            // 0 picks the number of hardware threads, at least 2.
+            size_t threads = 0;
+            size_t starvationLimit = 32;
+            std::function<void()> threadStart;
+            std::function<void()> threadExit;
+        };
+
+        struct Stats
+        {
+            size_t executed[3] = {}; // Indexed by TaskPriority
+            size_t stolen = 0;       // Taken from another worker's deque
+            size_t aged = 0;         // Run ahead of more urgent work by the starvation rule
+            size_t failed = 0;       // Ended with an exception, which went no further
+        };
+
+        TaskExecutor();
+        explicit TaskExecutor(Options options);
+        ~TaskExecutor();
+
+        TaskExecutor(const TaskExecutor &) = delete;
+        TaskExecutor &operator=(const TaskExecutor &) = delete;
+
+        void Post(TaskPriority priority, Task task);
+
+        // Queues |task| once |delay| has passed. The delay is not a deadline;
+        // the task still waits its turn after that.
+        void PostAfter(std::chrono::milliseconds delay, TaskPriority priority, Task task);
+
+        // Runs |job| and returns a future for its result.
+        template <typename Job>
+        auto Submit(TaskPriority priority, Job job) -> std::future<std::invoke_result_t<Job &>>
+        {
+            using Result = std::invoke_result_t<Job &>;
+            // Shared, because Task must be copyable and packaged_task is not.
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::move(job));
+            std::future<Result> result = task->get_future();
+            Post(priority, [task] { (*task)(); });
+            return result;
+        }
+
+        size_t ThreadCount() const { return workers_.size(); }
+        // True on one of this executor's workers.
+        bool OnWorker() const;
+        Stats GetStats() const;
+
+    private:
+        static constexpr size_t kPriorities = 3;
+
+        struct Worker;
+
+        void WorkerLoop(size_t index);
+        void TimerLoop();
+        bool Take(size_t index, Task &task);
+        bool TakeAt(size_t index, size_t priority, Task &task);
+        bool Pending() const;
+        void Wake();
+
+        const Options options_;
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::vector<std::thread> threads_;
+
+        std::mutex mutex_; // Guards injected_ and idle sleeping
+        std::condition_variable cv_;
+        std::deque<Task> injected_[kPriorities]; // Posted from outside the pool
+        std::atomic<bool> stop_{false};
+        std::atomic<size_t> queued_[kPriorities];
+        std::atomic<size_t> idle_{0};
+
+        std::mutex timerMutex_;
+        std::condition_variable timerCv_;
+        std::multimap<std::chrono::steady_clock::time_point, std::pair<TaskPriority, Task>> timers_;
+        bool timerStop_ = false;
+        std::thread timerThread_;
+
+        std::atomic<size_t> executed_[kPriorities];
+        std::atomic<size_t> stolen_{0};
+        std::atomic<size_t> aged_{0};
+        std::atomic<size_t> failed_{0};
+    };
+
+    // The process-wide executor. On Windows its workers live in a single-threaded
+    // COM apartment, as the shell and index APIs used by the scanners expect.
+    // Never destroyed, so tasks may still be running at exit.
+    TaskExecutor &SharedExecutor();
+
+    constexpr size_t kBlockingThreads = 4;
+
+    // For calls that mostly wait on something outside the process: a full
+    // scan, an index query, a helper process. A separate pool of
+    // |kBlockingThreads| workers, set up like SharedExecutor()'s, so such calls
+    // never hold the workers keystrokes are answered on; callers bound how many
+    // they start (ConcurrencyLimiter). Never destroyed.
+    TaskExecutor &BlockingExecutor();
+
+} // namespace utils
+
+#endif // TASK_EXECUTOR_H
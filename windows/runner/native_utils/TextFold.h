@@ -0,0 +1,71 @@
+#ifndef TEXT_FOLD_H
+#define TEXT_FOLD_H
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+namespace utils
+{
+
+    // ASCII-only case folding. Program names and paths are UTF-8; multi-byte
+    // sequences pass through unchanged, which matches how the Dart side's
+    // toLowerCase() treats the overwhelmingly ASCII catalog closely enough.
+    inline char FoldAscii(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    inline std::string FoldCase(std::string_view text)
+    {
+        std::string folded(text);
+        for (char &c : folded)
+            c = FoldAscii(c);
+        return folded;
+    }
+
+    // FoldCase() into a string allocated from |resource|, e.g. a query arena.
+    inline std::pmr::string FoldCase(std::string_view text, std::pmr::memory_resource *resource)
+    {
+        std::pmr::string folded(text, resource);
+        for (char &c : folded)
+            c = FoldAscii(c);
+        return folded;
+    }
+
+    // True if |haystack| contains |foldedNeedle| ignoring ASCII case.
+    // |foldedNeedle| must already be folded with FoldCase().
+    inline bool ContainsFolded(std::string_view haystack, std::string_view foldedNeedle)
+    {
+        if (foldedNeedle.empty())
+            return true;
+        if (foldedNeedle.size() > haystack.size())
+            return false;
+        const size_t last = haystack.size() - foldedNeedle.size();
+        for (size_t i = 0; i <= last; ++i)
+        {
+            size_t j = 0;
+            while (j < foldedNeedle.size() && FoldAscii(haystack[i + j]) == foldedNeedle[j])
+                ++j;
+            if (j == foldedNeedle.size())
+                return true;
+        }
+        return false;
+    }
+
+    // True if |text| begins with |foldedPrefix| ignoring ASCII case.
+    inline bool StartsWithFolded(std::string_view text, std::string_view foldedPrefix)
+    {
+        if (foldedPrefix.size() > text.size())
+            return false;
+        for (size_t i = 0; i < foldedPrefix.size(); ++i)
+        {
+            if (FoldAscii(text[i]) != foldedPrefix[i])
+                return false;
+        }
+        return true;
+    }
+
+} // namespace utils
+
+#endif // TEXT_FOLD_H
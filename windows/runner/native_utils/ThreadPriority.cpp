@@ -0,0 +1,55 @@
+#include "ThreadPriority.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace utils
+{
+
+#ifdef _WIN32
+
+    bool EnterBackgroundMode()
+    {
+        return SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN) != 0;
+    }
+
+#elif defined(__linux__)
+
+    namespace
+    {
+        // From linux/ioprio.h, which glibc does not wrap.
+        constexpr int kIoprioWhoProcess = 1;
+        constexpr int kIoprioClassIdle = 3;
+        constexpr int kIoprioClassShift = 13;
+    } // namespace
+
+    bool EnterBackgroundMode()
+    {
+        // All three act on the calling thread only: Linux schedules threads as tasks.
+        const pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+        sched_param param{};
+        param.sched_priority = 0;
+        const bool idle = sched_setscheduler(0, SCHED_IDLE, &param) == 0;
+        setpriority(PRIO_PROCESS, static_cast<id_t>(tid), 19);
+        syscall(SYS_ioprio_set, kIoprioWhoProcess, 0, kIoprioClassIdle << kIoprioClassShift);
+        return idle;
+    }
+
+#else
+
+    bool EnterBackgroundMode()
+    {
+        return setpriority(PRIO_PROCESS, 0, 19) == 0;
+    }
+
+#endif
+
+} // namespace utils
@@ -0,0 +1,25 @@
+#ifndef THREAD_PRIORITY_H
+#define THREAD_PRIORITY_H
+
+namespace utils
+{
+
+    /**
+     * @brief Drops the calling thread to background CPU and I/O priority for the rest of its life.
+     *
+     * @details Windows: THREAD_MODE_BACKGROUND_BEGIN, which also lowers I/O and memory
+     *          priority. Linux: SCHED_IDLE, nice 19 and the idle I/O class. Elsewhere
+     *          only the nice value is lowered.
+     *
+     *          Meant for dedicated maintenance threads. A background thread that takes
+     *          a lock the UI also needs can hold it up, so such threads should keep
+     *          their critical sections short.
+     *
+     * @return false if the main lowering step failed; the thread keeps running at
+     *         whatever priority it ended up with.
+     */
+    bool EnterBackgroundMode();
+
+} // namespace utils
+
+#endif // THREAD_PRIORITY_H
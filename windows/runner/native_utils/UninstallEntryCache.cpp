@@ -0,0 +1,211 @@
+#include "UninstallEntryCache.h"
+
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+#include "BinaryIO.h"
+#include "ProgramCodec.h"
+#include "SearchProviders.h"
+
+namespace utils
+{
+
+    namespace fs = std::filesystem;
+
+    namespace
+    {
+        constexpr uint32_t kMagic = 0x43555856; // "VXUC"
+        constexpr uint32_t kVersion = 1;
+
+        std::wstring EntryKey(const UninstallEntryCache::Root &root, const std::wstring &subkey)
+        {
+            std::wstring key(root.label.begin(), root.label.end());
+            key += root.view == RegistryView::Wow32 ? L"|32|" : L"|64|";
+            key += root.path;
+            key += L'\\';
+            key += subkey;
+            return key;
+        }
+    } // namespace
+
+    bool UninstallEntryCache::Load(const fs::path &file)
+    {
+        std::ifstream stream(file, std::ios::binary);
+        std::string data;
+        if (stream)
+            data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+
+        std::unordered_map<std::wstring, Entry> loaded;
+        bool valid = data.size() >= 8;
+        if (valid)
+        {
+            const std::string_view payload(data.data(), data.size() - 8);
+            BinaryReader trailer(std::string_view(data).substr(payload.size()));
+            uint64_t checksum = 0;
+            valid = trailer.U64(checksum) && checksum == Fnv1a64(payload);
+
+            BinaryReader in(payload);
+            uint32_t magic = 0, version = 0, count = 0;
+            valid = valid && in.U32(magic) && in.U32(version) && in.U32(count) && magic == kMagic && version == kVersion;
+            for (uint32_t i = 0; valid && i < count; ++i)
+            {
+                std::wstring key;
+                Entry entry;
+                uint8_t hasProgram = 0;
+                in.WString(key);
+                in.I64(entry.lastWrite);
+                in.U8(hasProgram);
+                if (hasProgram)
+                {
+                    entry.program.emplace();
+                    ReadProgram(in, *entry.program);
+                }
+                valid = in.Ok();
+                if (valid)
+                    loaded[std::move(key)] = std::move(entry);
+            }
+            valid = valid && in.AtEnd();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_ = valid ? std::move(loaded) : std::unordered_map<std::wstring, Entry>();
+        dirty_ = false;
+        return valid;
+    }
+
+    bool UninstallEntryCache::Save(const fs::path &file)
+    {
+        BinaryWriter out;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!dirty_)
+                return true;
+            out.U32(kMagic);
+            out.U32(kVersion);
+            out.U32(static_cast<uint32_t>(entries_.size()));
+            for (const auto &[key, entry] : entries_)
+            {
+                out.WString(key);
+                out.I64(entry.lastWrite);
+                out.U8(entry.program ? 1 : 0);
+                if (entry.program)
+                    WriteProgram(out, *entry.program);
+            }
+            dirty_ = false;
+        }
+        out.U64(Fnv1a64(out.Data()));
+
+        std::error_code ec;
+        fs::create_directories(file.parent_path(), ec);
+        fs::path temp = file;
+        temp += ".tmp";
+        {
+            std::ofstream stream(temp, std::ios::binary | std::ios::trunc);
+            stream.write(out.Data().data(), static_cast<std::streamsize>(out.Data().size()));
+            if (!stream)
+                ec = std::make_error_code(std::errc::io_error);
+        }
+        if (!ec)
+            fs::rename(temp, file, ec);
+        if (ec)
+        {
+            fs::remove(temp, ec);
+            std::lock_guard<std::mutex> lock(mutex_);
+            dirty_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<Program> UninstallEntryCache::Scan(const RegistryReader &reader, const std::vector<Root> &roots, const Parser &parse,
+                                                   const CancellationToken &token)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++scan_;
+        parsed_ = 0;
+        reused_ = 0;
+
+        std::vector<Program> programs;
+        for (const Root &root : roots)
+        {
+            if (token.IsCancelled())
+                break;
+            std::unique_ptr<RegistryKey> rootKey = reader.Open(root.hive, root.path, root.view);
+            if (!rootKey)
+                continue;
+
+            for (const RegistrySubkey &subkey : rootKey->Subkeys())
+            {
+                if (token.IsCancelled())
+                    break;
+                std::wstring key = EntryKey(root, subkey.name);
+                auto it = entries_.find(key);
+                if (it != entries_.end() && it->second.lastWrite == subkey.lastWrite)
+                {
+                    ++reused_;
+                    it->second.scan = scan_;
+                    if (it->second.program)
+                        programs.push_back(SearchEngine::CloneProgram(*it->second.program));
+                    continue;
+                }
+
+                ++parsed_;
+                std::unique_ptr<RegistryKey> appKey = rootKey->OpenSubkey(subkey.name);
+                if (!appKey)
+                    continue; // Not cached: access may be granted later without a write.
+                std::optional<Program> program = parse(*appKey, subkey.name, root.label);
+                if (token.IsCancelled())
+                {
+                    // The parser may have stopped short (e.g. without an icon); use
+                    // the result but do not remember it.
+                    if (program)
+                        programs.push_back(std::move(*program));
+                    break;
+                }
+
+                Entry &entry = entries_[std::move(key)];
+                entry.lastWrite = subkey.lastWrite;
+                entry.scan = scan_;
+                entry.program.reset();
+                if (program)
+                {
+                    entry.program = SearchEngine::CloneProgram(*program);
+                    programs.push_back(std::move(*program));
+                }
+                dirty_ = true;
+            }
+        }
+
+        if (!token.IsCancelled())
+        {
+            for (auto it = entries_.begin(); it != entries_.end();)
+            {
+                if (it->second.scan != scan_)
+                {
+                    it = entries_.erase(it);
+                    dirty_ = true;
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+        return programs;
+    }
+
+    void UninstallEntryCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::unordered_map<std::wstring, Entry>().swap(entries_);
+        dirty_ = false;
+    }
+
+    UninstallEntryCache::Stats UninstallEntryCache::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return {entries_.size(), parsed_, reused_};
+    }
+
+} // namespace utils
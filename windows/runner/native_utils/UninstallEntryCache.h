@@ -0,0 +1,84 @@
+#ifndef UNINSTALL_ENTRY_CACHE_H
+#define UNINSTALL_ENTRY_CACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "Program.h"
+#include "RegistryReader.h"
+
+namespace utils
+{
+
+    /**
+     * @brief Reuses parsed Uninstall registry entries whose subkey has not been written since.
+     *
+     * @details Parsing an Uninstall subkey takes several value queries, a path
+     *          search and an icon extraction, and between two scans almost none of
+     *          them change. Scan() only enumerates the roots: a subkey whose name and
+     *          last-write time match the previous scan is answered from the cache
+     *          (including subkeys that were skipped), and only new or written subkeys
+     *          are opened and handed to the parser.
+     *
+     *          Persisted with the same record format conventions as ShortcutCache.
+     *          Thread-safe.
+     */
+    class UninstallEntryCache
+    {
+    public:
+        struct Root
+        {
+            RegistryHive hive;
+            std::wstring path;
+            RegistryView view;
+            std::string label; // Program::source prefix, e.g. "HKLM"
+        };
+
+        // Builds the entry for one subkey, or nullopt if it is filtered out.
+        using Parser = std::function<std::optional<Program>(const RegistryKey &key, const std::wstring &subkeyName, const std::string &label)>;
+
+        struct Stats
+        {
+            size_t entries = 0;
+            size_t parsed = 0; // Subkeys opened by the last scan
+            size_t reused = 0; // Subkeys answered from the cache by the last scan
+        };
+
+        bool Load(const std::filesystem::path &file);
+        bool Save(const std::filesystem::path &file);
+        // Drops every entry and frees the table; unsaved changes are lost.
+        void Clear();
+
+        // Entries in enumeration order. A cancelled scan returns what it has and
+        // keeps cache entries it did not reach.
+        std::vector<Program> Scan(const RegistryReader &reader, const std::vector<Root> &roots, const Parser &parse,
+                                  const CancellationToken &token = {});
+
+        Stats GetStats() const;
+
+    private:
+        struct Entry
+        {
+            int64_t lastWrite = 0;
+            std::optional<Program> program;
+            uint32_t scan = 0;
+        };
+
+        mutable std::mutex mutex_;
+        std::unordered_map<std::wstring, Entry> entries_; // Keyed by root and subkey name
+        uint32_t scan_ = 0;
+        bool dirty_ = false;
+        size_t parsed_ = 0;
+        size_t reused_ = 0;
+    };
+
+} // namespace utils
+
+#endif // UNINSTALL_ENTRY_CACHE_H
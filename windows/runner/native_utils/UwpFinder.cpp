@@ -1,10 +1,10 @@
 #include "UwpFinder.h"
 #include "common_utils.h" // Include for WideToUtf8, PathToUtf8, Base64Encode etc.
+#include "TaskExecutor.h"
 
 // Define NOMINMAX before including Windows.h to prevent min/max macro definitions
 #define NOMINMAX
 #include <Windows.h>
-#include <thread>
 #include <future>
 #include <ShlObj.h> // For SHLoadIndirectString
 #include <propkey.h> // For PKEYs
@@ -174,33 +174,23 @@ std::vector<utils::Program> GetInstalledUWPPrograms()
 
 
 std::vector<utils::Program> GetUwpProgramsOnStaThread() {
-    // Use std::async to launch the task potentially on a new thread.
-    // The lambda running inside async will execute on that thread.
-    auto future = std::async(std::launch::async, []() {
-        // Initialize COM/WinRT *specifically for this new thread* as STA.
-        // This is crucial.
-        winrt::init_apartment(winrt::apartment_type::single_threaded);
-
-        // Now call the original function. It will run entirely within
-        // this STA thread context. It might call init_apartment again
-        // internally, which is safe (it will likely return S_FALSE).
-        std::vector<utils::Program> programs = GetInstalledUWPPrograms();
-
-        // Uninitialize COM/WinRT for this thread before it exits.
-        winrt::uninit_apartment();
-
-        return programs; // Return the result from the thread
+    // The shared executor's workers are already in a single-threaded apartment.
+    if (utils::SharedExecutor().OnWorker()) {
+        return GetInstalledUWPPrograms();
+    }
+    auto future = utils::SharedExecutor().Submit(utils::TaskPriority::Refresh, []() {
+        return GetInstalledUWPPrograms();
     });
 
     // Wait for the asynchronous operation to complete and return its result.
     // This blocks the *calling* thread (the method channel thread) until
-    // the STA thread finishes its work.
+    // the STA worker finishes its work.
     try {
         return future.get();
     } catch (...) {
-        // Rethrow the exception caught by future.get() if the async task failed
+        // Rethrow the exception caught by future.get() if the task failed
         // Or handle it more gracefully here if needed
          fprintf(stderr, "Exception caught while getting result from STA thread future.\n");
          throw; // Rethrow to be caught by the method channel handler's catch block
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,127 @@
+#include "VxSearchApi.h"
+
+#include <cstdlib>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "QueryArena.h"
+#include "SearchProviders.h"
+#include "ShortQueryIndex.h"
+#include "TextFold.h"
+
+struct vx_catalog
+{
+    std::shared_ptr<const SearchEngine::ProgramCatalog> catalog;
+    std::shared_ptr<SearchEngine::ShortQueryIndex> shortQueries;
+};
+
+struct vx_results
+{
+    // Keeps the generation the views below point into alive.
+    SearchEngine::ProgramCatalog::Snapshot snapshot;
+    std::vector<vx_result> rows;
+};
+
+namespace
+{
+    std::mutex publishedMutex;
+    vx_catalog published;
+
+    vx_str View(const std::string &text)
+    {
+        return {text.data(), static_cast<uint32_t>(text.size())};
+    }
+} // namespace
+
+namespace SearchEngine
+{
+    void PublishFfiCatalog(std::shared_ptr<const ProgramCatalog> catalog, std::shared_ptr<ShortQueryIndex> shortQueries)
+    {
+        std::lock_guard<std::mutex> lock(publishedMutex);
+        published.catalog = std::move(catalog);
+        published.shortQueries = std::move(shortQueries);
+    }
+} // namespace SearchEngine
+
+extern "C"
+{
+    uint32_t vx_abi_version(void)
+    {
+        return VX_ABI_VERSION;
+    }
+
+    vx_catalog *vx_catalog_open(void)
+    {
+        std::lock_guard<std::mutex> lock(publishedMutex);
+        if (!published.catalog)
+            return nullptr;
+        return new (std::nothrow) vx_catalog(published);
+    }
+
+    void vx_catalog_close(vx_catalog *catalog)
+    {
+        delete catalog;
+    }
+
+    uint64_t vx_catalog_generation(vx_catalog *catalog)
+    {
+        return catalog ? catalog->catalog->GenerationNumber() : 0;
+    }
+
+    vx_results *vx_search(vx_catalog *catalog, const char *query, uint32_t query_size, uint32_t max_results)
+    {
+        if (!catalog || (!query && query_size != 0))
+            return nullptr;
+        auto *results = new (std::nothrow) vx_results();
+        if (!results)
+            return nullptr;
+        results->snapshot = catalog->catalog->Current();
+
+        utils::QueryArena::Scope scope;
+        std::pmr::memory_resource *arena = utils::QueryArena::Current();
+        const std::pmr::string foldedQuery = utils::FoldCase(std::string_view(query, query_size), arena);
+        std::pmr::vector<size_t> indices(arena);
+        SearchEngine::MatchCatalog(results->snapshot, foldedQuery, catalog->shortQueries.get(), utils::CancellationToken(),
+                                   max_results, indices);
+
+        results->rows.reserve(indices.size());
+        for (size_t index : indices)
+        {
+            const utils::Program &program = (*results->snapshot)[index];
+            results->rows.push_back({View(program.name), View(program.executablePath), View(program.arguments),
+                                     View(program.kind), View(program.description), View(program.iconDataBase64),
+                                     program.id});
+        }
+        return results;
+    }
+
+    uint32_t vx_result_count(const vx_results *results)
+    {
+        return results ? static_cast<uint32_t>(results->rows.size()) : 0;
+    }
+
+    const vx_result *vx_result_at(const vx_results *results, uint32_t index)
+    {
+        if (!results || index >= results->rows.size())
+            return nullptr;
+        return &results->rows[index];
+    }
+
+    void vx_results_free(vx_results *results)
+    {
+        delete results;
+    }
+
+    void *vx_alloc(uint32_t size)
+    {
+        return std::malloc(size);
+    }
+
+    void vx_free(void *p)
+    {
+        std::free(p);
+    }
+} // extern "C"
@@ -0,0 +1,88 @@
+#ifndef VX_SEARCH_API_H
+#define VX_SEARCH_API_H
+
+// C ABI over the native program catalog, for dart:ffi and other in-process
+// callers. Plain C types only; structs are append-only and VX_ABI_VERSION
+// goes up whenever one grows or an export goes away, so callers can check
+// what they link against.
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define VX_API __declspec(dllexport)
+#else
+#define VX_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Version 4 removed the catalog image exports (vx_image_*) of version 2.
+#define VX_ABI_VERSION 4
+
+    typedef struct vx_catalog vx_catalog;
+    typedef struct vx_results vx_results;
+
+    // UTF-8, not NUL-terminated.
+    typedef struct vx_str
+    {
+        const char *data;
+        uint32_t size;
+    } vx_str;
+
+    typedef struct vx_result
+    {
+        vx_str name;
+        vx_str path;
+        vx_str args;
+        vx_str kind;
+        vx_str description;
+        vx_str icon; // Base64 PNG, empty if none
+        uint64_t id; // utils::EntryId() (EntryId.h); since version 3
+    } vx_result;
+
+    VX_API uint32_t vx_abi_version(void);
+
+    // Attaches to the catalog the host process published, or returns NULL if it
+    // has not published one yet. Each handle must be closed.
+    VX_API vx_catalog *vx_catalog_open(void);
+    VX_API void vx_catalog_close(vx_catalog *catalog);
+
+    // Number of the catalog generation the next search will see.
+    VX_API uint64_t vx_catalog_generation(vx_catalog *catalog);
+
+    // Entries whose name or path contains |query| (|query_size| bytes of UTF-8),
+    // ignoring ASCII case, like the catalog search provider, best first in
+    // SearchResultSorter's order (ResultRank.h). At most |max_results|, the best
+    // of all matches; 0 for no limit. Never NULL for a valid catalog.
+    VX_API vx_results *vx_search(vx_catalog *catalog, const char *query, uint32_t query_size, uint32_t max_results);
+
+    VX_API uint32_t vx_result_count(const vx_results *results);
+    // Valid until vx_results_free(), even if the catalog is republished
+    // meanwhile. NULL if |index| is out of range.
+    VX_API const vx_result *vx_result_at(const vx_results *results, uint32_t index);
+    VX_API void vx_results_free(vx_results *results);
+
+    // Heap memory for arguments, e.g. the query, from callers without an allocator.
+    VX_API void *vx_alloc(uint32_t size);
+    VX_API void vx_free(void *p);
+
+#ifdef __cplusplus
+} // extern "C"
+
+#include <memory>
+
+namespace SearchEngine
+{
+    class ProgramCatalog;
+    class ShortQueryIndex;
+
+    // Makes |catalog| what vx_catalog_open() attaches to; nullptr withdraws it.
+    // Open handles keep the catalog they attached to.
+    void PublishFfiCatalog(std::shared_ptr<const ProgramCatalog> catalog, std::shared_ptr<ShortQueryIndex> shortQueries);
+} // namespace SearchEngine
+#endif
+
+#endif // VX_SEARCH_API_H
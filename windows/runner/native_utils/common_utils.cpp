@@ -1,5 +1,6 @@
 #define NOMINMAX
 #include "common_utils.h"
+#include "StatCache.h"
 #include <windows.h>
 #include <shlwapi.h>    // Path functions, _wcsicmp, PathParseIconLocationW, SearchPathW, PathFindExtension
 #include <shlobj.h>     // SHGetKnownFolderPath, FOLDERID_ constants
@@ -20,6 +21,7 @@
 #include <comdef.h>     // For COM error handling
 #include <algorithm>    // For std::sort
 #include <filesystem>   // Required for fs::path operations in deduplication
+#include <psapi.h>      // GetProcessMemoryInfo
 
 
 #pragma comment(lib, "Ole32.lib")
@@ -70,7 +72,7 @@ std::wstring Utf8ToWide(const std::string &utf8Str) { if (utf8Str.empty()) retur
 // --- Filesystem Path Conversion & Normalization ---
 std::string PathToUtf8(const fs::path& p) { return WideToUtf8(p.wstring()); }
 fs::path Utf8ToPath(const std::string& utf8Str) { return fs::path(Utf8ToWide(utf8Str)); }
-std::string NormalizePath(const std::string &path_utf8) { if (path_utf8.empty()) return ""; std::wstring wide_path = Utf8ToWide(path_utf8); if (wide_path.empty() && !path_utf8.empty()) { /*Debug*/ return path_utf8; } try { fs::path p(wide_path); fs::path canonical_p = fs::weakly_canonical(p); std::string utf8_canonical_path = WideToUtf8(canonical_p.wstring()); if (utf8_canonical_path.empty() && !canonical_p.empty()) { /*Debug*/ return path_utf8; } return utf8_canonical_path; } catch (const fs::filesystem_error& [[maybe_unused]] e) { /*Debug*/ return path_utf8; } catch (...) { /*Debug*/ return path_utf8; } }
+std::string NormalizePath(const std::string &path_utf8) { if (path_utf8.empty()) return ""; std::wstring wide_path = Utf8ToWide(path_utf8); if (wide_path.empty() && !path_utf8.empty()) { /*Debug*/ return path_utf8; } try { fs::path p(wide_path); fs::path canonical_p; if (StatCache *cache = StatCache::Current()) { std::optional<fs::path> memo = cache->WeaklyCanonical(p); if (!memo) return path_utf8; canonical_p = std::move(*memo); } else { canonical_p = fs::weakly_canonical(p); } std::string utf8_canonical_path = WideToUtf8(canonical_p.wstring()); if (utf8_canonical_path.empty() && !canonical_p.empty()) { /*Debug*/ return path_utf8; } return utf8_canonical_path; } catch (const fs::filesystem_error& [[maybe_unused]] e) { /*Debug*/ return path_utf8; } catch (...) { /*Debug*/ return path_utf8; } }
 
 // --- Base64 Encoding Helper ---
 std::string Base64Encode(const std::vector<uint8_t>& data) { if (data.empty()) return ""; if (data.size() > std::numeric_limits<DWORD>::max()) { /*Err*/ return ""; } DWORD dataSizeDWORD = static_cast<DWORD>(data.size()); DWORD base64StringSize = 0; if (!CryptBinaryToStringA(data.data(), dataSizeDWORD, CRYPT_STRING_BASE64 | CRYPT_STRING_NOCRLF, nullptr, &base64StringSize)) { /*Err*/ return ""; } if (base64StringSize <= 1) { return ""; } std::string base64String; base64String.resize(base64StringSize - 1); DWORD actualSize = base64StringSize; if (!CryptBinaryToStringA(data.data(), dataSizeDWORD, CRYPT_STRING_BASE64 | CRYPT_STRING_NOCRLF, &base64String[0], &actualSize)) { /*Err*/ return ""; } return base64String; }
@@ -79,12 +81,17 @@ std::string Base64Encode(const std::vector<uint8_t>& data) { if (data.empty()) r
 int GetEncoderClsid(const WCHAR* format, CLSID* pClsid) { UINT num = 0, size = 0; GetImageEncodersSize(&num, &size); if (size == 0) return -1; std::unique_ptr<ImageCodecInfo, decltype(&free)> pICI((ImageCodecInfo*)(malloc(size)), free); if (!pICI) return -1; GetImageEncoders(num, size, pICI.get()); for (UINT j = 0; j < num; ++j) { if (wcscmp(pICI.get()[j].MimeType, format) == 0) { *pClsid = pICI.get()[j].Clsid; return static_cast<int>(j); } } return -1; }
 
 // --- Icon Extraction and Encoding ---
-std::optional<std::string> ExtractAndEncodeIconAsBase64(const std::string &iconPathUtf8, int iconIndex); // Definition unchanged below
+std::optional<std::string> ExtractAndEncodeIconAsBase64(const std::string &iconPathUtf8, int iconIndex, const CancellationToken &token); // Definition unchanged below
 
 // --- Filesystem Path Existence Checks ---
 // Use a more permissive check - just needs to exist, not necessarily be a regular file
 bool DoesPathExist(const std::wstring& pathW) {
     if (pathW.empty()) return false;
+    // During a scan: memoized canonicalization, existence from one listing per directory.
+    if (StatCache *cache = StatCache::Current()) {
+        std::optional<fs::path> canonical = cache->WeaklyCanonical(fs::path(pathW));
+        return cache->Exists(canonical ? *canonical : fs::path(pathW));
+    }
     std::error_code ec;
     try {
          // Use weakly_canonical to resolve symlinks etc. before checking existence
@@ -110,12 +117,43 @@ bool DoesPathExist(const std::wstring& pathW) {
     }
 }
 
+// --- Local App Data ---
+fs::path GetLocalDataDirectory() {
+    PWSTR folderRaw = nullptr;
+    HRESULT hr = SHGetKnownFolderPath(FOLDERID_LocalAppData, KF_FLAG_DEFAULT, NULL, &folderRaw);
+    CoTaskMemUniquePtr<WCHAR> folder(folderRaw);
+    if (FAILED(hr) || !folder || folder.get()[0] == L'\0') return {};
+    fs::path directory = fs::path(folder.get()) / L"vxkonsol";
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    return directory;
+}
 
+MemoryTrim TrimProcessMemory() {
+    MemoryTrim trim;
+    HANDLE process = GetCurrentProcess();
+    PROCESS_MEMORY_COUNTERS counters = {};
+    counters.cb = sizeof(counters);
+    if (GetProcessMemoryInfo(process, &counters, sizeof(counters)))
+        trim.workingSetBefore = counters.WorkingSetSize;
+
+    // Coalesce free blocks so the heap can decommit them, then page out whatever
+    // is not locked; it faults back in on the next show.
+    HeapCompact(GetProcessHeap(), 0);
+    SetProcessWorkingSetSize(process, static_cast<SIZE_T>(-1), static_cast<SIZE_T>(-1));
+
+    if (GetProcessMemoryInfo(process, &counters, sizeof(counters)))
+        trim.workingSetAfter = counters.WorkingSetSize;
+    return trim;
+}
 
 
 
 
-std::optional<utils::ShortcutInfo> ResolveShortcut(const fs::path &linkPathFs) {
+
+
+std::optional<utils::ShortcutInfo> ResolveShortcut(const fs::path &linkPathFs, const CancellationToken &token) {
+    if (token.IsCancelled()) return std::nullopt;
     HRESULT hr;
     ComUniquePtr<IShellLinkW> psl;
     ComUniquePtr<IPersistFile> ppf;
@@ -379,8 +417,12 @@ std::optional<utils::ShortcutInfo> ResolveShortcut(const fs::path &linkPathFs) {
     // --- Extract Icon Data (Optional, kept as is) ---
     // This might fail more often for UWP apps if the icon path is an AUMID or resource path
     // that ExtractAndEncodeIconAsBase64 doesn't handle directly.
+    if (token.IsCancelled()) {
+        DebugOutput(L"LNK INFO V5: Cancelled before icon extraction for '%ls'.", linkPathW.c_str());
+        return std::nullopt;
+    }
     if (!info.iconPathUtf8.empty() && info.iconIndex >= 0) {
-        auto encodedIconOpt = utils::ExtractAndEncodeIconAsBase64(info.iconPathUtf8, info.iconIndex);
+        auto encodedIconOpt = utils::ExtractAndEncodeIconAsBase64(info.iconPathUtf8, info.iconIndex, token);
         if (encodedIconOpt) {
             info.iconDataBase64 = std::move(*encodedIconOpt);
             // Debug output for success is inside ExtractAndEncodeIconAsBase64
@@ -538,11 +580,14 @@ std::vector<Program> DeduplicatePrograms(std::vector<Program> &allPrograms) {
 }
 
 
-std::optional<std::string> ExtractAndEncodeIconAsBase64(const std::string& iconPathUtf8, int iconIndex) {
+std::optional<std::string> ExtractAndEncodeIconAsBase64(const std::string& iconPathUtf8, int iconIndex, const CancellationToken& token) {
     // Ensure GDI+ is initialized for this scope/thread if not done globally
     // static GdiplusInitializer gdiplusInit; // Use static if called repeatedly, or instance if one-off
 
     // --- Input Validation ---
+    if (token.IsCancelled()) {
+        return std::nullopt;
+    }
     if (iconPathUtf8.empty() || iconIndex < 0) {
         DebugOutput(L"Icon Extract Fail: Invalid input path or index.");
         return std::nullopt;
@@ -631,6 +676,11 @@ std::optional<std::string> ExtractAndEncodeIconAsBase64(const std::string& iconP
     HIconUniquePtr hIcon(hIconRaw);
     hIconRaw = nullptr; // Prevent any accidental use/deletion of the raw handle
 
+    // The PNG encode below is the expensive half; skip it for abandoned queries.
+    if (token.IsCancelled()) {
+        return std::nullopt;
+    }
+
     // --- GDI+ Conversion to PNG ---
     std::vector<uint8_t> pngData;
     // GDI+ operations can throw exceptions or return error statuses.
@@ -0,0 +1,140 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "QueryArena.h"
+#include "SearchProviders.h"
+
+// Every heap allocation of the bench binary goes through here and is counted.
+namespace
+{
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> allocatedBytes{0};
+} // namespace
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double Percentile(std::vector<double> values, double p)
+    {
+        std::sort(values.begin(), values.end());
+        return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+    }
+
+    std::vector<utils::Program> ScannedPrograms(size_t count)
+    {
+        static const char *const kWords[] = {"Visual", "Studio", "Code", "Office", "Word", "Excel", "Paint",
+                                             "Terminal", "Steam", "Player", "Editor", "Manager", "Update",
+                                             "Setup", "Viewer", "Notes"};
+        std::vector<utils::Program> programs;
+        programs.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            utils::Program program;
+            program.name = std::string(kWords[i % 16]) + " " + kWords[(i / 16) % 16] + " " + std::to_string(i);
+            program.executablePath = "D:\\Programs\\Vendor " + std::to_string(i % 97) + "\\" + program.name + ".exe";
+            program.description = i % 5 == 0 ? "Tools for " + std::string(kWords[(i / 3) % 16]) : "";
+            programs.push_back(std::move(program));
+        }
+        return programs;
+    }
+
+    struct Keystrokes
+    {
+        std::vector<double> us;
+        size_t allocations = 0;
+        size_t bytes = 0;
+        size_t results = 0;
+        size_t keys = 0;
+    };
+
+    // Types each session a character at a time, each keystroke one Search()
+    // inside an arena scope the way ProviderScheduler runs it.
+    Keystrokes Replay(SearchEngine::CatalogProvider &provider, const std::vector<std::string> &sessions, int rounds)
+    {
+        Keystrokes keystrokes;
+        for (int round = 0; round < rounds; ++round)
+        {
+            for (const std::string &session : sessions)
+            {
+                for (size_t length = 1; length <= session.size(); ++length)
+                {
+                    const std::string query = session.substr(0, length);
+                    const size_t allocationsBefore = allocations.load();
+                    const size_t bytesBefore = allocatedBytes.load();
+                    const Clock::time_point start = Clock::now();
+                    size_t results = 0;
+                    {
+                        utils::QueryArena::Scope scope;
+                        results = provider.Search(query, {}).size();
+                    }
+                    keystrokes.us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+                    keystrokes.allocations += allocations.load() - allocationsBefore;
+                    keystrokes.bytes += allocatedBytes.load() - bytesBefore;
+                    keystrokes.results += results;
+                    ++keystrokes.keys;
+                }
+            }
+        }
+        return keystrokes;
+    }
+} // namespace
+
+// Heap allocations and latency per keystroke of the catalog search over
+// replayed typing, copying out every match against only the best
+// CatalogProvider::kDefaultTopK. Scratch data is in the query arena either
+// way; what is left is the copied results. Run on a Release build:
+//
+//   native_utils_bench AllocationBench
+TEST(AllocationBench, PerKeystroke)
+{
+    auto catalog = std::make_shared<SearchEngine::ProgramCatalog>();
+    catalog->Publish(ScannedPrograms(3000));
+    const std::vector<std::string> sessions = {"visual studio code", "steam", "paint", "notes viewer 12",
+                                               "terminal", "excel", "update manager", "ed"};
+
+    const std::pair<const char *, size_t> runs[] = {{"every match", 0},
+                                                    {"top 200", SearchEngine::CatalogProvider::kDefaultTopK}};
+    for (const auto &[label, topK] : runs)
+    {
+        SearchEngine::CatalogProvider provider(catalog, nullptr, topK);
+        Replay(provider, sessions, 1); // Grows the arena and warms the caches
+        const utils::QueryArena::Stats before = utils::QueryArena::ForThread().GetStats();
+        const Keystrokes keystrokes = Replay(provider, sessions, 5);
+        const utils::QueryArena::Stats after = utils::QueryArena::ForThread().GetStats();
+        std::printf("  %-12s %7.1f allocations, %7.1f KiB, %6.1f results per keystroke; p50 %.0f us, p99 %.0f us, "
+                    "max %.0f us; arena %zu KiB, grew %zu times\n",
+                    label, double(keystrokes.allocations) / keystrokes.keys,
+                    keystrokes.bytes / 1024.0 / keystrokes.keys, double(keystrokes.results) / keystrokes.keys,
+                    Percentile(keystrokes.us, 0.5), Percentile(keystrokes.us, 0.99), Percentile(keystrokes.us, 1.0),
+                    after.capacity / 1024, after.upstreamAllocations - before.upstreamAllocations);
+    }
+}
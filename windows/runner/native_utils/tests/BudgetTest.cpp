@@ -0,0 +1,175 @@
+#include "Test.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "BudgetedRunner.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    bool WaitUntil(const std::function<bool()> &done)
+    {
+        const Clock::time_point deadline = Clock::now() + std::chrono::seconds(5);
+        while (!done())
+        {
+            if (Clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    utils::BudgetedRunner::Options Budget(int ms)
+    {
+        utils::BudgetedRunner::Options options;
+        options.budget = std::chrono::milliseconds(ms);
+        return options;
+    }
+
+    // Held by a job until released, so a test decides when an overrun ends.
+    struct Gate
+    {
+        std::atomic<bool> open{false};
+
+        void Wait() const
+        {
+            while (!open)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+} // namespace
+
+// Jobs inside the budget return their results, one after another on the
+// same worker.
+TEST(Budget, OnTimeJobsComplete)
+{
+    utils::BudgetedRunner runner(Budget(2000));
+    std::thread::id first;
+    CHECK(runner.Run([&first]() { first = std::this_thread::get_id(); }));
+    std::thread::id second;
+    CHECK(runner.Call<std::string>([&second]() {
+        second = std::this_thread::get_id();
+        return std::string("shortcut.lnk");
+    }) == std::optional<std::string>("shortcut.lnk"));
+    CHECK(first == second);
+    CHECK(first != std::this_thread::get_id());
+
+    const utils::BudgetedRunner::Stats stats = runner.GetStats();
+    CHECK_EQ(stats.completed, size_t(2));
+    CHECK_EQ(stats.overran, size_t(0));
+    CHECK_EQ(stats.abandoned, size_t(0));
+}
+
+// A job past its budget is given up on when the budget expires, keeps its
+// captures until it returns, and the next job gets a new worker.
+TEST(Budget, OverrunIsAbandoned)
+{
+    utils::BudgetedRunner runner(Budget(50));
+    auto gate = std::make_shared<Gate>();
+    auto returned = std::make_shared<std::atomic<bool>>(false);
+    std::thread::id stuck;
+    const Clock::time_point start = Clock::now();
+    const std::optional<int> result = runner.Call<int>([gate, returned, &stuck]() {
+        stuck = std::this_thread::get_id();
+        gate->Wait();
+        *returned = true;
+        return 1;
+    });
+    const double ms = MsSince(start);
+    CHECK(!result.has_value());
+    CHECK(ms >= 45.0);
+    CHECK(ms < 1000.0);
+
+    utils::BudgetedRunner::Stats stats = runner.GetStats();
+    CHECK_EQ(stats.overran, size_t(1));
+    CHECK_EQ(stats.abandoned, size_t(1));
+    CHECK(stats.max == std::chrono::microseconds(std::chrono::milliseconds(50)));
+
+    std::thread::id fresh;
+    CHECK(runner.Run([&fresh]() { fresh = std::this_thread::get_id(); }));
+
+    gate->open = true;
+    REQUIRE(WaitUntil([returned]() { return returned->load(); }));
+    CHECK(fresh != stuck);
+    REQUIRE(WaitUntil([&runner]() { return runner.GetStats().abandoned == 0; }));
+    CHECK(!runner.Saturated());
+}
+
+// With |maxAbandoned| workers stuck the runner refuses jobs rather than
+// start more threads, and takes them again once one of them returns.
+TEST(Budget, SaturatedRunnerRefusesJobs)
+{
+    utils::BudgetedRunner::Options options = Budget(20);
+    options.maxAbandoned = 2;
+    utils::BudgetedRunner runner(options);
+    auto gate = std::make_shared<Gate>();
+    CHECK(!runner.Run([gate]() { gate->Wait(); }));
+    CHECK(!runner.Saturated());
+    CHECK(!runner.Run([gate]() { gate->Wait(); }));
+    CHECK(runner.Saturated());
+
+    bool ran = false;
+    CHECK(!runner.Run([&ran]() { ran = true; }));
+    CHECK(!ran);
+    CHECK_EQ(runner.GetStats().refused, size_t(1));
+
+    gate->open = true;
+    REQUIRE(WaitUntil([&runner]() { return !runner.Saturated(); }));
+    CHECK(runner.Run([&ran]() { ran = true; }));
+    CHECK(ran);
+}
+
+// |threadStart| and |threadExit| bracket every worker, including one that
+// was abandoned.
+TEST(Budget, ThreadHooksBracketEachWorker)
+{
+    auto starts = std::make_shared<std::atomic<int>>(0);
+    auto exits = std::make_shared<std::atomic<int>>(0);
+    auto gate = std::make_shared<Gate>();
+    {
+        utils::BudgetedRunner::Options options = Budget(20);
+        options.threadStart = [starts]() { ++*starts; };
+        options.threadExit = [exits]() { ++*exits; };
+        utils::BudgetedRunner runner(options);
+        CHECK(runner.Run([]() {}));
+        CHECK(!runner.Run([gate]() { gate->Wait(); }));
+        CHECK(runner.Run([]() {}));
+        CHECK_EQ(starts->load(), 2);
+    }
+    // The runner's own worker has stopped; the abandoned one is still in its job.
+    CHECK_EQ(exits->load(), 1);
+    gate->open = true;
+    REQUIRE(WaitUntil([exits]() { return exits->load() == 2; }));
+}
+
+// Latency percentiles cover the latest |latencySamples| jobs, an overrun
+// counting as the whole budget.
+TEST(Budget, LatencyPercentiles)
+{
+    utils::BudgetedRunner::Options options = Budget(100);
+    options.latencySamples = 4;
+    utils::BudgetedRunner runner(options);
+    auto gate = std::make_shared<Gate>();
+    for (int i = 0; i < 8; ++i)
+        CHECK(runner.Run([]() {}));
+    CHECK(!runner.Run([gate]() { gate->Wait(); }));
+
+    const utils::BudgetedRunner::Stats stats = runner.GetStats();
+    CHECK(stats.p50 < std::chrono::milliseconds(50));
+    CHECK(stats.max == std::chrono::microseconds(std::chrono::milliseconds(100)));
+    CHECK(stats.p99 == stats.max);
+    gate->open = true;
+    REQUIRE(WaitUntil([&runner]() { return runner.GetStats().abandoned == 0; }));
+}
@@ -0,0 +1,201 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "ProviderScheduler.h"
+#include "SearchProviders.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MsBetween(Clock::time_point from, Clock::time_point to)
+    {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    std::shared_ptr<SearchEngine::ProgramCatalog> MakeCatalog(size_t count)
+    {
+        std::vector<utils::Program> programs;
+        programs.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            utils::Program program;
+            program.name = "Application number " + std::to_string(i);
+            program.executablePath = "C:\\Program Files\\Vendor " + std::to_string(i % 97) + "\\app" + std::to_string(i) + ".exe";
+            programs.push_back(std::move(program));
+        }
+        auto catalog = std::make_shared<SearchEngine::ProgramCatalog>();
+        catalog->Publish(std::move(programs));
+        return catalog;
+    }
+
+    // Keeps the other hardware threads busy while it lives.
+    class Load
+    {
+    public:
+        Load()
+        {
+            // One core short of all, so what is measured is the polling and not the
+            // OS time slice of an oversubscribed machine.
+            const unsigned cores = std::max(std::thread::hardware_concurrency(), 2u);
+            const unsigned count = cores - 1;
+            for (unsigned i = 0; i < count; ++i)
+                threads_.emplace_back([this]() {
+                    volatile uint64_t sink = 0;
+                    while (!stop_.load(std::memory_order_relaxed))
+                        sink = sink + 1;
+                });
+        }
+        ~Load()
+        {
+            stop_ = true;
+            for (std::thread &thread : threads_)
+                thread.join();
+        }
+
+    private:
+        std::atomic<bool> stop_{false};
+        std::vector<std::thread> threads_;
+    };
+
+    // A provider that works until its token fires and records when it noticed.
+    class SpinningProvider : public SearchEngine::SearchProvider
+    {
+    public:
+        const char *Name() const override { return "spin"; }
+        std::vector<utils::Program> Search(const std::string &, const utils::CancellationToken &token) override
+        {
+            started = true;
+            while (!token.IsCancelled())
+                std::this_thread::yield();
+            returned = Clock::now();
+            finished = true;
+            return {};
+        }
+
+        std::atomic<bool> started{false};
+        std::atomic<bool> finished{false};
+        Clock::time_point returned;
+    };
+} // namespace
+
+TEST(Cancellation, RegistryCancelsThroughSequence)
+{
+    utils::CancellationRegistry registry;
+    utils::CancellationToken first = registry.Register(1);
+    utils::CancellationToken second = registry.Register(2);
+    utils::CancellationToken third = registry.Register(3);
+    registry.CancelThrough(2);
+    CHECK(first.IsCancelled());
+    CHECK(second.IsCancelled());
+    CHECK(!third.IsCancelled());
+
+    // A Register() overtaken by its cancel gets a cancelled token.
+    CHECK(registry.Register(2).IsCancelled());
+    CHECK(!registry.Register(4).IsCancelled());
+    CHECK(!utils::CancellationToken().IsCancelled());
+}
+
+// Dart numbers searches from 1 again after a hot restart.
+TEST(Cancellation, ResetStartsNumberingOver)
+{
+    utils::CancellationRegistry registry;
+    utils::CancellationToken running = registry.Register(41);
+    registry.CancelThrough(40);
+    CHECK(!running.IsCancelled());
+    CHECK(registry.Register(1).IsCancelled());
+
+    registry.Reset();
+    CHECK(running.IsCancelled());
+    utils::CancellationToken first = registry.Register(1);
+    CHECK(!first.IsCancelled());
+    registry.CancelThrough(1);
+    CHECK(first.IsCancelled());
+    CHECK(!registry.Register(2).IsCancelled());
+}
+
+// The catalog scan polls its token per entry, so a newer keystroke stops the
+// old query within about a millisecond even while every core is busy.
+TEST(Cancellation, CatalogSearchStopsPromptlyUnderLoad)
+{
+    std::shared_ptr<SearchEngine::ProgramCatalog> catalog = MakeCatalog(400000);
+    SearchEngine::CatalogProvider provider(catalog);
+
+    const Clock::time_point fullStart = Clock::now();
+    provider.Search("no such program", {});
+    const double fullMs = MsBetween(fullStart, Clock::now());
+
+    Load load;
+    std::vector<double> latencies;
+    for (int trial = 0; trial < 20; ++trial)
+    {
+        utils::CancellationSource source;
+        std::atomic<bool> started{false};
+        Clock::time_point returned;
+        std::thread search([&]() {
+            started = true;
+            provider.Search("no such program", source.Token());
+            returned = Clock::now();
+        });
+        while (!started)
+            std::this_thread::yield();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        const Clock::time_point cancelled = Clock::now();
+        source.Cancel();
+        search.join();
+        latencies.push_back(std::max(0.0, MsBetween(cancelled, returned)));
+    }
+    std::sort(latencies.begin(), latencies.end());
+    const double median = latencies[latencies.size() / 2];
+    std::printf("  full scan %.1f ms; cancel latency under load: median %.3f ms, max %.3f ms\n", fullMs, median,
+                latencies.back());
+    CHECK(fullMs > 5.0); // Otherwise the searches may have ended on their own
+    // Instrumented builds (ThreadSanitizer) scan many times slower; there the
+    // bound is 1% of a full scan.
+    CHECK(median < std::max(1.0, fullMs / 100));
+    CHECK(latencies.back() < 50.0);
+}
+
+// Once cancelled, a scheduled query emits no further frames and its providers
+// see the token.
+TEST(Cancellation, SchedulerStopsProvidersAndFrames)
+{
+    utils::TaskExecutor executor;
+    SearchEngine::SchedulerOptions options;
+    options.deadline = std::chrono::milliseconds(1);
+    SearchEngine::ProviderScheduler scheduler(options, executor);
+    auto provider = std::make_shared<SpinningProvider>();
+    scheduler.AddProvider(provider);
+
+    Load load;
+    utils::CancellationSource source;
+    std::atomic<int> framesAfterCancel{0};
+    std::atomic<bool> cancelled{false};
+    scheduler.Run(1, "query", source.Token(), [&](SearchEngine::SearchFrame &&) {
+        if (cancelled)
+            ++framesAfterCancel;
+    });
+    while (!provider->started)
+        std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5)); // Past the deadline: frame 0 is out
+    const Clock::time_point cancelAt = Clock::now();
+    cancelled = true;
+    source.Cancel();
+    while (!provider->finished)
+        std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    const double latencyMs = MsBetween(cancelAt, provider->returned);
+    std::printf("  provider stopped %.3f ms after cancel\n", latencyMs);
+    CHECK(latencyMs < 50.0);
+    CHECK_EQ(framesAfterCancel.load(), 0);
+}
@@ -0,0 +1,91 @@
+#include "Test.h"
+
+#include <string>
+#include <vector>
+
+#include "EntryId.h"
+#include "SearchProviders.h"
+
+namespace
+{
+    utils::Program MakeProgram(const std::string &name, const std::string &path, const std::string &source,
+                               const std::string &icon = "")
+    {
+        utils::Program program;
+        program.name = name;
+        program.executablePath = path;
+        program.source = source;
+        program.iconDataBase64 = icon;
+        if (!icon.empty())
+        {
+            program.iconPath = path;
+            program.iconIndex = 0;
+        }
+        return program;
+    }
+} // namespace
+
+TEST(Catalog, SourcePrecedence)
+{
+    CHECK(utils::SourcePrecedence("Start Menu (User)") < utils::SourcePrecedence("Start Menu (Common)"));
+    CHECK(utils::SourcePrecedence("Start Menu (Common)") < utils::SourcePrecedence("HKCU Uninstall"));
+    CHECK(utils::SourcePrecedence("HKCU Uninstall") < utils::SourcePrecedence("HKLM Uninstall"));
+    CHECK_EQ(utils::SourcePrecedence("Registry (HKLM) Uninstall"), utils::SourcePrecedence("HKLM Uninstall"));
+    CHECK(utils::SourcePrecedence("HKLM Uninstall") < utils::SourcePrecedence("UWP"));
+    CHECK_EQ(utils::SourcePrecedence("UWP"), utils::SourcePrecedence("Windows Search Index"));
+}
+
+// Entries with one id become one entry, whatever order the scan produced.
+TEST(Catalog, PublishMergesEntriesSharingAnId)
+{
+    for (int order = 0; order < 2; ++order)
+    {
+        std::vector<utils::Program> programs;
+        programs.push_back(MakeProgram("Other", "C:\\other.exe", "HKLM Uninstall"));
+        utils::Program registry = MakeProgram("App (x64)", "C:\\Program Files\\App\\app.exe", "HKLM Uninstall", "REGICON");
+        registry.description = "From the registry";
+        utils::Program shortcut = MakeProgram("App", "c:/program files/app/APP.exe", "Start Menu (Common)");
+        shortcut.originPath = "C:\\ProgramData\\Microsoft\\Windows\\Start Menu\\Programs\\App.lnk";
+        if (order == 0)
+        {
+            programs.push_back(std::move(registry));
+            programs.push_back(std::move(shortcut));
+        }
+        else
+        {
+            programs.push_back(std::move(shortcut));
+            programs.push_back(std::move(registry));
+        }
+
+        SearchEngine::ProgramCatalog catalog;
+        catalog.Publish(std::move(programs));
+        SearchEngine::ProgramCatalog::Snapshot snapshot = catalog.Current();
+        REQUIRE(snapshot->size() == 2);
+        const utils::Program &app = (*snapshot)[1]; // Where the first of the two was
+        // The Start Menu entry wins; what it lacked comes from the registry.
+        CHECK_EQ(app.name, std::string("App"));
+        CHECK_EQ(app.source, std::string("Start Menu (Common)"));
+        CHECK_EQ(app.executablePath, std::string("c:/program files/app/APP.exe"));
+        CHECK_EQ(app.description, std::string("From the registry"));
+        CHECK_EQ(app.iconDataBase64, std::string("REGICON"));
+        CHECK_EQ(app.iconPath, std::string("C:\\Program Files\\App\\app.exe"));
+        CHECK_EQ(app.iconIndex, 0);
+        CHECK(!app.originPath.empty());
+        CHECK_EQ(app.id, utils::EntryId("C:\\Program Files\\App\\app.exe", ""));
+    }
+}
+
+TEST(Catalog, PublishPrefersIconWithinASource)
+{
+    std::vector<utils::Program> programs;
+    programs.push_back(MakeProgram("Plain", "C:\\app.exe", "Start Menu (User)"));
+    programs.push_back(MakeProgram("With icon", "C:\\APP.exe", "Start Menu (User)", "ICON"));
+    programs.push_back(MakeProgram("Third", "C:\\app.exe", "Start Menu (User)"));
+
+    SearchEngine::ProgramCatalog catalog;
+    catalog.Publish(std::move(programs));
+    SearchEngine::ProgramCatalog::Snapshot snapshot = catalog.Current();
+    REQUIRE(snapshot->size() == 1);
+    CHECK_EQ((*snapshot)[0].name, std::string("With icon"));
+    CHECK_EQ((*snapshot)[0].iconDataBase64, std::string("ICON"));
+}
@@ -0,0 +1,256 @@
+#include "Test.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "CoalescingProvider.h"
+#include "ConcurrencyLimiter.h"
+#include "ProviderScheduler.h"
+#include "TaskExecutor.h"
+
+namespace
+{
+    bool WaitFor(const std::function<bool()> &done)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!done())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    // Stands in for the index: counts its calls, and each one waits until the
+    // test opens the gate or its token fires.
+    class CountingProvider : public SearchEngine::SearchProvider
+    {
+    public:
+        const char *Name() const override { return "index"; }
+        bool IsExpensive() const override { return true; }
+
+        std::vector<utils::Program> Search(const std::string &query, const utils::CancellationToken &token) override
+        {
+            ++calls;
+            const int now = ++running;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now))
+            {
+            }
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                while (!open_ && !token.IsCancelled())
+                    gate_.wait_for(lock, std::chrono::milliseconds(1));
+            }
+            --running;
+            if (fail)
+                throw std::runtime_error("index unavailable");
+            std::vector<utils::Program> results;
+            for (int i = 0; i < 3; ++i)
+            {
+                utils::Program program;
+                program.name = query + " " + std::to_string(i);
+                program.executablePath = "D:\\Index\\" + program.name + ".exe";
+                results.push_back(std::move(program));
+            }
+            return results;
+        }
+
+        void Open()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            open_ = true;
+            gate_.notify_all();
+        }
+
+        std::atomic<int> calls{0};
+        std::atomic<int> running{0};
+        std::atomic<int> peak{0};
+        std::atomic<bool> fail{false};
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable gate_;
+        bool open_ = false;
+    };
+
+    // Collects what SearchAsync() answers.
+    struct Answers
+    {
+        std::mutex mutex;
+        std::vector<std::vector<utils::Program>> results;
+
+        SearchEngine::SearchProvider::Completion Add()
+        {
+            return [this](std::vector<utils::Program> &&programs) {
+                std::lock_guard<std::mutex> lock(mutex);
+                results.push_back(std::move(programs));
+            };
+        }
+
+        size_t Count()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return results.size();
+        }
+    };
+} // namespace
+
+// Keystrokes that repeat a query while it runs share the one index call.
+TEST(Coalescing, OverlappingQueriesShareOneSearch)
+{
+    utils::TaskExecutor executor;
+    auto limiter = std::make_shared<utils::ConcurrencyLimiter>(2, executor);
+    auto inner = std::make_shared<CountingProvider>();
+    SearchEngine::CoalescingProvider provider(inner, limiter);
+    CHECK(provider.IsExpensive());
+    CHECK(std::string(provider.Name()) == "index");
+
+    Answers answers;
+    for (int i = 0; i < 5; ++i)
+        provider.SearchAsync("code", {}, answers.Add());
+    provider.SearchAsync("notepad", {}, answers.Add());
+    REQUIRE(WaitFor([&]() { return inner->calls.load() == 2; }));
+    inner->Open();
+    REQUIRE(WaitFor([&]() { return answers.Count() == 6; }));
+    CHECK_EQ(inner->calls.load(), 2);
+
+    int code = 0;
+    for (const std::vector<utils::Program> &programs : answers.results)
+    {
+        REQUIRE(programs.size() == 3);
+        if (programs[0].name == "code 0")
+            ++code;
+    }
+    CHECK_EQ(code, 5);
+    const SearchEngine::CoalescingProvider::Stats stats = provider.GetStats();
+    CHECK_EQ(stats.searches, 2u);
+    CHECK_EQ(stats.joined, 4u);
+}
+
+// Index calls queue for the limiter they share with the other expensive calls.
+TEST(Coalescing, CallsQueueForTheLimiter)
+{
+    utils::TaskExecutor::Options options;
+    options.threads = 4;
+    utils::TaskExecutor executor(options);
+    auto limiter = std::make_shared<utils::ConcurrencyLimiter>(1, executor);
+    auto inner = std::make_shared<CountingProvider>();
+    SearchEngine::CoalescingProvider provider(inner, limiter);
+
+    Answers answers;
+    const char *queries[] = {"a", "b", "c", "d"};
+    for (const char *query : queries)
+        provider.SearchAsync(query, {}, answers.Add());
+    REQUIRE(WaitFor([&]() { return inner->calls.load() == 1; }));
+    CHECK_EQ(limiter->GetStats().queued, 3u);
+    inner->Open();
+    REQUIRE(WaitFor([&]() { return answers.Count() == 4; }));
+    CHECK_EQ(inner->peak.load(), 1);
+    CHECK_EQ(inner->calls.load(), 4);
+}
+
+// A cancelled query's partial results go to nobody; a live query that had
+// joined it gets a search of its own, and one cancelled before its turn costs
+// no index call at all.
+TEST(Coalescing, CancelledLeaderHandsOver)
+{
+    utils::TaskExecutor executor;
+    auto limiter = std::make_shared<utils::ConcurrencyLimiter>(2, executor);
+    auto inner = std::make_shared<CountingProvider>();
+    SearchEngine::CoalescingProvider provider(inner, limiter);
+
+    utils::CancellationSource leader;
+    Answers leaderAnswers;
+    Answers followerAnswers;
+    provider.SearchAsync("code", leader.Token(), leaderAnswers.Add());
+    REQUIRE(WaitFor([&]() { return inner->calls.load() == 1; }));
+    provider.SearchAsync("code", {}, followerAnswers.Add());
+    leader.Cancel();
+    REQUIRE(WaitFor([&]() { return leaderAnswers.Count() == 1 && inner->calls.load() == 2; }));
+    CHECK(leaderAnswers.results[0].empty());
+    CHECK_EQ(followerAnswers.Count(), 0u);
+    inner->Open();
+    REQUIRE(WaitFor([&]() { return followerAnswers.Count() == 1; }));
+    CHECK_EQ(followerAnswers.results[0].size(), 3u);
+
+    utils::CancellationSource late;
+    late.Cancel();
+    Answers lateAnswers;
+    provider.SearchAsync("notepad", late.Token(), lateAnswers.Add());
+    REQUIRE(WaitFor([&]() { return lateAnswers.Count() == 1; }));
+    CHECK(lateAnswers.results[0].empty());
+    CHECK_EQ(inner->calls.load(), 2);
+}
+
+// A throwing index answers everyone that shared the call with nothing, and
+// the limiter slot is not lost.
+TEST(Coalescing, ThrowingSearchAnswersEmpty)
+{
+    utils::TaskExecutor executor;
+    auto limiter = std::make_shared<utils::ConcurrencyLimiter>(1, executor);
+    auto inner = std::make_shared<CountingProvider>();
+    inner->fail = true;
+    inner->Open();
+    SearchEngine::CoalescingProvider provider(inner, limiter);
+
+    Answers answers;
+    provider.SearchAsync("code", {}, answers.Add());
+    provider.SearchAsync("code", {}, answers.Add());
+    REQUIRE(WaitFor([&]() { return answers.Count() == 2; }));
+    CHECK(answers.results[0].empty() && answers.results[1].empty());
+    REQUIRE(WaitFor([&]() { return limiter->GetStats().running == 0; }));
+    CHECK(limiter->GetStats().failed >= 1u);
+
+    inner->fail = false;
+    CHECK_EQ(provider.Search("code", {}).size(), 3u);
+}
+
+// Through the scheduler, two runs of one query make one index call, and the
+// wait for the limiter holds no scheduler worker.
+TEST(Coalescing, SchedulerRunsShareTheCall)
+{
+    utils::TaskExecutor::Options options;
+    options.threads = 2;
+    utils::TaskExecutor executor(options);
+    auto limiter = std::make_shared<utils::ConcurrencyLimiter>(1, executor);
+    auto inner = std::make_shared<CountingProvider>();
+    SearchEngine::ProviderScheduler scheduler({}, executor);
+    scheduler.AddProvider(std::make_shared<SearchEngine::CoalescingProvider>(inner, limiter));
+
+    std::mutex mutex;
+    std::vector<SearchEngine::SearchFrame> frames;
+    auto onFrame = [&](SearchEngine::SearchFrame &&frame) {
+        std::lock_guard<std::mutex> lock(mutex);
+        frames.push_back(std::move(frame));
+    };
+    scheduler.Run(1, "code", {}, onFrame);
+    scheduler.Run(2, "code", {}, onFrame);
+    REQUIRE(WaitFor([&]() { return inner->calls.load() == 1; }));
+
+    // One worker is in the index call; the other is still free.
+    std::atomic<bool> ran{false};
+    executor.Post(utils::TaskPriority::Interactive, [&]() { ran = true; });
+    CHECK(WaitFor([&]() { return ran.load(); }));
+
+    inner->Open();
+    auto finals = [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        int count = 0;
+        for (const SearchEngine::SearchFrame &frame : frames)
+            count += frame.isFinal && frame.items.size() == 3 ? 1 : 0;
+        return count;
+    };
+    REQUIRE(WaitFor([&]() { return finals() == 2; }));
+    CHECK_EQ(inner->calls.load(), 1);
+}
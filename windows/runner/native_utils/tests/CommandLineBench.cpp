@@ -0,0 +1,60 @@
+#include "Test.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "CommandLineParser.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // What the registry scan did before: split into owned strings.
+    std::vector<std::string> SplitAllocating(const std::string &line)
+    {
+        std::vector<std::string> argv;
+        utils::CommandLineParser parser(line);
+        argv.emplace_back(parser.Program());
+        std::string_view raw;
+        while (parser.NextArgument(raw))
+        {
+            std::string arg(raw.size(), '\0');
+            arg.resize(utils::CommandLineParser::Unescape(raw, arg.data(), arg.size()));
+            argv.push_back(std::move(arg));
+        }
+        return argv;
+    }
+} // namespace
+
+TEST(CommandLineBench, ParseUninstallString)
+{
+    const std::string line = "\"C:\\Program Files (x86)\\Some Vendor\\Product\\uninstall.exe\" /S "
+                             "/LOG=\"C:\\Temp\\un log.txt\" --quiet";
+    constexpr int kLines = 1000000;
+
+    size_t total = 0;
+    const Clock::time_point spanStart = Clock::now();
+    for (int i = 0; i < kLines; ++i)
+    {
+        const utils::UninstallCommand<char> command = utils::ParseUninstallString<char>(line);
+        utils::CommandLineParser parser(line);
+        std::string_view raw;
+        char buffer[256];
+        while (parser.NextArgument(raw))
+            total += utils::CommandLineParser::Unescape(raw, buffer, sizeof buffer);
+        total += command.program.size();
+    }
+    const Clock::time_point spanEnd = Clock::now();
+    for (int i = 0; i < kLines; ++i)
+    {
+        for (const std::string &arg : SplitAllocating(line))
+            total += arg.size();
+    }
+    const Clock::time_point allocEnd = Clock::now();
+
+    const auto nsPerLine = [](Clock::duration d) { return std::chrono::duration<double, std::nano>(d).count() / kLines; };
+    std::printf("  spans %.0f ns/line, owned strings %.0f ns/line (%zu)\n", nsPerLine(spanEnd - spanStart),
+                nsPerLine(allocEnd - spanEnd), total);
+}
@@ -0,0 +1,232 @@
+#include "Test.h"
+
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CommandLineParser.h"
+
+namespace
+{
+    using Args = std::vector<std::string>;
+
+    // The documented CommandLineToArgvW algorithm, written out with std::string
+    // and kept deliberately naive, to check the parser against.
+    Args ReferenceArgv(const std::string &line)
+    {
+        Args argv;
+        std::string current;
+        const char *s = line.c_str();
+        if (*s == '"')
+        {
+            ++s;
+            while (*s && *s != '"')
+                current += *s++;
+            if (*s == '"')
+                ++s;
+        }
+        else
+        {
+            while (*s && *s != ' ' && *s != '\t')
+                current += *s++;
+        }
+        argv.push_back(current);
+        current.clear();
+        while (*s == ' ' || *s == '\t')
+            ++s;
+        if (!*s)
+            return argv;
+
+        int quotes = 0;
+        int backslashes = 0;
+        while (*s)
+        {
+            if ((*s == ' ' || *s == '\t') && quotes == 0)
+            {
+                argv.push_back(current);
+                current.clear();
+                while (*s == ' ' || *s == '\t')
+                    ++s;
+                backslashes = 0;
+                if (!*s)
+                    return argv;
+            }
+            else if (*s == '\\')
+            {
+                current += *s++;
+                ++backslashes;
+            }
+            else if (*s == '"')
+            {
+                if (backslashes % 2 == 0)
+                {
+                    current.resize(current.size() - backslashes / 2);
+                    ++quotes;
+                }
+                else
+                {
+                    current.resize(current.size() - backslashes / 2 - 1);
+                    current += '"';
+                }
+                ++s;
+                backslashes = 0;
+                while (*s == '"')
+                {
+                    if (++quotes == 3)
+                    {
+                        current += '"';
+                        quotes = 0;
+                    }
+                    ++s;
+                }
+                if (quotes == 2)
+                    quotes = 0;
+            }
+            else
+            {
+                current += *s++;
+                backslashes = 0;
+            }
+        }
+        argv.push_back(current);
+        return argv;
+    }
+
+    Args ParsedArgv(const std::string &line)
+    {
+        utils::CommandLineParser parser(line);
+        Args argv{std::string(parser.Program())};
+        std::string_view raw;
+        char buffer[512];
+        while (parser.NextArgument(raw))
+        {
+            const size_t length = utils::CommandLineParser::Unescape(raw, buffer, sizeof buffer);
+            REQUIRE(length <= sizeof buffer);
+            argv.emplace_back(buffer, length);
+            if (utils::CommandLineParser::IsVerbatim(raw))
+                CHECK_EQ(argv.back(), std::string(raw));
+        }
+        return argv;
+    }
+
+    std::string Join(const Args &args)
+    {
+        std::string out;
+        for (const std::string &arg : args)
+            out += "<" + arg + ">";
+        return out;
+    }
+
+    struct UninstallCase
+    {
+        const char *line;
+        const char *program;
+        const char *arguments;
+        utils::UninstallForm form;
+        const char *target;
+        bool exactProgram;
+    };
+
+    using utils::UninstallForm;
+
+    // Shapes seen in HKLM/HKCU ...\Uninstall\*\UninstallString.
+    const UninstallCase kUninstallCorpus[] = {
+        {"\"C:\\Program Files\\Mozilla Firefox\\uninstall\\helper.exe\"", "C:\\Program Files\\Mozilla Firefox\\uninstall\\helper.exe", "", UninstallForm::Command, "", true},
+        {"\"C:\\Program Files (x86)\\Steam\\uninstall.exe\"", "C:\\Program Files (x86)\\Steam\\uninstall.exe", "", UninstallForm::Command, "", true},
+        {"\"C:\\Program Files\\Git\\unins000.exe\" /SILENT", "C:\\Program Files\\Git\\unins000.exe", "/SILENT", UninstallForm::Command, "", true},
+        {"C:\\Program Files\\7-Zip\\Uninstall.exe", "C:\\Program Files\\7-Zip\\Uninstall.exe", "", UninstallForm::Command, "", true},
+        {"C:\\Program Files\\App\\uninst.exe /S /D=x", "C:\\Program Files\\App\\uninst.exe", "/S /D=x", UninstallForm::Command, "", true},
+        {"  C:\\Program Files\\my.exe.dir\\run.EXE  -x", "C:\\Program Files\\my.exe.dir\\run.EXE", "-x", UninstallForm::Command, "", true},
+        {"C:\\Tools\\uninstall", "C:\\Tools\\uninstall", "", UninstallForm::Command, "", true},
+        {"C:\\Tools\\uninstall --all", "C:\\Tools\\uninstall", "--all", UninstallForm::Command, "", false},
+        {"MsiExec.exe /X{1234-ABCD}", "MsiExec.exe", "/X{1234-ABCD}", UninstallForm::MsiExec, "{1234-ABCD}", true},
+        {"MsiExec.exe /I{90160000-008C-0000-1000-0000000FF1CE}", "MsiExec.exe", "/I{90160000-008C-0000-1000-0000000FF1CE}", UninstallForm::MsiExec, "{90160000-008C-0000-1000-0000000FF1CE}", true},
+        {"msiexec /x {AC76BA86-7AD7-1033-7B44-AC0F074E4100} /qn", "msiexec", "/x {AC76BA86-7AD7-1033-7B44-AC0F074E4100} /qn", UninstallForm::MsiExec, "{AC76BA86-7AD7-1033-7B44-AC0F074E4100}", false},
+        {"C:\\Windows\\System32\\MsiExec.exe /X{5FCE6D76-F5DC-37AB-B2B8-22AB8CEDB1D4}", "C:\\Windows\\System32\\MsiExec.exe", "/X{5FCE6D76-F5DC-37AB-B2B8-22AB8CEDB1D4}", UninstallForm::MsiExec, "{5FCE6D76-F5DC-37AB-B2B8-22AB8CEDB1D4}", true},
+        {"MsiExec.exe /X", "MsiExec.exe", "/X", UninstallForm::MsiExec, "", true},
+        {"C:\\Windows\\System32\\rundll32.exe \"C:\\Program Files\\x\\y.dll\",Uninstall /q", "C:\\Windows\\System32\\rundll32.exe", "\"C:\\Program Files\\x\\y.dll\",Uninstall /q", UninstallForm::Rundll32, "C:\\Program Files\\x\\y.dll", true},
+        {"RunDll32 C:\\x\\y.dll,Entry", "RunDll32", "C:\\x\\y.dll,Entry", UninstallForm::Rundll32, "C:\\x\\y.dll", false},
+        {"rundll32.exe dfshim.dll,ShArpMaintain App.application, Culture=neutral", "rundll32.exe", "dfshim.dll,ShArpMaintain App.application, Culture=neutral", UninstallForm::Rundll32, "dfshim.dll", true},
+        {"\"C:\\Program Files\\A B\\unins000.exe\" /SILENT", "C:\\Program Files\\A B\\unins000.exe", "/SILENT", UninstallForm::Command, "", true},
+        {"\"C:\\ProgramData\\Package Cache\\{f65db027}\\VC_redist.x64.exe\"  /uninstall", "C:\\ProgramData\\Package Cache\\{f65db027}\\VC_redist.x64.exe", "/uninstall", UninstallForm::Command, "", true},
+        {"\"C:\\Users\\me\\AppData\\Local\\Discord\\Update.exe\" --uninstall", "C:\\Users\\me\\AppData\\Local\\Discord\\Update.exe", "--uninstall", UninstallForm::Command, "", true},
+        {"\"C:\\Program Files\\Unclosed\\uninst.exe /S", "C:\\Program Files\\Unclosed\\uninst.exe /S", "", UninstallForm::Command, "", true},
+        {"\"\"", "", "", UninstallForm::Command, "", true},
+        {"", "", "", UninstallForm::Command, "", true},
+        {"C:\\Program Files\\Vendor\\setup.exe\t-uninstall -remove \"all files\"", "C:\\Program Files\\Vendor\\setup.exe", "-uninstall -remove \"all files\"", UninstallForm::Command, "", true},
+        {"C:\\Program Files\\Not an exe.exeX\\u.exe", "C:\\Program Files\\Not an exe.exeX\\u.exe", "", UninstallForm::Command, "", true},
+    };
+} // namespace
+
+// The worked examples from Microsoft's "Parsing C++ command-line arguments".
+TEST(CommandLine, DocumentedExamples)
+{
+    const std::pair<const char *, Args> examples[] = {
+        {"p \"abc\" d e", {"p", "abc", "d", "e"}},
+        {"p a\\\\b d\"e f\"g h", {"p", "a\\\\b", "de fg", "h"}},
+        {"p a\\\\\\\"b c d", {"p", "a\\\"b", "c", "d"}},
+        {"p a\\\\\\\\\"b c\" d e", {"p", "a\\\\b c", "d", "e"}},
+        {"p a\"b\"\" c d", {"p", "ab\"", "c", "d"}},
+        {"\"C:\\Program Files\\x\\u.exe\" /S", {"C:\\Program Files\\x\\u.exe", "/S"}},
+        {"\"C:\\a\\\"b c", {"C:\\a\\", "b", "c"}}, // argv[0] has no escapes
+        {" lead", {"", "lead"}},
+        {"p \"\"", {"p", ""}},
+        {"p \"\"\"\"\"\"", {"p", "\"\""}},
+        {"p\ta\t\t b", {"p", "a", "b"}},
+    };
+    for (const auto &[line, expected] : examples)
+    {
+        CHECK_EQ(Join(ParsedArgv(line)), Join(expected));
+        CHECK_EQ(Join(ReferenceArgv(line)), Join(expected));
+    }
+}
+
+// Random lines over the characters the rules care about.
+TEST(CommandLine, MatchesReferenceOnRandomLines)
+{
+    std::mt19937 rng(7);
+    const char alphabet[] = "ab \t\\\"\"\\";
+    for (int i = 0; i < 200000; ++i)
+    {
+        std::string line;
+        const int length = static_cast<int>(rng() % 16);
+        for (int c = 0; c < length; ++c)
+            line += alphabet[rng() % (sizeof alphabet - 1)];
+        const Args expected = ReferenceArgv(line);
+        const Args parsed = ParsedArgv(line);
+        if (parsed != expected)
+        {
+            CHECK_EQ(Join(parsed), Join(expected));
+            return;
+        }
+    }
+}
+
+TEST(CommandLine, UnescapeTruncates)
+{
+    char buffer[3];
+    const size_t length = utils::CommandLineParser::Unescape("\"abcdef\"", buffer, sizeof buffer);
+    CHECK_EQ(length, 6u);
+    CHECK_EQ(std::string(buffer, 3), std::string("abc"));
+}
+
+TEST(CommandLine, UninstallCorpus)
+{
+    for (const UninstallCase &c : kUninstallCorpus)
+    {
+        const utils::UninstallCommand<char> command = utils::ParseUninstallString<char>(c.line);
+        CHECK_EQ(std::string(command.program), std::string(c.program));
+        CHECK_EQ(std::string(command.arguments), std::string(c.arguments));
+        CHECK(command.form == c.form);
+        CHECK_EQ(std::string(command.target), std::string(c.target));
+        CHECK_EQ(command.exactProgram, c.exactProgram);
+
+        // The wide parser splits the same way.
+        const std::wstring wide(c.line, c.line + std::char_traits<char>::length(c.line));
+        const utils::UninstallCommand<wchar_t> wideCommand = utils::ParseUninstallString<wchar_t>(wide);
+        CHECK_EQ(wideCommand.program.size(), command.program.size());
+        CHECK_EQ(wideCommand.arguments.size(), command.arguments.size());
+        CHECK(wideCommand.form == command.form);
+    }
+}
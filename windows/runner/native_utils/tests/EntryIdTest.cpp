@@ -0,0 +1,88 @@
+#include "Test.h"
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "EntryId.h"
+
+TEST(EntryId, NormalizesTargets)
+{
+    CHECK_EQ(utils::NormalizeTarget("  \"C:/Program Files//App\\\\App.EXE\"  "), std::string("c:\\program files\\app\\app.exe"));
+    CHECK_EQ(utils::NormalizeTarget("C:\\Tools\\"), std::string("c:\\tools"));
+    CHECK_EQ(utils::NormalizeTarget("C:\\"), std::string("c:\\"));
+    CHECK_EQ(utils::NormalizeTarget("\\\\Server\\Share\\\\x.exe"), std::string("\\\\server\\share\\x.exe"));
+    CHECK_EQ(utils::NormalizeTarget("\\\\"), std::string("\\\\"));
+    CHECK_EQ(utils::NormalizeTarget("Microsoft.WindowsCalculator_8wekyb3d8bbwe!App"),
+             std::string("shell:appsfolder\\microsoft.windowscalculator_8wekyb3d8bbwe!app"));
+    // Already a shell target, and a path that merely contains '!'.
+    CHECK_EQ(utils::NormalizeTarget("shell:AppsFolder\\Pkg!App"), std::string("shell:appsfolder\\pkg!app"));
+    CHECK_EQ(utils::NormalizeTarget("C:\\Games\\Wow!\\wow.exe"), std::string("c:\\games\\wow!\\wow.exe"));
+    // Non-ASCII bytes are left alone.
+    CHECK_EQ(utils::NormalizeTarget("C:\\\xC3\x84pp.exe"), std::string("c:\\\xC3\x84pp.exe"));
+}
+
+TEST(EntryId, NormalizesArguments)
+{
+    CHECK_EQ(utils::NormalizeArguments("  --Mode   Fast\t-X "), std::string("--mode fast -x"));
+    // Blanks inside quotes are content; the quotes stay.
+    CHECK_EQ(utils::NormalizeArguments("--Mode \"A  B\"  -x"), std::string("--mode \"a  b\" -x"));
+    CHECK_EQ(utils::NormalizeArguments(""), std::string());
+}
+
+// Fixed values, computed independently from the normalized bytes; the Dart twin
+// (lib/native_apis/entry_id.dart) must produce the same.
+TEST(EntryId, KnownValues)
+{
+    CHECK_EQ(utils::EntryId("C:\\Program Files\\App\\App.exe", ""), 0xdcb9885456bf3dabull);
+    CHECK_EQ(utils::EntryId("Microsoft.WindowsCalculator_8wekyb3d8bbwe!App", ""), 0x8c1ae9131a61d918ull);
+    CHECK_EQ(utils::EntryId("c:/tools/run.exe", " --MODE \"a  b\"   -x"), 0xf70b1942f3331ec7ull);
+}
+
+TEST(EntryId, EquivalentSpellingsShareAnId)
+{
+    const uint64_t id = utils::EntryId("C:\\Program Files\\App\\App.exe", "/S");
+    CHECK_EQ(utils::EntryId("\"c:/program files/app/APP.EXE\"", " /s "), id);
+    CHECK_EQ(utils::EntryId("C:\\\\Program Files\\App\\\\App.exe", "/S"), id);
+    CHECK(utils::EntryId("C:\\Program Files\\App\\App.exe", "") != id);
+    CHECK(utils::EntryId("C:\\Program Files\\App\\App2.exe", "/S") != id);
+    // Target and arguments cannot trade bytes.
+    CHECK(utils::EntryId("a.exe b", "") != utils::EntryId("a.exe", "b"));
+
+    utils::Program program;
+    program.executablePath = "C:/Program Files/App/App.exe";
+    program.arguments = "/S";
+    CHECK_EQ(utils::EntryId(program), id);
+    CHECK_EQ(utils::AssignEntryId(program), id);
+    program.id = 42; // An assigned id wins
+    CHECK_EQ(utils::EntryId(program), 42u);
+    CHECK_EQ(utils::AssignEntryId(program), 42u);
+}
+
+// Two million distinct, realistically shaped entries: no two ids collide.
+TEST(EntryId, NoCollisionsAcrossDistinctEntries)
+{
+    const char *const roots[] = {"C:\\Program Files\\", "C:\\Program Files (x86)\\", "C:\\Users\\me\\AppData\\Local\\",
+                                 "D:\\Games\\"};
+    const char *const arguments[] = {"", "/S", "--profile=default", "-x \"a b\""};
+    std::unordered_map<uint64_t, std::string> seen;
+    seen.reserve(2000000);
+    size_t collisions = 0;
+    for (size_t i = 0; i < 500000; ++i)
+    {
+        for (size_t a = 0; a < 4; ++a)
+        {
+            const std::string target = std::string(roots[i % 4]) + "Vendor" + std::to_string(i / 4) + "\\App" +
+                                       std::to_string(i) + ".exe";
+            const uint64_t id = utils::EntryId(target, arguments[a]);
+            const std::string key = utils::NormalizeTarget(target) + '\0' + arguments[a];
+            auto [it, inserted] = seen.emplace(id, key);
+            if (!inserted && it->second != key)
+                ++collisions;
+        }
+    }
+    std::printf("  %zu ids, %zu collisions\n", seen.size(), collisions);
+    CHECK_EQ(seen.size(), 2000000u);
+    CHECK_EQ(collisions, 0u);
+}
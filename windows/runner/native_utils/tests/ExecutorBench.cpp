@@ -0,0 +1,155 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TaskExecutor.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using utils::TaskPriority;
+
+    double UsBetween(Clock::time_point from, Clock::time_point to)
+    {
+        return std::chrono::duration<double, std::micro>(to - from).count();
+    }
+
+    double Percentile(std::vector<double> values, double p)
+    {
+        std::sort(values.begin(), values.end());
+        return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+    }
+
+    void Spin(std::chrono::microseconds duration)
+    {
+        const Clock::time_point until = Clock::now() + duration;
+        while (Clock::now() < until)
+        {
+        }
+    }
+
+    void WaitFor(const std::atomic<size_t> &count, size_t target)
+    {
+        while (count.load() < target)
+            std::this_thread::yield();
+    }
+
+    // Urgent tasks that repost themselves for |duration|, each noting how long
+    // it waited, on top of a backlog of refresh tasks.
+    struct Fairness
+    {
+        std::vector<double> waitUs;
+        size_t refreshes = 0;
+        size_t urgent = 0;
+    };
+
+    Fairness Measure(size_t starvationLimit, std::chrono::milliseconds duration)
+    {
+        utils::TaskExecutor::Options options;
+        options.threads = 2;
+        options.starvationLimit = starvationLimit;
+        auto executor = std::make_unique<utils::TaskExecutor>(options);
+
+        std::mutex mutex;
+        Fairness result;
+        std::atomic<size_t> refreshes{0};
+        std::atomic<size_t> chains{0};
+        const Clock::time_point end = Clock::now() + duration;
+        for (int i = 0; i < 10000; ++i)
+            executor->Post(TaskPriority::Refresh, [&refreshes]() {
+                Spin(std::chrono::microseconds(20));
+                ++refreshes;
+            });
+
+        std::function<void(Clock::time_point)> urgent = [&](Clock::time_point posted) {
+            const Clock::time_point started = Clock::now();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                result.waitUs.push_back(UsBetween(posted, started));
+            }
+            Spin(std::chrono::microseconds(20));
+            if (Clock::now() < end)
+            {
+                const Clock::time_point now = Clock::now();
+                executor->Post(TaskPriority::Interactive, [&urgent, now]() { urgent(now); });
+            }
+            else
+            {
+                ++chains;
+            }
+        };
+        constexpr size_t kChains = 8;
+        for (size_t i = 0; i < kChains; ++i)
+        {
+            const Clock::time_point now = Clock::now();
+            executor->Post(TaskPriority::Interactive, [&urgent, now]() { urgent(now); });
+        }
+        WaitFor(chains, kChains);
+        result.refreshes = refreshes.load();
+        // Waits for the last chain to return; queued refreshes are dropped.
+        executor.reset();
+        result.urgent = result.waitUs.size();
+        return result;
+    }
+} // namespace
+
+// The cost of one task: posted from outside the pool (the injection queue),
+// from a worker (its own deque), and a Submit() round trip.
+TEST(ExecutorBench, Overhead)
+{
+    utils::TaskExecutor executor;
+    constexpr size_t kTasks = 200000;
+    std::atomic<size_t> done{0};
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < kTasks; ++i)
+        executor.Post(TaskPriority::Interactive, [&done]() { ++done; });
+    WaitFor(done, kTasks);
+    const double injectedNs = UsBetween(start, Clock::now()) * 1000 / kTasks;
+
+    done = 0;
+    start = Clock::now();
+    executor.Post(TaskPriority::Interactive, [&executor, &done]() {
+        for (size_t i = 0; i < kTasks; ++i)
+            executor.Post(TaskPriority::Interactive, [&done]() { ++done; });
+    });
+    WaitFor(done, kTasks);
+    const double ownNs = UsBetween(start, Clock::now()) * 1000 / kTasks;
+
+    std::vector<double> roundTripUs;
+    for (int i = 0; i < 2000; ++i)
+    {
+        const Clock::time_point posted = Clock::now();
+        executor.Submit(TaskPriority::Interactive, []() { return 1; }).get();
+        roundTripUs.push_back(UsBetween(posted, Clock::now()));
+    }
+    const utils::TaskExecutor::Stats stats = executor.GetStats();
+    std::printf("  %zu threads: %.0f ns per task injected, %.0f ns from a worker (%zu stolen); "
+                "Submit round trip p50 %.1f us, p99 %.1f us\n",
+                executor.ThreadCount(), injectedNs, ownNs, stats.stolen, Percentile(roundTripUs, 0.5),
+                Percentile(roundTripUs, 0.99));
+}
+
+// A steady stream of urgent tasks over a refresh backlog, with the default
+// starvation limit and with strict priorities: how many refresh tasks get
+// through, and what that costs the urgent tasks' queueing delay.
+TEST(ExecutorBench, PriorityFairness)
+{
+    const std::pair<const char *, size_t> runs[] = {{"limit 32", 32}, {"strict", SIZE_MAX}};
+    for (const auto &[label, limit] : runs)
+    {
+        const Fairness fairness = Measure(limit, std::chrono::milliseconds(300));
+        std::printf("  %-9s %6zu urgent, %5zu refresh tasks in 300 ms; urgent wait p50 %.1f us, p99 %.1f us\n",
+                    label, fairness.urgent, fairness.refreshes, Percentile(fairness.waitUs, 0.5),
+                    Percentile(fairness.waitUs, 0.99));
+    }
+}
@@ -0,0 +1,224 @@
+#include "Test.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TaskExecutor.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using utils::TaskPriority;
+
+    double MsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    bool WaitUntil(const std::function<bool()> &done)
+    {
+        const Clock::time_point deadline = Clock::now() + std::chrono::seconds(5);
+        while (!done())
+        {
+            if (Clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    utils::TaskExecutor::Options Threads(size_t threads)
+    {
+        utils::TaskExecutor::Options options;
+        options.threads = threads;
+        return options;
+    }
+
+    // The order tasks ran in.
+    struct Log
+    {
+        std::function<void()> Add(int id)
+        {
+            return [this, id]() {
+                std::lock_guard<std::mutex> lock(mutex);
+                ids.push_back(id);
+            };
+        }
+
+        size_t Size()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return ids.size();
+        }
+
+        std::mutex mutex;
+        std::vector<int> ids;
+    };
+
+    // Holds the executor's only worker until opened, so tasks can be queued
+    // behind it.
+    struct Gate
+    {
+        void Block(utils::TaskExecutor &executor)
+        {
+            executor.Post(TaskPriority::Interactive, [this]() {
+                entered = true;
+                while (!open)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            });
+            WaitUntil([this]() { return entered.load(); });
+        }
+
+        std::atomic<bool> entered{false};
+        std::atomic<bool> open{false};
+    };
+} // namespace
+
+// Queued work runs most urgent first, and in posting order within a priority.
+TEST(Executor, PrioritiesAreStrict)
+{
+    utils::TaskExecutor executor(Threads(1));
+    Gate gate;
+    gate.Block(executor);
+    Log log;
+    executor.Post(TaskPriority::Refresh, log.Add(30));
+    executor.Post(TaskPriority::VisibleIcons, log.Add(20));
+    executor.Post(TaskPriority::Refresh, log.Add(31));
+    executor.Post(TaskPriority::Interactive, log.Add(10));
+    executor.Post(TaskPriority::VisibleIcons, log.Add(21));
+    executor.Post(TaskPriority::Interactive, log.Add(11));
+    gate.open = true;
+    REQUIRE(WaitUntil([&log]() { return log.Size() == 6; }));
+    CHECK(log.ids == std::vector<int>({10, 11, 20, 21, 30, 31}));
+}
+
+// Past |starvationLimit| (32) urgent tasks in a row with a refresh waiting,
+// the refresh runs next; then the urgent stream resumes.
+TEST(Executor, StarvationLimitLetsRefreshThrough)
+{
+    utils::TaskExecutor executor(Threads(1));
+    Gate gate;
+    gate.Block(executor);
+    Log log;
+    executor.Post(TaskPriority::Refresh, log.Add(-1));
+    for (int i = 0; i < 100; ++i)
+        executor.Post(TaskPriority::Interactive, log.Add(i));
+    gate.open = true;
+    REQUIRE(WaitUntil([&log]() { return log.Size() == 101; }));
+
+    std::vector<int> expected;
+    for (int i = 0; i < 32; ++i)
+        expected.push_back(i);
+    expected.push_back(-1);
+    for (int i = 32; i < 100; ++i)
+        expected.push_back(i);
+    CHECK(log.ids == expected);
+    CHECK_EQ(executor.GetStats().aged, size_t(1));
+    CHECK_EQ(executor.GetStats().executed[0], size_t(101)); // With the gate
+    CHECK_EQ(executor.GetStats().executed[2], size_t(1));
+}
+
+// With nothing more urgent waiting the streak does not build up.
+TEST(Executor, StarvationNeedsWaitingWork)
+{
+    utils::TaskExecutor::Options options = Threads(1);
+    options.starvationLimit = 4;
+    utils::TaskExecutor executor(options);
+    Gate gate;
+    gate.Block(executor);
+    Log log;
+    for (int i = 0; i < 10; ++i)
+        executor.Post(TaskPriority::Interactive, log.Add(i));
+    executor.Post(TaskPriority::VisibleIcons, log.Add(-1));
+    gate.open = true;
+    REQUIRE(WaitUntil([&log]() { return log.Size() == 11; }));
+    CHECK(log.ids == std::vector<int>({0, 1, 2, 3, -1, 4, 5, 6, 7, 8, 9}));
+
+    // All urgent work: nothing is aged.
+    Log urgent;
+    for (int i = 0; i < 10; ++i)
+        executor.Post(TaskPriority::Interactive, urgent.Add(i));
+    REQUIRE(WaitUntil([&urgent]() { return urgent.Size() == 10; }));
+    CHECK_EQ(executor.GetStats().aged, size_t(1));
+}
+
+// A worker takes back what it posted newest-first.
+TEST(Executor, OwnDequeIsLastInFirstOut)
+{
+    utils::TaskExecutor executor(Threads(1));
+    Log log;
+    executor.Post(TaskPriority::Interactive, [&executor, &log]() {
+        for (int i = 0; i < 4; ++i)
+            executor.Post(TaskPriority::Interactive, log.Add(i));
+    });
+    REQUIRE(WaitUntil([&log]() { return log.Size() == 4; }));
+    CHECK(log.ids == std::vector<int>({3, 2, 1, 0}));
+    CHECK_EQ(executor.GetStats().stolen, size_t(0));
+}
+
+// Work posted by a busy worker is stolen oldest-first by an idle one.
+TEST(Executor, IdleWorkersSteal)
+{
+    utils::TaskExecutor executor(Threads(2));
+    Log log;
+    std::atomic<bool> posted{false};
+    std::thread::id owner;
+    std::vector<std::thread::id> ranOn(8);
+    executor.Post(TaskPriority::Interactive, [&]() {
+        owner = std::this_thread::get_id();
+        for (int i = 0; i < 8; ++i)
+        {
+            executor.Post(TaskPriority::Interactive, [&log, &ranOn, i]() {
+                ranOn[i] = std::this_thread::get_id();
+                log.Add(i)();
+            });
+        }
+        posted = true;
+        // Busy until the other worker has taken everything.
+        WaitUntil([&log]() { return log.Size() == 8; });
+    });
+    REQUIRE(WaitUntil([&log, &posted]() { return posted && log.Size() == 8; }));
+    CHECK(log.ids == std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7}));
+    CHECK_EQ(executor.GetStats().stolen, size_t(8));
+    for (const std::thread::id &id : ranOn)
+        CHECK(id != owner);
+}
+
+// Delayed tasks are queued in due order, never early.
+TEST(Executor, PostAfterRunsInDueOrder)
+{
+    utils::TaskExecutor executor(Threads(2));
+    Log log;
+    const Clock::time_point start = Clock::now();
+    std::atomic<double> firstAt{0};
+    executor.PostAfter(std::chrono::milliseconds(90), TaskPriority::Refresh, log.Add(90));
+    executor.PostAfter(std::chrono::milliseconds(30), TaskPriority::Refresh, [&]() {
+        firstAt = MsSince(start);
+        log.Add(30)();
+    });
+    executor.PostAfter(std::chrono::milliseconds(60), TaskPriority::Interactive, log.Add(60));
+    executor.PostAfter(std::chrono::milliseconds(0), TaskPriority::Refresh, log.Add(0));
+    REQUIRE(WaitUntil([&log]() { return log.Size() == 4; }));
+    CHECK(log.ids == std::vector<int>({0, 30, 60, 90}));
+    CHECK(firstAt >= 30.0);
+    CHECK(MsSince(start) >= 90.0);
+}
+
+// Delayed tasks not yet due when the executor goes are dropped, without the
+// destructor waiting for them.
+TEST(Executor, PendingDelaysAreDropped)
+{
+    auto ran = std::make_shared<std::atomic<bool>>(false);
+    const Clock::time_point start = Clock::now();
+    {
+        utils::TaskExecutor executor(Threads(1));
+        executor.PostAfter(std::chrono::hours(1), TaskPriority::Refresh, [ran]() { *ran = true; });
+    }
+    CHECK(MsSince(start) < 1000.0);
+    CHECK(!ran->load());
+}
@@ -0,0 +1,110 @@
+#ifndef NATIVE_UTILS_FAKE_REGISTRY_H
+#define NATIVE_UTILS_FAKE_REGISTRY_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "RegistryReader.h"
+
+namespace test
+{
+
+    /**
+     * @brief An in-memory registry for code written against utils::RegistryReader.
+     *
+     * @details Keys enumerate in name order. Counts the keys opened and values
+     *          read, which is what a scan against the real registry pays for.
+     */
+    class FakeRegistry : public utils::RegistryReader
+    {
+    public:
+        struct Node
+        {
+            int64_t lastWrite = 0;
+            std::map<std::wstring, std::wstring> strings;
+            std::map<std::wstring, uint32_t> dwords;
+            std::map<std::wstring, std::unique_ptr<Node>> children;
+
+            Node &Child(const std::wstring &name)
+            {
+                std::unique_ptr<Node> &child = children[name];
+                if (!child)
+                    child = std::make_unique<Node>();
+                return *child;
+            }
+        };
+
+        Node &Root(utils::RegistryHive hive, const std::wstring &path, utils::RegistryView view = utils::RegistryView::Native64)
+        {
+            return roots_[{hive, view, path}];
+        }
+
+        std::unique_ptr<utils::RegistryKey> Open(utils::RegistryHive hive, const std::wstring &path, utils::RegistryView view) const override
+        {
+            auto it = roots_.find({hive, view, path});
+            if (it == roots_.end())
+                return nullptr;
+            ++opens;
+            return std::make_unique<Key>(it->second, *this);
+        }
+
+        mutable size_t opens = 0;
+        mutable size_t valueReads = 0;
+
+    private:
+        class Key : public utils::RegistryKey
+        {
+        public:
+            Key(const Node &node, const FakeRegistry &registry) : node_(node), registry_(registry) {}
+
+            std::vector<utils::RegistrySubkey> Subkeys() const override
+            {
+                std::vector<utils::RegistrySubkey> subkeys;
+                for (const auto &[name, child] : node_.children)
+                    subkeys.push_back({name, child->lastWrite});
+                return subkeys;
+            }
+
+            std::unique_ptr<utils::RegistryKey> OpenSubkey(const std::wstring &name) const override
+            {
+                auto it = node_.children.find(name);
+                if (it == node_.children.end())
+                    return nullptr;
+                ++registry_.opens;
+                return std::make_unique<Key>(*it->second, registry_);
+            }
+
+            std::optional<std::wstring> StringValue(const wchar_t *name) const override
+            {
+                ++registry_.valueReads;
+                auto it = node_.strings.find(name);
+                if (it == node_.strings.end())
+                    return std::nullopt;
+                return it->second;
+            }
+
+            std::optional<uint32_t> DwordValue(const wchar_t *name) const override
+            {
+                ++registry_.valueReads;
+                auto it = node_.dwords.find(name);
+                if (it == node_.dwords.end())
+                    return std::nullopt;
+                return it->second;
+            }
+
+        private:
+            const Node &node_;
+            const FakeRegistry &registry_;
+        };
+
+        std::map<std::tuple<utils::RegistryHive, utils::RegistryView, std::wstring>, Node> roots_;
+    };
+
+} // namespace test
+
+#endif // NATIVE_UTILS_FAKE_REGISTRY_H
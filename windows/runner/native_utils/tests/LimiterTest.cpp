@@ -0,0 +1,138 @@
+#include "Test.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ConcurrencyLimiter.h"
+#include "TaskExecutor.h"
+
+namespace
+{
+    bool WaitFor(const std::function<bool()> &done)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!done())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+} // namespace
+
+// Never more than |limit| at once, however many are posted.
+TEST(Limiter, BoundsConcurrency)
+{
+    utils::TaskExecutor::Options options;
+    options.threads = 6;
+    utils::TaskExecutor executor(options);
+    utils::ConcurrencyLimiter limiter(2, executor);
+
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    std::atomic<int> finished{0};
+    for (int i = 0; i < 20; ++i)
+    {
+        limiter.Post(utils::TaskPriority::Interactive, [&]() {
+            const int now = ++running;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now))
+            {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            --running;
+            ++finished;
+        });
+    }
+    REQUIRE(WaitFor([&]() { return finished.load() == 20; }));
+    CHECK(peak.load() <= 2);
+    REQUIRE(WaitFor([&]() { return limiter.GetStats().running == 0; }));
+    const utils::ConcurrencyLimiter::Stats stats = limiter.GetStats();
+    CHECK_EQ(stats.admitted, 20u);
+    CHECK_EQ(stats.waited, 18u);
+    CHECK_EQ(stats.queued, 0u);
+}
+
+// Queued tasks start most urgent first, oldest first within a priority.
+TEST(Limiter, QueuedByPriority)
+{
+    utils::TaskExecutor executor;
+    utils::ConcurrencyLimiter limiter(1, executor);
+    std::atomic<bool> release{false};
+    std::mutex mutex;
+    std::vector<int> order;
+    limiter.Post(utils::TaskPriority::Interactive, [&]() {
+        while (!release.load())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    const utils::TaskPriority priorities[] = {utils::TaskPriority::Refresh, utils::TaskPriority::Interactive,
+                                              utils::TaskPriority::VisibleIcons, utils::TaskPriority::Interactive};
+    for (int i = 0; i < 4; ++i)
+    {
+        limiter.Post(priorities[i], [&, i]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(i);
+        });
+    }
+    release = true;
+    REQUIRE(WaitFor([&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return order.size() == 4;
+    }));
+    CHECK(order == std::vector<int>({1, 3, 2, 0}));
+}
+
+// A task that throws frees its slot; the worker and the queue carry on.
+TEST(Limiter, ThrowingTaskReleasesItsSlot)
+{
+    utils::TaskExecutor executor;
+    utils::ConcurrencyLimiter limiter(1, executor);
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 3; ++i)
+        limiter.Post(utils::TaskPriority::Interactive, []() { throw std::runtime_error("index unavailable"); });
+    limiter.Post(utils::TaskPriority::Interactive, [&]() { ++ran; });
+    REQUIRE(WaitFor([&]() { return ran.load() == 1; }));
+    REQUIRE(WaitFor([&]() { return limiter.GetStats().running == 0; }));
+    CHECK_EQ(limiter.GetStats().failed, 3u);
+
+    // Thrown straight on the executor, too.
+    executor.Post(utils::TaskPriority::Interactive, []() { throw 42; });
+    executor.Post(utils::TaskPriority::Interactive, [&]() { ++ran; });
+    REQUIRE(WaitFor([&]() { return ran.load() == 2; }));
+    CHECK(WaitFor([&]() { return executor.GetStats().failed == 1; })); // The limiter caught its own three
+}
+
+// Shutdown() waits for what runs, drops what waits, and refuses the rest.
+TEST(Limiter, ShutdownDrainsRunningTasks)
+{
+    utils::TaskExecutor executor;
+    utils::ConcurrencyLimiter limiter(1, executor);
+    std::atomic<bool> started{false};
+    std::atomic<bool> finished{false};
+    std::atomic<int> dropped{0};
+    limiter.Post(utils::TaskPriority::Interactive, [&]() {
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished = true;
+    });
+    limiter.Post(utils::TaskPriority::Interactive, [&]() { ++dropped; });
+    REQUIRE(WaitFor([&]() { return started.load(); }));
+    limiter.Shutdown();
+    CHECK(finished.load());
+    limiter.Post(utils::TaskPriority::Interactive, [&]() { ++dropped; });
+
+    std::atomic<bool> after{false};
+    executor.Post(utils::TaskPriority::Interactive, [&]() { after = true; });
+    REQUIRE(WaitFor([&]() { return after.load(); }));
+    CHECK_EQ(dropped.load(), 0);
+    const utils::ConcurrencyLimiter::Stats stats = limiter.GetStats();
+    CHECK_EQ(stats.running, 0u);
+    CHECK_EQ(stats.queued, 0u);
+    CHECK_EQ(stats.admitted, 1u);
+}
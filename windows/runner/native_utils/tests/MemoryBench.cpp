@@ -0,0 +1,148 @@
+#include "Test.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "SearchProviders.h"
+#include "VxSearchApi.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Resident set in MiB from /proc/self/statm; 0 where there is none.
+    double ResidentMiB()
+    {
+        std::ifstream statm("/proc/self/statm");
+        size_t pages = 0;
+        size_t resident = 0;
+        if (!(statm >> pages >> resident))
+            return 0;
+        return resident * 4096.0 / (1024 * 1024);
+    }
+
+    // Heap bytes in use; 0 where the allocator does not say.
+    size_t HeapInUse()
+    {
+#ifdef __GLIBC__
+        return mallinfo2().uordblks;
+#else
+        return 0;
+#endif
+    }
+
+    // A scan's worth of entries, each with an icon the size of a 32 px PNG in base64.
+    std::vector<utils::Program> ScannedPrograms(size_t count, char iconFill)
+    {
+        std::vector<utils::Program> programs;
+        programs.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            utils::Program program;
+            program.name = "Program " + std::to_string(i);
+            program.executablePath = "D:\\Programs\\Vendor " + std::to_string(i % 97) + "\\app" + std::to_string(i) + ".exe";
+            program.iconDataBase64.assign(3000, iconFill);
+            programs.push_back(std::move(program));
+        }
+        return programs;
+    }
+} // namespace
+
+// What trimming does for the steps that are not Windows-specific: catalog
+// generations retired while a search pinned them, and the heap pages their
+// icons held. The runner also drops the scan caches and the working set
+// (trimMemory), which only exist on Windows. Run on a Release build:
+//
+//   native_utils_bench MemoryBench
+TEST(MemoryBench, TrimWhileHidden)
+{
+    constexpr size_t kPrograms = 5000;
+    const double start = ResidentMiB();
+    auto catalog = std::make_shared<SearchEngine::ProgramCatalog>();
+    SearchEngine::CatalogProvider provider(catalog);
+    catalog->Publish(ScannedPrograms(kPrograms, 'a'));
+    const double steady = ResidentMiB();
+
+    // Refreshes land while a search is still reading an older generation.
+    {
+        SearchEngine::ProgramCatalog::ReadGuard pinned = catalog->Read();
+        for (char fill : {'b', 'c', 'd'})
+            catalog->Publish(ScannedPrograms(kPrograms, fill));
+    }
+    const double hidden = ResidentMiB();
+    Clock::time_point searchStart = Clock::now();
+    provider.Search("program 42", {});
+    const double searchBeforeMs = MsSince(searchStart);
+
+    Clock::time_point trimStart = Clock::now();
+    const size_t retired = catalog->Reclaim();
+    const double reclaimed = ResidentMiB();
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+    const double trimMs = MsSince(trimStart);
+    const double trimmed = ResidentMiB();
+
+    // Time to full responsiveness on the next show: the first search after the trim.
+    searchStart = Clock::now();
+    const size_t found = provider.Search("program 42", {}).size();
+    const double searchAfterMs = MsSince(searchStart);
+
+    std::printf("  RSS: start %.1f MiB, one generation %.1f MiB, hidden with retired generations %.1f MiB, "
+                "reclaimed %.1f MiB, heap trimmed %.1f MiB (%zu retired left, %.2f ms)\n",
+                start, steady, hidden, reclaimed, trimmed, retired, trimMs);
+    std::printf("  search \"program 42\" (%zu hits): before the trim %.3f ms, first after it %.3f ms\n", found,
+                searchBeforeMs, searchAfterMs);
+}
+
+// What the catalog costs now that it exists only natively: the heap one
+// generation takes, against what one dart:ffi search of the instant results
+// (50 rows) and one with no limit add on top of it, counting the bytes Dart
+// reads out of the rows. Run on a Release build:
+//
+//   native_utils_bench MemoryBench
+TEST(MemoryBench, CatalogFootprint)
+{
+    constexpr size_t kPrograms = 5000;
+    const size_t empty = HeapInUse();
+    auto catalog = std::make_shared<SearchEngine::ProgramCatalog>();
+    catalog->Publish(ScannedPrograms(kPrograms, 'a'));
+    const size_t generation = HeapInUse() - empty;
+    SearchEngine::PublishFfiCatalog(catalog, nullptr);
+    vx_catalog *handle = vx_catalog_open();
+    REQUIRE(handle != nullptr);
+
+    std::printf("  %zu entries: one catalog generation %.1f MiB of heap\n", kPrograms, generation / (1024.0 * 1024));
+    vx_results_free(vx_search(handle, "program", 7, 0)); // Grows this thread's query arena
+    for (uint32_t limit : {50u, 0u})
+    {
+        const size_t before = HeapInUse();
+        vx_results *results = vx_search(handle, "program", 7, limit);
+        const size_t held = HeapInUse() - before;
+        size_t read = 0;
+        for (uint32_t i = 0; i < vx_result_count(results); ++i)
+        {
+            const vx_result *row = vx_result_at(results, i);
+            for (const vx_str *field : {&row->name, &row->path, &row->args, &row->kind, &row->description, &row->icon})
+                read += field->size;
+        }
+        std::printf("  search, limit %2u: %4u rows, %7.1f KiB held natively, %8.1f KiB read by Dart\n", limit,
+                    vx_result_count(results), held / 1024.0, read / 1024.0);
+        vx_results_free(results);
+    }
+    vx_catalog_close(handle);
+    SearchEngine::PublishFfiCatalog(nullptr, nullptr);
+}
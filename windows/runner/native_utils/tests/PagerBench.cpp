@@ -0,0 +1,196 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ResultDiff.h"
+#include "ResultPager.h"
+#include "SearchProviders.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double UsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    }
+
+    // A file query's hits: documents with one of 50 icons the size of a 32 px
+    // PNG in Base64, a few programs among them.
+    std::vector<utils::Program> FileHits(size_t first, size_t count)
+    {
+        std::vector<utils::Program> hits;
+        for (size_t i = first; i < first + count; ++i)
+        {
+            utils::Program program;
+            program.name = "Quarterly report " + std::to_string(i);
+            program.executablePath = "C:\\Users\\me\\Documents\\Reports\\" + program.name + (i % 97 ? ".pdf" : ".exe");
+            program.kind = "file";
+            program.description = "Modified 2026-10-" + std::to_string(1 + i % 28);
+            program.iconDataBase64.assign(3000, static_cast<char>('A' + i % 50));
+            hits.push_back(std::move(program));
+        }
+        return hits;
+    }
+
+    // What the channel carries for a row: its strings plus the two 8-byte ids.
+    size_t RowBytes(const SearchEngine::ResultRow &row)
+    {
+        return row.name.size() + row.path.size() + row.args.size() + row.kind.size() + row.description.size() + 16;
+    }
+
+    // Installed programs with their icons, several sharing one image.
+    std::vector<utils::Program> InstalledPrograms(size_t count)
+    {
+        static const char *const kWords[] = {"Visual", "Studio", "Code", "Office", "Word", "Excel", "Paint",
+                                             "Terminal", "Steam", "Player", "Editor", "Manager", "Update",
+                                             "Setup", "Viewer", "Notes"};
+        std::vector<utils::Program> programs;
+        for (size_t i = 0; i < count; ++i)
+        {
+            utils::Program program;
+            program.name = std::string(kWords[i % 16]) + " " + kWords[(i / 16) % 16] + " " + std::to_string(i);
+            program.executablePath = "D:\\Programs\\Vendor " + std::to_string(i % 97) + "\\" + program.name + ".exe";
+            program.iconDataBase64.assign(3000, static_cast<char>('A' + i % 50));
+            programs.push_back(std::move(program));
+        }
+        return programs;
+    }
+
+    // What the channel carries for a view update: the rows it sends plus
+    // 4 bytes per patch index.
+    size_t UpdateBytes(const SearchEngine::ResultView::Update &update)
+    {
+        size_t bytes = 4 * (update.patch.removes.size() + update.patch.moves.size() + update.patch.inserts.size() +
+                            update.patch.updates.size());
+        for (const SearchEngine::ResultRow &row : update.inserted)
+            bytes += RowBytes(row);
+        for (const SearchEngine::ResultRow &row : update.updated)
+            bytes += RowBytes(row);
+        return bytes;
+    }
+
+    size_t ProgramBytes(const utils::Program &program)
+    {
+        return program.name.size() + program.executablePath.size() + program.arguments.size() + program.kind.size() +
+               program.description.size() + program.iconDataBase64.size() + 8;
+    }
+} // namespace
+
+// A 5,000-hit query arriving in 10 frames: the cost of ranking each frame
+// into the pager, and the bytes and time of a 40-row page (with the icons it
+// shows fetched separately) against sending every hit with its icon. Run on a
+// Release build:
+//
+//   native_utils_bench PagerBench
+TEST(PagerBench, BytesPerPage)
+{
+    constexpr size_t kHits = 5000;
+    constexpr size_t kFrames = 10;
+    constexpr size_t kPageRows = 40;
+    SearchEngine::ResultPager pager;
+    size_t everything = 0;
+    double appendUs = 0;
+    for (size_t frame = 0; frame < kFrames; ++frame)
+    {
+        // Later frames are the better matches: their names start with the query.
+        std::vector<utils::Program> hits = FileHits(frame * (kHits / kFrames), kHits / kFrames);
+        for (utils::Program &hit : hits)
+        {
+            if (frame == kFrames - 1)
+                hit.name = "Report " + hit.name;
+            everything += ProgramBytes(hit);
+        }
+        const Clock::time_point start = Clock::now();
+        pager.Append(1, "report", std::move(hits));
+        appendUs += UsSince(start);
+    }
+
+    std::vector<double> pageUs;
+    size_t pageBytes = 0;
+    size_t iconBytes = 0;
+    size_t pages = 0;
+    for (int round = 0; round < 20; ++round)
+    {
+        for (size_t first = 0; first < kHits; first += kPageRows)
+        {
+            const Clock::time_point start = Clock::now();
+            const std::vector<SearchEngine::ResultRow> rows = pager.Fetch(1, first, kPageRows);
+            pageUs.push_back(UsSince(start));
+            std::set<uint64_t> icons;
+            for (const SearchEngine::ResultRow &row : rows)
+            {
+                pageBytes += RowBytes(row);
+                if (row.iconId && icons.insert(row.iconId).second)
+                    iconBytes += pager.Icon(row.iconId)->size();
+            }
+            ++pages;
+        }
+    }
+    std::sort(pageUs.begin(), pageUs.end());
+    std::printf("  %zu hits in %zu frames: %.0f us per frame to rank into the pager\n", kHits, kFrames,
+                appendUs / kFrames);
+    std::printf("  %zu-row page: %.1f KiB of rows + %.1f KiB of icons, p50 %.1f us, p99 %.1f us; "
+                "every hit with its icon: %.1f KiB\n",
+                kPageRows, pageBytes / 1024.0 / pages, iconBytes / 1024.0 / pages, pageUs[pageUs.size() / 2],
+                pageUs[pageUs.size() * 99 / 100], everything / 1024.0);
+    const std::vector<SearchEngine::ResultRow> top = pager.Fetch(1, 0, 1);
+    std::printf("  first row: %s\n", top.empty() ? "(none)" : top[0].name.c_str());
+}
+
+// Replayed typing through the pager and the view, as the runner sends each
+// keystroke's first page: patch bytes and rows the UI rebuilds (inserted or
+// updated) per keystroke. The first run gives icons ids scoped to the keystroke's
+// session, as the pager once did, so every kept row with an icon differs; the
+// second uses the pager's content ids. Run on a Release build:
+//
+//   native_utils_bench PagerBench
+TEST(PagerBench, ReplayTyping)
+{
+    constexpr size_t kPageRows = 40;
+    auto catalog = std::make_shared<SearchEngine::ProgramCatalog>();
+    catalog->Publish(InstalledPrograms(3000));
+    SearchEngine::CatalogProvider provider(catalog);
+    const std::vector<std::string> sessions = {"visual studio code", "steam", "paint", "notes viewer 12",
+                                               "terminal", "excel", "update manager", "ed"};
+
+    for (bool sessionIds : {true, false})
+    {
+        SearchEngine::ResultPager pager;
+        SearchEngine::ResultView view;
+        int64_t seq = 0;
+        size_t bytes = 0;
+        size_t rebuilt = 0;
+        for (const std::string &session : sessions)
+        {
+            for (size_t length = 1; length <= session.size(); ++length)
+            {
+                const std::string query = session.substr(0, length);
+                ++seq;
+                pager.Append(seq, query, provider.Search(query, {}));
+                std::vector<SearchEngine::ResultRow> rows = pager.Fetch(seq, 0, kPageRows);
+                if (sessionIds)
+                {
+                    for (SearchEngine::ResultRow &row : rows)
+                        row.iconId = row.iconId ? (static_cast<uint64_t>(seq) << 32) | (row.iconId & 0xffff) : 0;
+                }
+                const std::optional<SearchEngine::ResultView::Update> update = view.Replace(seq, std::move(rows));
+                if (!update)
+                    continue;
+                bytes += UpdateBytes(*update);
+                rebuilt += update->inserted.size() + update->updated.size();
+            }
+            pager.CloseThrough(seq);
+            view.Reset();
+        }
+        std::printf("  %-18s %6.1f KiB of patch, %5.1f rows rebuilt per keystroke (%zu keystrokes)\n",
+                    sessionIds ? "session icon ids:" : "content icon ids:", bytes / 1024.0 / seq,
+                    double(rebuilt) / seq, static_cast<size_t>(seq));
+    }
+}
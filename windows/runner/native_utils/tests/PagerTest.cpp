@@ -0,0 +1,192 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "EntryId.h"
+#include "ResultPager.h"
+#include "ResultRank.h"
+#include "TextFold.h"
+
+namespace
+{
+    utils::Program Make(const std::string &name, const std::string &path, const std::string &icon = "")
+    {
+        utils::Program program;
+        program.name = name;
+        program.executablePath = path;
+        program.iconDataBase64 = icon;
+        return program;
+    }
+
+    template <typename... Programs>
+    std::vector<utils::Program> Batch(Programs &&...programs)
+    {
+        std::vector<utils::Program> batch;
+        (batch.push_back(std::move(programs)), ...);
+        return batch;
+    }
+
+    std::vector<uint64_t> Ids(const std::vector<SearchEngine::ResultRow> &rows)
+    {
+        std::vector<uint64_t> ids;
+        for (const SearchEngine::ResultRow &row : rows)
+            ids.push_back(row.id);
+        return ids;
+    }
+
+    // Results as the providers of a query might send them: documents, folders,
+    // shortcuts and programs, some matching by name and some by path only.
+    utils::Program RandomResult(std::mt19937 &random, size_t i)
+    {
+        const char *names[] = {"Report", "Paint", "Reports Viewer", "Annual report", "Notes", "report"};
+        const char *extensions[] = {".exe", ".lnk", ".pdf", ".txt", ".url", "\\"};
+        return Make(std::string(names[random() % 6]) + " " + std::to_string(random() % 50),
+                    "C:\\Users\\me\\report" + std::to_string(i) + extensions[random() % 6]);
+    }
+} // namespace
+
+// A batch that arrives late still puts its better rows on the first page:
+// the pager merges by rank instead of appending.
+TEST(Pager, LateBetterRowsLandOnTheFirstPage)
+{
+    SearchEngine::ResultPager pager;
+    std::vector<utils::Program> documents;
+    for (int i = 0; i < 30; ++i)
+        documents.push_back(Make("Report " + std::to_string(i), "C:\\Docs\\report" + std::to_string(i) + ".pdf"));
+    CHECK_EQ(pager.Append(1, "report", std::move(documents)), 30u);
+    const std::vector<SearchEngine::ResultRow> first = pager.Fetch(1, 0, 1);
+    REQUIRE(first.size() == 1);
+    CHECK_EQ(first[0].name, std::string("Report 0"));
+
+    CHECK_EQ(pager.Append(1, "report", Batch(Make("Annual report", "C:\\Apps\\annual.exe"),
+                                              Make("Report Studio", "C:\\Apps\\studio.exe"))),
+             32u);
+    const std::vector<SearchEngine::ResultRow> page = pager.Fetch(1, 0, 3);
+    REQUIRE(page.size() == 3);
+    CHECK_EQ(page[0].name, std::string("Report Studio")); // Program, name prefix
+    CHECK_EQ(page[1].name, std::string("Annual report")); // Program, name substring
+    CHECK_EQ(page[2].name, std::string("Report 0"));
+    const std::vector<SearchEngine::ResultRow> last = pager.Fetch(1, 31, 10);
+    REQUIRE(last.size() == 1);
+    CHECK_EQ(last[0].name, std::string("Report 9"));
+}
+
+// However the results are split into batches, every page is the slice of
+// the whole set sorted by RanksBefore().
+TEST(Pager, PagesMatchOneSortOfEverything)
+{
+    std::mt19937 random(7);
+    for (int round = 0; round < 20; ++round)
+    {
+        const std::string query = round % 2 ? "Report" : "re";
+        std::vector<utils::Program> all;
+        for (size_t i = 0; i < 300; ++i)
+        {
+            all.push_back(RandomResult(random, i));
+            utils::AssignEntryId(all.back());
+        }
+        const std::string folded = utils::FoldCase(query);
+        std::vector<const utils::Program *> sorted;
+        for (const utils::Program &program : all)
+            sorted.push_back(&program);
+        std::sort(sorted.begin(), sorted.end(), [&folded](const utils::Program *a, const utils::Program *b) {
+            return SearchEngine::RanksBefore(*a, SearchEngine::RankOf(*a, folded), *b, SearchEngine::RankOf(*b, folded));
+        });
+
+        SearchEngine::ResultPager pager;
+        std::vector<utils::Program> shuffled;
+        for (const utils::Program &program : all)
+            shuffled.push_back(Make(program.name, program.executablePath));
+        std::shuffle(shuffled.begin(), shuffled.end(), random);
+        for (size_t start = 0; start < shuffled.size();)
+        {
+            const size_t size = std::min<size_t>(1 + random() % 80, shuffled.size() - start);
+            std::vector<utils::Program> batch;
+            for (size_t i = start; i < start + size; ++i)
+                batch.push_back(std::move(shuffled[i]));
+            pager.Append(3, query, std::move(batch));
+            start += size;
+        }
+
+        for (size_t first : {0, 40, 280})
+        {
+            const std::vector<SearchEngine::ResultRow> page = pager.Fetch(3, first, 40);
+            std::vector<uint64_t> expected;
+            for (size_t i = first; i < std::min<size_t>(first + 40, sorted.size()); ++i)
+                expected.push_back(sorted[i]->id);
+            CHECK(Ids(page) == expected);
+        }
+    }
+}
+
+// An entry the session holds is not added again, and rows with the same
+// icon share one copy of it.
+TEST(Pager, DuplicatesAndSharedIcons)
+{
+    SearchEngine::ResultPager pager;
+    CHECK_EQ(pager.Append(1, "a", Batch(Make("App", "C:\\a.exe", "ICON"), Make("Also", "C:\\b.exe", "ICON"),
+                                         Make("Apex", "C:\\c.exe"))),
+             3u);
+    CHECK_EQ(pager.Append(1, "a", Batch(Make("App", "C:\\A.EXE", "ICON"))), 3u);
+
+    const std::vector<SearchEngine::ResultRow> rows = pager.Fetch(1, 0, 10);
+    REQUIRE(rows.size() == 3);
+    CHECK_EQ(rows[1].name, std::string("Apex")); // Also, Apex, App
+    CHECK_EQ(rows[1].iconId, 0u);
+    CHECK(rows[0].iconId != 0);
+    CHECK_EQ(rows[0].iconId, rows[2].iconId);
+    const std::optional<std::string> icon = pager.Icon(rows[0].iconId);
+    REQUIRE(icon.has_value());
+    CHECK_EQ(*icon, std::string("ICON"));
+    CHECK(pager.Fetch(1, 3, 10).empty());
+    CHECK(pager.Fetch(2, 0, 10).empty());
+}
+
+// Only the newest sessions are kept; closed and evicted sequence numbers take
+// no more rows.
+TEST(Pager, SessionsCloseAndEvict)
+{
+    SearchEngine::ResultPager pager(2);
+    pager.Append(1, "a", Batch(Make("A", "C:\\a.exe", "ICON")));
+    const uint64_t icon = pager.Fetch(1, 0, 1)[0].iconId;
+    pager.Append(2, "a", Batch(Make("A", "C:\\a.exe")));
+    pager.Append(3, "a", Batch(Make("A", "C:\\a.exe")));
+    CHECK(!pager.Count(1).has_value());
+    CHECK(!pager.Icon(icon).has_value());
+    CHECK_EQ(pager.Append(1, "a", Batch(Make("B", "C:\\b.exe"))), 0u);
+    CHECK(pager.Count(2) == std::optional<size_t>(1));
+
+    pager.CloseThrough(2);
+    CHECK(!pager.Count(2).has_value());
+    CHECK(pager.Count(3) == std::optional<size_t>(1));
+    CHECK_EQ(pager.Append(2, "a", Batch(Make("B", "C:\\b.exe"))), 0u);
+    CHECK_EQ(pager.Append(4, "a", Batch(Make("B", "C:\\b.exe"))), 1u);
+}
+
+// An icon's id is its content: the next keystroke's session gives the same
+// image the same id, and it stays fetchable while any session holds it.
+TEST(Pager, IconIdsFollowTheImage)
+{
+    SearchEngine::ResultPager pager(2);
+    pager.Append(1, "n",
+                 Batch(Make("Notepad", "C:\\notepad.exe", "NOTEPAD"), Make("Paint", "C:\\mspaint.exe", "PAINT")));
+    pager.Append(2, "no",
+                 Batch(Make("Notepad", "C:\\notepad.exe", "NOTEPAD"), Make("Notes", "C:\\notes.exe", "PAINT")));
+    const std::vector<SearchEngine::ResultRow> first = pager.Fetch(1, 0, 2);
+    const std::vector<SearchEngine::ResultRow> second = pager.Fetch(2, 0, 2);
+    REQUIRE(first.size() == 2 && second.size() == 2);
+    CHECK_EQ(first[0].iconId, second[0].iconId); // Notepad in both
+    CHECK_EQ(first[1].iconId, second[1].iconId); // Paint's image on Notes
+    CHECK(first[0].iconId != first[1].iconId);
+
+    pager.CloseThrough(1);
+    const std::optional<std::string> icon = pager.Icon(first[0].iconId);
+    REQUIRE(icon.has_value());
+    CHECK_EQ(*icon, std::string("NOTEPAD"));
+    pager.CloseThrough(2);
+    CHECK(!pager.Icon(first[0].iconId).has_value());
+}
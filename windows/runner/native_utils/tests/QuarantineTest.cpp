@@ -0,0 +1,121 @@
+#include "Test.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "QuarantineList.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    using Clock = utils::QuarantineList::Clock;
+    using std::chrono::minutes;
+
+    const Clock::time_point kNow = Clock::time_point(std::chrono::hours(24 * 365 * 50));
+
+    fs::path TempFile(const std::string &name)
+    {
+        const fs::path path = fs::temp_directory_path() / ("vxkonsol-" + name);
+        fs::remove(path);
+        return path;
+    }
+
+    std::string ReadAll(const fs::path &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+
+    utils::QuarantineList::Policy Policy()
+    {
+        utils::QuarantineList::Policy policy;
+        policy.base = minutes(15);
+        policy.cap = minutes(60);
+        return policy;
+    }
+} // namespace
+
+// One timeout is only a strike; from the second the item is skipped for
+// |base|, doubling per strike up to |cap|.
+TEST(Quarantine, BackoffDoublesUpToTheCap)
+{
+    utils::QuarantineList list(Policy());
+    CHECK(!list.RecordTimeout("Slow.lnk", false, kNow));
+    CHECK(!list.IsQuarantined("Slow.lnk", kNow));
+
+    CHECK(list.RecordTimeout("Slow.lnk", false, kNow));
+    CHECK(list.IsQuarantined("Slow.lnk", kNow + minutes(14)));
+    CHECK(!list.IsQuarantined("Slow.lnk", kNow + minutes(15)));
+
+    CHECK(list.RecordTimeout("Slow.lnk", false, kNow));
+    CHECK(list.IsQuarantined("Slow.lnk", kNow + minutes(29)));
+    CHECK(!list.IsQuarantined("Slow.lnk", kNow + minutes(30)));
+
+    for (int strike = 0; strike < 40; ++strike)
+        list.RecordTimeout("Slow.lnk", false, kNow);
+    CHECK(list.IsQuarantined("Slow.lnk", kNow + minutes(59)));
+    CHECK(!list.IsQuarantined("Slow.lnk", kNow + minutes(60)));
+}
+
+// A hang that had to be killed quarantines on the first strike; a success
+// releases the item at once.
+TEST(Quarantine, SevereAndRelease)
+{
+    utils::QuarantineList list(Policy());
+    CHECK(list.RecordTimeout("Hung.lnk", true, kNow));
+    CHECK(list.IsQuarantined("Hung.lnk", kNow));
+    CHECK(list.Quarantined(kNow) == std::vector<std::string>({"Hung.lnk"}));
+
+    list.RecordSuccess("Hung.lnk");
+    CHECK(!list.IsQuarantined("Hung.lnk", kNow));
+    CHECK(list.Quarantined(kNow).empty());
+
+    // Released items start over from one strike.
+    CHECK(!list.RecordTimeout("Hung.lnk", false, kNow));
+}
+
+// Quarantines survive a save and load, and expire by wall-clock time
+// afterwards.
+TEST(Quarantine, PersistsAcrossRestarts)
+{
+    const fs::path file = TempFile("quarantine.bin");
+    {
+        utils::QuarantineList list(Policy());
+        list.RecordTimeout("Hung.lnk", true, kNow);
+        list.RecordTimeout("Once.lnk", false, kNow);
+        REQUIRE(list.Save(file));
+    }
+    utils::QuarantineList loaded(Policy());
+    REQUIRE(loaded.Load(file));
+    CHECK(loaded.Quarantined(kNow) == std::vector<std::string>({"Hung.lnk"}));
+    CHECK(!loaded.IsQuarantined("Hung.lnk", kNow + minutes(15)));
+
+    // The strike count came back too: one more timeout quarantines Once.lnk.
+    CHECK(loaded.RecordTimeout("Once.lnk", false, kNow));
+    fs::remove(file);
+}
+
+// Saving an unchanged list writes nothing; a damaged file loads as empty.
+TEST(Quarantine, SaveOnlyWhenDirtyAndRejectDamage)
+{
+    const fs::path file = TempFile("quarantine-damaged.bin");
+    utils::QuarantineList list(Policy());
+    CHECK(list.Save(file));
+    CHECK(!fs::exists(file));
+
+    list.RecordTimeout("Hung.lnk", true, kNow);
+    REQUIRE(list.Save(file));
+    std::string data = ReadAll(file);
+    data[data.size() / 2] ^= 0x20;
+    std::ofstream(file, std::ios::binary | std::ios::trunc) << data;
+
+    utils::QuarantineList damaged(Policy());
+    CHECK(!damaged.Load(file));
+    CHECK(damaged.Quarantined(kNow).empty());
+    fs::remove(file);
+}
@@ -0,0 +1,169 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "EntryId.h"
+#include "ResultRank.h"
+#include "SearchProviders.h"
+#include "TextFold.h"
+
+namespace
+{
+    utils::Program Make(const std::string &name, const std::string &path, const std::string &description = "")
+    {
+        utils::Program program;
+        program.name = name;
+        program.executablePath = path;
+        program.description = description;
+        return program;
+    }
+
+    int Type(const std::string &name, const std::string &path)
+    {
+        return SearchEngine::RankOf(Make(name, path), "").type;
+    }
+
+    // A catalog where many entries share a name, a type and a relevance.
+    SearchEngine::ProgramCatalog::Snapshot RandomCatalog(size_t count, unsigned seed)
+    {
+        const char *words[] = {"Studio", "studio", "Code", "Reader", "Tools", "Stu", "Paint"};
+        const char *extensions[] = {".exe", ".lnk", ".url", ".pdf", ".bat", ""};
+        std::mt19937 random(seed);
+        auto programs = std::make_shared<std::vector<utils::Program>>();
+        for (size_t i = 0; i < count; ++i)
+        {
+            utils::Program program = Make(std::string(words[random() % 7]) + " " + words[random() % 7],
+                                          "C:\\Apps\\app" + std::to_string(i) + extensions[random() % 6],
+                                          random() % 3 == 0 ? "studio helper" : "");
+            program.id = utils::EntryId(program);
+            programs->push_back(std::move(program));
+        }
+        return programs;
+    }
+} // namespace
+
+// Type priorities follow SearchResultSorter._getTypePriority branch by branch.
+TEST(Rank, TypePriority)
+{
+    CHECK_EQ(Type("Settings", "explorer.exe"), 0);
+    CHECK_EQ(Type("Display", "C:\\Windows\\ImmersiveControlPanel\\SystemSettings.exe"), 0);
+    CHECK_EQ(Type("Files", "C:\\Windows\\EXPLORER.EXE"), 0);
+    CHECK_EQ(Type("Code", "C:\\Apps\\Code.EXE"), 1);
+    CHECK_EQ(Type("Setup", "D:\\setup.msi"), 1);
+    CHECK_EQ(Type("Code", "C:\\Start Menu\\Code.lnk"), 2);
+    CHECK_EQ(Type("Build", "C:\\build.cmd"), 3);
+    CHECK_EQ(Type("Command Prompt", "C:\\Start Menu\\cmd.url"), 3);
+    CHECK_EQ(Type("PowerShell", "C:\\Start Menu\\PowerShell.lnk"), 2);
+    CHECK_EQ(Type("Site", "C:\\Favorites\\site.url"), 4);
+    CHECK_EQ(Type("Projects", "C:\\Projects\\"), 5);
+    CHECK_EQ(Type("Report", "C:\\report.pdf"), 6);
+    CHECK_EQ(Type("Photo", "C:\\photo.jpeg"), 7);
+    CHECK_EQ(Type("Notes", "C:\\notes.md"), 8);
+    CHECK_EQ(Type("Archive", "C:\\backup.tar.gz"), 8);
+    CHECK_EQ(Type("Dotfile", "C:\\Users\\me\\.exe"), 99);
+    CHECK_EQ(Type("Dotted folder", "C:\\app.exe\\data"), 99);
+    CHECK_EQ(Type("Unknown", "C:\\data.bin"), 99);
+    CHECK_EQ(Type("Empty", ""), 99);
+}
+
+// Relevance: name prefix, then name substring, then description.
+TEST(Rank, Relevance)
+{
+    const utils::Program program = Make("Visual Studio Code", "C:\\code.exe", "Source code editor");
+    CHECK_EQ(SearchEngine::RankOf(program, "vis").relevance, 3);
+    CHECK_EQ(SearchEngine::RankOf(program, "studio").relevance, 2);
+    CHECK_EQ(SearchEngine::RankOf(program, "editor").relevance, 1);
+    CHECK_EQ(SearchEngine::RankOf(program, "code.exe").relevance, 0);
+    CHECK_EQ(SearchEngine::RankOf(program, "").relevance, 0);
+}
+
+// Type beats relevance, relevance beats the name, the name (ignoring case)
+// beats the entry id.
+TEST(Rank, Order)
+{
+    const auto before = [](const utils::Program &a, const utils::Program &b, const char *query) {
+        return SearchEngine::RanksBefore(a, SearchEngine::RankOf(a, query), b, SearchEngine::RankOf(b, query));
+    };
+    const utils::Program exe = Make("Zip Studio", "C:\\zip.exe");
+    const utils::Program lnk = Make("Studio", "C:\\studio.lnk");
+    CHECK(before(exe, lnk, "studio"));
+    CHECK(!before(lnk, exe, "studio"));
+
+    const utils::Program prefix = Make("Studio Z", "C:\\z.exe");
+    CHECK(before(prefix, exe, "studio"));
+
+    const utils::Program upper = Make("BETA", "C:\\b.exe");
+    const utils::Program lower = Make("alpha", "C:\\a.exe");
+    CHECK(before(lower, upper, "a"));
+
+    utils::Program first = Make("Same", "C:\\1.exe");
+    utils::Program second = Make("same", "C:\\2.exe");
+    first.id = 1;
+    second.id = 2;
+    CHECK(before(first, second, "s"));
+    CHECK(!before(second, first, "s"));
+    CHECK(!before(first, first, "s"));
+}
+
+// MatchCatalog's limit keeps the best matches of the whole catalog, not the
+// first ones it comes across, and in order.
+TEST(Rank, MatchCatalogKeepsTheBest)
+{
+    const SearchEngine::ProgramCatalog::Snapshot programs = RandomCatalog(2000, 11);
+    for (const char *query : {"stu", "studio", "code", "app1", "s"})
+    {
+        std::pmr::vector<size_t> all;
+        SearchEngine::MatchCatalog(programs, query, nullptr, {}, 0, all);
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < programs->size(); ++i)
+        {
+            const utils::Program &program = (*programs)[i];
+            if (utils::FoldCase(program.name).find(query) != std::string::npos ||
+                utils::FoldCase(program.executablePath).find(query) != std::string::npos)
+                expected.push_back(i);
+        }
+        std::sort(expected.begin(), expected.end(), [&programs, query](size_t a, size_t b) {
+            const utils::Program &x = (*programs)[a];
+            const utils::Program &y = (*programs)[b];
+            return SearchEngine::RanksBefore(x, SearchEngine::RankOf(x, query), y, SearchEngine::RankOf(y, query));
+        });
+        REQUIRE(expected.size() > 20);
+        CHECK(std::vector<size_t>(all.begin(), all.end()) == expected);
+
+        for (size_t limit : {1, 7, 50})
+        {
+            std::pmr::vector<size_t> best;
+            SearchEngine::MatchCatalog(programs, query, nullptr, {}, limit, best);
+            CHECK(std::vector<size_t>(best.begin(), best.end()) ==
+                  std::vector<size_t>(expected.begin(), expected.begin() + limit));
+        }
+    }
+}
+
+// The catalog provider hands back copies of the best |topK| only.
+TEST(Rank, CatalogProviderReturnsTheTopK)
+{
+    auto catalog = std::make_shared<SearchEngine::ProgramCatalog>();
+    const SearchEngine::ProgramCatalog::Snapshot random = RandomCatalog(500, 3);
+    std::vector<utils::Program> programs;
+    for (const utils::Program &program : *random)
+        programs.push_back(SearchEngine::CloneProgram(program));
+    catalog->Publish(std::move(programs));
+
+    SearchEngine::CatalogProvider all(catalog, nullptr, 0);
+    SearchEngine::CatalogProvider top(catalog, nullptr, 10);
+    const std::vector<utils::Program> every = all.Search("Studio", {});
+    const std::vector<utils::Program> best = top.Search("Studio", {});
+    REQUIRE(every.size() > 10);
+    REQUIRE(best.size() == 10);
+    for (size_t i = 0; i < best.size(); ++i)
+        CHECK_EQ(best[i].id, every[i].id);
+    const size_t defaultCount = SearchEngine::CatalogProvider(catalog).Search("Studio", {}).size();
+    const size_t expectedCount = std::min(every.size(), SearchEngine::CatalogProvider::kDefaultTopK);
+    CHECK_EQ(defaultCount, expectedCount);
+}
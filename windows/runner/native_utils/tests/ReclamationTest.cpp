@@ -0,0 +1,151 @@
+#include "Test.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EpochReclamation.h"
+#include "SearchProviders.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint64_t kAlive = 0x5AFE5AFE5AFE5AFEull;
+
+    std::atomic<int> liveNodes{0};
+
+    struct Node
+    {
+        explicit Node(uint64_t v) : value(v), check(v ^ kAlive) { ++liveNodes; }
+        ~Node()
+        {
+            check = 0; // A reader that still sees this node fails its check
+            --liveNodes;
+        }
+
+        uint64_t value;
+        uint64_t check;
+    };
+
+    // Runs |body(thread index)| on |count| threads until |duration| has passed.
+    template <typename Body>
+    void RunFor(std::chrono::milliseconds duration, int count, Body body)
+    {
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> threads;
+        for (int i = 0; i < count; ++i)
+            threads.emplace_back([&stop, &body, i]() {
+                while (!stop.load(std::memory_order_relaxed))
+                    body(i);
+            });
+        std::this_thread::sleep_for(duration);
+        stop = true;
+        for (std::thread &thread : threads)
+            thread.join();
+    }
+
+    // A generation whose every entry names it, so a reader can tell a torn or
+    // freed one from a whole one.
+    std::vector<utils::Program> MakeGeneration(uint64_t tag, size_t count)
+    {
+        std::vector<utils::Program> programs;
+        for (size_t i = 0; i < count; ++i)
+        {
+            utils::Program program;
+            program.name = "gen" + std::to_string(tag);
+            program.executablePath = "c:\\app" + std::to_string(i) + ".exe";
+            programs.push_back(std::move(program));
+        }
+        return programs;
+    }
+} // namespace
+
+// Readers pin and dereference while writers swap and retire; no reader may
+// ever see a reclaimed node, and every retired node is eventually freed.
+TEST(Reclamation, ReadersNeverSeeReclaimedNodes)
+{
+    {
+        utils::EpochDomain domain;
+        std::atomic<Node *> current{new Node(0)};
+        std::atomic<uint64_t> nextValue{1};
+        std::atomic<uint64_t> reads{0};
+        std::atomic<uint64_t> torn{0};
+
+        RunFor(std::chrono::milliseconds(500), 6, [&](int thread) {
+            if (thread < 2)
+            {
+                // Writers
+                Node *next = new Node(nextValue++);
+                Node *previous = current.exchange(next);
+                domain.Retire([previous]() { delete previous; });
+                if (thread == 0)
+                    domain.Collect();
+                return;
+            }
+            utils::EpochDomain::Guard pin = domain.Pin();
+            const Node *node = current.load();
+            for (int i = 0; i < 16; ++i)
+            {
+                if ((node->value ^ node->check) != kAlive)
+                    ++torn;
+            }
+            ++reads;
+        });
+
+        CHECK_EQ(torn.load(), 0u);
+        CHECK(reads.load() > 0);
+        CHECK_EQ(domain.Collect(), 0u);
+        CHECK_EQ(liveNodes.load(), 1);
+        delete current.load();
+    }
+    CHECK_EQ(liveNodes.load(), 0);
+}
+
+// The catalog under concurrent queries and refreshes: every read sees one
+// whole generation, and Reclaim() frees all retired ones once readers leave.
+TEST(Reclamation, CatalogQueriesDuringRefreshes)
+{
+    SearchEngine::ProgramCatalog catalog;
+    catalog.Publish(MakeGeneration(0, 200));
+    std::atomic<uint64_t> tag{1};
+    std::atomic<uint64_t> mixed{0};
+    std::atomic<uint64_t> queries{0};
+    std::atomic<uint64_t> publishes{0};
+
+    RunFor(std::chrono::milliseconds(500), 6, [&](int thread) {
+        if (thread < 2)
+        {
+            catalog.Publish(MakeGeneration(tag++, 200));
+            ++publishes;
+            return;
+        }
+        if (thread == 2)
+        {
+            // Snapshots outlive the read that took them.
+            SearchEngine::ProgramCatalog::Snapshot snapshot = catalog.Current();
+            if (snapshot->empty() || snapshot->front().name != snapshot->back().name)
+                ++mixed;
+            return;
+        }
+        SearchEngine::ProgramCatalog::ReadGuard generation = catalog.Read();
+        const std::vector<utils::Program> &programs = *generation->programs;
+        for (const utils::Program &program : programs)
+        {
+            if (program.name != programs.front().name)
+            {
+                ++mixed;
+                break;
+            }
+        }
+        ++queries;
+    });
+
+    CHECK_EQ(mixed.load(), 0u);
+    CHECK(queries.load() > 0);
+    CHECK(publishes.load() > 0);
+    CHECK_EQ(catalog.Reclaim(), 0u);
+}
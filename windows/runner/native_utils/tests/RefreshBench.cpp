@@ -0,0 +1,140 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "RefreshScheduler.h"
+#include "SearchProviders.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MsBetween(Clock::time_point from, Clock::time_point to)
+    {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    double Percentile(std::vector<double> values, double p)
+    {
+        std::sort(values.begin(), values.end());
+        return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+    }
+
+    // A rescan that keeps a core busy until cancelled.
+    void BusyRefresh(const utils::CancellationToken &token, std::atomic<uint64_t> &work)
+    {
+        uint64_t hash = 1469598103934665603ull;
+        while (!token.IsCancelled())
+        {
+            for (int i = 0; i < 10000; ++i)
+                hash = (hash ^ static_cast<uint64_t>(i)) * 1099511628211ull;
+            work += 1;
+        }
+        if (hash == 0)
+            std::printf(" ");
+    }
+
+    struct Latency
+    {
+        std::vector<double> queryMs;
+        uint64_t refreshWork = 0;
+    };
+
+    // Keystrokes every 15 ms, each a catalog search, timed from when the key
+    // was due so a late wake-up counts. |refresh| is none, or a refresh at
+    // normal or background priority running throughout.
+    Latency Measure(const SearchEngine::ProgramCatalog::Snapshot &programs, int refresh)
+    {
+        std::unique_ptr<SearchEngine::RefreshScheduler> scheduler;
+        std::atomic<uint64_t> work{0};
+        if (refresh != 0)
+        {
+            SearchEngine::RefreshScheduler::Options options;
+            options.resumeDelay = std::chrono::milliseconds(0);
+            options.backgroundPriority = refresh == 2;
+            scheduler = std::make_unique<SearchEngine::RefreshScheduler>(options);
+            scheduler->AddJob("scan", std::chrono::hours(1), [&work](const utils::CancellationToken &token) { BusyRefresh(token, work); });
+            scheduler->SetForeground(false);
+            scheduler->RunSoon("scan");
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+
+        const std::vector<std::string> queries = {"s", "st", "stu", "stud", "studi", "studio", "to", "too", "tool"};
+        Latency latency;
+        std::pmr::vector<size_t> indices;
+        Clock::time_point due = Clock::now();
+        for (int key = 0; key < 400; ++key)
+        {
+            due += std::chrono::milliseconds(15);
+            std::this_thread::sleep_until(due);
+            indices.clear();
+            SearchEngine::MatchCatalog(programs, queries[key % queries.size()], nullptr, {}, 0, indices);
+            latency.queryMs.push_back(MsBetween(due, Clock::now()));
+        }
+        latency.refreshWork = work;
+        scheduler.reset();
+        return latency;
+    }
+} // namespace
+
+// Foreground search latency while a CPU-bound refresh runs, with the worker
+// at normal priority against background priority. Also the time from the
+// palette showing to the running job returning.
+TEST(RefreshBench, ForegroundLatency)
+{
+    auto programs = std::make_shared<std::vector<utils::Program>>();
+    for (size_t i = 0; i < 3000; ++i)
+    {
+        utils::Program program;
+        program.name = "Application " + std::to_string(i) + (i % 7 == 0 ? " Studio" : " Tool");
+        program.executablePath = "C:\\Program Files\\Vendor " + std::to_string(i % 97) + "\\app" + std::to_string(i) + ".exe";
+        programs->push_back(std::move(program));
+    }
+    const SearchEngine::ProgramCatalog::Snapshot snapshot = programs;
+
+    const char *labels[] = {"no refresh", "normal priority", "background"};
+    for (int refresh = 0; refresh < 3; ++refresh)
+    {
+        const Latency latency = Measure(snapshot, refresh);
+        std::printf("  %-16s search p50 %.2f ms, p99 %.2f ms, max %.2f ms; refresh work %llu\n", labels[refresh],
+                    Percentile(latency.queryMs, 0.5), Percentile(latency.queryMs, 0.99), Percentile(latency.queryMs, 1.0),
+                    static_cast<unsigned long long>(latency.refreshWork));
+    }
+
+    std::vector<double> cancelMs;
+    SearchEngine::RefreshScheduler::Options options;
+    options.resumeDelay = std::chrono::milliseconds(0);
+    options.burst = 1000;
+    SearchEngine::RefreshScheduler scheduler(options);
+    std::atomic<uint64_t> work{0};
+    std::atomic<bool> running{false};
+    std::atomic<Clock::rep> returnedAt{0};
+    scheduler.AddJob("scan", std::chrono::hours(1), [&](const utils::CancellationToken &token) {
+        running = true;
+        BusyRefresh(token, work);
+        returnedAt = Clock::now().time_since_epoch().count();
+        running = false;
+    });
+    for (int run = 0; run < 20; ++run)
+    {
+        scheduler.SetForeground(false);
+        scheduler.RunSoon("scan");
+        while (!running)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        const Clock::time_point shown = Clock::now();
+        scheduler.SetForeground(true);
+        while (running)
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        cancelMs.push_back(MsBetween(shown, Clock::time_point(Clock::duration(returnedAt.load()))));
+    }
+    std::printf("  shown to refresh stopped: p50 %.2f ms, max %.2f ms\n", Percentile(cancelMs, 0.5), Percentile(cancelMs, 1.0));
+}
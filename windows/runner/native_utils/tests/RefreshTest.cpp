@@ -0,0 +1,166 @@
+#include "Test.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "RefreshScheduler.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    bool WaitUntil(const std::function<bool()> &done)
+    {
+        const Clock::time_point deadline = Clock::now() + std::chrono::seconds(5);
+        while (!done())
+        {
+            if (Clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    SearchEngine::RefreshScheduler::Options Quick()
+    {
+        SearchEngine::RefreshScheduler::Options options;
+        options.resumeDelay = std::chrono::milliseconds(0);
+        options.burst = 100;
+        options.refillInterval = std::chrono::milliseconds(10);
+        options.backgroundPriority = false;
+        return options;
+    }
+} // namespace
+
+// Nothing runs while the palette is up, nor until |resumeDelay| after it
+// goes away.
+TEST(Refresh, WaitsForTheBackground)
+{
+    SearchEngine::RefreshScheduler::Options options = Quick();
+    options.resumeDelay = std::chrono::milliseconds(80);
+    SearchEngine::RefreshScheduler scheduler(options);
+    std::atomic<int> runs{0};
+    scheduler.AddJob("scan", std::chrono::milliseconds(5), [&runs](const utils::CancellationToken &) { ++runs; });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    CHECK_EQ(runs.load(), 0);
+
+    const Clock::time_point hidden = Clock::now();
+    scheduler.SetForeground(false);
+    REQUIRE(WaitUntil([&runs]() { return runs > 0; }));
+    CHECK(MsSince(hidden) >= 75.0);
+
+    // Showing it again stops further runs.
+    scheduler.SetForeground(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const int shown = runs;
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    CHECK_EQ(runs.load(), shown);
+}
+
+// Showing the palette cancels the running job at once, and the job runs
+// again the next time the palette is hidden rather than a whole interval
+// later.
+TEST(Refresh, ShowingCancelsAndReruns)
+{
+    SearchEngine::RefreshScheduler scheduler(Quick());
+    std::atomic<int> started{0};
+    std::atomic<bool> returned{false};
+    scheduler.AddJob("scan", std::chrono::milliseconds(1), [&](const utils::CancellationToken &token) {
+        if (++started == 1)
+        {
+            while (!token.IsCancelled())
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            returned = true;
+        }
+    });
+    scheduler.SetForeground(false);
+    REQUIRE(WaitUntil([&started]() { return started > 0; }));
+
+    const Clock::time_point shown = Clock::now();
+    scheduler.SetForeground(true);
+    REQUIRE(WaitUntil([&returned]() { return returned.load(); }));
+    CHECK(MsSince(shown) < 50.0);
+    REQUIRE(WaitUntil([&scheduler]() { return scheduler.GetStats().cancelled == 1; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    CHECK_EQ(started.load(), 1);
+
+    scheduler.SetForeground(false);
+    REQUIRE(WaitUntil([&scheduler]() { return scheduler.GetStats().completed >= 1; }));
+}
+
+// A burst of due runs is cut to |burst|, then one per |refillInterval|.
+TEST(Refresh, TokenBucketLimitsRuns)
+{
+    SearchEngine::RefreshScheduler::Options options = Quick();
+    options.burst = 2;
+    options.refillInterval = std::chrono::milliseconds(300);
+    const Clock::time_point start = Clock::now();
+    SearchEngine::RefreshScheduler scheduler(options);
+    std::atomic<int> runs{0};
+    scheduler.AddJob("scan", std::chrono::milliseconds(1), [&runs](const utils::CancellationToken &) { ++runs; });
+    scheduler.SetForeground(false);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    CHECK_EQ(runs.load(), 2);
+    CHECK_EQ(scheduler.GetStats().throttled, size_t(1));
+    REQUIRE(WaitUntil([&runs]() { return runs >= 3; }));
+    CHECK(MsSince(start) >= 290.0);
+}
+
+// RunSoon() makes a job due without waiting out its interval.
+TEST(Refresh, RunSoonSkipsTheInterval)
+{
+    SearchEngine::RefreshScheduler scheduler(Quick());
+    std::atomic<int> scans{0};
+    std::atomic<int> validations{0};
+    scheduler.AddJob("scan", std::chrono::hours(1), [&scans](const utils::CancellationToken &) { ++scans; });
+    scheduler.AddJob("validate", std::chrono::hours(1), [&validations](const utils::CancellationToken &) { ++validations; });
+    scheduler.SetForeground(false);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    CHECK_EQ(scans.load(), 0);
+
+    scheduler.RunSoon("validate");
+    REQUIRE(WaitUntil([&validations]() { return validations > 0; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    CHECK_EQ(scans.load(), 0);
+    CHECK_EQ(validations.load(), 1);
+}
+
+// Jobs run on a worker in background priority; the caller's priority is
+// left alone.
+TEST(Refresh, WorkerRunsInBackgroundPriority)
+{
+#ifdef __linux__
+    SearchEngine::RefreshScheduler::Options options = Quick();
+    options.backgroundPriority = true;
+    SearchEngine::RefreshScheduler scheduler(options);
+    std::atomic<int> policy{-1};
+    std::atomic<int> nice{0};
+    scheduler.AddJob("scan", std::chrono::hours(1), [&](const utils::CancellationToken &) {
+        nice = getpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)));
+        policy = sched_getscheduler(0);
+    });
+    scheduler.SetForeground(false);
+    scheduler.RunSoon("scan");
+    REQUIRE(WaitUntil([&policy]() { return policy >= 0; }));
+    CHECK_EQ(policy.load(), SCHED_IDLE);
+    CHECK_EQ(nice.load(), 19);
+    CHECK_EQ(sched_getscheduler(0), SCHED_OTHER);
+#endif
+}
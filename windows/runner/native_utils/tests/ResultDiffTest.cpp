@@ -0,0 +1,214 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ResultDiff.h"
+
+namespace
+{
+    // Applies |patch| to |old| the way the Dart cubit does (_applyPatch).
+    // Returns nullopt where the Dart side would throw.
+    template <typename T>
+    std::optional<std::vector<T>> Apply(const std::vector<T> &old, const SearchEngine::ListPatch &patch,
+                                        const std::vector<T> &inserted, const std::vector<T> &updated)
+    {
+        if (inserted.size() != patch.inserts.size() || updated.size() != patch.updates.size() || patch.moves.size() % 2)
+            return std::nullopt;
+        const size_t length = old.size() - patch.removes.size() + patch.inserts.size();
+        std::vector<std::optional<T>> next(length);
+        std::vector<bool> taken(old.size(), false);
+        for (int32_t index : patch.removes)
+            taken[index] = true;
+        for (size_t k = 0; k < patch.moves.size(); k += 2)
+        {
+            next[patch.moves[k + 1]] = old[patch.moves[k]];
+            taken[patch.moves[k]] = true;
+        }
+        for (size_t k = 0; k < patch.inserts.size(); ++k)
+            next[patch.inserts[k]] = inserted[k];
+        size_t from = 0;
+        for (size_t i = 0; i < length; ++i)
+        {
+            if (next[i])
+                continue;
+            while (from < old.size() && taken[from])
+                ++from;
+            if (from == old.size())
+                return std::nullopt;
+            next[i] = old[from++];
+        }
+        for (size_t k = 0; k < patch.updates.size(); ++k)
+            next[patch.updates[k]] = updated[k];
+        std::vector<T> result;
+        for (auto &item : next)
+            result.push_back(*item);
+        return result;
+    }
+
+    SearchEngine::ResultRow Row(uint64_t id, const std::string &name = "")
+    {
+        SearchEngine::ResultRow row;
+        row.id = id;
+        row.name = name.empty() ? "App " + std::to_string(id) : name;
+        return row;
+    }
+
+    bool SameRows(const std::vector<SearchEngine::ResultRow> &a, const std::vector<SearchEngine::ResultRow> &b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].id != b[i].id || a[i].name != b[i].name || a[i].iconId != b[i].iconId)
+                return false;
+        }
+        return true;
+    }
+} // namespace
+
+// The patch between any two lists turns the first into the second, and moves
+// are minimal: a pure permutation moves n minus its longest ordered run.
+TEST(ResultDiff, PatchReproducesRandomLists)
+{
+    std::mt19937 rng(7);
+    for (int round = 0; round < 2000; ++round)
+    {
+        std::vector<uint64_t> pool(40);
+        std::iota(pool.begin(), pool.end(), 1);
+        std::shuffle(pool.begin(), pool.end(), rng);
+        std::vector<uint64_t> before(pool.begin(), pool.begin() + rng() % 25);
+        std::shuffle(pool.begin(), pool.end(), rng);
+        std::vector<uint64_t> after(pool.begin(), pool.begin() + rng() % 25);
+
+        const SearchEngine::ListPatch patch = SearchEngine::DiffLists(before, after);
+        std::vector<uint64_t> inserted;
+        for (int32_t index : patch.inserts)
+            inserted.push_back(after[index]);
+        CHECK(patch.updates.empty());
+        CHECK(std::is_sorted(patch.removes.begin(), patch.removes.end()));
+        CHECK(std::is_sorted(patch.inserts.begin(), patch.inserts.end()));
+        std::optional<std::vector<uint64_t>> result = Apply(before, patch, inserted, {});
+        REQUIRE(result.has_value());
+        if (*result != after)
+        {
+            CHECK(*result == after);
+            return;
+        }
+    }
+}
+
+TEST(ResultDiff, PermutationMovesAreMinimal)
+{
+    std::vector<uint64_t> ids(7);
+    std::iota(ids.begin(), ids.end(), 1);
+    const std::vector<uint64_t> before = ids;
+    do
+    {
+        const SearchEngine::ListPatch patch = SearchEngine::DiffLists(before, ids);
+        CHECK(patch.removes.empty());
+        CHECK(patch.inserts.empty());
+
+        // Longest increasing subsequence, by brute force over the small n.
+        size_t longest = 0;
+        for (uint32_t mask = 0; mask < (1u << ids.size()); ++mask)
+        {
+            uint64_t last = 0;
+            size_t length = 0;
+            bool increasing = true;
+            for (size_t i = 0; i < ids.size() && increasing; ++i)
+            {
+                if (!(mask & (1u << i)))
+                    continue;
+                increasing = ids[i] > last;
+                last = ids[i];
+                ++length;
+            }
+            if (increasing)
+                longest = std::max(longest, length);
+        }
+        CHECK_EQ(patch.moves.size() / 2, ids.size() - longest);
+        std::optional<std::vector<uint64_t>> result = Apply(before, patch, {}, {});
+        REQUIRE(result.has_value());
+        CHECK(*result == ids);
+    } while (std::next_permutation(ids.begin(), ids.end()));
+}
+
+// A row the new frame keeps but with other content is sent again in place;
+// unchanged ones are not.
+TEST(ResultDiff, ViewSendsChangedKeptRows)
+{
+    SearchEngine::ResultView view;
+    std::vector<SearchEngine::ResultRow> shown;
+    auto replace = [&](int64_t seq, std::vector<SearchEngine::ResultRow> rows) {
+        const std::vector<SearchEngine::ResultRow> expected = rows;
+        std::optional<SearchEngine::ResultView::Update> update = view.Replace(seq, std::move(rows));
+        REQUIRE(update.has_value());
+        std::optional<std::vector<SearchEngine::ResultRow>> next =
+            Apply(shown, update->patch, update->inserted, update->updated);
+        REQUIRE(next.has_value());
+        CHECK(SameRows(*next, expected));
+        shown = std::move(*next);
+        return *update;
+    };
+
+    replace(1, {Row(1), Row(2), Row(3)});
+    SearchEngine::ResultView::Update update = replace(2, {Row(3), Row(1, "Renamed"), Row(2)});
+    CHECK_EQ(update.patch.updates.size(), 1u);
+    CHECK_EQ(update.patch.updates[0], 1);
+    CHECK(update.inserted.empty());
+
+    SearchEngine::ResultRow withIcon = Row(2);
+    withIcon.iconId = 0x51c0; // Same row, its icon now loaded
+    update = replace(3, {Row(3), Row(1, "Renamed"), withIcon, Row(4)});
+    CHECK_EQ(update.patch.updates.size(), 1u);
+    CHECK_EQ(update.patch.inserts.size(), 1u);
+
+    update = replace(4, {Row(3), Row(1, "Renamed"), withIcon, Row(4)});
+    CHECK(update.patch.updates.empty());
+    CHECK(update.patch.moves.empty());
+
+    // Appended rows are what later Replace() calls compare against.
+    std::optional<SearchEngine::ResultView::Update> appended = view.Append(4, {Row(5)});
+    REQUIRE(appended.has_value());
+    shown.push_back(Row(5));
+    update = replace(5, {Row(5, "Changed"), Row(3)});
+    CHECK_EQ(update.patch.updates.size(), 1u);
+    CHECK_EQ(update.patch.updates[0], 0);
+}
+
+// Randomized: whatever the frames, the UI's list after each patch equals the
+// native one, content included.
+TEST(ResultDiff, ViewRoundTripsRandomFrames)
+{
+    std::mt19937 rng(11);
+    SearchEngine::ResultView view;
+    std::vector<SearchEngine::ResultRow> shown;
+    for (int64_t seq = 1; seq <= 500; ++seq)
+    {
+        std::vector<uint64_t> pool(30);
+        std::iota(pool.begin(), pool.end(), 1);
+        std::shuffle(pool.begin(), pool.end(), rng);
+        std::vector<SearchEngine::ResultRow> rows;
+        const size_t count = rng() % 20;
+        for (size_t i = 0; i < count; ++i)
+            rows.push_back(Row(pool[i], "App " + std::to_string(pool[i]) + (rng() % 4 == 0 ? "*" : "")));
+        const std::vector<SearchEngine::ResultRow> expected = rows;
+        std::optional<SearchEngine::ResultView::Update> update = view.Replace(seq, std::move(rows));
+        REQUIRE(update.has_value());
+        CHECK_EQ(update->base + 1, update->version);
+        std::optional<std::vector<SearchEngine::ResultRow>> next =
+            Apply(shown, update->patch, update->inserted, update->updated);
+        REQUIRE(next.has_value());
+        if (!SameRows(*next, expected))
+        {
+            CHECK(SameRows(*next, expected));
+            return;
+        }
+        shown = std::move(*next);
+    }
+}
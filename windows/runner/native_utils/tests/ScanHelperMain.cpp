@@ -0,0 +1,55 @@
+// The scanner helper the ScanSupervisor tests launch:
+//
+//   native_utils_scan_helper <channel> <item>...
+//
+// Items resolve to one program named after them, except that "hang:..." never
+// returns, "crash:..." kills the helper and "slow:..." is deferred.
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ScanSupervisor.h"
+
+namespace
+{
+    class FakeSource : public SearchEngine::ScanSource
+    {
+    public:
+        explicit FakeSource(std::vector<std::string> items) : items_(std::move(items)) {}
+
+        std::vector<std::string> Items() override { return items_; }
+
+        Resolution Resolve(const std::string &item) override
+        {
+            if (item.rfind("hang:", 0) == 0)
+            {
+                for (;;)
+                    std::this_thread::sleep_for(std::chrono::seconds(1));
+            }
+            if (item.rfind("crash:", 0) == 0)
+                std::abort();
+
+            Resolution resolution;
+            utils::Program program;
+            program.name = item;
+            program.executablePath = "C:\\Programs\\" + item + ".exe";
+            resolution.programs.push_back(std::move(program));
+            resolution.deferred = item.rfind("slow:", 0) == 0;
+            return resolution;
+        }
+
+    private:
+        std::vector<std::string> items_;
+    };
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+        return 2;
+    FakeSource source(std::vector<std::string>(argv + 2, argv + argc));
+    return SearchEngine::RunScanHelper(argv[1], source);
+}
@@ -0,0 +1,163 @@
+#include "Test.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "ChildProcess.h"
+#include "ScanSupervisor.h"
+
+// Runs tests/ScanHelperMain.cpp as the helper: NATIVE_UTILS_SCAN_HELPER is
+// its path, set by the build.
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    struct Launches
+    {
+        std::atomic<int> count{0};
+    };
+
+    SearchEngine::ScanSupervisor::Launcher Launcher(std::vector<std::string> items, std::shared_ptr<Launches> launches = nullptr)
+    {
+        return [items, launches](const std::string &channel) {
+            if (launches)
+                ++launches->count;
+            std::vector<std::string> argv = {NATIVE_UTILS_SCAN_HELPER, channel};
+            argv.insert(argv.end(), items.begin(), items.end());
+            return utils::ChildProcess::Spawn(argv);
+        };
+    }
+
+    SearchEngine::ScanSupervisor::Options Fast()
+    {
+        SearchEngine::ScanSupervisor::Options options;
+        options.itemDeadline = std::chrono::milliseconds(300);
+        options.dataRingBytes = 64 << 10;
+        return options;
+    }
+
+    std::vector<std::string> Names(const SearchEngine::ScanSupervisor::Result &result)
+    {
+        std::vector<std::string> names;
+        for (const utils::Program &program : result.programs)
+            names.push_back(program.name);
+        return names;
+    }
+} // namespace
+
+// A helper that gets through every item streams them back in order.
+TEST(ScanSupervisor, CompleteScan)
+{
+    SearchEngine::ScanSupervisor supervisor(Launcher({"a", "b", "c"}), Fast());
+    const SearchEngine::ScanSupervisor::Result result = supervisor.Scan();
+    CHECK(result.complete);
+    CHECK(Names(result) == std::vector<std::string>({"a", "b", "c"}));
+    CHECK(result.finished == std::vector<std::string>({"a", "b", "c"}));
+    CHECK_EQ(result.restarts, 0);
+    CHECK(result.hung.empty());
+}
+
+// An item that hangs is given |itemDeadline|, then the helper is killed and
+// a new one carries on from the next item without redoing the first.
+TEST(ScanSupervisor, HangingItemIsKilledAndSkipped)
+{
+    auto launches = std::make_shared<Launches>();
+    SearchEngine::ScanSupervisor supervisor(Launcher({"a", "hang:b", "c", "d"}, launches), Fast());
+    const Clock::time_point start = Clock::now();
+    const SearchEngine::ScanSupervisor::Result result = supervisor.Scan();
+    const double ms = MsSince(start);
+    CHECK(result.complete);
+    CHECK(Names(result) == std::vector<std::string>({"a", "c", "d"}));
+    CHECK(result.hung == std::vector<std::string>({"hang:b"}));
+    CHECK_EQ(result.restarts, 1);
+    CHECK_EQ(launches->count.load(), 2);
+    CHECK(ms >= 300.0);
+    CHECK(ms < 2000.0);
+}
+
+// A crash inside an item is noticed without waiting out the deadline.
+TEST(ScanSupervisor, CrashRestartsAtTheNextItem)
+{
+    SearchEngine::ScanSupervisor::Options options = Fast();
+    options.itemDeadline = std::chrono::seconds(10);
+    SearchEngine::ScanSupervisor supervisor(Launcher({"a", "crash:b", "c"}), options);
+    const Clock::time_point start = Clock::now();
+    const SearchEngine::ScanSupervisor::Result result = supervisor.Scan();
+    CHECK(result.complete);
+    CHECK(Names(result) == std::vector<std::string>({"a", "c"}));
+    CHECK(result.hung == std::vector<std::string>({"crash:b"}));
+    CHECK(MsSince(start) < 5000.0);
+}
+
+// Items the caller skips are never resolved; deferred items still count as
+// finished.
+TEST(ScanSupervisor, SkipsAndDeferrals)
+{
+    SearchEngine::ScanSupervisor supervisor(Launcher({"hang:quarantined", "a", "slow:b", "c"}), Fast());
+    const SearchEngine::ScanSupervisor::Result result = supervisor.Scan({"hang:quarantined"});
+    CHECK(result.complete);
+    CHECK(Names(result) == std::vector<std::string>({"a", "slow:b", "c"}));
+    CHECK(result.deferred == std::vector<std::string>({"slow:b"}));
+    CHECK(result.hung.empty());
+}
+
+// Past |maxRestarts| the scan gives up with what it has.
+TEST(ScanSupervisor, GivesUpAfterMaxRestarts)
+{
+    SearchEngine::ScanSupervisor::Options options = Fast();
+    options.maxRestarts = 1;
+    auto launches = std::make_shared<Launches>();
+    SearchEngine::ScanSupervisor supervisor(Launcher({"a", "crash:b", "crash:c", "d"}, launches), options);
+    const SearchEngine::ScanSupervisor::Result result = supervisor.Scan();
+    CHECK(!result.complete);
+    CHECK(Names(result) == std::vector<std::string>({"a"}));
+    CHECK(result.hung == std::vector<std::string>({"crash:b", "crash:c"}));
+    CHECK_EQ(result.restarts, 1);
+    CHECK_EQ(launches->count.load(), 2);
+}
+
+// Cancelling stops the scan without waiting for the hung item's deadline.
+TEST(ScanSupervisor, CancelStopsAHungScan)
+{
+    SearchEngine::ScanSupervisor::Options options = Fast();
+    options.itemDeadline = std::chrono::seconds(30);
+    SearchEngine::ScanSupervisor supervisor(Launcher({"a", "hang:b"}), options);
+    utils::CancellationSource source;
+    std::thread canceller([&source]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        source.Cancel();
+    });
+    const Clock::time_point start = Clock::now();
+    const SearchEngine::ScanSupervisor::Result result = supervisor.Scan(source.Token());
+    canceller.join();
+    CHECK(!result.complete);
+    CHECK(Names(result) == std::vector<std::string>({"a"}));
+    CHECK(MsSince(start) < 2000.0);
+}
+
+// A helper's exit code comes back; an executable that is not there does
+// not start.
+TEST(ScanSupervisor, ChildProcessExitCode)
+{
+    std::unique_ptr<utils::ChildProcess> bad = utils::ChildProcess::Spawn({NATIVE_UTILS_SCAN_HELPER});
+    REQUIRE(bad != nullptr);
+    const Clock::time_point start = Clock::now();
+    while (bad->IsRunning() && MsSince(start) < 5000.0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    CHECK(bad->ExitCode() == std::optional<int>(2)); // No channel given
+
+    std::unique_ptr<utils::ChildProcess> missing = utils::ChildProcess::Spawn({"/nonexistent/helper"});
+    CHECK(missing == nullptr);
+}
@@ -0,0 +1,141 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ProviderScheduler.h"
+#include "SearchProviders.h"
+#include "TaskExecutor.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MsBetween(Clock::time_point from, Clock::time_point to)
+    {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    double Percentile(std::vector<double> values, double p)
+    {
+        std::sort(values.begin(), values.end());
+        return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+    }
+
+    // Sleeps for a latency drawn per call: usually |fastMs|, one call in
+    // |slowEvery| |slowMs|.
+    class SleepingProvider : public SearchEngine::SearchProvider
+    {
+    public:
+        SleepingProvider(const char *name, int fastMs, int slowMs, int slowEvery, bool expensive)
+            : name_(name), fastMs_(fastMs), slowMs_(slowMs), slowEvery_(slowEvery), expensive_(expensive)
+        {
+        }
+
+        const char *Name() const override { return name_; }
+        bool IsExpensive() const override { return expensive_; }
+
+        std::vector<utils::Program> Search(const std::string &query, const utils::CancellationToken &token) override
+        {
+            int latencyMs;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                latencyMs = random_() % slowEvery_ == 0 ? slowMs_ : fastMs_;
+            }
+            const Clock::time_point until = Clock::now() + std::chrono::milliseconds(latencyMs);
+            while (Clock::now() < until && !token.IsCancelled())
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            utils::Program program;
+            program.name = query + " " + name_;
+            program.executablePath = std::string("C:\\") + name_ + "\\" + query + ".exe";
+            std::vector<utils::Program> results;
+            results.push_back(std::move(program));
+            return results;
+        }
+
+    private:
+        const char *name_;
+        int fastMs_;
+        int slowMs_;
+        int slowEvery_;
+        bool expensive_;
+        std::mutex mutex_;
+        std::mt19937 random_{7};
+    };
+} // namespace
+
+// Per-keystroke latency of the first and the final frame, with the real
+// catalog (3,000 entries) and settings providers, a cheap provider that is
+// slow one call in four, and an expensive index-like one.
+TEST(SchedulerBench, FrameLatency)
+{
+    auto catalog = std::make_shared<SearchEngine::ProgramCatalog>();
+    {
+        std::vector<utils::Program> programs;
+        for (size_t i = 0; i < 3000; ++i)
+        {
+            utils::Program program;
+            program.name = "Application " + std::to_string(i) + (i % 7 == 0 ? " Studio" : " Tool");
+            program.executablePath = "C:\\Program Files\\Vendor " + std::to_string(i % 97) + "\\app" +
+                                     std::to_string(i) + ".exe";
+            programs.push_back(std::move(program));
+        }
+        catalog->Publish(std::move(programs));
+    }
+
+    SearchEngine::SchedulerOptions options;
+    options.deadline = std::chrono::milliseconds(30);
+    options.speculativeDelay = std::chrono::milliseconds(40);
+    options.demoteAfterMisses = 1000; // Measure the deadline, not the demotion
+    utils::TaskExecutor executor;
+    SearchEngine::ProviderScheduler scheduler(options, executor);
+    scheduler.AddProvider(std::make_shared<SearchEngine::CatalogProvider>(catalog));
+    scheduler.AddProvider(std::make_shared<SearchEngine::SettingsPagesProvider>());
+    scheduler.AddProvider(std::make_shared<SleepingProvider>("uwp", 2, 80, 4, false));
+    scheduler.AddProvider(std::make_shared<SleepingProvider>("index", 60, 150, 5, true));
+
+    const std::vector<std::string> queries = {"s", "st", "stu", "stud", "studi", "studio", "a", "ap", "app",
+                                              "appl", "tool", "to", "t", "wi", "wif", "wifi", "dis", "disp"};
+    std::vector<double> firstMs;
+    std::vector<double> finalMs;
+    for (int run = 0; run < 120; ++run)
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        Clock::time_point first;
+        Clock::time_point last;
+        bool finished = false;
+        const Clock::time_point start = Clock::now();
+        scheduler.Run(run, queries[run % queries.size()], {}, [&](SearchEngine::SearchFrame &&frame) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (frame.index == 0)
+                first = Clock::now();
+            if (frame.isFinal)
+            {
+                last = Clock::now();
+                finished = true;
+                cv.notify_all();
+            }
+        });
+        std::unique_lock<std::mutex> lock(mutex);
+        REQUIRE(cv.wait_for(lock, std::chrono::seconds(10), [&finished]() { return finished; }));
+        firstMs.push_back(MsBetween(start, first));
+        finalMs.push_back(MsBetween(start, last));
+    }
+
+    std::printf("  first frame: p50 %.1f ms, p99 %.1f ms (deadline 30 ms)\n", Percentile(firstMs, 0.5),
+                Percentile(firstMs, 0.99));
+    std::printf("  final frame: p50 %.1f ms, p99 %.1f ms\n", Percentile(finalMs, 0.5), Percentile(finalMs, 0.99));
+    for (const SearchEngine::ProviderStats &stats : scheduler.Stats())
+        std::printf("  %-8s %4llu runs, %3llu late, average %.1f ms\n", stats.name.c_str(),
+                    static_cast<unsigned long long>(stats.runs), static_cast<unsigned long long>(stats.misses),
+                    stats.averageLatencyMs);
+}
@@ -0,0 +1,261 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "ProviderScheduler.h"
+#include "TaskExecutor.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MsBetween(Clock::time_point from, Clock::time_point to)
+    {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    // Answers after |latency| with |count| entries named after itself.
+    class FakeProvider : public SearchEngine::SearchProvider
+    {
+    public:
+        FakeProvider(const char *name, std::chrono::milliseconds latency, bool expensive = false, int count = 2)
+            : latencyMs(static_cast<int>(latency.count())), name_(name), expensive_(expensive), count_(count)
+        {
+        }
+
+        const char *Name() const override { return name_; }
+        bool IsExpensive() const override { return expensive_; }
+
+        std::vector<utils::Program> Search(const std::string &query, const utils::CancellationToken &token) override
+        {
+            ++calls;
+            const Clock::time_point until = Clock::now() + std::chrono::milliseconds(latencyMs.load());
+            while (Clock::now() < until && !token.IsCancelled())
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::vector<utils::Program> results;
+            for (int i = 0; i < count_; ++i)
+            {
+                utils::Program program;
+                program.name = query + " " + name_ + " " + std::to_string(i);
+                program.executablePath = std::string("C:\\") + name_ + "\\" + std::to_string(i) + ".exe";
+                results.push_back(std::move(program));
+            }
+            return results;
+        }
+
+        std::atomic<int> latencyMs;
+        std::atomic<int> calls{0};
+
+    private:
+        const char *name_;
+        bool expensive_;
+        int count_;
+    };
+
+    // The frames of one Run(), and when each arrived.
+    struct Recorder
+    {
+        struct Frame
+        {
+            SearchEngine::SearchFrame frame;
+            Clock::time_point at;
+        };
+
+        SearchEngine::ProviderScheduler::FrameCallback Callback()
+        {
+            return [this](SearchEngine::SearchFrame &&frame) {
+                std::lock_guard<std::mutex> lock(mutex);
+                const bool last = frame.isFinal;
+                frames.push_back({std::move(frame), Clock::now()});
+                if (last)
+                {
+                    finished = true;
+                    cv.notify_all();
+                }
+            };
+        }
+
+        bool WaitFinal()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            return cv.wait_for(lock, std::chrono::seconds(10), [this]() { return finished; });
+        }
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<Frame> frames;
+        bool finished = false;
+    };
+
+    bool HasProvider(const SearchEngine::SearchFrame &frame, const std::string &name)
+    {
+        return std::find(frame.providers.begin(), frame.providers.end(), name) != frame.providers.end();
+    }
+} // namespace
+
+// A slow provider misses the first frame, which goes at the deadline with the
+// fast one's results; the slow results follow as the final frame.
+TEST(Scheduler, FirstFrameMeetsDeadline)
+{
+    utils::TaskExecutor::Options executorOptions;
+    executorOptions.threads = 4;
+    utils::TaskExecutor executor(executorOptions);
+    SearchEngine::SchedulerOptions options;
+    options.deadline = std::chrono::milliseconds(30);
+    options.demoteAfterMisses = 1000; // Keep waiting for it in every run
+    SearchEngine::ProviderScheduler scheduler(options, executor);
+    scheduler.AddProvider(std::make_shared<FakeProvider>("fast", std::chrono::milliseconds(0)));
+    scheduler.AddProvider(std::make_shared<FakeProvider>("slow", std::chrono::milliseconds(120)));
+
+    std::vector<double> firstMs;
+    for (int run = 0; run < 10; ++run)
+    {
+        Recorder recorder;
+        const Clock::time_point start = Clock::now();
+        scheduler.Run(run, "q" + std::to_string(run), {}, recorder.Callback());
+        REQUIRE(recorder.WaitFinal());
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        REQUIRE(recorder.frames.size() == 2);
+        const SearchEngine::SearchFrame &first = recorder.frames[0].frame;
+        const SearchEngine::SearchFrame &last = recorder.frames[1].frame;
+        CHECK_EQ(first.index, 0);
+        CHECK(!first.isFinal);
+        CHECK(HasProvider(first, "fast"));
+        CHECK(!HasProvider(first, "slow"));
+        CHECK_EQ(first.items.size(), size_t(2));
+        CHECK_EQ(last.index, 1);
+        CHECK(last.isFinal);
+        CHECK(HasProvider(last, "slow"));
+        firstMs.push_back(MsBetween(start, recorder.frames[0].at));
+        CHECK(MsBetween(start, recorder.frames[1].at) >= 120.0);
+    }
+    std::sort(firstMs.begin(), firstMs.end());
+    std::printf("  first frame: min %.1f ms, max %.1f ms (deadline 30 ms)\n", firstMs.front(), firstMs.back());
+    CHECK(firstMs.front() >= 29.0);
+    CHECK(firstMs.back() < 30.0 + 40.0); // Timer and wake-up slack
+}
+
+// With every provider it waits for done, frame 0 goes before the deadline.
+TEST(Scheduler, FastProvidersDoNotWaitForTheDeadline)
+{
+    utils::TaskExecutor::Options executorOptions;
+    executorOptions.threads = 4;
+    utils::TaskExecutor executor(executorOptions);
+    SearchEngine::SchedulerOptions options;
+    options.deadline = std::chrono::milliseconds(500);
+    SearchEngine::ProviderScheduler scheduler(options, executor);
+    scheduler.AddProvider(std::make_shared<FakeProvider>("catalog", std::chrono::milliseconds(0)));
+    scheduler.AddProvider(std::make_shared<FakeProvider>("settings", std::chrono::milliseconds(2)));
+
+    Recorder recorder;
+    const Clock::time_point start = Clock::now();
+    scheduler.Run(1, "q", {}, recorder.Callback());
+    REQUIRE(recorder.WaitFinal());
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    REQUIRE(recorder.frames.size() == 1);
+    CHECK(recorder.frames[0].frame.isFinal);
+    CHECK_EQ(recorder.frames[0].frame.items.size(), size_t(4));
+    CHECK(MsBetween(start, recorder.frames[0].at) < 250.0);
+}
+
+// After |demoteAfterMisses| late runs the first frame stops waiting for the
+// slow provider, and on-time runs bring it back.
+TEST(Scheduler, LateProviderIsDemotedAndPromoted)
+{
+    utils::TaskExecutor::Options executorOptions;
+    executorOptions.threads = 4;
+    utils::TaskExecutor executor(executorOptions);
+    SearchEngine::SchedulerOptions options;
+    options.deadline = std::chrono::milliseconds(20);
+    options.demoteAfterMisses = 2;
+    options.promoteAfterHits = 2;
+    SearchEngine::ProviderScheduler scheduler(options, executor);
+    scheduler.AddProvider(std::make_shared<FakeProvider>("fast", std::chrono::milliseconds(0)));
+    auto slow = std::make_shared<FakeProvider>("slow", std::chrono::milliseconds(60));
+    scheduler.AddProvider(slow);
+
+    for (int run = 0; run < 2; ++run)
+    {
+        Recorder recorder;
+        scheduler.Run(run, "q", {}, recorder.Callback());
+        REQUIRE(recorder.WaitFinal());
+    }
+    std::vector<SearchEngine::ProviderStats> stats = scheduler.Stats();
+    REQUIRE(stats.size() == 2);
+    CHECK(!stats[0].demoted);
+    CHECK(stats[1].demoted);
+    CHECK_EQ(stats[1].misses, uint64_t(2));
+
+    // Demoted: frame 0 goes as soon as the fast provider is done.
+    Recorder recorder;
+    const Clock::time_point start = Clock::now();
+    scheduler.Run(2, "q", {}, recorder.Callback());
+    REQUIRE(recorder.WaitFinal());
+    {
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        REQUIRE(recorder.frames.size() == 2);
+        CHECK(MsBetween(start, recorder.frames[0].at) < 20.0);
+        CHECK(!HasProvider(recorder.frames[0].frame, "slow"));
+    }
+
+    // Quick again: waited for once more after |promoteAfterHits| runs.
+    slow->latencyMs = 0;
+    for (int run = 3; run < 5; ++run)
+    {
+        Recorder quick;
+        scheduler.Run(run, "q", {}, quick.Callback());
+        REQUIRE(quick.WaitFinal());
+    }
+    CHECK(!scheduler.Stats()[1].demoted);
+}
+
+// An expensive provider starts only after the speculative delay, is never
+// waited for, and a query cancelled within the delay never starts it.
+TEST(Scheduler, ExpensiveProviderStartsSpeculatively)
+{
+    utils::TaskExecutor::Options executorOptions;
+    executorOptions.threads = 4;
+    utils::TaskExecutor executor(executorOptions);
+    SearchEngine::SchedulerOptions options;
+    options.deadline = std::chrono::milliseconds(200);
+    options.speculativeDelay = std::chrono::milliseconds(40);
+    SearchEngine::ProviderScheduler scheduler(options, executor);
+    auto index = std::make_shared<FakeProvider>("index", std::chrono::milliseconds(10), true);
+    scheduler.AddProvider(std::make_shared<FakeProvider>("catalog", std::chrono::milliseconds(0)));
+    scheduler.AddProvider(index);
+
+    Recorder recorder;
+    const Clock::time_point start = Clock::now();
+    scheduler.Run(1, "q", {}, recorder.Callback());
+    REQUIRE(recorder.WaitFinal());
+    {
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        REQUIRE(recorder.frames.size() == 2);
+        CHECK(MsBetween(start, recorder.frames[0].at) < 40.0);
+        CHECK(HasProvider(recorder.frames[1].frame, "index"));
+        CHECK(MsBetween(start, recorder.frames[1].at) >= 50.0);
+    }
+    CHECK_EQ(index->calls.load(), 1);
+
+    // Superseded by the next keystroke within the delay.
+    utils::CancellationSource source;
+    std::atomic<int> framesFromIndex{0};
+    scheduler.Run(2, "qu", source.Token(), [&framesFromIndex](SearchEngine::SearchFrame &&frame) {
+        if (HasProvider(frame, "index"))
+            ++framesFromIndex;
+    });
+    source.Cancel();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CHECK_EQ(index->calls.load(), 1);
+    CHECK_EQ(framesFromIndex.load(), 0);
+}
@@ -0,0 +1,90 @@
+#include "Test.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "SettingsPages.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double NsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    char Fold(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    bool ContainsFolded(std::string_view text, std::string_view needle)
+    {
+        for (size_t i = 0; i + needle.size() <= text.size(); ++i)
+        {
+            size_t j = 0;
+            while (j < needle.size() && Fold(text[i + j]) == Fold(needle[j]))
+                ++j;
+            if (j == needle.size())
+                return true;
+        }
+        return false;
+    }
+
+    // The lookup the index replaces: every field of every page searched for the query.
+    size_t ScanSettingsPages(std::string_view query, uint16_t *out)
+    {
+        while (!query.empty() && query.back() == ' ')
+            query.remove_suffix(1);
+        size_t count = 0;
+        for (size_t i = 0; i < kSettingsPageCount; ++i)
+        {
+            const SettingsPage &page = kSettingsPages[i];
+            if (ContainsFolded(page.name, query) || ContainsFolded(page.description, query) ||
+                ContainsFolded(page.uri, query) || ContainsFolded(page.keywords, query))
+                out[count++] = static_cast<uint16_t>(i);
+        }
+        return count;
+    }
+
+    template <typename Lookup>
+    double NsPerLookup(const std::vector<std::string> &queries, Lookup lookup, size_t &hits)
+    {
+        constexpr int kRounds = 2000;
+        uint16_t out[kSettingsPageCount];
+        const Clock::time_point start = Clock::now();
+        for (int round = 0; round < kRounds; ++round)
+        {
+            for (const std::string &query : queries)
+                hits += lookup(query, out);
+        }
+        return NsSince(start) / (kRounds * queries.size());
+    }
+} // namespace
+
+// FindSettingsPages() per query: whole words through the perfect hash, words
+// still being typed through the sorted table, and misses, against a scan of
+// every page.
+TEST(SettingsPagesBench, Lookup)
+{
+    const std::vector<std::pair<const char *, std::vector<std::string>>> sets = {
+        {"whole words", {"bluetooth ", "display ", "wifi ", "sound ", "mouse ", "privacy camera "}},
+        {"typing", {"b", "bl", "blu", "blue", "d", "di", "dis", "disp"}},
+        {"misses", {"qzx ", "zzzq ", "steamapps ", "chrome "}},
+    };
+    for (const auto &[label, queries] : sets)
+    {
+        size_t hits = 0, scanHits = 0;
+        const double indexed = NsPerLookup(queries, [](std::string_view query, uint16_t *out) {
+            return FindSettingsPages(query, out, kSettingsPageCount);
+        }, hits);
+        const double scanned = NsPerLookup(queries, ScanSettingsPages, scanHits);
+        std::printf("  %-12s %7.0f ns per lookup against a scan's %7.0f ns (%zu pages; %zu against %zu hits)\n", label,
+                    indexed, scanned, kSettingsPageCount, hits, scanHits);
+    }
+}
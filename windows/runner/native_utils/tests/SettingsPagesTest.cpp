@@ -0,0 +1,216 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "SettingsPages.h"
+
+namespace
+{
+    constexpr std::string_view kUriPrefix = "ms-settings:";
+
+    std::string Folded(std::string_view text)
+    {
+        std::string folded(text);
+        for (char &c : folded)
+        {
+            if (c >= 'A' && c <= 'Z')
+                c = static_cast<char>(c - 'A' + 'a');
+        }
+        return folded;
+    }
+
+    bool IsWordChar(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || static_cast<unsigned char>(c) >= 0x80;
+    }
+
+    std::vector<std::string> Split(std::string_view text)
+    {
+        std::vector<std::string> words;
+        size_t pos = 0;
+        while (pos < text.size())
+        {
+            if (!IsWordChar(text[pos]))
+            {
+                ++pos;
+                continue;
+            }
+            size_t end = pos;
+            while (end < text.size() && IsWordChar(text[end]))
+                ++end;
+            words.push_back(Folded(text.substr(pos, end - pos)));
+            pos = end;
+        }
+        return words;
+    }
+
+    // The folded words of each page, and of its name alone, by a plain scan.
+    struct PageWords
+    {
+        std::set<std::string> all;
+        std::set<std::string> name;
+    };
+
+    std::vector<PageWords> AllPageWords()
+    {
+        std::vector<PageWords> pages(kSettingsPageCount);
+        for (size_t i = 0; i < kSettingsPageCount; ++i)
+        {
+            const SettingsPage &page = kSettingsPages[i];
+            for (std::string_view field : {page.name, page.description, page.uri.substr(kUriPrefix.size()), page.keywords})
+            {
+                for (std::string &word : Split(field))
+                    pages[i].all.insert(std::move(word));
+            }
+            for (std::string &word : Split(page.name))
+                pages[i].name.insert(std::move(word));
+        }
+        return pages;
+    }
+
+    // What FindSettingsPages() should return for a one-word query: an exact
+    // word when |exact|, otherwise a prefix, ordered by tier then table order.
+    std::vector<uint16_t> Expected(const std::vector<PageWords> &pages, const std::string &word, bool exact)
+    {
+        const auto matches = [&word, exact](const std::set<std::string> &words) {
+            if (exact)
+                return words.count(word) != 0;
+            auto it = words.lower_bound(word);
+            return it != words.end() && it->compare(0, word.size(), word) == 0;
+        };
+        std::vector<uint16_t> tiers[3];
+        for (size_t i = 0; i < pages.size(); ++i)
+        {
+            if (!matches(pages[i].all))
+                continue;
+            const bool prefixOfName = Folded(kSettingsPages[i].name).compare(0, word.size(), word) == 0;
+            tiers[prefixOfName ? 0 : (matches(pages[i].name) ? 1 : 2)].push_back(static_cast<uint16_t>(i));
+        }
+        std::vector<uint16_t> expected;
+        for (const std::vector<uint16_t> &tier : tiers)
+            expected.insert(expected.end(), tier.begin(), tier.end());
+        return expected;
+    }
+
+    std::vector<uint16_t> Find(std::string_view query, size_t capacity = kSettingsPageCount)
+    {
+        std::vector<uint16_t> hits(kSettingsPageCount);
+        hits.resize(FindSettingsPages(query, hits.data(), std::min(capacity, hits.size())));
+        return hits;
+    }
+
+    std::string Upper(std::string text)
+    {
+        for (char &c : text)
+        {
+            if (c >= 'a' && c <= 'z')
+                c = static_cast<char>(c - 'a' + 'A');
+        }
+        return text;
+    }
+} // namespace
+
+// Every word of every page goes through the perfect hash to exactly the
+// pages a plain scan finds, in either case.
+TEST(SettingsPages, EveryWordResolves)
+{
+    const std::vector<PageWords> pages = AllPageWords();
+    std::set<std::string> words;
+    for (const PageWords &page : pages)
+        words.insert(page.all.begin(), page.all.end());
+    REQUIRE(words.size() > 100);
+
+    for (const std::string &word : words)
+    {
+        const std::vector<uint16_t> expected = Expected(pages, word, true);
+        REQUIRE(!expected.empty());
+        CHECK(Find(word + " ") == expected);
+        CHECK(Find(Upper(word) + " ") == expected);
+    }
+}
+
+// Words that are on no page find nothing, however close their hash: random
+// strings, and proper prefixes of page words once a separator ends them.
+TEST(SettingsPages, MissesReturnNothing)
+{
+    const std::vector<PageWords> pages = AllPageWords();
+    std::set<std::string> words;
+    for (const PageWords &page : pages)
+        words.insert(page.all.begin(), page.all.end());
+
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<int> length(1, 10);
+    size_t misses = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        std::string word(static_cast<size_t>(length(random)), ' ');
+        for (char &c : word)
+            c = static_cast<char>(letter(random));
+        if (words.count(word) != 0)
+            continue;
+        ++misses;
+        CHECK(Find(word + " ").empty());
+    }
+    CHECK(misses > 19000);
+
+    for (const std::string &word : words)
+    {
+        for (size_t length = 1; length < word.size(); ++length)
+        {
+            const std::string prefix = word.substr(0, length);
+            if (words.count(prefix) == 0)
+                CHECK(Find(prefix + " ").empty());
+        }
+    }
+
+    CHECK(Find("").empty());
+    CHECK(Find("  -- ").empty());
+    CHECK(Find("bluetooth zzzq ").empty());
+}
+
+// The last word may still be being typed, so it matches as a prefix.
+TEST(SettingsPages, LastWordIsAPrefix)
+{
+    const std::vector<PageWords> pages = AllPageWords();
+    std::set<std::string> prefixes;
+    for (const PageWords &page : pages)
+    {
+        for (const std::string &word : page.all)
+        {
+            for (size_t length = 1; length <= std::min<size_t>(word.size(), 4); ++length)
+                prefixes.insert(word.substr(0, length));
+        }
+    }
+    for (const std::string &prefix : prefixes)
+        CHECK(Find(prefix) == Expected(pages, prefix, false));
+}
+
+// Each word narrows the result, and a page's own name finds it.
+TEST(SettingsPages, WordsIntersect)
+{
+    const std::vector<PageWords> pages = AllPageWords();
+    for (size_t i = 0; i < kSettingsPageCount; ++i)
+    {
+        const std::vector<uint16_t> hits = Find(kSettingsPages[i].name);
+        CHECK(std::find(hits.begin(), hits.end(), static_cast<uint16_t>(i)) != hits.end());
+        for (uint16_t hit : hits)
+        {
+            for (const std::string &word : Split(kSettingsPages[i].name))
+            {
+                const auto it = pages[hit].all.lower_bound(word);
+                CHECK(it != pages[hit].all.end() && it->compare(0, word.size(), word) == 0);
+            }
+        }
+    }
+
+    const std::vector<uint16_t> all = Find("display");
+    REQUIRE(all.size() > 1);
+    CHECK(Find("display", 1) == std::vector<uint16_t>({all[0]}));
+}
@@ -0,0 +1,137 @@
+#include "Test.h"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "ShmRing.h"
+
+namespace
+{
+    // Page-aligned like a mapping, so the header's padding does its job.
+    struct Memory
+    {
+        explicit Memory(size_t size) : bytes(size), storage(new uint64_t[(size + 4095) / 8 + 512]())
+        {
+            const uintptr_t raw = reinterpret_cast<uintptr_t>(storage.get());
+            data = reinterpret_cast<void *>((raw + 4095) & ~uintptr_t{4095});
+        }
+
+        size_t bytes;
+        std::unique_ptr<uint64_t[]> storage;
+        void *data;
+    };
+
+    std::string Record(uint32_t serial, size_t size)
+    {
+        std::string record(size, '\0');
+        for (size_t i = 0; i < size; ++i)
+            record[i] = static_cast<char>((serial * 131 + i) & 0xFF);
+        return record;
+    }
+} // namespace
+
+TEST(ShmRing, FormatAttachAndLimits)
+{
+    Memory memory(utils::ShmRing::RequiredBytes(64));
+    utils::ShmRing producer = utils::ShmRing::Format(memory.data, memory.bytes);
+    REQUIRE(producer.IsValid());
+    CHECK_EQ(producer.Capacity(), 64u);
+    utils::ShmRing consumer = utils::ShmRing::Attach(memory.data, memory.bytes);
+    REQUIRE(consumer.IsValid());
+
+    Memory blank(utils::ShmRing::RequiredBytes(64));
+    CHECK(!utils::ShmRing::Attach(blank.data, blank.bytes).IsValid()); // Never formatted
+    CHECK(!utils::ShmRing::Attach(memory.data, memory.bytes - 1).IsValid()); // Smaller than formatted
+    CHECK(!utils::ShmRing::Format(memory.data, 4).IsValid());
+
+    std::string record;
+    CHECK(!consumer.TryRead(record));
+    CHECK(!producer.TryWrite(std::string(61, 'x'))); // Capacity - 4 at most
+    CHECK(producer.TryWrite(std::string(60, 'x')));
+    CHECK(!producer.TryWrite("")); // Full
+    CHECK(consumer.TryRead(record));
+    CHECK_EQ(record.size(), 60u);
+    CHECK(producer.TryWrite("")); // Empty records are records
+    CHECK(!consumer.IsDrained());
+    producer.Close();
+    CHECK(!consumer.IsDrained()); // Closed, but one record left
+    CHECK(consumer.TryRead(record));
+    CHECK(record.empty());
+    CHECK(consumer.IsDrained());
+}
+
+// Records of random sizes wrap around the area, the length prefix included,
+// and come out intact and in order.
+TEST(ShmRing, WrapsAround)
+{
+    Memory memory(utils::ShmRing::RequiredBytes(37)); // Odd, so prefixes straddle the end
+    utils::ShmRing ring = utils::ShmRing::Format(memory.data, memory.bytes);
+    REQUIRE(ring.IsValid());
+    std::mt19937 rng(5);
+    uint32_t written = 0;
+    uint32_t read = 0;
+    std::string record;
+    for (int step = 0; step < 20000; ++step)
+    {
+        if (rng() % 2)
+        {
+            if (ring.TryWrite(Record(written, rng() % 34)))
+                ++written;
+        }
+        else if (ring.TryRead(record))
+        {
+            if (record != Record(read, record.size()))
+            {
+                CHECK(record == Record(read, record.size()));
+                return;
+            }
+            ++read;
+        }
+    }
+    while (ring.TryRead(record))
+        ++read;
+    CHECK_EQ(read, written);
+    CHECK(written > 1000u);
+}
+
+// A producer and a consumer thread, as the two processes would be; clean
+// under TSan.
+TEST(ShmRing, ProducerConsumer)
+{
+    Memory memory(utils::ShmRing::RequiredBytes(4096));
+    utils::ShmRing producer = utils::ShmRing::Format(memory.data, memory.bytes);
+    utils::ShmRing consumer = utils::ShmRing::Attach(memory.data, memory.bytes);
+    REQUIRE(producer.IsValid() && consumer.IsValid());
+
+    constexpr uint32_t kRecords = 100000;
+    std::thread writer([&producer]() {
+        std::mt19937 rng(9);
+        for (uint32_t serial = 0; serial < kRecords; ++serial)
+        {
+            const std::string record = Record(serial, rng() % 300);
+            while (!producer.TryWrite(record))
+                std::this_thread::yield();
+        }
+        producer.Close();
+    });
+
+    uint32_t received = 0;
+    bool intact = true;
+    std::string record;
+    while (!consumer.IsDrained())
+    {
+        if (!consumer.TryRead(record))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        intact = intact && record == Record(received, record.size());
+        ++received;
+    }
+    writer.join();
+    CHECK(intact);
+    CHECK_EQ(received, kRecords);
+}
@@ -0,0 +1,93 @@
+#include "Test.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LaunchHistory.h"
+#include "SearchProviders.h"
+#include "ShortQueryIndex.h"
+#include "TaskExecutor.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    SearchEngine::ShortQueryIndex::Snapshot MakeCatalog(size_t count)
+    {
+        const char *words[] = {"Visual", "Studio", "Chrome", "Office", "Paint", "Code", "Steam", "Adobe", "Reader", "Tools"};
+        auto programs = std::make_shared<std::vector<utils::Program>>();
+        programs->reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            utils::Program program;
+            program.name = std::string(words[i % 10]) + " " + words[(i / 10) % 10] + " " + std::to_string(i);
+            program.executablePath = "C:\\Program Files\\Vendor " + std::to_string(i % 97) + "\\app" + std::to_string(i) + ".exe";
+            programs->push_back(std::move(program));
+        }
+        return programs;
+    }
+} // namespace
+
+// Cold start of the short-query tables: the build after a publish, then one-
+// and two-character lookups from the tables against the catalog scan they
+// replace.
+TEST(ShortQueryBench, BuildAndLookup)
+{
+    const std::vector<std::string> queries = {"s", "c", "a", "v", "st", "co", "pa", "re"};
+    for (size_t count : {2000, 20000})
+    {
+        const auto programs = MakeCatalog(count);
+        auto history = std::make_shared<SearchEngine::LaunchHistory>();
+        for (size_t i = 0; i < 200; ++i)
+            history->Record((*programs)[i * 7 % count].executablePath, "");
+
+        utils::TaskExecutor executor;
+        SearchEngine::ShortQueryIndex index(history, executor);
+        Clock::time_point start = Clock::now();
+        index.Prepare(programs);
+        while (!index.Ready(programs))
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        const double buildMs = MsSince(start);
+
+        constexpr int kRounds = 200;
+        std::pmr::vector<size_t> indices;
+        size_t hits = 0;
+        start = Clock::now();
+        for (int round = 0; round < kRounds; ++round)
+        {
+            for (const std::string &query : queries)
+            {
+                indices.clear();
+                REQUIRE(index.Lookup(programs, query, indices));
+                hits += indices.size();
+            }
+        }
+        const double lookupUs = MsSince(start) * 1000 / (kRounds * queries.size());
+
+        constexpr int kScanRounds = 10;
+        start = Clock::now();
+        for (int round = 0; round < kScanRounds; ++round)
+        {
+            for (const std::string &query : queries)
+            {
+                indices.clear();
+                SearchEngine::MatchCatalog(programs, query, nullptr, {}, 0, indices);
+                hits += indices.size();
+            }
+        }
+        const double scanUs = MsSince(start) * 1000 / (kScanRounds * queries.size());
+
+        std::printf("  %6zu programs: build %.1f ms; lookup %.2f us against scan %.1f us (%zu hits)\n", count, buildMs,
+                    lookupUs, scanUs, hits);
+    }
+}
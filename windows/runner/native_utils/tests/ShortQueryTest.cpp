@@ -0,0 +1,309 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LaunchHistory.h"
+#include "SearchProviders.h"
+#include "ShortQueryIndex.h"
+#include "TaskExecutor.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    SearchEngine::ShortQueryIndex::Snapshot MakeCatalog(const std::vector<std::string> &names)
+    {
+        auto programs = std::make_shared<std::vector<utils::Program>>();
+        for (const std::string &name : names)
+        {
+            utils::Program program;
+            program.name = name;
+            program.executablePath = "D:\\Bin\\" + name + ".exe";
+            programs->push_back(std::move(program));
+        }
+        return programs;
+    }
+
+    SearchEngine::ShortQueryIndex::Snapshot MakeLargeCatalog(size_t count)
+    {
+        std::vector<std::string> names;
+        names.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            names.push_back("Program " + std::to_string(i * 7919 % 100003));
+        return MakeCatalog(names);
+    }
+
+    bool WaitReady(const SearchEngine::ShortQueryIndex &index, const SearchEngine::ShortQueryIndex::Snapshot &programs)
+    {
+        const Clock::time_point deadline = Clock::now() + std::chrono::seconds(20);
+        while (!index.Ready(programs))
+        {
+            if (Clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    std::vector<size_t> Lookup(SearchEngine::ShortQueryIndex &index, const SearchEngine::ShortQueryIndex::Snapshot &programs,
+                               std::string_view query, bool &served)
+    {
+        std::pmr::vector<size_t> indices;
+        served = index.Lookup(programs, query, indices);
+        return std::vector<size_t>(indices.begin(), indices.end());
+    }
+} // namespace
+
+// Lookup() declines until the tables are built in the background, then
+// answers best first.
+TEST(ShortQuery, BuildsInBackgroundAndRanks)
+{
+    utils::TaskExecutor executor;
+    SearchEngine::ShortQueryIndex index(std::make_shared<SearchEngine::LaunchHistory>(), executor);
+    const auto programs = MakeCatalog({"Notepad", "Visual Studio Code", "Calculator", "Control Panel", "Docker"});
+
+    bool served = true;
+    Lookup(index, programs, "c", served);
+    CHECK(!served); // Scheduled, not built inline
+    REQUIRE(WaitReady(index, programs));
+
+    std::vector<size_t> hits = Lookup(index, programs, "c", served);
+    CHECK(served);
+    REQUIRE(hits.size() == 4u); // All but Notepad
+    CHECK(hits[0] == 2 || hits[0] == 3); // Calculator, Control Panel: name prefix first
+    CHECK(hits[1] == 2 || hits[1] == 3);
+
+    hits = Lookup(index, programs, "co", served); // Word-start bigram
+    CHECK(served);
+    REQUIRE(hits.size() == 2u);
+    CHECK_EQ(hits[0], 3u); // Control Panel (prefix) before Visual Studio Code
+    CHECK_EQ(hits[1], 1u);
+
+    Lookup(index, programs, "q", served); // Single character nobody has
+    CHECK(served);
+    Lookup(index, programs, "ud", served); // Not a word start: scan
+    CHECK(!served);
+    Lookup(index, programs, "cod", served);
+    CHECK(!served);
+}
+
+// However long a build takes, a lookup never waits for it.
+TEST(ShortQuery, LookupNeverWaitsForABuild)
+{
+    utils::TaskExecutor executor;
+    SearchEngine::ShortQueryIndex index(nullptr, executor);
+    const auto programs = MakeLargeCatalog(200000);
+
+    double slowestMs = 0;
+    bool served = false;
+    const Clock::time_point start = Clock::now();
+    while (!index.Ready(programs) && Clock::now() - start < std::chrono::seconds(20))
+    {
+        const Clock::time_point before = Clock::now();
+        Lookup(index, programs, "p", served);
+        slowestMs = std::max(slowestMs, std::chrono::duration<double, std::milli>(Clock::now() - before).count());
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::printf("    build %.0f ms, slowest lookup meanwhile %.3f ms\n", buildMs, slowestMs);
+    REQUIRE(index.Ready(programs));
+    CHECK(slowestMs < buildMs / 10);
+    Lookup(index, programs, "p", served);
+    CHECK(served);
+}
+
+// A newer snapshot is built once asked for; queries on an older one while
+// that runs do not take the build over.
+TEST(ShortQuery, NewSnapshotReplacesTables)
+{
+    utils::TaskExecutor executor;
+    SearchEngine::ShortQueryIndex index(nullptr, executor);
+    const auto first = MakeCatalog({"Alpha", "Beta"});
+    const auto second = MakeCatalog({"Gamma", "Alpha Two"});
+
+    index.Prepare(first);
+    REQUIRE(WaitReady(index, first));
+
+    // Hold every worker so the second build cannot start yet.
+    std::atomic<bool> release{false};
+    std::atomic<size_t> held{0};
+    for (size_t i = 0; i < executor.ThreadCount(); ++i)
+    {
+        executor.Post(utils::TaskPriority::Interactive, [&]() {
+            ++held;
+            while (!release.load())
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
+    }
+    while (held.load() < executor.ThreadCount())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    index.Prepare(second);
+    bool served = true;
+    Lookup(index, first, "a", served); // Still the built one
+    CHECK(served);
+    Lookup(index, second, "a", served);
+    CHECK(!served);
+    release = true;
+    REQUIRE(WaitReady(index, second));
+    CHECK(!index.Ready(first));
+
+    std::vector<size_t> hits = Lookup(index, second, "a", served);
+    CHECK(served);
+    REQUIRE(hits.size() == 2u);
+    CHECK_EQ(hits[0], 1u); // Alpha Two: prefix
+    Lookup(index, first, "a", served);
+    CHECK(!served);
+}
+
+// A launch moves the item ahead of entries of equal relevance, also when it
+// is recorded while the tables are being built.
+TEST(ShortQuery, LaunchReRanks)
+{
+    utils::TaskExecutor executor;
+    auto history = std::make_shared<SearchEngine::LaunchHistory>();
+    SearchEngine::ShortQueryIndex index(history, executor);
+    const auto programs = MakeCatalog({"Edge", "Excel", "Expenses"});
+    index.Prepare(programs);
+    REQUIRE(WaitReady(index, programs));
+
+    bool served = false;
+    std::vector<size_t> hits = Lookup(index, programs, "e", served);
+    REQUIRE(served && hits.size() == 3u);
+    CHECK_EQ(hits[0], 0u); // Alphabetical among equals
+
+    history->Record((*programs)[2].executablePath, "");
+    index.OnLaunch((*programs)[2].executablePath, "");
+    hits = Lookup(index, programs, "e", served);
+    REQUIRE(hits.size() == 3u);
+    CHECK_EQ(hits[0], 2u);
+
+    const auto next = MakeCatalog({"Edge", "Excel", "Expenses", "Eclipse"});
+    index.Prepare(next);
+    history->Record((*next)[1].executablePath, "");
+    history->Record((*next)[1].executablePath, "");
+    index.OnLaunch((*next)[1].executablePath, "");
+    REQUIRE(WaitReady(index, next));
+    hits = Lookup(index, next, "e", served);
+    REQUIRE(hits.size() == 4u);
+    CHECK_EQ(hits[0], 1u);
+    CHECK_EQ(hits[1], 2u);
+}
+
+// The history survives a restart, so the tables rank a launched item first
+// from the start; a damaged file leaves it empty.
+TEST(ShortQuery, LaunchHistoryPersists)
+{
+    namespace fs = std::filesystem;
+    const fs::path file = fs::temp_directory_path() / "vxkonsol-test" / "launch-history.bin";
+    fs::remove(file);
+    const auto programs = MakeCatalog({"Edge", "Excel", "Expenses"});
+    const auto now = SearchEngine::LaunchHistory::Clock::now();
+    {
+        SearchEngine::LaunchHistory history;
+        CHECK(!history.Load(file));
+        history.Record((*programs)[2].executablePath, "", now - std::chrono::hours(24 * 30));
+        history.Record((*programs)[2].executablePath, "", now);
+        history.Record((*programs)[1].executablePath, "--safe", now);
+        REQUIRE(history.Save(file));
+    }
+
+    auto history = std::make_shared<SearchEngine::LaunchHistory>();
+    REQUIRE(history->Load(file));
+    CHECK_EQ(history->Frecency((*programs)[2].executablePath, "", now), 2 * (50.0 + 100.0) / 2);
+    CHECK_EQ(history->Frecency((*programs)[1].executablePath, "--safe", now), 100.0);
+    CHECK_EQ(history->Frecency((*programs)[1].executablePath, "", now), 0.0);
+
+    utils::TaskExecutor executor;
+    SearchEngine::ShortQueryIndex index(history, executor);
+    index.Prepare(programs);
+    REQUIRE(WaitReady(index, programs));
+    bool served = false;
+    std::vector<size_t> hits = Lookup(index, programs, "e", served);
+    REQUIRE(served && hits.size() == 3u);
+    CHECK_EQ(hits[0], 2u);
+
+    // One flipped byte fails the checksum.
+    std::string data;
+    {
+        std::ifstream in(file, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    REQUIRE(data.size() > 20);
+    data[12] ^= 1;
+    {
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+    CHECK(!history->Load(file));
+    CHECK_EQ(history->Frecency((*programs)[2].executablePath, "", now), 0.0);
+    fs::remove(file);
+}
+
+// Lookups, launches and new snapshots from several threads at once (run
+// under TSan for the data-race check).
+TEST(ShortQuery, ConcurrentUse)
+{
+    utils::TaskExecutor executor;
+    auto history = std::make_shared<SearchEngine::LaunchHistory>();
+    SearchEngine::ShortQueryIndex index(history, executor);
+    std::vector<SearchEngine::ShortQueryIndex::Snapshot> snapshots;
+    for (size_t i = 0; i < 4; ++i)
+        snapshots.push_back(MakeLargeCatalog(2000 + i * 500));
+
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            size_t round = static_cast<size_t>(t);
+            while (!stop.load())
+            {
+                const auto &programs = snapshots[round++ % snapshots.size()];
+                std::pmr::vector<size_t> indices;
+                const char query[] = {static_cast<char>('0' + round % 10), 0};
+                if (index.Lookup(programs, query, indices))
+                {
+                    for (size_t i : indices)
+                    {
+                        if (i >= programs->size())
+                            test::Fail(__FILE__, __LINE__, "index out of range");
+                    }
+                }
+            }
+        });
+    }
+    threads.emplace_back([&]() {
+        for (size_t round = 0; !stop.load(); ++round)
+        {
+            const auto &programs = snapshots[round % snapshots.size()];
+            const std::string &path = (*programs)[round % programs->size()].executablePath;
+            history->Record(path, "");
+            index.OnLaunch(path, "");
+            if (round % 50 == 0)
+                index.Prepare(programs);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    stop = true;
+    for (std::thread &thread : threads)
+        thread.join();
+
+    // Builds may have kept superseding each other; once one is let finish,
+    // it serves.
+    index.Prepare(snapshots[0]);
+    REQUIRE(WaitReady(index, snapshots[0]));
+    std::pmr::vector<size_t> indices;
+    CHECK(index.Lookup(snapshots[0], "1", indices));
+}
@@ -0,0 +1,128 @@
+#include "Test.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "ShortcutCache.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Stands in for utils::ResolveShortcut(): reads the link and builds what a
+    // resolve returns, a target and a ~3 KB base64 icon. The real one adds
+    // COM and icon extraction on top, so the cold numbers are a floor.
+    std::optional<utils::ShortcutInfo> Resolve(const fs::path &link)
+    {
+        std::ifstream in(link, std::ios::binary);
+        std::string target((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (target.empty())
+            return std::nullopt;
+        utils::ShortcutInfo info;
+        info.resolvedTargetPathUtf8 = target;
+        info.iconPathUtf8 = target;
+        info.iconIndex = 0;
+        info.kind = "shortcut";
+        info.iconDataBase64.reserve(3072);
+        while (info.iconDataBase64.size() < 3072)
+            info.iconDataBase64 += target;
+        info.iconDataBase64.resize(3072);
+        return info;
+    }
+
+    struct Scan
+    {
+        double ms = 0;
+        size_t resolved = 0;
+    };
+
+    // One Start Menu pass the way ProgramFinder runs it: stamp from the
+    // directory walk, cached entry if the stamp matches, resolve otherwise.
+    Scan RunScan(utils::ShortcutCache &cache, const fs::path &root)
+    {
+        Scan scan;
+        const Clock::time_point start = Clock::now();
+        cache.BeginScan();
+        for (const fs::directory_entry &entry : fs::recursive_directory_iterator(root))
+        {
+            if (!entry.is_regular_file())
+                continue;
+            const std::optional<utils::FileStamp> stamp = utils::FileStamp::Of(entry);
+            const std::string link = entry.path().u8string();
+            std::optional<utils::ShortcutInfo> info = stamp ? cache.Find(link, *stamp) : std::nullopt;
+            if (!info)
+            {
+                info = Resolve(entry.path());
+                ++scan.resolved;
+                if (info && stamp)
+                    cache.Store(link, *stamp, *info);
+            }
+        }
+        cache.EndScan();
+        scan.ms = MsSince(start);
+        return scan;
+    }
+} // namespace
+
+// Start Menu rescans with and without the shortcut cache: a cold scan that
+// resolves everything, a warm one after a restart (Load() included), and a
+// warm one with 1% of the links rewritten.
+TEST(ShortcutCacheBench, WarmAgainstCold)
+{
+    const fs::path root = fs::temp_directory_path() / "vxkonsol-shortcut-bench";
+    const fs::path file = fs::temp_directory_path() / "vxkonsol-shortcut-bench.bin";
+    for (size_t count : {500, 5000})
+    {
+        fs::remove_all(root);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const fs::path folder = root / ("Vendor " + std::to_string(i % 50));
+            fs::create_directories(folder);
+            std::ofstream(folder / ("App " + std::to_string(i) + ".lnk"), std::ios::binary)
+                << "C:\\Program Files\\Vendor " << i % 50 << "\\app" << i << ".exe";
+        }
+        fs::remove(file);
+
+        utils::ShortcutCache cold;
+        const Scan coldScan = RunScan(cold, root);
+        Clock::time_point start = Clock::now();
+        REQUIRE(cold.Save(file));
+        const double saveMs = MsSince(start);
+
+        utils::ShortcutCache warm;
+        start = Clock::now();
+        REQUIRE(warm.Load(file));
+        const double loadMs = MsSince(start);
+        const Scan warmScan = RunScan(warm, root);
+        CHECK_EQ(warmScan.resolved, size_t(0));
+
+        for (size_t i = 0; i < count; i += 100)
+        {
+            std::ofstream(root / ("Vendor " + std::to_string(i % 50)) / ("App " + std::to_string(i) + ".lnk"),
+                          std::ios::binary | std::ios::app)
+                << " --updated";
+        }
+        const Scan churnScan = RunScan(warm, root);
+        CHECK_EQ(churnScan.resolved, count / 100);
+
+        std::printf("  %5zu links: cold %.1f ms; warm %.1f ms + load %.1f ms; 1%% changed %.1f ms (%zu resolved); "
+                    "save %.1f ms, %.0f KB\n",
+                    count, coldScan.ms, warmScan.ms, loadMs, churnScan.ms, churnScan.resolved, saveMs,
+                    static_cast<double>(fs::file_size(file)) / 1024.0);
+    }
+    fs::remove_all(root);
+    fs::remove(file);
+}
@@ -0,0 +1,213 @@
+#include "Test.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "BinaryIO.h"
+#include "ShortcutCache.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    fs::path TempFile(const std::string &name)
+    {
+        const fs::path path = fs::temp_directory_path() / ("vxkonsol-" + name);
+        fs::remove(path);
+        return path;
+    }
+
+    std::string ReadAll(const fs::path &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+
+    void WriteAll(const fs::path &path, const std::string &data)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    // Replaces the FNV-1a trailer, so a test can alter the payload and still get
+    // past the checksum.
+    std::string Resign(std::string file)
+    {
+        file.resize(file.size() - 8);
+        utils::BinaryWriter trailer;
+        trailer.U64(utils::Fnv1a64(file));
+        return file + trailer.Data();
+    }
+
+    utils::ShortcutInfo Info(const std::string &target)
+    {
+        utils::ShortcutInfo info;
+        info.resolvedTargetPathUtf8 = target;
+        info.argumentsUtf8 = "--profile \"Default\"";
+        info.iconPathUtf8 = target + ",3";
+        info.iconIndex = 3;
+        info.iconDataBase64 = "iVBORw0KGgoAAAANSUhEUgAAABAAAAAQ";
+        info.kind = "shortcut";
+        info.descriptionUtf8 = "Caf\xC3\xA9 \xE2\x80\x94 editor";
+        info.isFallbackPath = target.size() % 2 == 0;
+        return info;
+    }
+
+    bool SameInfo(const utils::ShortcutInfo &a, const utils::ShortcutInfo &b)
+    {
+        return a.resolvedTargetPathUtf8 == b.resolvedTargetPathUtf8 && a.argumentsUtf8 == b.argumentsUtf8 &&
+               a.iconPathUtf8 == b.iconPathUtf8 && a.iconIndex == b.iconIndex && a.iconDataBase64 == b.iconDataBase64 &&
+               a.kind == b.kind && a.descriptionUtf8 == b.descriptionUtf8 && a.isFallbackPath == b.isFallbackPath;
+    }
+
+    // A small saved cache the corruption tests start from.
+    std::string SavedCache(const fs::path &file)
+    {
+        utils::ShortcutCache cache;
+        cache.Store("C:\\Start Menu\\Editor.lnk", {120, 1000}, Info("C:\\Tools\\editor.exe"));
+        cache.Store("C:\\Start Menu\\Shell.lnk", {80, 2000}, Info("C:\\Tools\\shell.exe"));
+        REQUIRE(cache.Save(file));
+        return ReadAll(file);
+    }
+} // namespace
+
+// Every field survives Save() and Load(); lookups fold case and need the
+// stamp the entry was stored with.
+TEST(ShortcutCache, RoundTrip)
+{
+    const fs::path file = TempFile("shortcut-roundtrip.bin");
+    {
+        utils::ShortcutCache cache;
+        cache.Store("C:\\Start Menu\\Editor.lnk", {120, 1000}, Info("C:\\Tools\\editor.exe"));
+        cache.Store("C:\\Start Menu\\Shell.lnk", {80, 2000}, Info("C:\\Tools\\shell.exe"));
+        utils::ShortcutInfo empty;
+        cache.Store("C:\\Start Menu\\Empty.lnk", {0, -5}, empty);
+        REQUIRE(cache.Save(file));
+    }
+
+    utils::ShortcutCache loaded;
+    REQUIRE(loaded.Load(file));
+    CHECK_EQ(loaded.GetStats().entries, size_t(3));
+    std::optional<utils::ShortcutInfo> editor = loaded.Find("c:\\start menu\\EDITOR.LNK", {120, 1000});
+    REQUIRE(editor.has_value());
+    CHECK(SameInfo(*editor, Info("C:\\Tools\\editor.exe")));
+    std::optional<utils::ShortcutInfo> empty = loaded.Find("C:\\Start Menu\\Empty.lnk", {0, -5});
+    REQUIRE(empty.has_value());
+    CHECK(SameInfo(*empty, utils::ShortcutInfo()));
+
+    CHECK(!loaded.Find("C:\\Start Menu\\Shell.lnk", {81, 2000}).has_value());  // Rewritten
+    CHECK(!loaded.Find("C:\\Start Menu\\Shell.lnk", {80, 2001}).has_value());  // Touched
+    CHECK(!loaded.Find("C:\\Start Menu\\Other.lnk", {80, 2000}).has_value());
+    CHECK_EQ(loaded.GetStats().hits, size_t(2));
+    CHECK_EQ(loaded.GetStats().misses, size_t(3));
+    fs::remove(file);
+}
+
+// Nothing changed since Load(): Save() leaves the file alone.
+TEST(ShortcutCache, SaveSkipsCleanCache)
+{
+    const fs::path file = TempFile("shortcut-clean.bin");
+    SavedCache(file);
+    utils::ShortcutCache cache;
+    REQUIRE(cache.Load(file));
+    REQUIRE(cache.Find("C:\\Start Menu\\Editor.lnk", {120, 1000}).has_value());
+    fs::remove(file);
+    CHECK(cache.Save(file));
+    CHECK(!fs::exists(file));
+
+    cache.Forget("C:\\Start Menu\\Editor.lnk");
+    CHECK(cache.Save(file));
+    CHECK(fs::exists(file));
+    fs::remove(file);
+}
+
+// A file that is truncated, has any byte flipped, or parses to something
+// other than exactly the records it claims is rejected whole, and the
+// cache comes back empty rather than half loaded.
+TEST(ShortcutCache, CorruptFilesAreRejected)
+{
+    const fs::path file = TempFile("shortcut-corrupt.bin");
+    const std::string good = SavedCache(file);
+    REQUIRE(good.size() > 20);
+
+    std::vector<std::pair<std::string, std::string>> cases;
+    cases.emplace_back("empty", "");
+    for (size_t size : {size_t(4), size_t(8), size_t(12), good.size() / 2, good.size() - 1})
+        cases.emplace_back("truncated to " + std::to_string(size), good.substr(0, size));
+    for (size_t i = 0; i < good.size(); ++i)
+    {
+        std::string flipped = good;
+        flipped[i] = static_cast<char>(flipped[i] ^ 0x20);
+        cases.emplace_back("byte " + std::to_string(i) + " flipped", flipped);
+    }
+    {
+        std::string version = good;
+        version[4] = 2;
+        cases.emplace_back("newer version", Resign(version));
+    }
+    {
+        std::string count = good;
+        count[8] = 3;
+        cases.emplace_back("count too high", Resign(count));
+    }
+    {
+        std::string count = good;
+        count[8] = 1;
+        cases.emplace_back("count too low", Resign(count));
+    }
+    {
+        std::string length = good;
+        length[12] = static_cast<char>(0xFF); // First key's length
+        length[13] = static_cast<char>(0xFF);
+        cases.emplace_back("string past the end", Resign(length));
+    }
+    cases.emplace_back("trailing bytes", Resign(good.substr(0, good.size() - 8) + "junk" + good.substr(good.size() - 8)));
+
+    for (const auto &[name, data] : cases)
+    {
+        WriteAll(file, data);
+        utils::ShortcutCache cache;
+        cache.Store("C:\\Start Menu\\Stale.lnk", {1, 1}, Info("C:\\stale.exe"));
+        const bool loaded = cache.Load(file);
+        if (loaded || cache.GetStats().entries != 0)
+            std::printf("  accepted: %s\n", name.c_str());
+        CHECK(!loaded);
+        CHECK_EQ(cache.GetStats().entries, size_t(0));
+    }
+
+    // The rejected file is replaced by the next Save() once anything is stored.
+    utils::ShortcutCache cache;
+    CHECK(!cache.Load(file));
+    cache.Store("C:\\Start Menu\\Editor.lnk", {120, 1000}, Info("C:\\Tools\\editor.exe"));
+    REQUIRE(cache.Save(file));
+    utils::ShortcutCache reloaded;
+    CHECK(reloaded.Load(file));
+    fs::remove(file);
+}
+
+// EndScan() drops what the scan neither found nor stored; skipping it, as an
+// aborted scan does, keeps everything.
+TEST(ShortcutCache, EndScanDropsUnvisitedEntries)
+{
+    utils::ShortcutCache cache;
+    cache.Store("C:\\a.lnk", {1, 1}, Info("C:\\a.exe"));
+    cache.Store("C:\\b.lnk", {1, 1}, Info("C:\\b.exe"));
+    cache.Store("C:\\c.lnk", {1, 1}, Info("C:\\c.exe"));
+
+    cache.BeginScan();
+    CHECK(cache.Find("C:\\a.lnk", {1, 1}).has_value());
+    CHECK(!cache.Find("C:\\b.lnk", {2, 1}).has_value()); // Changed, then resolved again
+    cache.Store("C:\\b.lnk", {2, 1}, Info("C:\\b2.exe"));
+    cache.Store("C:\\d.lnk", {1, 1}, Info("C:\\d.exe"));
+    CHECK_EQ(cache.EndScan(), size_t(1));
+    CHECK_EQ(cache.GetStats().entries, size_t(3));
+    CHECK(!cache.Find("C:\\c.lnk", {1, 1}).has_value());
+
+    cache.BeginScan();
+    CHECK(cache.Find("C:\\a.lnk", {1, 1}).has_value()); // Aborted here: no EndScan()
+    CHECK_EQ(cache.GetStats().entries, size_t(3));
+}
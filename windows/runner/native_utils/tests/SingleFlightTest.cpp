@@ -0,0 +1,81 @@
+#include "Test.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "SingleFlight.h"
+
+namespace
+{
+    using Flights = utils::SingleFlight<std::string, int>;
+} // namespace
+
+// Joins before the landing share the one value, in join order.
+TEST(SingleFlight, JoinersShareOneValue)
+{
+    Flights flights;
+    std::vector<int> order;
+    std::vector<const int *> seen;
+    std::vector<int> values;
+    std::vector<bool> soles;
+    auto record = [&](int who) {
+        return [&, who](const Flights::Result &result, bool sole) {
+            order.push_back(who);
+            seen.push_back(result.get());
+            values.push_back(result ? *result : -1);
+            soles.push_back(sole);
+        };
+    };
+    std::shared_ptr<Flights::Flight> flight = flights.Join("q", {}, record(0));
+    REQUIRE(flight != nullptr);
+    CHECK(flights.Join("q", {}, record(1)) == nullptr);
+    CHECK(flights.Join("q", {}, record(2)) == nullptr);
+    std::shared_ptr<Flights::Flight> other = flights.Join("other", {}, record(3));
+    CHECK(other != nullptr);
+
+    flights.Land(flight, std::make_shared<int>(7));
+    CHECK(order == std::vector<int>({0, 1, 2}));
+    CHECK(seen[0] == seen[1] && seen[1] == seen[2]);
+    CHECK(values == std::vector<int>({7, 7, 7}));
+    CHECK(!soles[0] && !soles[1] && !soles[2]);
+
+    flights.Land(other, std::make_shared<int>(8));
+    CHECK(soles.back());
+
+    // Landed: the next Join() starts over.
+    std::shared_ptr<Flights::Flight> again = flights.Join("q", {}, record(4));
+    CHECK(again != nullptr);
+    flights.Land(again, nullptr);
+    CHECK_EQ(values.back(), -1);
+
+    const Flights::Stats stats = flights.GetStats();
+    CHECK_EQ(stats.started, 3u);
+    CHECK_EQ(stats.joined, 2u);
+}
+
+// A cancelled flight is not joined; it still lands for the callbacks it has,
+// without taking the newer flight's place.
+TEST(SingleFlight, CancelledFlightIsNotJoined)
+{
+    Flights flights;
+    utils::CancellationSource source;
+    int first = 0;
+    int second = 0;
+    std::shared_ptr<Flights::Flight> cancelled =
+        flights.Join("q", source.Token(), [&](const Flights::Result &, bool) { ++first; });
+    source.Cancel();
+    std::shared_ptr<Flights::Flight> fresh = flights.Join("q", {}, [&](const Flights::Result &, bool) { ++second; });
+    REQUIRE(fresh != nullptr);
+    CHECK(fresh != cancelled);
+
+    flights.Land(cancelled, nullptr);
+    CHECK_EQ(first, 1);
+    CHECK_EQ(second, 0);
+    CHECK(flights.Join("q", {}, [&](const Flights::Result &, bool) { ++second; }) == nullptr);
+
+    flights.Land(fresh, std::make_shared<int>(1));
+    CHECK_EQ(first, 1);
+    CHECK_EQ(second, 2);
+}
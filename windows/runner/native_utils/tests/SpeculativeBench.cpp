@@ -0,0 +1,221 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "ProviderScheduler.h"
+#include "SearchProviders.h"
+#include "TaskExecutor.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MsBetween(Clock::time_point from, Clock::time_point to)
+    {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    double Percentile(std::vector<double> values, double p)
+    {
+        if (values.empty())
+            return 0.0;
+        std::sort(values.begin(), values.end());
+        return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+    }
+
+    // Counts the calls that reach |inner|, and those whose query was cancelled
+    // by the time they returned: work a newer keystroke threw away.
+    class CountingProvider : public SearchEngine::SearchProvider
+    {
+    public:
+        explicit CountingProvider(std::shared_ptr<SearchEngine::SearchProvider> inner) : inner_(std::move(inner)) {}
+
+        const char *Name() const override { return inner_->Name(); }
+        bool IsExpensive() const override { return inner_->IsExpensive(); }
+
+        std::vector<utils::Program> Search(const std::string &query, const utils::CancellationToken &token) override
+        {
+            ++calls;
+            std::vector<utils::Program> results = inner_->Search(query, token);
+            if (token.IsCancelled())
+                ++wasted;
+            return results;
+        }
+
+        std::atomic<int> calls{0};
+        std::atomic<int> wasted{0};
+
+    private:
+        std::shared_ptr<SearchEngine::SearchProvider> inner_;
+    };
+
+    // Stands in for the Windows Search Index: |latencyMs| per query.
+    class IndexProvider : public SearchEngine::SearchProvider
+    {
+    public:
+        const char *Name() const override { return "index"; }
+        bool IsExpensive() const override { return true; }
+
+        std::vector<utils::Program> Search(const std::string &, const utils::CancellationToken &token) override
+        {
+            const Clock::time_point until = Clock::now() + std::chrono::milliseconds(80);
+            while (Clock::now() < until && !token.IsCancelled())
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return {};
+        }
+    };
+
+    struct Keystroke
+    {
+        std::chrono::milliseconds at; // From the start of the replay
+        std::string query;
+        bool pauseAfter = false; // The user stops typing for a while after it
+    };
+
+    // Words typed at 70-200 ms a key, each followed by a 0.4-0.9 s pause, and
+    // now and then a backspace.
+    std::vector<Keystroke> TypingTrace()
+    {
+        const std::vector<std::string> words = {"visual studio", "chrome", "wifi", "display", "notepad", "paint"};
+        std::mt19937 random(28);
+        std::vector<Keystroke> trace;
+        std::chrono::milliseconds at{0};
+        for (const std::string &word : words)
+        {
+            std::string typed;
+            for (size_t i = 0; i < word.size(); ++i)
+            {
+                typed += word[i];
+                at += std::chrono::milliseconds(70 + random() % 130);
+                trace.push_back({at, typed});
+                if (i == 2 && random() % 2 == 0)
+                {
+                    typed.pop_back();
+                    at += std::chrono::milliseconds(120);
+                    trace.push_back({at, typed});
+                    typed += word[i];
+                    at += std::chrono::milliseconds(90);
+                    trace.push_back({at, typed});
+                }
+            }
+            trace.back().pauseAfter = true;
+            at += std::chrono::milliseconds(400 + random() % 500);
+        }
+        return trace;
+    }
+
+    struct ReplayResult
+    {
+        int searches = 0;
+        std::vector<double> answerMs;      // Keystroke to its first frame, for those answered
+        std::vector<double> afterPauseMs;  // The same for the keystroke before each pause
+    };
+
+    // Replays |trace| the way SearchCubit.search() drives the runner: every
+    // keystroke cancels the searches before it, then either starts its own
+    // (speculative) or starts it once 250 ms pass without another keystroke.
+    ReplayResult Replay(SearchEngine::ProviderScheduler &scheduler, const std::vector<Keystroke> &trace,
+                        bool speculative)
+    {
+        constexpr std::chrono::milliseconds kDebounce{250};
+        utils::CancellationRegistry registry;
+        std::mutex mutex;
+        std::map<int64_t, Clock::time_point> firstFrames;
+        ReplayResult result;
+        std::vector<Clock::time_point> typedAt(trace.size());
+
+        const Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < trace.size(); ++i)
+        {
+            std::this_thread::sleep_until(start + trace[i].at);
+            typedAt[i] = Clock::now();
+            const int64_t seq = static_cast<int64_t>(i) + 1;
+            registry.CancelThrough(seq - 1);
+            if (!speculative)
+            {
+                const bool last = i + 1 == trace.size();
+                if (!last && trace[i + 1].at - trace[i].at < kDebounce)
+                    continue; // The debounce timer never fires
+                std::this_thread::sleep_until(typedAt[i] + kDebounce);
+            }
+            ++result.searches;
+            scheduler.Run(seq, trace[i].query, registry.Register(seq), [&mutex, &firstFrames, seq](SearchEngine::SearchFrame &&frame) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (frame.index == 0)
+                    firstFrames.emplace(seq, Clock::now());
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < trace.size(); ++i)
+        {
+            auto it = firstFrames.find(static_cast<int64_t>(i) + 1);
+            if (it == firstFrames.end())
+                continue;
+            const double ms = MsBetween(typedAt[i], it->second);
+            result.answerMs.push_back(ms);
+            if (trace[i].pauseAfter)
+                result.afterPauseMs.push_back(ms);
+        }
+        return result;
+    }
+} // namespace
+
+// Debounced against speculative search over the same typing trace: searches
+// started, provider calls thrown away by the next keystroke, index queries,
+// and how soon a keystroke's results arrive.
+TEST(SpeculativeBench, DebouncedAgainstSpeculative)
+{
+    auto catalog = std::make_shared<SearchEngine::ProgramCatalog>();
+    {
+        std::vector<utils::Program> programs;
+        const char *names[] = {"Visual Studio", "Google Chrome", "Notepad", "Paint", "Display Fusion", "Word"};
+        for (size_t i = 0; i < 3000; ++i)
+        {
+            utils::Program program;
+            program.name = std::string(names[i % 6]) + " " + std::to_string(i);
+            program.executablePath = "C:\\Program Files\\Vendor " + std::to_string(i % 97) + "\\app" +
+                                     std::to_string(i) + ".exe";
+            programs.push_back(std::move(program));
+        }
+        catalog->Publish(std::move(programs));
+    }
+    const std::vector<Keystroke> trace = TypingTrace();
+
+    for (const bool speculative : {false, true})
+    {
+        SearchEngine::SchedulerOptions options;
+        options.deadline = std::chrono::milliseconds(30);
+        options.speculativeDelay = std::chrono::milliseconds(speculative ? 40 : 0);
+        utils::TaskExecutor executor;
+        SearchEngine::ProviderScheduler scheduler(options, executor);
+        auto catalogProvider = std::make_shared<CountingProvider>(std::make_shared<SearchEngine::CatalogProvider>(catalog));
+        auto settings = std::make_shared<CountingProvider>(std::make_shared<SearchEngine::SettingsPagesProvider>());
+        auto index = std::make_shared<CountingProvider>(std::make_shared<IndexProvider>());
+        scheduler.AddProvider(catalogProvider);
+        scheduler.AddProvider(settings);
+        scheduler.AddProvider(index);
+
+        const ReplayResult result = Replay(scheduler, trace, speculative);
+        const int calls = catalogProvider->calls + settings->calls + index->calls;
+        const int wasted = catalogProvider->wasted + settings->wasted + index->wasted;
+        std::printf("  %-11s %zu keys: %d searches, %d provider calls (%d thrown away), %d index queries\n",
+                    speculative ? "speculative" : "debounced", trace.size(), result.searches, calls, wasted,
+                    index->calls.load());
+        std::printf("  %-11s %zu keys answered, first frame p50 %.1f ms p90 %.1f ms; after a pause p50 %.1f ms\n", "",
+                    result.answerMs.size(), Percentile(result.answerMs, 0.5), Percentile(result.answerMs, 0.9),
+                    Percentile(result.afterPauseMs, 0.5));
+    }
+}
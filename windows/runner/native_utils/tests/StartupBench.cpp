@@ -0,0 +1,87 @@
+#include "Test.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LaunchHistory.h"
+#include "SearchProviders.h"
+#include "ShortQueryIndex.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // What a scan hands over: names, paths and arguments like a Start Menu's.
+    std::vector<utils::Program> ScannedPrograms(size_t count)
+    {
+        static const char *const kWords[] = {"Visual", "Studio", "Code", "Office", "Word", "Excel", "Paint",
+                                             "Terminal", "Steam", "Player", "Editor", "Manager", "Update",
+                                             "Setup", "Viewer", "Notes"};
+        std::vector<utils::Program> programs;
+        programs.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            utils::Program program;
+            program.name = std::string(kWords[i % 16]) + " " + kWords[(i / 16) % 16] + " " + std::to_string(i);
+            program.executablePath = "D:\\Programs\\Vendor " + std::to_string(i % 97) + "\\" + program.name + ".exe";
+            program.arguments = i % 7 == 0 ? "--profile default" : "";
+            program.source = "startmenu";
+            programs.push_back(std::move(program));
+        }
+        return programs;
+    }
+
+    double FirstSearchMs(SearchEngine::CatalogProvider &provider, const std::string &query)
+    {
+        const Clock::time_point start = Clock::now();
+        provider.Search(query, {});
+        return MsSince(start);
+    }
+} // namespace
+
+// What the warmup takes off the first keystroke's path once the scan is done:
+// publishing the catalog, then the first short query, which without prepared
+// short-query tables scans the whole catalog. Run on a Release build:
+//
+//   native_utils_bench StartupBench
+TEST(StartupBench, FirstSearchColdAndWarm)
+{
+    for (size_t count : {2000u, 20000u})
+    {
+        auto history = std::make_shared<SearchEngine::LaunchHistory>();
+
+        // Cold: the scan result arrives with the first keystroke.
+        auto cold = std::make_shared<SearchEngine::ProgramCatalog>();
+        auto coldShort = std::make_shared<SearchEngine::ShortQueryIndex>(history);
+        SearchEngine::CatalogProvider coldProvider(cold, coldShort);
+        std::vector<utils::Program> scanned = ScannedPrograms(count);
+        Clock::time_point start = Clock::now();
+        cold->Publish(std::move(scanned));
+        const double publishMs = MsSince(start);
+        const double coldMs = FirstSearchMs(coldProvider, "s");
+
+        // Warm: published and prepared while the engine starts.
+        auto warm = std::make_shared<SearchEngine::ProgramCatalog>();
+        auto warmShort = std::make_shared<SearchEngine::ShortQueryIndex>(history);
+        SearchEngine::CatalogProvider warmProvider(warm, warmShort);
+        warm->Publish(ScannedPrograms(count));
+        start = Clock::now();
+        warmShort->Prepare(warm->Current());
+        while (!warmShort->Ready(warm->Current()))
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        const double prepareMs = MsSince(start);
+        const double warmMs = FirstSearchMs(warmProvider, "s");
+
+        std::printf("  %zu programs: publish %.2f ms, tables %.2f ms; first search \"s\" cold %.3f ms, warm %.3f ms\n",
+                    count, publishMs, prepareMs, coldMs, warmMs);
+    }
+}
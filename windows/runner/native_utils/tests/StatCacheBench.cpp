@@ -0,0 +1,96 @@
+#include "Test.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "StatCache.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // A listing of a folder this size is an open, two getdents (the second
+    // comes back empty) and a close.
+    constexpr size_t kCallsPerListing = 4;
+} // namespace
+
+// The probes of a scan, answered by one stat each against the stat cache.
+// Each program is probed for its target, a sibling icon, an uninstaller
+// and two icon fallbacks, most of them missing, across 200 install folders
+// of 40 files. The file-system calls are counted from the cache's own
+// statistics.
+TEST(StatCacheBench, SyscallsPerScan)
+{
+    const fs::path root = fs::temp_directory_path() / "vxkonsol-statcache-bench";
+    fs::remove_all(root);
+    constexpr size_t kFolders = 200;
+    constexpr size_t kFiles = 40;
+    for (size_t folder = 0; folder < kFolders; ++folder)
+    {
+        const fs::path dir = root / ("Vendor " + std::to_string(folder)) / "App";
+        fs::create_directories(dir);
+        for (size_t file = 0; file < kFiles; ++file)
+            std::ofstream(dir / ("file" + std::to_string(file) + (file == 0 ? ".exe" : ".dll")));
+    }
+
+    std::vector<fs::path> probes;
+    for (size_t program = 0; program < kFolders * 5; ++program)
+    {
+        const fs::path dir = root / ("Vendor " + std::to_string(program % kFolders)) / "App";
+        probes.push_back(dir / "file0.exe");
+        probes.push_back(dir / "file0.ico");
+        probes.push_back(dir / "uninst.exe");
+        probes.push_back(dir / "app.ico");
+        probes.push_back(root / ("Vendor " + std::to_string(program % kFolders)) / "Icons" / "app.ico");
+    }
+
+    Clock::time_point start = Clock::now();
+    size_t found = 0;
+    for (const fs::path &probe : probes)
+    {
+        std::error_code ec;
+        found += fs::exists(probe, ec) ? 1 : 0;
+    }
+    const double directMs = MsSince(start);
+
+    utils::StatCache cache;
+    start = Clock::now();
+    size_t cachedFound = 0;
+    for (const fs::path &probe : probes)
+        cachedFound += cache.Exists(probe) ? 1 : 0;
+    const double cachedMs = MsSince(start);
+    CHECK_EQ(cachedFound, found);
+
+    const utils::StatCache::Stats stats = cache.GetStats();
+    std::printf("  %zu probes (%zu found): stat each %zu calls, %.2f ms; stat cache %zu listings + %zu direct = ~%zu calls, %.2f ms\n",
+                probes.size(), found, probes.size(), directMs, stats.listings, stats.direct,
+                stats.listings * kCallsPerListing + stats.direct, cachedMs);
+
+    // Canonicalizing every probe, as NormalizePath() does for targets and icons.
+    start = Clock::now();
+    for (const fs::path &probe : probes)
+    {
+        std::error_code ec;
+        (void)fs::weakly_canonical(probe, ec);
+    }
+    const double canonicalMs = MsSince(start);
+    start = Clock::now();
+    for (const fs::path &probe : probes)
+        (void)cache.WeaklyCanonical(probe);
+    const double memoMs = MsSince(start);
+    const utils::StatCache::Stats after = cache.GetStats();
+    std::printf("  weakly_canonical: %.2f ms uncached, %.2f ms memoized (%zu hits, %zu misses)\n", canonicalMs, memoMs,
+                after.canonicalHits, after.canonicalMisses);
+    fs::remove_all(root);
+}
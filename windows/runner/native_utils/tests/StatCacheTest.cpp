@@ -0,0 +1,100 @@
+#include "Test.h"
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include "StatCache.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // Vendor/App/{app.exe, app.ico, readme.txt} and an empty Vendor/Empty.
+    fs::path MakeTree(const std::string &name)
+    {
+        const fs::path root = fs::temp_directory_path() / ("vxkonsol-" + name);
+        fs::remove_all(root);
+        fs::create_directories(root / "Vendor" / "App");
+        fs::create_directories(root / "Vendor" / "Empty");
+        for (const char *file : {"app.exe", "app.ico", "readme.txt"})
+            std::ofstream(root / "Vendor" / "App" / file) << file;
+        return root;
+    }
+} // namespace
+
+// Every probe agrees with the file system, and each directory is listed once
+// however many probes land in it.
+TEST(StatCache, AnswersFromOneListingPerDirectory)
+{
+    const fs::path root = MakeTree("statcache-exists");
+    const fs::path app = root / "Vendor" / "App";
+    utils::StatCache cache;
+
+    const fs::path probes[] = {app / "app.exe", app / "app.ico", app / "missing.exe", app / "readme.txt",
+                               app / "app.exe", root / "Vendor" / "Empty" / "x.ico", root / "Vendor" / "App",
+                               root / "Gone" / "Deeper" / "app.exe", app / "." / "app.exe", "relative/app.exe"};
+    for (const fs::path &probe : probes)
+    {
+        std::error_code ec;
+        CHECK_EQ(cache.Exists(probe), fs::exists(probe, ec));
+    }
+    const utils::StatCache::Stats stats = cache.GetStats();
+    CHECK_EQ(stats.probes, size_t(10));
+    CHECK_EQ(stats.listings, size_t(4)); // App, Empty, Vendor, Gone/Deeper
+    CHECK_EQ(stats.direct, size_t(2));   // The "." and the relative path
+    fs::remove_all(root);
+}
+
+// Made for one scan: a file created after its directory was listed stays
+// unseen until the next cache.
+TEST(StatCache, ListingIsASnapshot)
+{
+    const fs::path root = MakeTree("statcache-snapshot");
+    const fs::path late = root / "Vendor" / "App" / "late.exe";
+    utils::StatCache cache;
+    CHECK(!cache.Exists(late));
+    std::ofstream(late) << "late";
+    CHECK(!cache.Exists(late));
+    CHECK(utils::StatCache().Exists(late));
+    fs::remove_all(root);
+}
+
+// Canonical forms match fs::weakly_canonical and are computed once per folder.
+TEST(StatCache, CanonicalizationIsMemoized)
+{
+    const fs::path root = MakeTree("statcache-canonical");
+    utils::StatCache cache;
+    const fs::path paths[] = {root / "Vendor" / "App" / "app.exe", root / "Vendor" / "App" / "app.ico",
+                              root / "Vendor" / "App" / ".." / "App" / "readme.txt", root / "Vendor" / "App" / "app.exe"};
+    for (const fs::path &path : paths)
+    {
+        const std::optional<fs::path> canonical = cache.WeaklyCanonical(path);
+        const fs::path expected = fs::weakly_canonical(path);
+        REQUIRE(canonical.has_value());
+        CHECK_EQ(canonical->native(), expected.native());
+    }
+    const utils::StatCache::Stats stats = cache.GetStats();
+    CHECK_EQ(stats.canonicalHits, size_t(1));
+    CHECK_EQ(stats.canonicalMisses, size_t(3));
+    fs::remove_all(root);
+}
+
+// Scopes install a cache for the calling thread and nest.
+TEST(StatCache, ScopesNest)
+{
+    CHECK(utils::StatCache::Current() == nullptr);
+    utils::StatCache outer;
+    utils::StatCache inner;
+    {
+        utils::StatCache::Scope outerScope(outer);
+        CHECK(utils::StatCache::Current() == &outer);
+        {
+            utils::StatCache::Scope innerScope(inner);
+            CHECK(utils::StatCache::Current() == &inner);
+        }
+        CHECK(utils::StatCache::Current() == &outer);
+    }
+    CHECK(utils::StatCache::Current() == nullptr);
+}
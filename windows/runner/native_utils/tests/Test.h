@@ -0,0 +1,72 @@
+#ifndef NATIVE_UTILS_TEST_H
+#define NATIVE_UTILS_TEST_H
+
+#include <functional>
+#include <sstream>
+#include <string>
+
+/**
+ * @brief A minimal test registry for the native_utils tests.
+ *
+ * @details TEST(Suite, Name) defines a test; CHECK and CHECK_EQ record a failure
+ *          and carry on, REQUIRE stops the test. The runner (TestMain.cpp) runs
+ *          every test whose suite matches its first argument, or all of them.
+ */
+namespace test
+{
+
+    struct Registrar
+    {
+        Registrar(const char *suite, const char *name, std::function<void()> body);
+    };
+
+    // Records a failure of the running test.
+    void Fail(const char *file, int line, const std::string &message);
+
+    // Thrown by REQUIRE to leave the running test.
+    struct Abort
+    {
+    };
+
+    template <typename A, typename B>
+    std::string Describe(const A &a, const B &b)
+    {
+        std::ostringstream out;
+        out << a << " vs " << b;
+        return out.str();
+    }
+
+} // namespace test
+
+#define TEST(suite, name)                                                                  \
+    static void suite##_##name();                                                          \
+    static const test::Registrar suite##_##name##_registrar(#suite, #name, suite##_##name); \
+    static void suite##_##name()
+
+#define CHECK(condition)                                        \
+    do                                                          \
+    {                                                           \
+        if (!(condition))                                       \
+            test::Fail(__FILE__, __LINE__, "CHECK(" #condition ")"); \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                                               \
+    do                                                                                               \
+    {                                                                                                \
+        const auto &check_a_ = (a);                                                                  \
+        const auto &check_b_ = (b);                                                                  \
+        if (!(check_a_ == check_b_))                                                                 \
+            test::Fail(__FILE__, __LINE__, "CHECK_EQ(" #a ", " #b "): " + test::Describe(check_a_, check_b_)); \
+    } while (0)
+
+#define REQUIRE(condition)                                        \
+    do                                                            \
+    {                                                             \
+        if (!(condition))                                         \
+        {                                                         \
+            test::Fail(__FILE__, __LINE__, "REQUIRE(" #condition ")"); \
+            throw test::Abort();                                  \
+        }                                                         \
+    } while (0)
+
+#endif // NATIVE_UTILS_TEST_H
@@ -0,0 +1,67 @@
+#include "Test.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace test
+{
+
+    namespace
+    {
+        struct Case
+        {
+            const char *suite;
+            const char *name;
+            std::function<void()> body;
+        };
+
+        std::vector<Case> &Cases()
+        {
+            static std::vector<Case> cases;
+            return cases;
+        }
+
+        int failures = 0; // In the running test
+    } // namespace
+
+    Registrar::Registrar(const char *suite, const char *name, std::function<void()> body)
+    {
+        Cases().push_back({suite, name, std::move(body)});
+    }
+
+    void Fail(const char *file, int line, const std::string &message)
+    {
+        std::fprintf(stderr, "%s:%d: %s\n", file, line, message.c_str());
+        ++failures;
+    }
+
+} // namespace test
+
+int main(int argc, char **argv)
+{
+    const char *suite = argc > 1 ? argv[1] : nullptr;
+    int ran = 0;
+    int failed = 0;
+    for (const test::Case &c : test::Cases())
+    {
+        if (suite && std::strcmp(suite, c.suite) != 0)
+            continue;
+        test::failures = 0;
+        std::printf("[ RUN  ] %s.%s\n", c.suite, c.name);
+        std::fflush(stdout);
+        try
+        {
+            c.body();
+        }
+        catch (const test::Abort &)
+        {
+        }
+        ++ran;
+        if (test::failures != 0)
+            ++failed;
+        std::printf("[ %s ] %s.%s\n", test::failures == 0 ? " OK " : "FAIL", c.suite, c.name);
+    }
+    std::printf("%d of %d tests passed\n", ran - failed, ran);
+    return ran == 0 || failed != 0 ? 1 : 0;
+}
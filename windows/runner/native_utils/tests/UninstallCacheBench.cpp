@@ -0,0 +1,90 @@
+#include "Test.h"
+
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "FakeRegistry.h"
+#include "UninstallEntryCache.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    const std::wstring kUninstall = L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall";
+
+    // The value reads ProgramFromUninstallKeyInternal makes before its path
+    // search and icon extraction, which this leaves out.
+    std::optional<utils::Program> Parse(const utils::RegistryKey &key, const std::wstring &subkey, const std::string &label)
+    {
+        if (key.DwordValue(L"SystemComponent") == 1u || key.DwordValue(L"WindowsInstaller") == 1u)
+            return std::nullopt;
+        const std::wstring name = key.StringValue(L"DisplayName").value_or(subkey);
+        std::wstring uninstall = key.StringValue(L"QuietUninstallString").value_or(L"");
+        if (uninstall.empty())
+            uninstall = key.StringValue(L"UninstallString").value_or(L"");
+        const std::wstring icon = key.StringValue(L"DisplayIcon").value_or(L"");
+        utils::Program program;
+        program.name.assign(name.begin(), name.end());
+        program.executablePath.assign(uninstall.begin(), uninstall.end());
+        program.iconPath.assign(icon.begin(), icon.end());
+        const std::wstring publisher = key.StringValue(L"Publisher").value_or(L"");
+        program.description.assign(publisher.begin(), publisher.end());
+        program.source = "Registry (" + label + ")";
+        return program;
+    }
+} // namespace
+
+// Uninstall scans against an in-memory registry: the first scan, a rescan
+// with nothing changed, and one after 1% of the subkeys were written. Keys
+// opened and values read stand for the registry round trips saved.
+TEST(UninstallCacheBench, Churn)
+{
+    const std::vector<utils::UninstallEntryCache::Root> roots = {
+        {utils::RegistryHive::LocalMachine, kUninstall, utils::RegistryView::Native64, "HKLM"},
+        {utils::RegistryHive::CurrentUser, kUninstall, utils::RegistryView::Native64, "HKCU"}};
+    for (size_t count : {1000, 10000})
+    {
+        test::FakeRegistry registry;
+        for (size_t i = 0; i < count; ++i)
+        {
+            test::FakeRegistry::Node &root = registry.Root(i % 5 == 0 ? utils::RegistryHive::CurrentUser : utils::RegistryHive::LocalMachine, kUninstall);
+            test::FakeRegistry::Node &app = root.Child(L"{" + std::to_wstring(100000 + i) + L"}");
+            app.lastWrite = 1;
+            app.strings[L"DisplayName"] = L"Application " + std::to_wstring(i);
+            app.strings[L"UninstallString"] = L"\"C:\\Program Files\\Vendor\\app" + std::to_wstring(i) + L"\\uninst.exe\" /S";
+            app.strings[L"DisplayIcon"] = L"C:\\Program Files\\Vendor\\app" + std::to_wstring(i) + L"\\app.exe,0";
+            app.strings[L"Publisher"] = L"Vendor";
+            if (i % 3 == 0)
+                app.dwords[L"SystemComponent"] = 1;
+        }
+
+        utils::UninstallEntryCache cache;
+        const auto measure = [&](const char *label) {
+            registry.opens = 0;
+            registry.valueReads = 0;
+            const Clock::time_point start = Clock::now();
+            const size_t programs = cache.Scan(registry, roots, Parse).size();
+            const double ms = MsSince(start);
+            const utils::UninstallEntryCache::Stats stats = cache.GetStats();
+            std::printf("  %6zu subkeys, %-10s %7.2f ms: %zu programs, %zu parsed, %zu reused, %zu keys opened, %zu values read\n",
+                        count, label, ms, programs, stats.parsed, stats.reused, registry.opens, registry.valueReads);
+        };
+        measure("first");
+        measure("unchanged");
+        for (size_t i = 0; i < count; i += 100)
+        {
+            test::FakeRegistry::Node &root = registry.Root(i % 5 == 0 ? utils::RegistryHive::CurrentUser : utils::RegistryHive::LocalMachine, kUninstall);
+            root.Child(L"{" + std::to_wstring(100000 + i) + L"}").lastWrite = 2;
+        }
+        measure("1% written");
+        CHECK_EQ(cache.GetStats().parsed, count / 100);
+    }
+}
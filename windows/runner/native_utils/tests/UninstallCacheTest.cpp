@@ -0,0 +1,183 @@
+#include "Test.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "FakeRegistry.h"
+#include "UninstallEntryCache.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    const std::wstring kUninstall = L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall";
+
+    std::vector<utils::UninstallEntryCache::Root> Roots()
+    {
+        return {{utils::RegistryHive::LocalMachine, kUninstall, utils::RegistryView::Native64, "HKLM"},
+                {utils::RegistryHive::LocalMachine, kUninstall, utils::RegistryView::Wow32, "HKLM"},
+                {utils::RegistryHive::CurrentUser, kUninstall, utils::RegistryView::Native64, "HKCU"}};
+    }
+
+    void AddApp(test::FakeRegistry::Node &root, const std::wstring &key, const std::wstring &name, int64_t lastWrite,
+                bool systemComponent = false)
+    {
+        test::FakeRegistry::Node &app = root.Child(key);
+        app.lastWrite = lastWrite;
+        app.strings[L"DisplayName"] = name;
+        app.strings[L"UninstallString"] = L"C:\\Program Files\\" + name + L"\\uninstall.exe";
+        if (systemComponent)
+            app.dwords[L"SystemComponent"] = 1;
+    }
+
+    // The filter ProgramFinder applies, without the path search and icon.
+    struct CountingParser
+    {
+        std::optional<utils::Program> operator()(const utils::RegistryKey &key, const std::wstring &subkey, const std::string &label)
+        {
+            ++*calls;
+            if (key.DwordValue(L"SystemComponent") == 1u)
+                return std::nullopt;
+            const std::wstring name = key.StringValue(L"DisplayName").value_or(subkey);
+            utils::Program program;
+            program.name.assign(name.begin(), name.end());
+            const std::wstring uninstall = key.StringValue(L"UninstallString").value_or(L"");
+            program.executablePath.assign(uninstall.begin(), uninstall.end());
+            program.source = "Registry (" + label + ")";
+            return program;
+        }
+
+        std::shared_ptr<int> calls = std::make_shared<int>(0);
+    };
+
+    std::vector<std::string> Names(const std::vector<utils::Program> &programs)
+    {
+        std::vector<std::string> names;
+        for (const utils::Program &program : programs)
+            names.push_back(program.name);
+        return names;
+    }
+
+    test::FakeRegistry MakeRegistry()
+    {
+        test::FakeRegistry registry;
+        test::FakeRegistry::Node &machine = registry.Root(utils::RegistryHive::LocalMachine, kUninstall);
+        AddApp(machine, L"{A}", L"Alpha", 10);
+        AddApp(machine, L"{B}", L"Beta", 10);
+        AddApp(machine, L"{C}", L"Driver Runtime", 10, true);
+        AddApp(machine, L"{D}", L"Delta", 10);
+        // The same subkey name in the 32-bit view is a different entry.
+        AddApp(registry.Root(utils::RegistryHive::LocalMachine, kUninstall, utils::RegistryView::Wow32), L"{A}", L"Alpha x86", 10);
+        AddApp(registry.Root(utils::RegistryHive::CurrentUser, kUninstall), L"Echo", L"Echo", 10);
+        return registry;
+    }
+} // namespace
+
+// A rescan opens only subkeys that are new or were written since; filtered
+// subkeys are remembered as filtered, and removed ones are forgotten.
+TEST(UninstallCache, ParsesOnlyChangedSubkeys)
+{
+    test::FakeRegistry registry = MakeRegistry();
+    utils::UninstallEntryCache cache;
+    CountingParser parse;
+
+    std::vector<utils::Program> programs = cache.Scan(registry, Roots(), parse);
+    CHECK(Names(programs) == std::vector<std::string>({"Alpha", "Beta", "Delta", "Alpha x86", "Echo"}));
+    CHECK_EQ(*parse.calls, 6);
+    CHECK_EQ(cache.GetStats().entries, size_t(6));
+    CHECK_EQ(cache.GetStats().parsed, size_t(6));
+
+    registry.opens = 0;
+    registry.valueReads = 0;
+    programs = cache.Scan(registry, Roots(), parse);
+    CHECK(Names(programs) == std::vector<std::string>({"Alpha", "Beta", "Delta", "Alpha x86", "Echo"}));
+    CHECK_EQ(*parse.calls, 6);
+    CHECK_EQ(cache.GetStats().reused, size_t(6));
+    CHECK_EQ(registry.opens, size_t(3)); // The roots only
+    CHECK_EQ(registry.valueReads, size_t(0));
+
+    test::FakeRegistry::Node &machine = registry.Root(utils::RegistryHive::LocalMachine, kUninstall);
+    AddApp(machine, L"{B}", L"Beta 2", 11);  // Updated in place
+    machine.children.erase(L"{D}");          // Uninstalled
+    AddApp(machine, L"{F}", L"Foxtrot", 12); // Installed
+    programs = cache.Scan(registry, Roots(), parse);
+    CHECK(Names(programs) == std::vector<std::string>({"Alpha", "Beta 2", "Foxtrot", "Alpha x86", "Echo"}));
+    CHECK_EQ(*parse.calls, 8);
+    CHECK_EQ(cache.GetStats().parsed, size_t(2));
+    CHECK_EQ(cache.GetStats().reused, size_t(4));
+    CHECK_EQ(cache.GetStats().entries, size_t(6));
+}
+
+// A scan after a restart reuses the saved entries; a damaged file only costs
+// a full parse.
+TEST(UninstallCache, PersistsAcrossRestart)
+{
+    const fs::path file = fs::temp_directory_path() / "vxkonsol-uninstall-cache.bin";
+    fs::remove(file);
+    test::FakeRegistry registry = MakeRegistry();
+    {
+        utils::UninstallEntryCache cache;
+        CountingParser parse;
+        cache.Scan(registry, Roots(), parse);
+        REQUIRE(cache.Save(file));
+    }
+
+    utils::UninstallEntryCache restarted;
+    REQUIRE(restarted.Load(file));
+    CountingParser parse;
+    const std::vector<utils::Program> programs = restarted.Scan(registry, Roots(), parse);
+    CHECK_EQ(*parse.calls, 0);
+    CHECK(Names(programs) == std::vector<std::string>({"Alpha", "Beta", "Delta", "Alpha x86", "Echo"}));
+    REQUIRE(programs.size() == 5);
+    CHECK_EQ(programs[3].source, std::string("Registry (HKLM)"));
+
+    {
+        std::fstream damage(file, std::ios::binary | std::ios::in | std::ios::out);
+        damage.seekp(20);
+        damage.put('\x7F');
+    }
+    utils::UninstallEntryCache damaged;
+    CHECK(!damaged.Load(file));
+    CountingParser reparse;
+    CHECK_EQ(damaged.Scan(registry, Roots(), reparse).size(), size_t(5));
+    CHECK_EQ(*reparse.calls, 6);
+    fs::remove(file);
+}
+
+// A cancelled scan keeps the entries it did not reach, and does not
+// remember the one the parser may have cut short.
+TEST(UninstallCache, CancelledScanKeepsUnreachedEntries)
+{
+    test::FakeRegistry registry = MakeRegistry();
+    utils::UninstallEntryCache cache;
+    CountingParser first;
+    cache.Scan(registry, Roots(), first);
+
+    test::FakeRegistry::Node &machine = registry.Root(utils::RegistryHive::LocalMachine, kUninstall);
+    for (const std::wstring key : {L"{A}", L"{B}", L"{D}"})
+        machine.Child(key).lastWrite = 20;
+    utils::CancellationSource source;
+    CountingParser inner;
+    int calls = 0;
+    const std::vector<utils::Program> partial = cache.Scan(
+        registry, Roots(),
+        [&](const utils::RegistryKey &key, const std::wstring &subkey, const std::string &label) {
+            if (++calls == 2)
+                source.Cancel();
+            return inner(key, subkey, label);
+        },
+        source.Token());
+    CHECK(Names(partial) == std::vector<std::string>({"Alpha", "Beta"}));
+    CHECK_EQ(cache.GetStats().entries, size_t(6));
+
+    // {A} was stored; {B} (cancelled mid-parse) and {D} still need a parse.
+    CountingParser resume;
+    const std::vector<utils::Program> programs = cache.Scan(registry, Roots(), resume);
+    CHECK_EQ(*resume.calls, 2);
+    CHECK_EQ(programs.size(), size_t(5));
+}
@@ -0,0 +1,218 @@
+#include "Test.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LaunchHistory.h"
+#include "SearchProviders.h"
+#include "ShortQueryIndex.h"
+#include "TaskExecutor.h"
+#include "VxSearchApi.h"
+
+// The layout dart:ffi mirrors in lib/native_apis/native_catalog.dart, on 64-bit
+// targets. Fields are only ever appended.
+static_assert(sizeof(void *) != 8 || sizeof(vx_str) == 16, "vx_str layout changed");
+static_assert(sizeof(void *) != 8 || offsetof(vx_result, path) == 16, "vx_result layout changed");
+static_assert(sizeof(void *) != 8 || offsetof(vx_result, icon) == 80, "vx_result layout changed");
+static_assert(sizeof(void *) != 8 || offsetof(vx_result, id) == 96, "vx_result layout changed");
+static_assert(sizeof(void *) != 8 || sizeof(vx_result) == 104, "vx_result layout changed");
+
+namespace
+{
+    utils::Program Make(const std::string &name, const std::string &path)
+    {
+        utils::Program program;
+        program.name = name;
+        program.executablePath = path;
+        return program;
+    }
+
+    std::vector<utils::Program> One(utils::Program program)
+    {
+        std::vector<utils::Program> programs;
+        programs.push_back(std::move(program));
+        return programs;
+    }
+
+    std::string Read(const vx_str &text)
+    {
+        return std::string(text.data, text.size);
+    }
+
+    // What dart:ffi sees of one vx_search() call.
+    std::vector<std::string> Search(vx_catalog *catalog, const std::string &query, uint32_t maxResults)
+    {
+        std::vector<std::string> names;
+        vx_results *results = vx_search(catalog, query.data(), static_cast<uint32_t>(query.size()), maxResults);
+        if (!results)
+            return names;
+        for (uint32_t i = 0; i < vx_result_count(results); ++i)
+            names.push_back(Read(vx_result_at(results, i)->name));
+        vx_results_free(results);
+        return names;
+    }
+
+    // Publishes a catalog for the test's duration and withdraws it after.
+    struct Published
+    {
+        explicit Published(std::vector<utils::Program> programs,
+                           std::shared_ptr<SearchEngine::ShortQueryIndex> shortQueries = nullptr)
+            : catalog(std::make_shared<SearchEngine::ProgramCatalog>())
+        {
+            catalog->Publish(std::move(programs));
+            SearchEngine::PublishFfiCatalog(catalog, std::move(shortQueries));
+        }
+        ~Published() { SearchEngine::PublishFfiCatalog(nullptr, nullptr); }
+
+        std::shared_ptr<SearchEngine::ProgramCatalog> catalog;
+    };
+
+    // Many documents in catalog order before the few executables that rank first.
+    std::vector<utils::Program> DocumentsFirst()
+    {
+        std::vector<utils::Program> programs;
+        for (int i = 0; i < 100; ++i)
+            programs.push_back(Make("Report " + std::to_string(i), "C:\\Docs\\report" + std::to_string(i) + ".pdf"));
+        programs.push_back(Make("Report Studio", "C:\\Apps\\studio.exe"));
+        programs.push_back(Make("Reports", "C:\\Start Menu\\Reports.lnk"));
+        programs.push_back(Make("Annual report", "C:\\Apps\\annual.exe"));
+        return programs;
+    }
+} // namespace
+
+// Opening before anything is published fails; handles outlive a withdrawal
+// and keep the catalog they attached to.
+TEST(VxSearchApi, OpenAndClose)
+{
+    CHECK_EQ(vx_abi_version(), 4u);
+    CHECK(vx_catalog_open() == nullptr);
+
+    vx_catalog *catalog = nullptr;
+    {
+        Published published(One(Make("Notepad", "C:\\Windows\\notepad.exe")));
+        catalog = vx_catalog_open();
+        REQUIRE(catalog != nullptr);
+        CHECK_EQ(vx_catalog_generation(catalog), 1u);
+        published.catalog->Publish(One(Make("Paint", "C:\\Windows\\mspaint.exe")));
+        CHECK_EQ(vx_catalog_generation(catalog), 2u);
+    }
+    CHECK(vx_catalog_open() == nullptr);
+    CHECK(Search(catalog, "paint", 0) == std::vector<std::string>{"Paint"});
+    vx_catalog_close(catalog);
+}
+
+// The limit cuts the ranked list, not the catalog order: executables found
+// last still come first.
+TEST(VxSearchApi, RanksBeforeTruncating)
+{
+    Published published(DocumentsFirst());
+    vx_catalog *catalog = vx_catalog_open();
+    REQUIRE(catalog != nullptr);
+
+    const std::vector<std::string> all = Search(catalog, "report", 0);
+    REQUIRE(all.size() == 103);
+    CHECK(std::vector<std::string>(all.begin(), all.begin() + 3) ==
+          (std::vector<std::string>{"Report Studio", "Annual report", "Reports"}));
+    CHECK_EQ(all[3], std::string("Report 0"));
+    for (uint32_t limit : {1u, 2u, 3u, 10u, 50u})
+        CHECK(Search(catalog, "REPORT", limit) == std::vector<std::string>(all.begin(), all.begin() + limit));
+    vx_catalog_close(catalog);
+}
+
+// Short queries answered from the ShortQueryIndex come back in the same order.
+TEST(VxSearchApi, ShortQueriesAgree)
+{
+    utils::TaskExecutor executor;
+    auto shortQueries =
+        std::make_shared<SearchEngine::ShortQueryIndex>(std::make_shared<SearchEngine::LaunchHistory>(), executor);
+    Published published(DocumentsFirst(), shortQueries);
+    vx_catalog *catalog = vx_catalog_open();
+    REQUIRE(catalog != nullptr);
+
+    const std::vector<std::string> scanned = Search(catalog, "re", 5);
+    const SearchEngine::ProgramCatalog::Snapshot snapshot = published.catalog->Current();
+    shortQueries->Prepare(snapshot);
+    while (!shortQueries->Ready(snapshot))
+        std::this_thread::yield();
+    CHECK(Search(catalog, "re", 5) == scanned);
+    CHECK_EQ(scanned.front(), std::string("Report Studio"));
+    vx_catalog_close(catalog);
+}
+
+// The catalog exists once, natively: rows are views into the published
+// entries, and a result set costs one vx_result per row on top of them.
+TEST(VxSearchApi, RowsPointIntoTheCatalog)
+{
+    Published published(DocumentsFirst());
+    vx_catalog *catalog = vx_catalog_open();
+    REQUIRE(catalog != nullptr);
+    const SearchEngine::ProgramCatalog::Snapshot snapshot = published.catalog->Current();
+
+    vx_results *results = vx_search(catalog, "report", 6, 0);
+    REQUIRE(vx_result_count(results) == snapshot->size());
+    for (uint32_t i = 0; i < vx_result_count(results); ++i)
+    {
+        const vx_result *row = vx_result_at(results, i);
+        bool found = false;
+        for (const utils::Program &program : *snapshot)
+        {
+            if (row->name.data == program.name.data() && row->path.data == program.executablePath.data() &&
+                row->icon.data == program.iconDataBase64.data() && row->id == program.id)
+                found = true;
+        }
+        CHECK(found);
+    }
+    const ptrdiff_t stride = reinterpret_cast<const char *>(vx_result_at(results, 1)) -
+                             reinterpret_cast<const char *>(vx_result_at(results, 0));
+    CHECK_EQ(stride, static_cast<ptrdiff_t>(sizeof(vx_result)));
+    vx_results_free(results);
+    vx_catalog_close(catalog);
+}
+
+// Every field comes through, rows stay valid after a republish, and bad
+// arguments get NULL or zero rather than a crash.
+TEST(VxSearchApi, RowsAndArguments)
+{
+    utils::Program program = Make("Code", "C:\\Apps\\Code.exe");
+    program.arguments = "--new-window";
+    program.kind = "program";
+    program.description = "Editor";
+    program.iconDataBase64 = "iVBORw0KGgo=";
+    Published published(One(std::move(program)));
+    vx_catalog *catalog = vx_catalog_open();
+    REQUIRE(catalog != nullptr);
+
+    vx_results *results = vx_search(catalog, "code", 4, 0);
+    REQUIRE(vx_result_count(results) == 1);
+    published.catalog->Publish({});
+    const vx_result *row = vx_result_at(results, 0);
+    REQUIRE(row != nullptr);
+    CHECK_EQ(Read(row->name), std::string("Code"));
+    CHECK_EQ(Read(row->path), std::string("C:\\Apps\\Code.exe"));
+    CHECK_EQ(Read(row->args), std::string("--new-window"));
+    CHECK_EQ(Read(row->kind), std::string("program"));
+    CHECK_EQ(Read(row->description), std::string("Editor"));
+    CHECK_EQ(Read(row->icon), std::string("iVBORw0KGgo="));
+    CHECK(row->id != 0);
+    CHECK(vx_result_at(results, 1) == nullptr);
+    vx_results_free(results);
+
+    CHECK(vx_search(nullptr, "code", 4, 0) == nullptr);
+    CHECK(vx_search(catalog, nullptr, 4, 0) == nullptr);
+    results = vx_search(catalog, nullptr, 0, 0); // The empty query, on the now empty catalog
+    REQUIRE(results != nullptr);
+    CHECK_EQ(vx_result_count(results), 0u);
+    vx_results_free(results);
+    CHECK_EQ(vx_result_count(nullptr), 0u);
+    CHECK(vx_result_at(nullptr, 0) == nullptr);
+    CHECK_EQ(vx_catalog_generation(nullptr), 0u);
+    vx_results_free(nullptr);
+    vx_catalog_close(catalog);
+
+    void *buffer = vx_alloc(64);
+    CHECK(buffer != nullptr);
+    vx_free(buffer);
+}
@@ -0,0 +1,89 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SearchProviders.h"
+#include "VxSearchApi.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double Percentile(std::vector<double> values, double p)
+    {
+        std::sort(values.begin(), values.end());
+        return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+    }
+
+    std::vector<utils::Program> ScannedPrograms(size_t count)
+    {
+        static const char *const kWords[] = {"Visual", "Studio", "Code", "Office", "Word", "Excel", "Paint",
+                                             "Terminal", "Steam", "Player", "Editor", "Manager", "Update",
+                                             "Setup", "Viewer", "Notes"};
+        static const char *const kExtensions[] = {".exe", ".lnk", ".pdf", ".url", ".exe", ".txt"};
+        std::vector<utils::Program> programs;
+        programs.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            utils::Program program;
+            program.name = std::string(kWords[i % 16]) + " " + kWords[(i / 16) % 16] + " " + std::to_string(i);
+            program.executablePath =
+                "D:\\Programs\\Vendor " + std::to_string(i % 97) + "\\" + program.name + kExtensions[i % 6];
+            program.description = i % 5 == 0 ? "Tools for " + std::string(kWords[(i / 3) % 16]) : "";
+            programs.push_back(std::move(program));
+        }
+        return programs;
+    }
+} // namespace
+
+// Latency of one vx_search() call as dart:ffi makes it for the instant results
+// (50 rows) and with no limit, reading every row back: the whole cost of a
+// keystroke's synchronous lookup. Run on a Release build:
+//
+//   native_utils_bench VxSearchBench
+TEST(VxSearchBench, PerCall)
+{
+    const char *const queries[] = {"v", "st", "vis", "code", "steam player", "notes viewer 12", "no such program"};
+    for (size_t size : {3000, 30000})
+    {
+        auto catalog = std::make_shared<SearchEngine::ProgramCatalog>();
+        catalog->Publish(ScannedPrograms(size));
+        SearchEngine::PublishFfiCatalog(catalog, nullptr);
+        vx_catalog *handle = vx_catalog_open();
+        REQUIRE(handle != nullptr);
+
+        for (uint32_t limit : {50u, 0u})
+        {
+            std::vector<double> us;
+            size_t rows = 0;
+            size_t nameBytes = 0; // Read back like the Dart side does
+            for (int round = 0; round < 20; ++round)
+            {
+                for (const char *query : queries)
+                {
+                    const std::string text = query;
+                    const Clock::time_point start = Clock::now();
+                    vx_results *results =
+                        vx_search(handle, text.data(), static_cast<uint32_t>(text.size()), limit);
+                    const uint32_t count = vx_result_count(results);
+                    for (uint32_t i = 0; i < count; ++i)
+                        nameBytes += vx_result_at(results, i)->name.size;
+                    vx_results_free(results);
+                    us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+                    rows += count;
+                }
+            }
+            std::printf("  %6zu entries, limit %2u: %6.1f rows, %6.0f name bytes per call; p50 %.0f us, p99 %.0f us, "
+                        "max %.0f us\n",
+                        size, limit, double(rows) / us.size(), double(nameBytes) / us.size(), Percentile(us, 0.5), Percentile(us, 0.99),
+                        Percentile(us, 1.0));
+        }
+        vx_catalog_close(handle);
+        SearchEngine::PublishFfiCatalog(nullptr, nullptr);
+    }
+}
@@ -0,0 +1,269 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ChangeDebouncer.h"
+#include "DirectoryWatcher.h"
+#include "IncrementalCatalog.h"
+#include "SearchProviders.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // A fresh directory under the temp folder, removed again with the object.
+    class TempTree
+    {
+    public:
+        explicit TempTree(const std::string &name) : path_(fs::temp_directory_path() / ("vxkonsol-" + name))
+        {
+            fs::remove_all(path_);
+            fs::create_directories(path_);
+        }
+        ~TempTree()
+        {
+            std::error_code ec;
+            fs::remove_all(path_, ec);
+        }
+
+        const fs::path &Path() const { return path_; }
+
+    private:
+        fs::path path_;
+    };
+
+    // Shortcut stand-ins: a .lnk file whose content is its target.
+    void WriteShortcut(const fs::path &path, const std::string &target)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << target;
+    }
+
+    std::optional<utils::Program> ResolveShortcut(const std::string &path, const std::string &source)
+    {
+        std::ifstream in(fs::u8path(path), std::ios::binary);
+        std::string target((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (target.empty())
+            return std::nullopt;
+        utils::Program program;
+        program.name = fs::u8path(path).stem().u8string();
+        program.executablePath = target;
+        program.originPath = path;
+        program.source = source;
+        return program;
+    }
+
+    std::vector<utils::Program> KeepAll(std::vector<utils::Program> &candidates)
+    {
+        return std::move(candidates);
+    }
+
+    std::set<std::string> CatalogNames(const SearchEngine::ProgramCatalog &catalog)
+    {
+        const SearchEngine::ProgramCatalog::Snapshot snapshot = catalog.Current();
+        std::set<std::string> names;
+        for (const utils::Program &program : *snapshot)
+            names.insert(program.name);
+        return names;
+    }
+
+    // Collects debounced batches.
+    struct Flushes
+    {
+        void Add(std::vector<SearchEngine::FileEvent> &&events)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batches.push_back(std::move(events));
+            ++flushed;
+            cv.notify_all();
+        }
+
+        bool WaitFor(size_t count, std::chrono::milliseconds timeout = std::chrono::seconds(5))
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            return cv.wait_for(lock, timeout, [this, count]() { return batches.size() >= count; });
+        }
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<std::vector<SearchEngine::FileEvent>> batches;
+        std::atomic<size_t> flushed{0};
+    };
+
+    bool WaitUntil(const std::function<bool()> &done)
+    {
+        const Clock::time_point deadline = Clock::now() + std::chrono::seconds(5);
+        while (!done())
+        {
+            if (Clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return true;
+    }
+} // namespace
+
+// Events for one path merge to their net effect, lost-event rescans come
+// first, and the batch waits for the tree to go quiet.
+TEST(Watcher, DebouncerCoalesces)
+{
+    using SearchEngine::FileChange;
+    Flushes flushes;
+    SearchEngine::ChangeDebouncer debouncer([&flushes](std::vector<SearchEngine::FileEvent> &&events) { flushes.Add(std::move(events)); },
+                                            std::chrono::milliseconds(50), std::chrono::milliseconds(1000));
+
+    const Clock::time_point start = Clock::now();
+    debouncer.Add({{FileChange::Added, "/r/temp.lnk"}, {FileChange::Modified, "/r/temp.lnk"}});
+    debouncer.Add({{FileChange::Removed, "/r/temp.lnk"}});                                      // Cancels out
+    debouncer.Add({{FileChange::Removed, "/r/app.lnk"}, {FileChange::Added, "/r/app.lnk"}});    // Modified
+    debouncer.Add({{FileChange::Added, "/r/new.lnk"}, {FileChange::Modified, "/r/new.lnk"}});   // Added
+    debouncer.Add({{FileChange::Overflow, "/r"}, {FileChange::Overflow, "/r"}});
+    REQUIRE(flushes.WaitFor(1));
+    CHECK(Clock::now() - start >= std::chrono::milliseconds(50));
+
+    std::lock_guard<std::mutex> lock(flushes.mutex);
+    REQUIRE(flushes.batches.size() == 1);
+    const std::vector<SearchEngine::FileEvent> &batch = flushes.batches[0];
+    REQUIRE(batch.size() == 3);
+    CHECK(batch[0].change == FileChange::Overflow);
+    CHECK_EQ(batch[0].path, std::string("/r"));
+    CHECK_EQ(batch[1].path, std::string("/r/app.lnk"));
+    CHECK(batch[1].change == FileChange::Modified);
+    CHECK_EQ(batch[2].path, std::string("/r/new.lnk"));
+    CHECK(batch[2].change == FileChange::Added);
+}
+
+// A steady trickle of events still flushes after |maxDelay|.
+TEST(Watcher, DebouncerFlushesWithinMaxDelay)
+{
+    using SearchEngine::FileChange;
+    Flushes flushes;
+    SearchEngine::ChangeDebouncer debouncer([&flushes](std::vector<SearchEngine::FileEvent> &&events) { flushes.Add(std::move(events)); },
+                                            std::chrono::milliseconds(100), std::chrono::milliseconds(300));
+    const Clock::time_point start = Clock::now();
+    for (int i = 0; i < 40 && flushes.flushed == 0; ++i)
+    {
+        debouncer.Add({{FileChange::Modified, "/r/busy" + std::to_string(i) + ".lnk"}});
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    REQUIRE(flushes.WaitFor(1));
+    const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    CHECK(ms >= 290.0);
+    CHECK(ms < 600.0);
+}
+
+// An installer's churn in a watched tree, through the real watcher and
+// debouncer into the incremental catalog: temporary files, rewrites,
+// renames, a folder renamed and one moved out of the tree. The catalog ends
+// up as a rescan would see it, from a handful of batches.
+TEST(Watcher, InstallerChurnReachesCatalog)
+{
+    TempTree tree("watcher-churn");
+    TempTree outside("watcher-outside");
+    const fs::path root = tree.Path();
+    auto catalog = std::make_shared<SearchEngine::ProgramCatalog>();
+    SearchEngine::IncrementalCatalog incremental(catalog, {{root.u8string(), "start-menu"}}, ResolveShortcut, KeepAll);
+    incremental.Reset({});
+
+    std::atomic<int> batches{0};
+    std::atomic<size_t> rawEvents{0};
+    std::atomic<int> ghostEvents{0};
+    const std::string ghost = (root / "Old" / "Ghost.lnk").u8string();
+    SearchEngine::ChangeDebouncer debouncer(
+        [&](std::vector<SearchEngine::FileEvent> &&events) {
+            incremental.Apply(events);
+            ++batches;
+        },
+        std::chrono::milliseconds(150), std::chrono::milliseconds(2000));
+    std::unique_ptr<SearchEngine::DirectoryWatcher> watcher = SearchEngine::DirectoryWatcher::Create();
+    REQUIRE(watcher->Start({root.u8string()}, [&](std::vector<SearchEngine::FileEvent> &&events) {
+        rawEvents += events.size();
+        for (const SearchEngine::FileEvent &event : events)
+            ghostEvents += event.path == ghost;
+        debouncer.Add(std::move(events));
+    }));
+
+    fs::create_directories(root / "Vendor" / "Tools");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20)); // Let the watcher add the new folders
+    for (int i = 0; i < 30; ++i)
+    {
+        const fs::path link = root / "Vendor" / ("App " + std::to_string(i) + ".lnk");
+        WriteShortcut(link, "/opt/vendor/app" + std::to_string(i));
+        WriteShortcut(link, "/opt/vendor/app" + std::to_string(i)); // Written twice
+        WriteShortcut(root / "Vendor" / ("setup" + std::to_string(i) + ".tmp.lnk"), "/tmp/setup");
+        fs::remove(root / "Vendor" / ("setup" + std::to_string(i) + ".tmp.lnk"));
+    }
+    WriteShortcut(root / "Vendor" / "Tools" / "Helper.lnk", "/opt/vendor/helper");
+    fs::rename(root / "Vendor" / "App 0.lnk", root / "Vendor" / "App Zero.lnk");
+    fs::remove(root / "Vendor" / "App 1.lnk");
+    fs::create_directories(root / "Old");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    WriteShortcut(root / "Old" / "Legacy.lnk", "/opt/legacy");
+    fs::rename(root / "Old", outside.Path() / "Old"); // Moved out of the tree
+
+    std::set<std::string> expected;
+    expected.insert("App Zero");
+    for (int i = 2; i < 30; ++i)
+        expected.insert("App " + std::to_string(i));
+    expected.insert("Helper");
+    REQUIRE(WaitUntil([&]() { return CatalogNames(*catalog) == expected; }));
+
+    // The folder moved away is no longer watched: nothing written there is
+    // reported under its old path.
+    WriteShortcut(outside.Path() / "Old" / "Ghost.lnk", "/opt/ghost");
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    CHECK_EQ(ghostEvents.load(), 0);
+    CHECK(CatalogNames(*catalog) == expected);
+    watcher->Stop();
+
+    std::printf("  %zu raw events in %d catalog batches\n", rawEvents.load(), batches.load());
+    CHECK(batches.load() <= 4);
+    CHECK(rawEvents.load() > static_cast<size_t>(4 * batches.load()));
+}
+
+// A watched root that disappears is reported once and dropped, rather than
+// reported again and again.
+TEST(Watcher, RemovedRootIsReportedOnce)
+{
+    TempTree tree("watcher-root");
+    TempTree outside("watcher-root-outside");
+    const fs::path root = tree.Path() / "Programs";
+    fs::create_directories(root);
+    std::mutex mutex;
+    std::vector<SearchEngine::FileEvent> seen;
+    std::unique_ptr<SearchEngine::DirectoryWatcher> watcher = SearchEngine::DirectoryWatcher::Create();
+    REQUIRE(watcher->Start({root.u8string()}, [&](std::vector<SearchEngine::FileEvent> &&events) {
+        std::lock_guard<std::mutex> lock(mutex);
+        seen.insert(seen.end(), events.begin(), events.end());
+    }));
+
+    fs::rename(root, outside.Path() / "Programs");
+    REQUIRE(WaitUntil([&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !seen.empty();
+    }));
+    WriteShortcut(outside.Path() / "Programs" / "After.lnk", "/opt/after");
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    watcher->Stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    REQUIRE(seen.size() == 1);
+    CHECK(seen[0].change == SearchEngine::FileChange::Overflow);
+    CHECK_EQ(seen[0].path, root.u8string());
+}
@@ -92,9 +92,12 @@ namespace {
 // Public API Implementation
 //-----------------------------------------------------------------------------
  // --- Revised SearchWindowsIndex Function ---
- std::vector<utils::Program> SearchWindowsIndex(const std::string &searchString)
+ std::vector<utils::Program> SearchWindowsIndex(const std::string &searchString, const utils::CancellationToken &token)
  {
      std::vector<utils::Program> finalResults;
+     if (token.IsCancelled()) {
+         return finalResults;
+     }
 
      // Initialize COM and optionally GDI+
      CoInitializer com_guard;
@@ -174,6 +177,10 @@ namespace {
 
              while (!pR->EndOfFile)
              {
+                 if (token.IsCancelled()) {
+                     DebugOutputWS(L"WinSearch: Cancelled while reading recordset.");
+                     break;
+                 }
                  std::wstring itemNameW, itemPathW, kindW, commentW;
                  _variant_t vName, vPath, vKind, vComment; // Use separate variants
 
@@ -322,6 +329,10 @@ namespace {
      // --- PASS 2: Process Unique Items ---
      for (const auto& pair : uniqueRawItems)
      {
+         if (token.IsCancelled()) {
+             DebugOutputWS(L"WinSearch: Cancelled during item processing.");
+             break;
+         }
          const std::wstring& itemPathDisplayW = pair.first;         // Key: Path
          const auto& itemData = pair.second;                        // Value: Tuple
          const std::wstring& itemNameW = std::get<0>(itemData);     // From Tuple
@@ -367,7 +378,7 @@ namespace {
 
              if (isLnk) {
                  // Resolve shortcut (function expected to return description)
-                 resolvedInfoOpt = utils::ResolveShortcut(itemPathFs);
+                 resolvedInfoOpt = utils::ResolveShortcut(itemPathFs, token);
                  if (!resolvedInfoOpt) {
                      DebugOutputWS(L"  Skipping: Failed to resolve shortcut '", itemPathDisplayW, L"'");
                      continue; // Skip this item
@@ -439,7 +450,7 @@ namespace {
                  program.iconDataBase64 = ""; // Clear previous (should be empty anyway)
                  if (!program.iconPath.empty() && program.iconIndex >= 0) {
                      // Call utility function (ensure it's linked/available and handles GDI+ init if needed)
-                     auto encodedIconOpt = utils::ExtractAndEncodeIconAsBase64(program.iconPath, program.iconIndex);
+                     auto encodedIconOpt = utils::ExtractAndEncodeIconAsBase64(program.iconPath, program.iconIndex, token);
                      if (encodedIconOpt) {
                          program.iconDataBase64 = std::move(*encodedIconOpt);
                      } else {
@@ -471,3 +482,8 @@ namespace {
      DebugOutputWS(L"WinSearch: Returning ", finalResults.size(), L" processed programs.");
      return finalResults;
  } // End SearchWindowsIndex
+
+std::vector<utils::Program> SearchEngine::WindowsIndexProvider::Search(const std::string &query, const utils::CancellationToken &token)
+{
+    return SearchWindowsIndex(query, token);
+}
@@ -6,6 +6,7 @@
 #include <vector>
 #include <cstdint>
 #include "common_utils.h"
+#include "SearchProviders.h"
 
 /**
  * @brief Searches the Windows Search Index for items matching the query,
@@ -16,10 +17,24 @@
  *          a ProgramFinder::Program structure. Assumes the input query string is UTF-8 encoded.
  *
  * @param searchString The UTF-8 encoded string to search for in item names or paths within the index.
+ * @param token Polled once per recordset row and once per processed item; when it fires the
+ *        function stops fetching and returns whatever it has built so far.
  * @return std::vector<ProgramFinder::Program> A list of programs/items found, matching the
  *         ProgramFinder::Program structure. Returns an empty vector on critical errors (e.g., COM failure).
  */
-std::vector<utils::Program> SearchWindowsIndex(const std::string &searchString); // Changed parameter type
+std::vector<utils::Program> SearchWindowsIndex(const std::string &searchString, const utils::CancellationToken &token = {});
+
+namespace SearchEngine
+{
+    // Scheduler adapter for SearchWindowsIndex(). Typically the slowest provider.
+    class WindowsIndexProvider : public SearchProvider
+    {
+    public:
+        const char *Name() const override { return "index"; }
+        bool IsExpensive() const override { return true; }
+        std::vector<utils::Program> Search(const std::string &query, const utils::CancellationToken &token) override;
+    };
+} // namespace SearchEngine
 
 // Utility function (can be kept if needed internally or removed if ProgramFinder helpers are used)
 // std::string wstringToString(const std::wstring &wstr); // Consider using ProgramFinder's WideToUtf8 instead
@@ -0,0 +1,38 @@
+#include "platform_task_queue.h"
+
+#include <utility>
+
+PlatformTaskQueue::PlatformTaskQueue(HWND window) : window_(window) {}
+
+void PlatformTaskQueue::Post(std::function<void()> task) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!window_) {
+    return;
+  }
+  bool was_empty = tasks_.empty();
+  tasks_.push_back(std::move(task));
+  // One wake-up per batch is enough; Drain picks up everything queued since.
+  if (was_empty) {
+    ::PostMessage(window_, kDrainMessage, 0, 0);
+  }
+}
+
+void PlatformTaskQueue::Drain() {
+  std::vector<std::function<void()>> tasks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks.swap(tasks_);
+  }
+  for (auto& task : tasks) {
+    task();
+  }
+}
+
+void PlatformTaskQueue::Detach() {
+  std::vector<std::function<void()>> dropped;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    window_ = nullptr;
+    dropped.swap(tasks_);
+  }
+}
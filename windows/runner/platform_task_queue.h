@@ -0,0 +1,37 @@
+#ifndef RUNNER_PLATFORM_TASK_QUEUE_H_
+#define RUNNER_PLATFORM_TASK_QUEUE_H_
+
+#include <windows.h>
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Marshals closures from native worker threads back onto the platform thread,
+// which owns the Flutter engine and every pending MethodResult. Workers hold a
+// shared_ptr to the queue, so they may outlive the window safely: once
+// |Detach| has been called further posts are dropped.
+class PlatformTaskQueue {
+ public:
+  // Window message used to wake the platform thread.
+  static constexpr UINT kDrainMessage = WM_APP + 0x100;
+
+  explicit PlatformTaskQueue(HWND window);
+
+  // Queues |task| and wakes the platform thread. Callable from any thread.
+  void Post(std::function<void()> task);
+
+  // Runs every queued task. Must be called on the platform thread in response
+  // to |kDrainMessage|.
+  void Drain();
+
+  // Stops accepting work and discards anything still queued.
+  void Detach();
+
+ private:
+  std::mutex mutex_;
+  HWND window_;
+  std::vector<std::function<void()>> tasks_;
+};
+
+#endif  // RUNNER_PLATFORM_TASK_QUEUE_H_